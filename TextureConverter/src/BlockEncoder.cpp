@@ -0,0 +1,317 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include "BlockEncoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    using Block = std::array<std::uint8_t, 64>; //4x4 RGBA
+
+    Block fetchBlock(const SourceImage& img, std::uint32_t blockX, std::uint32_t blockY)
+    {
+        //edge blocks repeat the last row/column
+        Block block = {};
+        for (auto y = 0u; y < 4u; ++y)
+        {
+            auto srcY = std::min(blockY * 4 + y, img.height - 1);
+            for (auto x = 0u; x < 4u; ++x)
+            {
+                auto srcX = std::min(blockX * 4 + x, img.width - 1);
+                std::memcpy(&block[(y * 4 + x) * 4], &img.pixels[(srcY * img.width + srcX) * 4], 4);
+            }
+        }
+        return block;
+    }
+
+    std::uint16_t pack565(std::int32_t r, std::int32_t g, std::int32_t b)
+    {
+        return static_cast<std::uint16_t>(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+    }
+
+    std::array<std::int32_t, 3> unpack565(std::uint16_t c)
+    {
+        std::int32_t r = (c >> 11) & 0x1f;
+        std::int32_t g = (c >> 5) & 0x3f;
+        std::int32_t b = c & 0x1f;
+        return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+    }
+
+    template <typename T>
+    void write(std::vector<std::uint8_t>& dst, T value)
+    {
+        auto offset = dst.size();
+        dst.resize(offset + sizeof(T));
+        std::memcpy(dst.data() + offset, &value, sizeof(T));
+    }
+
+    //always uses 4 colour mode, so alpha is ignored
+    void encodeColour(const Block& block, std::vector<std::uint8_t>& dst)
+    {
+        //find the principal axis of the block colours so that
+        //the endpoints follow the actual distribution of colours
+        //rather than the diagonal of their bounding box
+        std::array<float, 3> mean = {};
+        for (auto i = 0u; i < 16u; ++i)
+        {
+            for (auto c = 0u; c < 3u; ++c)
+            {
+                mean[c] += block[i * 4 + c];
+            }
+        }
+        for (auto& m : mean)
+        {
+            m /= 16.f;
+        }
+
+        std::array<float, 6> cov = {}; //rr, rg, rb, gg, gb, bb
+        for (auto i = 0u; i < 16u; ++i)
+        {
+            float r = block[i * 4] - mean[0];
+            float g = block[i * 4 + 1] - mean[1];
+            float b = block[i * 4 + 2] - mean[2];
+            cov[0] += r * r;
+            cov[1] += r * g;
+            cov[2] += r * b;
+            cov[3] += g * g;
+            cov[4] += g * b;
+            cov[5] += b * b;
+        }
+
+        std::array<float, 3> axis = { 1.f, 1.f, 1.f };
+        for (auto i = 0; i < 8; ++i)
+        {
+            std::array<float, 3> next =
+            {
+                axis[0] * cov[0] + axis[1] * cov[1] + axis[2] * cov[2],
+                axis[0] * cov[1] + axis[1] * cov[3] + axis[2] * cov[4],
+                axis[0] * cov[2] + axis[1] * cov[4] + axis[2] * cov[5]
+            };
+            auto len = std::max({ std::abs(next[0]), std::abs(next[1]), std::abs(next[2]) });
+            if (len == 0.f)
+            {
+                break;
+            }
+            axis = { next[0] / len, next[1] / len, next[2] / len };
+        }
+
+        float minProj = std::numeric_limits<float>::max();
+        float maxProj = std::numeric_limits<float>::lowest();
+        for (auto i = 0u; i < 16u; ++i)
+        {
+            float proj = (block[i * 4] - mean[0]) * axis[0]
+                + (block[i * 4 + 1] - mean[1]) * axis[1]
+                + (block[i * 4 + 2] - mean[2]) * axis[2];
+            minProj = std::min(minProj, proj);
+            maxProj = std::max(maxProj, proj);
+        }
+
+        //inset the endpoints slightly to reduce the error at the extremes
+        const auto axisLen2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+        const auto inset = (maxProj - minProj) / 16.f;
+        minProj = (minProj + inset) / axisLen2;
+        maxProj = (maxProj - inset) / axisLen2;
+
+        std::array<std::int32_t, 3> minCol = {};
+        std::array<std::int32_t, 3> maxCol = {};
+        for (auto c = 0u; c < 3u; ++c)
+        {
+            minCol[c] = std::clamp(static_cast<std::int32_t>(mean[c] + axis[c] * minProj + 0.5f), 0, 255);
+            maxCol[c] = std::clamp(static_cast<std::int32_t>(mean[c] + axis[c] * maxProj + 0.5f), 0, 255);
+        }
+
+        auto c0 = pack565(maxCol[0], maxCol[1], maxCol[2]);
+        auto c1 = pack565(minCol[0], minCol[1], minCol[2]);
+        if (c0 < c1)
+        {
+            std::swap(c0, c1);
+        }
+
+        write(dst, c0);
+        write(dst, c1);
+
+        std::uint32_t indices = 0;
+        if (c0 != c1)
+        {
+            auto p0 = unpack565(c0);
+            auto p1 = unpack565(c1);
+            std::array<std::array<std::int32_t, 3>, 4> palette =
+            {
+                p0, p1,
+                std::array<std::int32_t, 3>({ (2 * p0[0] + p1[0]) / 3, (2 * p0[1] + p1[1]) / 3, (2 * p0[2] + p1[2]) / 3 }),
+                std::array<std::int32_t, 3>({ (p0[0] + 2 * p1[0]) / 3, (p0[1] + 2 * p1[1]) / 3, (p0[2] + 2 * p1[2]) / 3 })
+            };
+
+            for (auto i = 0u; i < 16u; ++i)
+            {
+                std::uint32_t best = 0;
+                std::int32_t bestDist = std::numeric_limits<std::int32_t>::max();
+                for (auto j = 0u; j < 4u; ++j)
+                {
+                    std::int32_t dist = 0;
+                    for (auto c = 0u; c < 3u; ++c)
+                    {
+                        auto d = static_cast<std::int32_t>(block[i * 4 + c]) - palette[j][c];
+                        dist += d * d;
+                    }
+
+                    if (dist < bestDist)
+                    {
+                        bestDist = dist;
+                        best = j;
+                    }
+                }
+                indices |= (best << (i * 2));
+            }
+        }
+        write(dst, indices);
+    }
+
+    //used for both BC3 alpha and BC4
+    void encodeChannel(const Block& block, std::uint32_t channel, std::vector<std::uint8_t>& dst)
+    {
+        std::int32_t minVal = 255;
+        std::int32_t maxVal = 0;
+        for (auto i = 0u; i < 16u; ++i)
+        {
+            minVal = std::min(minVal, static_cast<std::int32_t>(block[i * 4 + channel]));
+            maxVal = std::max(maxVal, static_cast<std::int32_t>(block[i * 4 + channel]));
+        }
+
+        dst.push_back(static_cast<std::uint8_t>(maxVal));
+        dst.push_back(static_cast<std::uint8_t>(minVal));
+
+        std::uint64_t indices = 0;
+        if (maxVal != minVal)
+        {
+            //8 value mode as a0 > a1
+            std::array<std::int32_t, 8> palette = {};
+            palette[0] = maxVal;
+            palette[1] = minVal;
+            for (auto i = 1; i < 7; ++i)
+            {
+                palette[i + 1] = ((7 - i) * maxVal + i * minVal) / 7;
+            }
+
+            for (auto i = 0u; i < 16u; ++i)
+            {
+                std::uint64_t best = 0;
+                std::int32_t bestDist = std::numeric_limits<std::int32_t>::max();
+                for (auto j = 0u; j < 8u; ++j)
+                {
+                    auto dist = std::abs(static_cast<std::int32_t>(block[i * 4 + channel]) - palette[j]);
+                    if (dist < bestDist)
+                    {
+                        bestDist = dist;
+                        best = j;
+                    }
+                }
+                indices |= (best << (i * 3));
+            }
+        }
+
+        for (auto i = 0u; i < 6u; ++i)
+        {
+            dst.push_back(static_cast<std::uint8_t>((indices >> (i * 8)) & 0xff));
+        }
+    }
+}
+
+SourceImage SourceImage::createMip() const
+{
+    SourceImage retVal;
+    retVal.width = std::max(1u, width / 2);
+    retVal.height = std::max(1u, height / 2);
+    retVal.pixels.resize(retVal.width * retVal.height * 4);
+
+    for (auto y = 0u; y < retVal.height; ++y)
+    {
+        auto y0 = std::min(y * 2, height - 1);
+        auto y1 = std::min(y * 2 + 1, height - 1);
+        for (auto x = 0u; x < retVal.width; ++x)
+        {
+            auto x0 = std::min(x * 2, width - 1);
+            auto x1 = std::min(x * 2 + 1, width - 1);
+            for (auto c = 0u; c < 4u; ++c)
+            {
+                std::uint32_t sum = pixels[(y0 * width + x0) * 4 + c]
+                    + pixels[(y0 * width + x1) * 4 + c]
+                    + pixels[(y1 * width + x0) * 4 + c]
+                    + pixels[(y1 * width + x1) * 4 + c];
+                retVal.pixels[(y * retVal.width + x) * 4 + c] = static_cast<std::uint8_t>((sum + 2) / 4);
+            }
+        }
+    }
+    return retVal;
+}
+
+std::vector<std::uint8_t> compressImage(const SourceImage& img, cro::CompressedFormat::Type format)
+{
+    std::vector<std::uint8_t> retVal;
+    if (format != cro::CompressedFormat::BC1
+        && format != cro::CompressedFormat::BC3
+        && format != cro::CompressedFormat::BC4)
+    {
+        return retVal;
+    }
+
+    retVal.reserve(cro::CompressedImage::calcByteSize(format, img.width, img.height));
+
+    const auto blocksX = (img.width + 3) / 4;
+    const auto blocksY = (img.height + 3) / 4;
+    for (auto y = 0u; y < blocksY; ++y)
+    {
+        for (auto x = 0u; x < blocksX; ++x)
+        {
+            auto block = fetchBlock(img, x, y);
+            switch (format)
+            {
+            default: break;
+            case cro::CompressedFormat::BC1:
+                encodeColour(block, retVal);
+                break;
+            case cro::CompressedFormat::BC3:
+                encodeChannel(block, 3, retVal);
+                encodeColour(block, retVal);
+                break;
+            case cro::CompressedFormat::BC4:
+                encodeChannel(block, 0, retVal);
+                break;
+            }
+        }
+    }
+    return retVal;
+}
@@ -0,0 +1,59 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <crogine/graphics/CompressedImage.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/*!
+\brief RGBA8 pixel data used as the source for block compression
+*/
+struct SourceImage final
+{
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    std::vector<std::uint8_t> pixels; //always 4 channels
+
+    /*!
+    \brief Returns a half size copy of this image, box filtered
+    */
+    SourceImage createMip() const;
+};
+
+/*!
+\brief Compresses the given image into the given format.
+Only BC1, BC3 and BC4 are supported - BC4 encodes the red channel.
+\returns The compressed blocks, which will be empty if the format
+is unsupported
+*/
+std::vector<std::uint8_t> compressImage(const SourceImage&, cro::CompressedFormat::Type);
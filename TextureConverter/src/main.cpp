@@ -0,0 +1,314 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+/*
+Offline converter which creates pre-mipmapped, block compressed
+DDS files from images loadable by cro::Image. See readme.md
+*/
+
+#include "BlockEncoder.hpp"
+
+#include <crogine/core/ConfigFile.hpp>
+#include <crogine/core/FileSystem.hpp>
+#include <crogine/graphics/CompressedImage.hpp>
+#include <crogine/graphics/Image.hpp>
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Options final
+    {
+        std::string input;
+        std::string output;
+        cro::CompressedFormat::Type format = cro::CompressedFormat::None;
+        bool mipmaps = true;
+    };
+
+    //same order as GL_TEXTURE_CUBE_MAP_XXXX_YYYY and DDS
+    const std::array<std::string, 6u> CubemapLabels =
+    {
+        "right", "left", "up", "down", "front", "back"
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: texture_converter [-f bc1|bc3|bc4] [--no-mips] <input> <output.dds>\n"
+            << "  <input> is any image file supported by cro::Image, or a *.ccm\n"
+            << "  cubemap definition, in which case a DDS cubemap is written.\n"
+            << "  If -f is omitted RGB images use BC1, RGBA images BC3 and\n"
+            << "  single channel images BC4.\n";
+    }
+
+    bool parseArgs(int argc, char** argv, Options& options)
+    {
+        std::vector<std::string> paths;
+        for (auto i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "-f" && i + 1 < argc)
+            {
+                std::string fmt = argv[++i];
+                if (fmt == "bc1")
+                {
+                    options.format = cro::CompressedFormat::BC1;
+                }
+                else if (fmt == "bc3")
+                {
+                    options.format = cro::CompressedFormat::BC3;
+                }
+                else if (fmt == "bc4")
+                {
+                    options.format = cro::CompressedFormat::BC4;
+                }
+                else
+                {
+                    std::cerr << "Unsupported format " << fmt << "\n";
+                    return false;
+                }
+            }
+            else if (arg == "--no-mips")
+            {
+                options.mipmaps = false;
+            }
+            else
+            {
+                paths.push_back(arg);
+            }
+        }
+
+        if (paths.size() != 2)
+        {
+            return false;
+        }
+
+        options.input = paths[0];
+        options.output = paths[1];
+        return true;
+    }
+
+    bool loadSource(const std::string& path, bool flip, SourceImage& dst, cro::ImageFormat::Type& format)
+    {
+        cro::Image img(flip);
+        if (!img.loadFromFile(path))
+        {
+            return false;
+        }
+
+        auto size = img.getSize();
+        format = img.getFormat();
+        dst.width = size.x;
+        dst.height = size.y;
+        dst.pixels.resize(size.x * size.y * 4);
+
+        std::size_t channels = format == cro::ImageFormat::RGBA ? 4 : format == cro::ImageFormat::RGB ? 3 : 1;
+        const auto* src = img.getPixelData();
+        for (auto i = 0u; i < size.x * size.y; ++i)
+        {
+            auto* px = &dst.pixels[i * 4];
+            if (channels == 1)
+            {
+                px[0] = px[1] = px[2] = src[i];
+                px[3] = 255;
+            }
+            else
+            {
+                std::memcpy(px, src + (i * channels), channels);
+                if (channels == 3)
+                {
+                    px[3] = 255;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::uint32_t getFourCC(cro::CompressedFormat::Type format)
+    {
+        switch (format)
+        {
+        default: return 0;
+        case cro::CompressedFormat::BC1: return 0x31545844; //DXT1
+        case cro::CompressedFormat::BC3: return 0x35545844; //DXT5
+        case cro::CompressedFormat::BC4: return 0x31495441; //ATI1
+        }
+    }
+
+    std::vector<std::uint8_t> createHeader(std::uint32_t width, std::uint32_t height, std::uint32_t levels, bool cubemap, cro::CompressedFormat::Type format)
+    {
+        std::array<std::uint32_t, 32> header = {};
+        header[0] = 0x20534444; //"DDS "
+        header[1] = 124; //header size
+        header[2] = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000; //caps, height, width, pixel format, mip count, linear size
+        header[3] = height;
+        header[4] = width;
+        header[5] = static_cast<std::uint32_t>(cro::CompressedImage::calcByteSize(format, width, height));
+        header[7] = levels;
+        header[19] = 32; //pixel format size
+        header[20] = 0x4; //fourCC
+        header[21] = getFourCC(format);
+        header[27] = 0x1000 | ((levels > 1 || cubemap) ? 0x8 : 0) | (levels > 1 ? 0x400000 : 0); //texture, complex, mipmap
+        header[28] = cubemap ? 0x200 | 0xFC00 : 0; //cubemap, all faces
+
+        std::vector<std::uint8_t> retVal(sizeof(header));
+        std::memcpy(retVal.data(), header.data(), sizeof(header));
+        return retVal;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseArgs(argc, argv, options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    //cubemap faces are stored top row first, 2D textures bottom row first
+    //to match the orientation of Image / Texture
+    std::vector<SourceImage> faces;
+    cro::ImageFormat::Type sourceFormat = cro::ImageFormat::None;
+    const bool cubemap = cro::FileSystem::getFileExtension(options.input) == ".ccm";
+    if (cubemap)
+    {
+        cro::ConfigFile cfg;
+        if (!cfg.loadFromFile(options.input))
+        {
+            std::cerr << "Failed opening " << options.input << "\n";
+            return 1;
+        }
+
+        for (const auto& label : CubemapLabels)
+        {
+            auto* prop = cfg.findProperty(label);
+            if (!prop)
+            {
+                std::cerr << options.input << ": missing " << label << " face\n";
+                return 1;
+            }
+
+            auto& face = faces.emplace_back();
+            if (!loadSource(prop->getValue<std::string>(), true, face, sourceFormat))
+            {
+                return 1;
+            }
+
+            if (face.width != face.height
+                || face.width != faces[0].width)
+            {
+                std::cerr << "Cubemap faces must be square and of equal size\n";
+                return 1;
+            }
+        }
+    }
+    else
+    {
+        if (!loadSource(options.input, false, faces.emplace_back(), sourceFormat))
+        {
+            return 1;
+        }
+    }
+
+    if (options.format == cro::CompressedFormat::None)
+    {
+        switch (sourceFormat)
+        {
+        default:
+        case cro::ImageFormat::RGB:
+            options.format = cro::CompressedFormat::BC1;
+            break;
+        case cro::ImageFormat::RGBA:
+            options.format = cro::CompressedFormat::BC3;
+            break;
+        case cro::ImageFormat::A:
+            options.format = cro::CompressedFormat::BC4;
+            break;
+        }
+    }
+
+    const auto width = faces[0].width;
+    const auto height = faces[0].height;
+    std::uint32_t levelCount = 1;
+    if (options.mipmaps)
+    {
+        auto dim = std::max(width, height);
+        while (dim > 1)
+        {
+            dim /= 2;
+            levelCount++;
+        }
+    }
+
+    //DDS stores the full mip chain of each face in turn
+    auto output = createHeader(width, height, levelCount, cubemap, options.format);
+    for (const auto& face : faces)
+    {
+        SourceImage level = face;
+        for (auto i = 0u; i < levelCount; ++i)
+        {
+            if (i != 0)
+            {
+                level = level.createMip();
+            }
+
+            auto blocks = compressImage(level, options.format);
+            output.insert(output.end(), blocks.begin(), blocks.end());
+        }
+    }
+
+    //make sure the engine can actually read what we made
+    cro::CompressedImage validation;
+    if (!validation.loadFromMemory(output.data(), output.size()))
+    {
+        std::cerr << "Failed validating output\n";
+        return 1;
+    }
+
+    std::ofstream file(options.output, std::ios::binary);
+    if (!file.is_open() || !file.good())
+    {
+        std::cerr << "Failed opening " << options.output << " for writing\n";
+        return 1;
+    }
+    file.write(reinterpret_cast<const char*>(output.data()), output.size());
+
+    const std::size_t uncompressed = width * height * 4 * faces.size();
+    std::cout << "Wrote " << options.output << ": " << width << "x" << height
+        << ", " << levelCount << " level(s), " << faces.size() << " face(s), "
+        << output.size() << " bytes (" << uncompressed << " bytes uncompressed RGBA, base level only)\n";
+
+    return 0;
+}
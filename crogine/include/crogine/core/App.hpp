@@ -69,8 +69,19 @@ namespace cro
     {
     public:
         friend class Detail::SDLResource;
+        /*!
+        \brief Pass this as the window style flag to create an App which
+        has no window, OpenGL context, audio device or ImGui/Console.
+        run() then only executes the fixed update loop, calling simulate()
+        but never render(). Useful for dedicated servers and for running
+        simulations on machines without a GPU.
+        \see isHeadless()
+        */
+        static constexpr std::uint32_t Headless = 0x80000000;
+
         /*!
         \param windowStyleFlags Style flags with which to create the default window
+        or App::Headless to create the App without a window
         \see Window
         */
         explicit App(std::uint32_t windowStyleFlags = 0);
@@ -127,6 +138,14 @@ namespace cro
         */
         static bool isValid();
 
+        /*!
+        \brief Returns true if there is no valid instance of this class
+        or if the current instance was created with the Headless flag.
+        When this returns true there is no window or OpenGL context
+        available, and getWindow() must not be used.
+        */
+        static bool isHeadless();
+
     protected:
         
         virtual void handleEvent(const Event&) = 0;
@@ -191,8 +210,10 @@ namespace cro
         Colour m_clearColour;
         HiResTimer* m_frameClock;
         bool m_running;
+        bool m_headless;
 
         void handleEvents();
+        void runHeadless();
 
         MessageBus m_messageBus;
         void handleMessages();
@@ -1,6 +1,6 @@
 /*-----------------------------------------------------------------------
 
-Matt Marchant 2017 - 2021
+Matt Marchant 2017 - 2022
 http://trederia.blogspot.com
 
 crogine - Zlib license.
@@ -41,6 +41,8 @@ source distribution.
 #include <crogine/detail/glm/vec3.hpp>
 #include <crogine/detail/glm/vec4.hpp>
 
+#include <array>
+#include <cstdlib>
 #include <string>
 #include <vector>
 #include <sstream>
@@ -71,9 +73,14 @@ namespace cro
         void setParent(ConfigItem* parent);
         ConfigItem* getParent() const;
         void setName(const std::string& name);
+
+        //hash of the name, compared first when searching for items
+        std::size_t getNameHash() const { return m_nameHash; }
+
     private:
         ConfigItem* m_parent;
         std::string m_name;
+        std::size_t m_nameHash;
     };
     
     /*!
@@ -109,7 +116,12 @@ namespace cro
     private:
         std::string m_value;
         bool m_isStringValue;
-        std::vector<float> valueAsArray() const;
+
+        //numeric values are parsed once when the value is set
+        //rather than every time getValue() is called
+        std::array<float, 4u> m_floatValues = {};
+        void parseFloatValues();
+        const std::array<float, 4u>& valueAsArray() const { return m_floatValues; }
     };
 
 #include "ConfigFile.inl"
@@ -159,7 +171,7 @@ namespace cro
         a small scope as adding or removing any objects from the is likely to
         invalidate them.
         */
-        ConfigObject* findObjectWithName(const std::string& name)const;
+        ConfigObject* findObjectWithName(const std::string& name) const;
 
         /*!
         \brief Returns a reference to the vector of properties owned by this object
@@ -259,11 +271,10 @@ namespace cro
         std::vector<ConfigProperty> m_properties;
         std::vector<ConfigObject> m_objects;
 
-        static NameValue getObjectName(const std::string& line);
-        static NameValue getPropertyName(const std::string& line);
-        static bool isProperty(const std::string& line);
-        static void removeComment(std::string& line);
+        ConfigProperty* findProperty(const std::string& name, std::size_t hash) const;
+        ConfigObject* findObjectWithName(const std::string& name, std::size_t hash) const;
 
+        bool parse(char* begin, char* end, const std::string& path);
         bool parseAsJson(SDL_RWops*);
 
         std::size_t write(SDL_RWops* file, std::uint16_t depth = 0u);
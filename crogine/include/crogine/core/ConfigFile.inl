@@ -1,6 +1,6 @@
 /*-----------------------------------------------------------------------
 
-Matt Marchant 2017 - 2020
+Matt Marchant 2017 - 2022
 http://trederia.blogspot.com
 
 crogine - Zlib license.
@@ -48,28 +48,19 @@ inline cro::String ConfigProperty::getValue<cro::String>() const
 template <>
 inline std::int32_t ConfigProperty::getValue<std::int32_t>() const
 {
-    std::int32_t retVal;
-    std::istringstream is(m_value);
-    if (is >> retVal) return retVal;
-    return 0;
+    return static_cast<std::int32_t>(std::strtol(m_value.c_str(), nullptr, 10));
 }
 
 template <>
 inline std::uint32_t ConfigProperty::getValue<std::uint32_t>() const
 {
-    std::uint32_t retVal;
-    std::istringstream is(m_value);
-    if (is >> retVal) return retVal;
-    return 0;
+    return static_cast<std::uint32_t>(std::strtoul(m_value.c_str(), nullptr, 10));
 }
 
 template <>
 inline float ConfigProperty::getValue<float>() const
 {
-    float retVal;
-    std::istringstream is(m_value);
-    if (is >> retVal) return retVal;
-    return 0.f;
+    return m_floatValues[0];
 }
 
 template <>
@@ -81,7 +72,7 @@ inline bool ConfigProperty::getValue<bool>() const
 template <>
 inline glm::vec2 ConfigProperty::getValue<glm::vec2>() const
 {
-    auto values = valueAsArray();
+    const auto& values = valueAsArray();
     glm::vec2 retval(0.f); //loop allows for values to be the wrong size
     for (auto i = 0u; i < values.size() && i < 2; ++i)
     {
@@ -94,7 +85,7 @@ inline glm::vec2 ConfigProperty::getValue<glm::vec2>() const
 template <>
 inline glm::vec3 ConfigProperty::getValue<glm::vec3>() const
 {
-    auto values = valueAsArray();
+    const auto& values = valueAsArray();
     glm::vec3 retval(0.f);
     for (auto i = 0u; i < values.size() && i < 3; ++i)
     {
@@ -107,7 +98,7 @@ inline glm::vec3 ConfigProperty::getValue<glm::vec3>() const
 template <>
 inline glm::vec4 ConfigProperty::getValue<glm::vec4>() const
 {
-    auto values = valueAsArray();
+    const auto& values = valueAsArray();
     glm::vec4 retval(0.f);
     for (auto i = 0u; i < values.size() && i < 4; ++i)
     {
@@ -120,14 +111,14 @@ inline glm::vec4 ConfigProperty::getValue<glm::vec4>() const
 template <>
 inline FloatRect ConfigProperty::getValue<FloatRect>() const
 {
-    auto values = valueAsArray();
+    const auto& values = valueAsArray();
     return { values[0], values[1], values[2], values[3] };
 }
 
 template <>
 inline Colour ConfigProperty::getValue<Colour>() const
 {
-    auto values = valueAsArray();
+    const auto& values = valueAsArray();
     auto clamp = [](float v)
     {
         return std::max(0.f, std::min(1.f, v));
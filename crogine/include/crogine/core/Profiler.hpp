@@ -0,0 +1,170 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <crogine/Config.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace cro
+{
+    /*!
+    \brief Frame profiler.
+    Records nested CPU scopes from any thread, and GPU scopes measured with
+    timer queries on the render thread, keeping the last N frames in a ring
+    buffer. Captures can be exported with saveTrace() in the Chrome trace
+    event format, which can be opened in chrome://tracing or ui.perfetto.dev
+
+    Scopes are added with the macros below, which compile to nothing unless
+    CRO_PROFILING is defined (set CRO_ENABLE_PROFILING in CMake to build the
+    library with its own scopes enabled):
+    \begincode
+    void MySystem::process(float dt)
+    {
+        CRO_PROFILE_SCOPE("MySystem::process");
+        //...
+        {
+            CRO_PROFILE_GPU_SCOPE("Draw terrain");
+            //...
+        }
+    }
+    \endcode
+
+    Scope names are stored by pointer, so must have static storage duration,
+    such as string literals or the result of std::type_info::name().
+    GPU scopes are ignored on mobile platforms and in headless Apps, where
+    only CPU scopes are recorded.
+    */
+    class CRO_EXPORT_API Profiler final
+    {
+    public:
+        /*!
+        \brief Enables or disables recording at run time.
+        Enabled by default. When disabled, scopes compiled in with
+        CRO_PROFILING cost a single atomic load.
+        */
+        static void setEnabled(bool enabled);
+
+        /*!
+        \brief Returns true if recording is currently enabled
+        */
+        static bool isEnabled();
+
+        /*!
+        \brief Sets the number of frames kept in the capture buffer.
+        Older frames are discarded as new ones are recorded. Defaults to 120
+        */
+        static void setFrameCapacity(std::size_t frameCount);
+
+        /*!
+        \brief Returns the number of frames kept in the capture buffer
+        */
+        static std::size_t getFrameCapacity();
+
+        /*!
+        \brief Returns the index of the current frame
+        */
+        static std::uint64_t getFrameIndex();
+
+        /*!
+        \brief Sets the name with which the calling thread appears in
+        exported traces. Worker threads are named automatically.
+        \param name A string with static storage duration
+        */
+        static void setThreadName(const char* name);
+
+        /*!
+        \brief Writes the captured frames to the given path in the
+        Chrome trace event (JSON) format.
+        GPU scopes still waiting on their results are not included.
+        \returns true on success, else false
+        */
+        static bool saveTrace(const std::string& path);
+
+        /*!
+        \brief Discards all captured frames
+        */
+        static void clear();
+
+        /*!
+        \brief Records a CPU scope on the current thread for its lifetime
+        */
+        class CRO_EXPORT_API CpuScope final
+        {
+        public:
+            explicit CpuScope(const char* name);
+            ~CpuScope();
+
+            CpuScope(const CpuScope&) = delete;
+            CpuScope& operator = (const CpuScope&) = delete;
+
+        private:
+            const char* m_name;
+            std::int64_t m_start;
+        };
+
+        /*!
+        \brief Records a GPU scope with a pair of timestamp queries for its lifetime.
+        This must only be used on the thread which owns the OpenGL context. Results
+        are collected, without stalling, a few frames after they were recorded.
+        */
+        class CRO_EXPORT_API GpuScope final
+        {
+        public:
+            explicit GpuScope(const char* name);
+            ~GpuScope();
+
+            GpuScope(const GpuScope&) = delete;
+            GpuScope& operator = (const GpuScope&) = delete;
+
+        private:
+            const char* m_name;
+            std::uint32_t m_query;
+        };
+
+    private:
+        friend class App;
+        static void newFrame();
+        static void finalise();
+    };
+}
+
+#define CRO_PROFILE_CONCAT_IMPL(a, b) a##b
+#define CRO_PROFILE_CONCAT(a, b) CRO_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef CRO_PROFILING
+#define CRO_PROFILE_SCOPE(name) cro::Profiler::CpuScope CRO_PROFILE_CONCAT(croProfileScope, __LINE__)(name)
+#define CRO_PROFILE_GPU_SCOPE(name) cro::Profiler::GpuScope CRO_PROFILE_CONCAT(croProfileGpuScope, __LINE__)(name)
+#else
+#define CRO_PROFILE_SCOPE(name)
+#define CRO_PROFILE_GPU_SCOPE(name)
+#endif
@@ -29,13 +29,16 @@ source distribution.
 
 #pragma once
 
+#include <crogine/Config.hpp>
 #include <crogine/ecs/Entity.hpp>
 #include <crogine/graphics/BoundingBox.hpp>
+#include <crogine/graphics/Spatial.hpp>
 
 #include <vector>
 #include <limits>
 #include <cstdint>
 #include <array>
+#include <utility>
 
 namespace cro::Detail
 {
@@ -63,6 +66,17 @@ namespace cro::Detail
 
         //leaf == 0, else Null if free
         std::int32_t height = Null;
+
+        //copied from the owner so that queries needn't fetch components
+        std::uint64_t filterFlags = std::numeric_limits<std::uint64_t>::max();
+    };
+
+    //used to move many nodes at once with BalancedTree::moveNodes()
+    struct NodeUpdate final
+    {
+        std::int32_t treeID = TreeNode::Null; //updates with a Null ID are skipped
+        Box worldBounds;
+        glm::vec3 displacement = glm::vec3(0.f);
     };
 
     /*!
@@ -73,12 +87,12 @@ namespace cro::Detail
     (https://pybullet.org/wordpress/)
     */
 
-    class BalancedTree final
+    class CRO_EXPORT_API BalancedTree final
     {
     public:
         explicit BalancedTree(float unitsPerMetre);
 
-        std::int32_t addToTree(Entity, Box bounds);
+        std::int32_t addToTree(Entity, Box bounds, std::uint64_t filterFlags = std::numeric_limits<std::uint64_t>::max());
         void removeFromTree(std::int32_t);
 
         //moves a proxy with the specified treeID. If the entity
@@ -86,10 +100,58 @@ namespace cro::Detail
         //is removed from the tree and reinsterted.
         bool moveNode(std::int32_t, Box, glm::vec3);
 
+        enum class UpdateStrategy
+        {
+            Automatic, //picks one of the below depending on how many nodes moved
+            Reinsert, //each moved node is removed and reinserted as moveNode() does
+            Refit, //bounds are recalculated in place without changing the tree structure
+            Rebuild //the entire tree is rebuilt from its leaves
+        };
+
+        //applies many updates at once. Returns the number of nodes which
+        //moved outside of their fattened AABB. Refitting is cheaper than
+        //rebuilding but the tree becomes less efficient to query the more
+        //the refitted nodes have moved, so when refitting automatically the
+        //tree is rebuilt should the quality drop too far.
+        std::size_t moveNodes(const std::vector<NodeUpdate>&, UpdateStrategy = UpdateStrategy::Automatic);
+
+        //rebuilds the tree from its existing leaves with a surface area
+        //heuristic. The IDs of leaves are unchanged.
+        void rebuild();
+
+        //updates the flags against which query filters are tested
+        void setFilterFlags(std::int32_t, std::uint64_t);
+        std::uint64_t getFilterFlags(std::int32_t) const;
+
         std::int32_t getRoot() const { return m_root; }
 
         const std::vector<TreeNode>& getNodes() const { return m_nodes; }
 
+        //all queries append the entities of leaf nodes which have at least one
+        //flag in common with the filter to the destination, which is not cleared.
+
+        //leaves whose bounds intersect the given area
+        void query(const Box& area, std::uint64_t filter, std::vector<Entity>& dst) const;
+
+        //leaves whose bounds intersect the given sphere
+        void query(const Sphere& sphere, std::uint64_t filter, std::vector<Entity>& dst) const;
+
+        //leaves whose bounds are not entirely behind any of the frustum planes
+        void query(const Frustum& frustum, std::uint64_t filter, std::vector<Entity>& dst) const;
+
+        //leaves whose bounds are hit by the given ray within the given length.
+        //the direction is expected to be normalised
+        void queryRay(glm::vec3 origin, glm::vec3 direction, float length, std::uint64_t filter, std::vector<Entity>& dst) const;
+
+        //each pair of leaves with overlapping bounds, reported once
+        void queryPairs(std::uint64_t filter, std::vector<std::pair<Entity, Entity>>& dst) const;
+
+        //performs a query for each of the given areas, with the results
+        //for areas[n] placed in dst[n]. dst is resized to match areas and
+        //each result list is cleared first. Areas are tested in groups
+        //so that the tree is only traversed once per group.
+        void query(const std::vector<Box>& areas, std::uint64_t filter, std::vector<std::vector<Entity>>& dst) const;
+
     private:
         std::int32_t m_root;
 
@@ -103,7 +165,11 @@ namespace cro::Detail
 
         glm::vec3 m_fattenAmount;
 
+        float m_builtAreaRatio; //used to measure how much refitting has degraded the tree
+        std::vector<std::int32_t> m_movedIDs;
+
         Box getFatAABB(std::int32_t) const;
+        Box fatten(Box, glm::vec3 displacement) const;
         std::int32_t getMaxBalance() const;
         float getAreaRatio() const;
 
@@ -115,8 +181,22 @@ namespace cro::Detail
 
         std::int32_t balance(std::int32_t);
 
+        void refit();
+        void refit(std::int32_t);
+        struct BuildEntry final
+        {
+            glm::vec3 minBounds = glm::vec3(0.f);
+            glm::vec3 maxBounds = glm::vec3(0.f);
+            glm::vec3 centre = glm::vec3(0.f);
+            std::int32_t treeID = TreeNode::Null;
+        };
+        std::int32_t build(BuildEntry*, std::size_t, std::int32_t, std::int32_t);
+
         std::int32_t computeHeight() const;
         std::int32_t computeHeight(std::int32_t) const;
+
+        template <typename F>
+        void queryBatched(const std::vector<Box>&, std::uint64_t, F&&) const;
     };
 
     //fixed stack using preallocated memory
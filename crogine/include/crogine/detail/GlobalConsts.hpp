@@ -45,4 +45,11 @@ namespace cro
     //this is only a preferred amount and is dependent on MAX_VARYING_VECTORS
     //available on the current hardware
     static const std::int32_t MAX_PROJECTION_MAPS = 4;
+
+    namespace Detail
+    {
+        //used in place of the window size by cameras
+        //and scenes when there is no window (headless)
+        static const glm::vec2 HeadlessWindowSize(1920.f, 1080.f);
+    }
 }
\ No newline at end of file
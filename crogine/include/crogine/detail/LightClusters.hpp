@@ -0,0 +1,171 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <crogine/Config.hpp>
+
+#include <crogine/detail/glm/vec3.hpp>
+#include <crogine/detail/glm/mat4x4.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace cro::Detail
+{
+    /*!
+    \brief Assigns point and spot lights to view space clusters (froxels).
+    The camera frustum is divided into TileCountX * TileCountY screen tiles,
+    and SliceCount exponentially distributed depth slices. build() then
+    creates a list of light indices for each cluster which can be uploaded
+    to the GPU so that shaders only evaluate the lights which may affect
+    a fragment.
+
+    This is pure CPU work with no graphics dependencies, so it is available
+    to headless builds. The output depends only on the input, and is the
+    same regardless of how many threads the job is spread over.
+    */
+    class CRO_EXPORT_API LightClusters final
+    {
+    public:
+        static constexpr std::uint32_t TileCountX = 16;
+        static constexpr std::uint32_t TileCountY = 9;
+        static constexpr std::uint32_t SliceCount = 24;
+        static constexpr std::uint32_t TilesPerSlice = TileCountX * TileCountY;
+        static constexpr std::uint32_t ClusterCount = TilesPerSlice * SliceCount;
+
+        /*!
+        \brief Clusters which are touched by more than this many lights keep
+        only the lights with the lowest indices.
+        */
+        static constexpr std::uint32_t MaxLightsPerCluster = 128;
+
+        /*!
+        \brief Light data in view space
+        */
+        struct Light final
+        {
+            glm::vec3 position = glm::vec3(0.f);
+            float radius = 1.f;
+            glm::vec3 direction = glm::vec3(0.f, 0.f, -1.f); //!< normalised, spot lights only
+            float cosOuter = -1.f; //!< cosine of the outer cone angle, -1 for point lights
+        };
+
+        /*!
+        \brief Offset into the index array and number of lights for a cluster
+        */
+        struct Cluster final
+        {
+            std::uint32_t offset = 0;
+            std::uint32_t count = 0;
+        };
+
+        LightClusters();
+
+        /*!
+        \brief Sets the camera projection from which the cluster bounds are created.
+        This only needs to be called when the projection changes. Both perspective
+        and orthographic projections are supported.
+        \param projection The camera's projection matrix
+        \param nearPlane Distance to the camera's near plane
+        \param farPlane Distance to the camera's far plane
+        */
+        void setProjection(const glm::mat4& projection, float nearPlane, float farPlane);
+
+        /*!
+        \brief Assigns the given lights to clusters.
+        Light indices written to the cluster lists are the indices into the given vector.
+        */
+        void build(const std::vector<Light>& lights);
+
+        /*!
+        \brief Returns the index of the cluster containing the given view space
+        position, or ClusterCount if the position is outside the view.
+        This mirrors the look up performed in the shader.
+        */
+        std::uint32_t getClusterIndex(glm::vec3 viewPosition) const;
+
+        /*!
+        \brief Returns the cluster array, ordered by tile X, then tile Y, then slice.
+        */
+        const std::vector<Cluster>& getClusters() const { return m_clusters; }
+
+        /*!
+        \brief Returns the light indices referenced by the clusters
+        */
+        const std::vector<std::uint32_t>& getIndices() const { return m_indices; }
+
+        /*!
+        \brief Returns the scale and bias which convert log(view depth) to
+        a slice index: slice = log(depth) * scale + bias
+        */
+        float getSliceScale() const { return m_sliceScale; }
+        float getSliceBias() const { return m_sliceBias; }
+
+    private:
+
+        glm::mat4 m_projection;
+        float m_nearPlane;
+        float m_farPlane;
+        float m_sliceScale;
+        float m_sliceBias;
+        std::array<float, SliceCount + 1> m_sliceDepths;
+
+        struct Bounds final
+        {
+            glm::vec3 min = glm::vec3(0.f);
+            glm::vec3 max = glm::vec3(0.f);
+            glm::vec3 centre = glm::vec3(0.f);
+            float radius = 0.f;
+        };
+        std::vector<Bounds> m_bounds;
+
+        //inclusive cluster ranges covered by each light
+        struct LightRange final
+        {
+            std::uint16_t minX = 0, maxX = 0;
+            std::uint16_t minY = 0, maxY = 0;
+            std::uint16_t minZ = 1, maxZ = 0; //empty by default
+        };
+        std::vector<LightRange> m_lightRanges;
+
+        //per slice scratch space so slices can be built in parallel
+        std::vector<std::uint32_t> m_sliceIndices;
+        std::vector<std::uint32_t> m_sliceCounts;
+
+        std::vector<Cluster> m_clusters;
+        std::vector<std::uint32_t> m_indices;
+
+        float getSlice(float depth) const;
+        LightRange getLightRange(const Light&) const;
+        bool getTileRange(const Light&, float minDepth, float maxDepth, LightRange&) const;
+    };
+}
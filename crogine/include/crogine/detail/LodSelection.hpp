@@ -0,0 +1,72 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+
+#pragma once
+
+#include <crogine/Config.hpp>
+
+#include <crogine/detail/glm/mat4x4.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace cro::Detail
+{
+    /*!
+    \brief Proportion of a LOD threshold by which the screen size must pass
+    it before the level changes, so that models near a threshold don't pop
+    back and forth between levels every frame.
+    */
+    constexpr float DefaultLodHysteresis = 0.1f;
+
+    /*!
+    \brief Returns the projected diameter of a bounding sphere as a proportion
+    of the viewport height, where 1 fills the height of the view.
+    \param projection The camera's projection matrix. Both perspective and
+    orthographic projections are supported.
+    \param radius World space radius of the sphere
+    \param distance Distance from the camera to the centre of the sphere
+    */
+    float CRO_EXPORT_API getLodScreenSize(const glm::mat4& projection, float radius, float distance);
+
+    /*!
+    \brief Selects a level of detail for a model.
+    \param screenSizes The screen size below which each level is used, starting
+    with level 1 as level 0 is the full detail mesh. These must be in descending order.
+    \param screenSize Current screen size of the model, as returned by getLodScreenSize()
+    \param currentLevel The level selected for the model last time. The level only
+    changes once the screen size is further past a threshold than the hysteresis allows
+    \param hysteresis Proportion of each threshold used to delay changing level
+    \returns The selected level, where 0 is full detail
+    */
+    std::size_t CRO_EXPORT_API selectLod(const std::vector<float>& screenSizes, float screenSize,
+        std::size_t currentLevel, float hysteresis = DefaultLodHysteresis);
+}
@@ -0,0 +1,177 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+
+#pragma once
+
+#include <crogine/Config.hpp>
+#include <crogine/graphics/BoundingBox.hpp>
+
+#include <crogine/detail/glm/vec3.hpp>
+#include <crogine/detail/glm/vec4.hpp>
+#include <crogine/detail/glm/mat4x4.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace cro::Detail
+{
+    /*!
+    \brief Software depth buffer used for occlusion culling.
+    Occluder triangles are rasterised on the CPU into a low resolution
+    depth buffer. The buffer is divided into tiles which are rasterised
+    in parallel, using SSE where available. A hierarchy of min/max depth
+    levels is then built from the result, against which the screen space
+    bounds of potentially visible objects can be tested.
+
+    The test is conservative: an object is only reported as hidden if its
+    nearest point is further away than the occluders covering its whole
+    screen space rectangle. This has no graphics dependencies so it is
+    available to headless builds.
+
+    Usage per camera, per frame:
+    \begincode
+    buffer.begin(viewProjectionMatrix);
+    for (auto& occluder : occluders)
+    {
+        buffer.addOccluder(occluder.vertices, occluder.indices, worldTransform);
+    }
+    buffer.rasterise();
+
+    bool visible = buffer.isVisible(worldBoundingBox);
+    \endcode
+    */
+    class CRO_EXPORT_API OcclusionBuffer final
+    {
+    public:
+        static constexpr std::uint32_t TileWidth = 32;
+        static constexpr std::uint32_t TileHeight = 16;
+
+        /*!
+        \brief Constructor.
+        \param width Width of the depth buffer in pixels
+        \param height Height of the depth buffer in pixels
+        \see setSize()
+        */
+        explicit OcclusionBuffer(std::uint32_t width = 256, std::uint32_t height = 144);
+
+        /*!
+        \brief Sets the resolution of the depth buffer.
+        Sizes are rounded up to a whole number of tiles. Higher resolutions
+        cull small gaps more accurately at the cost of rasterisation time.
+        */
+        void setSize(std::uint32_t width, std::uint32_t height);
+
+        /*!
+        \brief Clears any existing occluders and starts a new buffer
+        for the given view-projection matrix.
+        */
+        void begin(const glm::mat4& viewProjection);
+
+        /*!
+        \brief Adds an occluder mesh to the buffer.
+        \param vertices Vertex positions in model space
+        \param indices Triangle list indices into the vertex array
+        \param worldTransform Transform to apply to the vertices
+        Triangles are not back face culled, and those outside the view
+        are rejected before rasterisation.
+        */
+        void addOccluder(const std::vector<glm::vec3>& vertices, const std::vector<std::uint32_t>& indices, const glm::mat4& worldTransform);
+
+        /*!
+        \brief Rasterises all added occluders and builds the depth hierarchy.
+        This must be called after adding occluders, and before testing
+        bounds with isVisible().
+        */
+        void rasterise();
+
+        /*!
+        \brief Returns false if the given world space bounding box is
+        completely hidden by the occluders in the buffer.
+        Boxes crossing the near plane, or lying outside the view, are
+        always reported as visible, as they should be culled by the
+        camera frustum.
+        */
+        bool isVisible(const Box& worldBounds) const;
+
+        /*!
+        \brief Returns the full resolution depth buffer, in the range 0 - 1,
+        with the bottom row first. Useful for debugging.
+        */
+        const std::vector<float>& getDepthBuffer() const { return m_levels[0].maxDepth; }
+
+        std::uint32_t getWidth() const { return m_width; }
+        std::uint32_t getHeight() const { return m_height; }
+
+        /*!
+        \brief Returns the number of triangles rasterised by the last
+        call to rasterise(), after clipping.
+        */
+        std::size_t getTriangleCount() const { return m_triangles.size(); }
+
+    private:
+        std::uint32_t m_width;
+        std::uint32_t m_height;
+        std::uint32_t m_tileCountX;
+        std::uint32_t m_tileCountY;
+
+        glm::mat4 m_viewProjection;
+
+        //edge and depth equations of a triangle, evaluated at pixel centres
+        struct Triangle final
+        {
+            glm::vec3 edges[3] = {};
+            glm::vec3 depth = glm::vec3(0.f);
+            std::int32_t minX = 0;
+            std::int32_t minY = 0;
+            std::int32_t maxX = 0;
+            std::int32_t maxY = 0;
+        };
+        std::vector<Triangle> m_triangles;
+        std::vector<glm::vec4> m_clipVertices;
+        std::vector<std::vector<std::uint32_t>> m_tileBins;
+
+        //level 0 is the depth buffer, which only uses maxDepth
+        struct Level final
+        {
+            std::uint32_t width = 0;
+            std::uint32_t height = 0;
+            std::vector<float> minDepth;
+            std::vector<float> maxDepth;
+        };
+        std::vector<Level> m_levels;
+
+        void addTriangle(const glm::vec4&, const glm::vec4&, const glm::vec4&);
+        void rasteriseTile(std::uint32_t);
+        void buildLevel(std::size_t);
+        bool testTexel(std::size_t level, std::int32_t x, std::int32_t y, float depth,
+            std::int32_t minX, std::int32_t minY, std::int32_t maxX, std::int32_t maxY) const;
+    };
+}
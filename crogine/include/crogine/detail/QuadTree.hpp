@@ -29,31 +29,41 @@ source distribution.
 
 #pragma once
 
+#include <crogine/Config.hpp>
 #include <crogine/ecs/Entity.hpp>
 #include <crogine/graphics/Rectangle.hpp>
 
-#include <memory>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 namespace cro::Detail
 {
     /*
-    Quad tree implementation based on this article
+    Loose quad tree implementation based on this article
     https://pvigier.github.io/2019/08/04/quadtree-collision-detection.html
+    with the node and member storage kept in contiguous pools, linked
+    by index rather than by pointer.
     
     Quad trees are by their nature 2 dimensional, and work best with
     mostly static geometry. This implementation is designed to be used
     with enities in a Scene which make up a menu or UI for example,
     where the members are mostly static and can be quickly culled when
-    rendering. For more dynamic scenes consider using the DynamicTreeSystem.
+    rendering. The bounds of each cell are loose - that is twice the
+    size of the area the cell covers - so members which move a small
+    distance can usually be updated without being reinserted. For more
+    dynamic scenes consider using the DynamicTreeSystem.
     \see DynamicTreeSystem
     */
 
-    class QuadTree final
+    class CRO_EXPORT_API QuadTree final
     {
     public:
         /*!
         \brief Constructor
-        \param rootArea The maximum area this QuadTree will cover.
+        \param rootArea The area this QuadTree will cover. Members outside
+        of this area are still added to the tree, but are always tested
+        when querying the tree.
         */
         explicit QuadTree(FloatRect rootArea);
 
@@ -67,15 +77,52 @@ namespace cro::Detail
         void add(Entity member);
 
         /*!
-        \brief Remove a member entity from the quad tree
-        This needs to be done if an entity is deleted, or
-        of an entity is moved, so that it can be reinserted
-        in the correct place. Highly dynamic entities should
-        consider using a BalancedTree or the DynamicTreeSystem
+        \brief Add an entity to the quad tree with the given bounds.
+        Entities added this way require no components, but must be
+        updated with update(Entity, FloatRect)
+        \param member Entity to add to the tree
+        \param bounds AABB of the entity in world coordinates
+        */
+        void add(Entity member, FloatRect bounds);
+
+        /*!
+        \brief Remove a member entity from the quad tree.
+        This needs to be done if an entity is deleted. Removing
+        an entity which is not in the tree does nothing.
         \param member Entity to remove from the tree
         */
         void remove(Entity member);
 
+        /*!
+        \brief Updates the position of the given entity in the
+        tree by recalculating its AABB from its Drawable2D and
+        Transform components. This should be called when the
+        entity moves or the size of the Drawable2D changes.
+        \param member Entity to update
+        \returns true if the entity had to be reinserted into
+        the tree, or false if the change was small enough that
+        it remained in place
+        */
+        bool update(Entity member);
+
+        /*!
+        \brief Updates the position of the given entity in the
+        tree using the given AABB.
+        \see update(Entity)
+        */
+        bool update(Entity member, FloatRect bounds);
+
+        /*!
+        \brief Returns true if the given entity is currently
+        a member of the tree
+        */
+        bool contains(Entity member) const;
+
+        /*!
+        \brief Removes all members from the tree
+        */
+        void clear();
+
         /*!
         \brief Query the tree for potential colliders or
         renderables which appear within the given FloatRect
@@ -87,6 +134,16 @@ namespace cro::Detail
         */
         std::vector<Entity> query(FloatRect area) const;
 
+        /*!
+        \brief Query the tree for potential colliders or renderables
+        which appear within the given FloatRect.
+        \param area Area to query within the tree, in world coords
+        \param dst Vector to which the results are appended. This is
+        not cleared first, so reusing it between queries prevents
+        allocating memory for each query.
+        */
+        void query(FloatRect area, std::vector<Entity>& dst) const;
+
         /*!
         \brief Returns a vector of pairs of entities whose
         AABBs intersect.
@@ -94,31 +151,69 @@ namespace cro::Detail
         */
         std::vector<std::pair<Entity, Entity>> getIntersecting() const;
 
+        /*!
+        \brief Appends pairs of entities whose AABBs intersect to
+        the given vector. Each pair is reported once.
+        */
+        void getIntersecting(std::vector<std::pair<Entity, Entity>>& dst) const;
+
+        /*!
+        \brief Returns the number of members in the tree
+        */
+        std::size_t size() const { return m_memberCount; }
+
     private:
         static constexpr std::size_t MaxDepth = 8;
         static constexpr std::size_t Threshold = 16;
+        static constexpr std::int32_t Null = -1;
 
         FloatRect m_rootArea;
+
         struct Node final
         {
-            std::array<std::unique_ptr<Node>, 4u> children;
-            std::vector<Entity> members;
+            FloatRect area; //of the cell, members may extend outside this by half its size
+            std::int32_t parent = Null;
+            std::int32_t firstChild = Null; //the 4 children are consecutive in the pool
+            std::int32_t firstMember = Null;
+            std::int32_t memberCount = 0;
+            std::int32_t depth = 0;
+        };
+        std::vector<Node> m_nodes;
+        std::int32_t m_freeNodes; //first of a free block of 4 nodes
+
+        struct Member final
+        {
+            FloatRect bounds;
+            Entity entity;
+            std::int32_t node = Null;
+            std::int32_t prev = Null;
+            std::int32_t next = Null; //also used to link the free list
         };
-        std::unique_ptr<Node> m_rootNode;
+        std::vector<Member> m_members;
+        std::int32_t m_freeMembers;
+        std::size_t m_memberCount;
+        std::size_t m_linkCount; //since the pool was last compacted
 
-        bool isLeaf(const Node*) const;
+        //indexed by entity index
+        std::vector<std::int32_t> m_memberIDs;
+
+        bool isLeaf(const Node&) const;
         FloatRect calcBox(FloatRect, std::int32_t dir) const;
-        std::int32_t getQuadrant(FloatRect nodeBounds, FloatRect entBounds) const;
-        void add(Node* target, std::size_t depth, FloatRect aabb, Entity member);
-        void split(Node*, FloatRect bounds);
-        bool removeFromNode(Node*, FloatRect bounds, Entity member);
-        void removeMember(Node*, Entity);
-        bool tryMerge(Node*);
-        void query(Node*, FloatRect bounds, FloatRect queryBounds, std::vector<Entity>& dst) const;
-        void findIntersections(Node*, std::vector<std::pair<Entity, Entity>>& dst) const;
-        void findChildIntersections(Node*, Entity parent, std::vector<std::pair<Entity, Entity>>& dst) const;
+        FloatRect getLooseArea(const Node&) const;
+        std::int32_t findChild(std::int32_t node, FloatRect bounds) const;
+
+        void addBranch(std::int32_t node, std::vector<Entity>& dst) const;
+        void insert(std::int32_t member, std::int32_t node);
+        void link(std::int32_t member, std::int32_t node);
+        void unlink(std::int32_t member);
+        void split(std::int32_t node);
+        void tryMerge(std::int32_t node);
+        void compact();
 
+        std::int32_t allocateNodes();
+        std::int32_t allocateMember();
 
+        std::int32_t getMemberID(Entity) const;
         FloatRect getAABB(cro::Entity entity) const;
     };
 }
\ No newline at end of file
@@ -0,0 +1,220 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <crogine/Config.hpp>
+
+#include <crogine/detail/glm/vec2.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace cro::Detail
+{
+    /*!
+    \brief Describes the render target required by a transient resource
+    in a RenderGraph. Two transient targets may only share the same
+    physical target if their descriptions are equal.
+    */
+    struct CRO_EXPORT_API RenderTargetDesc final
+    {
+        glm::uvec2 size = glm::uvec2(0u);
+        bool depthBuffer = false;
+        bool stencilBuffer = false;
+
+        bool operator == (const RenderTargetDesc& other) const
+        {
+            return size == other.size
+                && depthBuffer == other.depthBuffer
+                && stencilBuffer == other.stencilBuffer;
+        }
+
+        bool operator != (const RenderTargetDesc& other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    /*!
+    \brief Schedules a set of render passes and the targets they use.
+    Passes declare the targets they read from and write to, from which
+    compile() determines the order in which to execute the passes, culls
+    any passes which don't contribute to the output, and assigns transient
+    targets to a minimal set of physical targets by allowing targets whose
+    lifetimes don't overlap to share the same one.
+
+    The graph itself only makes these decisions - it doesn't own any GPU
+    resources. The owner is expected to create a render target for each of
+    getPhysicalTargets() and to look them up with getPhysicalIndex() when
+    executing the passes returned by getExecutionOrder().
+    */
+    class CRO_EXPORT_API RenderGraph final
+    {
+    public:
+        static constexpr std::size_t Invalid = std::numeric_limits<std::size_t>::max();
+
+        RenderGraph();
+
+        /*!
+        \brief Adds a target which is owned outside the graph, such as
+        the scene buffer or the active render target.
+        Imported targets are never aliased and may be read without being
+        written by any pass.
+        \returns ID of the target
+        */
+        std::size_t addImportedTarget(const std::string& name);
+
+        /*!
+        \brief Adds a target which only needs to exist while the passes
+        using it are executed. These may share physical targets with others.
+        \returns ID of the target
+        */
+        std::size_t addTransientTarget(const std::string& name, const RenderTargetDesc& desc);
+
+        /*!
+        \brief Adds a pass to the graph.
+        \param name Name of the pass, used in error messages
+        \param reads IDs of targets read by the pass. These must be imported
+        or be written by another pass.
+        \param writes IDs of targets written by the pass. Each target may be
+        written by only one pass. A transient target which is written but not
+        read by any other pass is considered local to the pass, for example
+        an intermediate buffer used between two draw calls.
+        \returns ID of the pass
+        */
+        std::size_t addPass(const std::string& name, const std::vector<std::size_t>& reads, const std::vector<std::size_t>& writes);
+
+        /*!
+        \brief Sets the target which the graph ultimately renders to.
+        Only passes which contribute to this target are executed.
+        */
+        void setOutput(std::size_t target);
+
+        /*!
+        \brief Compiles the graph.
+        \returns false if the graph is invalid, for example if it contains
+        a cycle, a target is written by more than one pass, or the output is
+        never written.
+        */
+        bool compile();
+
+        /*!
+        \brief Returns true if the graph was successfully compiled since
+        it was last modified
+        */
+        bool compiled() const { return m_compiled; }
+
+        /*!
+        \brief Returns the IDs of the passes which need to be executed,
+        in the order in which they should be executed.
+        */
+        const std::vector<std::size_t>& getExecutionOrder() const { return m_executionOrder; }
+
+        /*!
+        \brief Returns true if the given pass was culled because it doesn't
+        contribute to the output
+        */
+        bool isCulled(std::size_t pass) const;
+
+        /*!
+        \brief Returns the index into getPhysicalTargets() assigned to the
+        given transient target, or Invalid if the target is imported or unused.
+        */
+        std::size_t getPhysicalIndex(std::size_t target) const;
+
+        /*!
+        \brief Returns the description of each physical target required to
+        execute the compiled graph.
+        */
+        const std::vector<RenderTargetDesc>& getPhysicalTargets() const { return m_physicalTargets; }
+
+        /*!
+        \brief Returns the reads of the given pass
+        */
+        const std::vector<std::size_t>& getReads(std::size_t pass) const;
+
+        /*!
+        \brief Returns the writes of the given pass
+        */
+        const std::vector<std::size_t>& getWrites(std::size_t pass) const;
+
+        /*!
+        \brief Returns the number of passes added to the graph
+        */
+        std::size_t getPassCount() const { return m_passes.size(); }
+
+        /*!
+        \brief Returns the number of targets added to the graph
+        */
+        std::size_t getTargetCount() const { return m_targets.size(); }
+
+        /*!
+        \brief Removes all passes and targets
+        */
+        void clear();
+
+    private:
+        struct Target final
+        {
+            std::string name;
+            RenderTargetDesc desc;
+            bool imported = false;
+            std::size_t writer = Invalid;
+            std::size_t physicalIndex = Invalid;
+
+            //positions in the execution order
+            std::size_t firstUse = Invalid;
+            std::size_t lastUse = 0;
+        };
+        std::vector<Target> m_targets;
+
+        struct Pass final
+        {
+            std::string name;
+            std::vector<std::size_t> reads;
+            std::vector<std::size_t> writes;
+            bool culled = true;
+        };
+        std::vector<Pass> m_passes;
+
+        std::size_t m_output;
+        bool m_compiled;
+
+        std::vector<std::size_t> m_executionOrder;
+        std::vector<RenderTargetDesc> m_physicalTargets;
+
+        bool resolveWriters();
+        void cullPasses();
+        bool sortPasses();
+        void assignPhysicalTargets();
+    };
+}
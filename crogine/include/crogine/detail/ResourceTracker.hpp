@@ -0,0 +1,146 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <crogine/Config.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace cro
+{
+    /*!
+    \brief Memory usage counters returned by resource holders
+    such as TextureResource, MeshResource and ShaderResource.
+    Byte counts are estimates of the GPU memory used.
+    */
+    struct CRO_EXPORT_API ResourceStats final
+    {
+        std::size_t resourceCount = 0; //!< Number of resources currently loaded
+        std::size_t bytesUsed = 0; //!< Estimated number of bytes used by loaded resources
+        std::size_t budget = 0; //!< Current memory budget in bytes, 0 if unlimited
+        std::size_t evictionCount = 0; //!< Number of resources evicted since creation
+    };
+
+    namespace Detail
+    {
+        /*!
+        \brief Tracks the reference count, size and last use of resources
+        stored in a resource holder, and decides which resources should
+        be evicted when the memory budget is exceeded.
+        Resources start with a reference count of 1 when they are added,
+        so that resources which are never released are never evicted.
+        Only resources with a reference count of 0 are evicted, least
+        recently used first.
+        */
+        class CRO_EXPORT_API ResourceTracker final
+        {
+        public:
+            ResourceTracker();
+
+            /*!
+            \brief Starts tracking the resource with the given ID
+            \param id Resource ID
+            \param byteSize Estimated size of the resource in bytes
+            */
+            void add(std::size_t id, std::size_t byteSize);
+
+            /*!
+            \brief Stops tracking the resource with the given ID
+            */
+            void remove(std::size_t id);
+
+            /*!
+            \brief Updates the estimated size of a tracked resource
+            */
+            void setByteSize(std::size_t id, std::size_t byteSize);
+
+            /*!
+            \brief Marks the given resource as most recently used
+            */
+            void touch(std::size_t id);
+
+            /*!
+            \brief Increments the reference count of the given resource
+            \returns false if the resource is not tracked
+            */
+            bool acquire(std::size_t id);
+
+            /*!
+            \brief Decrements the reference count of the given resource
+            \returns false if the resource is not tracked or already has
+            a reference count of 0
+            */
+            bool release(std::size_t id);
+
+            /*!
+            \brief Returns the reference count of the given resource
+            or -1 if the resource is not tracked
+            */
+            std::int32_t getRefCount(std::size_t id) const;
+
+            /*!
+            \brief Sets the memory budget in bytes. 0 (the default) is unlimited
+            */
+            void setBudget(std::size_t bytes) { m_budget = bytes; }
+
+            /*!
+            \brief Returns the IDs of the resources which should be destroyed
+            to bring the memory use back within budget.
+            The returned resources are no longer tracked.
+            */
+            std::vector<std::size_t> collect();
+
+            /*!
+            \brief Stops tracking all resources.
+            The eviction count is preserved.
+            */
+            void clear();
+
+            ResourceStats getStats() const;
+
+        private:
+            struct Entry final
+            {
+                std::size_t byteSize = 0;
+                std::int32_t refCount = 1;
+                std::uint64_t lastUsed = 0;
+            };
+            std::unordered_map<std::size_t, Entry> m_entries;
+
+            std::uint64_t m_clock;
+            std::size_t m_bytesUsed;
+            std::size_t m_budget;
+            std::size_t m_evictionCount;
+        };
+    }
+}
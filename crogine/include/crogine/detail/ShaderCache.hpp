@@ -0,0 +1,128 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace cro::Detail
+{
+    /*
+    Stores linked shader program binaries on disk so that they can be
+    loaded on subsequent runs instead of being compiled again. Nothing
+    in here touches OpenGL - the binaries are retrieved from and uploaded
+    to the driver by ShaderResource. Binaries are only valid for the
+    driver which created them, so the driver string is part of the key
+    along with the shader source and defines.
+    */
+    class ShaderCache final
+    {
+    public:
+        ShaderCache();
+
+        /*!
+        \brief Sets the directory in which to store binaries, creating
+        it if it doesn't exist. An empty string disables the cache.
+        \returns false if the directory couldn't be created, in which
+        case the cache is disabled.
+        */
+        bool setDirectory(const std::string& path);
+        const std::string& getDirectory() const { return m_directory; }
+
+        bool isEnabled() const { return !m_directory.empty(); }
+
+        /*!
+        \brief Sets the string identifying the driver, eg the
+        vendor, renderer and version strings reported by OpenGL
+        */
+        void setDriverString(const std::string&);
+
+        /*!
+        \brief Creates a key from the given source strings and the
+        current driver string. nullptr may be passed for unused stages.
+        */
+        std::uint64_t getKey(std::initializer_list<const char*> sources) const;
+
+        /*!
+        \brief Returns the path of the file storing the binary with the given key
+        */
+        std::string getPath(std::uint64_t key) const;
+
+        /*!
+        \brief Reads the binary with the given key if it exists.
+        \param format Filled with the driver specific format of the binary
+        \param dst Filled with the binary data
+        \returns false if the binary doesn't exist or is invalid
+        */
+        bool read(std::uint64_t key, std::uint32_t& format, std::vector<std::uint8_t>& dst) const;
+
+        /*!
+        \brief Writes the given binary to the cache
+        */
+        bool write(std::uint64_t key, std::uint32_t format, const std::vector<std::uint8_t>& data) const;
+
+        //FNV-1a
+        static std::uint64_t hash(const void* data, std::size_t size, std::uint64_t seed = 0xcbf29ce484222325);
+
+    private:
+        std::string m_directory;
+        std::uint64_t m_driverHash;
+    };
+
+    /*
+    List of built in shader IDs, as returned by ShaderResource::loadBuiltIn(),
+    which can be saved once the application has loaded them all and used to
+    precompile them next time the application is run.
+    */
+    class ShaderManifest final
+    {
+    public:
+        //adds an ID if it doesn't already exist
+        void add(std::int32_t id);
+
+        //IDs are kept in ascending order
+        const std::vector<std::int32_t>& getIDs() const { return m_ids; }
+
+        void clear() { m_ids.clear(); }
+
+        //one hexadecimal ID per line. Empty lines and lines starting with # are skipped
+        std::string serialise() const;
+        bool deserialise(const std::string&);
+
+        bool loadFromFile(const std::string& path);
+        bool saveToFile(const std::string& path) const;
+
+    private:
+        std::vector<std::int32_t> m_ids;
+    };
+}
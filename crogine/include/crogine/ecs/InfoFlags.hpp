@@ -39,4 +39,14 @@ namespace cro
 
 	static constexpr std::uint32_t INFO_FLAG_SYSTEMS_ACTIVE = 0x1; //<! displays a window that prints active systems in the Scene
 	static constexpr std::uint32_t INFO_FLAG_SYSTEM_TIME    = 0x2; //<! displays a window containing timing information about System updates
+
+	/*!
+	\brief May be OR'd with the above when constructing a cro::Scene.
+	Headless scenes create no window dependent or OpenGL resources:
+	the skybox, post processes and rendering are disabled, and systems
+	skip any GPU uploads. Scenes are automatically headless when there
+	is no App, or the App was created with App::Headless.
+	\see Scene::isHeadless()
+	*/
+	static constexpr std::uint32_t SCENE_FLAG_HEADLESS      = 0x100;
 }
\ No newline at end of file
@@ -39,6 +39,7 @@ namespace cro
 {
     class Entity;
     class RenderTarget;
+    class VisibilitySystem;
     /*!
     \brief Renderable interface for systems which draw parts of the scene.
     Systems which implement this will be drawn by any scene to which they are added,
@@ -69,6 +70,19 @@ namespace cro
         */
         virtual void updateDrawList(Entity camera) = 0;
 
+        /*!
+        \brief Optionally adds culling volumes for the given camera to the Scene's
+        shared visibility pass.
+        This is called once per frame for each active Camera, after all Cameras
+        have been updated and before updateDrawList(), so that every volume can be
+        tested in a single sweep over the Scene's models. The results can then be
+        read in updateDrawList() with VisibilitySystem::getCameraVisibility().
+        The Camera's final and reflection passes are always included, so this only
+        needs implementing for extra volumes, such as shadow map cascades.
+        \see VisibilitySystem::addVolume()
+        */
+        virtual void updateVisibility(Entity /*camera*/, VisibilitySystem&) {}
+
         /*!
         \brief Renders this system.
         \param camera Entity containing a camera and transform component, automatically
@@ -33,6 +33,7 @@ source distribution.
 #include <crogine/core/App.hpp>
 #include <crogine/ecs/Entity.hpp>
 #include <crogine/ecs/System.hpp>
+#include <crogine/ecs/InfoFlags.hpp>
 #include <crogine/ecs/systems/CommandSystem.hpp>
 #include <crogine/ecs/Director.hpp>
 #include <crogine/ecs/Sunlight.hpp>
@@ -42,6 +43,7 @@ source distribution.
 #include <crogine/graphics/MaterialData.hpp>
 #include <crogine/graphics/RenderTexture.hpp>
 #include <crogine/graphics/postprocess/PostProcess.hpp>
+#include <crogine/detail/RenderGraph.hpp>
 
 #include <crogine/detail/glm/mat4x4.hpp>
 #include <crogine/detail/glm/gtx/quaternion.hpp>
@@ -52,6 +54,7 @@ namespace cro
 {
     class MessageBus;
     class Renderable;
+    class VisibilitySystem;
     class EnvironmentMap;
 
     /*!
@@ -79,7 +82,8 @@ namespace cro
         Debug builds will print a message to the console when a pool resizes, which can help decide
         what this initial value will be.
         \param infoFlags A bitwise value made from combining INFO_FLAG values by OR'ing
-        them together. \see InfoFlags.hpp
+        them together. Include SCENE_FLAG_HEADLESS to create a Scene which uses no
+        window or OpenGL resources, eg when running on a server. \see InfoFlags.hpp
         */
         explicit Scene(MessageBus& messageBus, std::size_t initialPoolSize = 128, std::uint32_t infoFlags = 0);
 
@@ -170,6 +174,13 @@ namespace cro
         template <typename T, typename... Args>
         T& addPostProcess(Args&&... args);
 
+        /*!
+        \brief Returns true if this Scene was created with SCENE_FLAG_HEADLESS
+        or there is no window available. Headless scenes never render, and
+        systems should skip any GPU work when this returns true.
+        */
+        bool isHeadless() const { return m_headless; }
+
         /*!
         \brief Enables or disables any added post processes added to the scene
         */
@@ -361,6 +372,23 @@ namespace cro
         */
         void updateDrawLists(Entity);
 
+        /*!
+        \brief Updates the Scene's shared visibility results for the given
+        list of Cameras. This is called automatically by the CameraSystem
+        once all active Cameras have been updated, and before their draw
+        lists are updated.
+        \see VisibilitySystem
+        */
+        void updateVisibility(const std::vector<Entity>& cameras);
+
+        /*!
+        \brief Returns a reference to the Scene's VisibilitySystem
+        which is used by Renderables to read the results of the
+        most recent visibility sweep.
+        */
+        VisibilitySystem& getVisibilitySystem() { return *m_visibilitySystem; }
+        const VisibilitySystem& getVisibilitySystem() const { return *m_visibilitySystem; }
+
         /*!
         \brief Posts a message on the system wide message bus
         */
@@ -386,6 +414,7 @@ namespace cro
     private:
         MessageBus& m_messageBus;
         std::size_t m_uid;
+        bool m_headless;
 
         Entity m_defaultCamera;
         Entity m_activeCamera;
@@ -403,6 +432,7 @@ namespace cro
         std::vector<std::unique_ptr<Director>> m_directors;
 
         std::vector<Renderable*> m_renderables;
+        VisibilitySystem* m_visibilitySystem;
 
         std::array<glm::mat4, 8u> m_projectionMaps;
         std::size_t m_projectionMapCount;
@@ -411,9 +441,14 @@ namespace cro
         float m_waterLevel;
 
         RenderTexture m_sceneBuffer;
-        std::array<RenderTexture, 2u> m_postBuffers;
+        std::vector<RenderTexture> m_postBuffers;
         std::vector<std::unique_ptr<PostProcess>> m_postEffects;
 
+        //schedules the post effects and assigns the
+        //buffers in m_postBuffers to their targets
+        Detail::RenderGraph m_postGraph;
+        std::vector<std::size_t> m_postOutputs;
+
 
         struct Skybox final
         {
@@ -461,6 +496,7 @@ namespace cro
         void destroySkybox();
 
         void resizeBuffers(glm::uvec2);
+        void buildPostGraph(glm::uvec2);
     };
 
 #include "Scene.inl"
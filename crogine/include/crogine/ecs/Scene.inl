@@ -96,6 +96,7 @@ template <typename T, typename... Args>
 T& Scene::addPostProcess(Args&&... args)
 {
     static_assert(std::is_base_of<PostProcess, T>::value, "Must be a post process type");
+    CRO_ASSERT(!m_headless, "Post processes are not available in headless scenes");
     auto size = App::getWindow().getSize();
     if (!m_sceneBuffer.available())
     {
@@ -114,16 +115,7 @@ T& Scene::addPostProcess(Args&&... args)
     m_postEffects.back()->resizeBuffer(size.x, size.y);
 
     //create intermediate buffers if needed
-    switch (m_postEffects.size())
-    {
-    case 2:
-        m_postBuffers[0].create(size.x, size.y, false);
-        break;
-    case 3:
-        m_postBuffers[1].create(size.x, size.y, false);
-        break;
-    default: break;
-    }
+    buildPostGraph(size);
 
     return *dynamic_cast<T*>(m_postEffects.back().get());
 }
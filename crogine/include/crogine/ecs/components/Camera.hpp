@@ -500,6 +500,28 @@ namespace cro
         */
         void updateMatrices(const Transform& tx, float reflectionLevel = 0.f);
 
+        /*!
+        \brief Returns true if the view or projection of any pass changed
+        during the last call to updateMatrices().
+        Matrices and frustums which have not changed are not recalculated.
+        Renderables can use this to skip rebuilding draw lists which only
+        depend on the Camera and the bounds of the entities it can see.
+        \see VisibilitySystem::CameraVisibility::isUnchanged()
+        */
+        bool hasChanged() const { return m_changed; }
+
+        /*!
+        \brief Returns a counter which is incremented by updateMatrices()
+        each time the world transform of the Camera has changed
+        */
+        std::uint32_t getTransformGeneration() const { return m_transformGeneration; }
+
+        /*!
+        \brief Returns a counter which is incremented each time the projection
+        matrix is changed with setPerspective() or setOrthographic()
+        */
+        std::uint32_t getProjectionGeneration() const { return m_projectionGeneration; }
+
         /*!
         \brief Returns the render target coordinates of the given
         3D world coordinates, as they would appear if rendered
@@ -562,9 +584,28 @@ namespace cro
         FloatRect m_orthographicView;
         FrustumData m_frustumData;
 
+        //tracks what updateMatrices() needs to recalculate
+        glm::mat4 m_lastWorldTransform = glm::mat4(1.f);
+        std::uint32_t m_transformGeneration = 0;
+        std::uint32_t m_projectionGeneration = 0;
+        std::uint32_t m_lastProjectionGeneration = std::numeric_limits<std::uint32_t>::max();
+        float m_reflectionLevel = 0.f;
+        bool m_reflectionValid = false;
+        bool m_changed = true;
+
 
         friend class ShadowMapRenderer;
         friend class ModelRenderer;
+        friend class LightSystem;
+        friend class DeferredRenderSystem;
+
+        //updated by the LightSystem, if there is one in the Scene
+        struct LightClusterData final
+        {
+            std::uint32_t texture = 0;
+            glm::vec4 params = glm::vec4(0.f); //slice scale, slice bias, index texel offset, enabled
+            std::array<glm::mat4, 2u> matrices = {}; //view, projection
+        }m_lightClusters;
 
         std::array<glm::vec4, 8u> m_frustumCorners;
         std::vector<std::array<glm::vec4, 8u>> m_frustumSplits;
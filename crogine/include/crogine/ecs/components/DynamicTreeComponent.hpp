@@ -76,7 +76,9 @@ namespace cro
         matching the query flags are returned. For example setting the
         flag to 4 will set the 3rd bit, and items matching a dynamic tree
         query which includes the 3rd bit will be included in the results.
-        All flags are set by default, so all items are returned in a query
+        All flags are set by default, so all items are returned in a query.
+        Changes are applied to the tree the next time the DynamicTreeSystem
+        is updated.
         */
         void setFilterFlags(std::uint64_t flags) { m_filterFlags = flags; }
 
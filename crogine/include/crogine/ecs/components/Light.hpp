@@ -0,0 +1,69 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <crogine/Config.hpp>
+#include <crogine/graphics/Colour.hpp>
+
+namespace cro
+{
+    /*!
+    \brief Local light source component.
+    Entities with a Light component and a Transform component are gathered
+    by the LightSystem and assigned to the view space clusters of each active
+    Camera, so that the PBR shaders of both the ModelRenderer and
+    DeferredRenderSystem only evaluate the lights near each fragment.
+    This is in addition to the Scene's Sunlight.
+
+    The light's position is taken from the entity's world transform, and spot
+    lights point along the transform's forward (negative Z) vector.
+    Lights are culled to their radius, at which point their contribution
+    falls smoothly to zero.
+    */
+    struct CRO_EXPORT_API Light final
+    {
+        enum class Type
+        {
+            Point, Spot
+        }type = Type::Point;
+
+        Colour colour = Colour::White;
+        float intensity = 1.f; //!< multiplies the colour to allow HDR values
+        float radius = 5.f; //!< distance in world units beyond which the light has no effect
+
+        //half angles of the spot light cone, in radians. The light fades between
+        //the inner and outer angle. The outer angle is clamped below 90 degrees.
+        float innerAngle = 0.3f;
+        float outerAngle = 0.5f;
+
+        bool active = true;
+    };
+}
@@ -38,6 +38,7 @@ source distribution.
 #include <crogine/detail/glm/mat4x4.hpp>
 
 #include <functional>
+#include <vector>
 
 namespace cro
 {
@@ -228,6 +229,31 @@ namespace cro
         */
         cro::Box getAABB() const { return m_boundingBox; }
 
+        /*!
+        \brief Adds a level of detail to the Model.
+        Renderers select a level for each camera pass based on the projected size
+        of the Model's bounding sphere, using fewer triangles as the Model gets smaller
+        on screen. The Model's mesh is level 0, and each call adds the next level.
+        \param meshData Mesh data for the new level. This must have the same vertex
+        attributes and sub-mesh count as the Model's mesh, and is drawn with the same
+        materials. The bounds of the Model's mesh are used for all levels.
+        \param screenSize Projected diameter of the bounding sphere, as a proportion
+        of the viewport height, below which this level is used. This must be smaller
+        than the screen size of the previous level.
+        \returns true if the level was added, else false if the mesh is incompatible
+        */
+        bool addLod(Mesh::Data meshData, float screenSize);
+
+        /*!
+        \brief Returns the number of levels of detail, including the Model's mesh.
+        */
+        std::size_t getLodCount() const { return m_lods.size() + 1; }
+
+        /*!
+        \brief Returns the mesh data used for the given level of detail.
+        */
+        const Mesh::Data& getLodMeshData(std::size_t level) const;
+
 #ifdef PLATFORM_DESKTOP
         /*!
         \brief Used to implement custom draw functions for the Model.
@@ -261,6 +287,7 @@ namespace cro
         
 #ifdef PLATFORM_DESKTOP
         void updateVAO(std::size_t materialIndex, std::int32_t passIndex);
+        void updateVAO(std::size_t materialIndex, std::int32_t passIndex, const Mesh::Data&, VAOPair&);
 
         struct DrawSingle final
         {
@@ -289,6 +316,35 @@ namespace cro
         glm::mat4* m_skeleton = nullptr;
         std::size_t m_jointCount = 0;
 
+        struct Lod final
+        {
+            Mesh::Data meshData;
+            std::array<VAOPair, Mesh::IndexData::MaxBuffers> vaos = {};
+        };
+        std::vector<Lod> m_lods;
+        std::vector<float> m_lodScreenSizes;
+
+        //last level selected for each pass of each camera which has
+        //drawn this model, so that changes can be delayed
+        struct LodState final
+        {
+            std::uint32_t cameraIndex = 0;
+            std::array<std::uint32_t, 2u> levels = {};
+        };
+        std::vector<LodState> m_lodLevels;
+
+        //the level used by the draw functions
+        mutable std::uint32_t m_activeLod = 0;
+
+        std::uint32_t selectLod(std::uint32_t cameraIndex, std::size_t pass, float screenSize);
+        std::uint32_t getLodLevel(std::uint32_t cameraIndex, std::size_t pass) const;
+        const Mesh::Data& getActiveMeshData() const { return m_activeLod == 0 ? m_meshData : m_lods[m_activeLod - 1].meshData; }
+        std::size_t getTriangleCount(std::size_t submesh) const;
+
+        //set when a change may invalidate draw lists built on previous
+        //frames - cleared by the VisibilitySystem once it has been seen
+        bool m_drawListDirty = true;
+
         //used with BalancedTree if active in frustum culling
         std::int32_t m_treeID = -1;
         glm::vec3 m_lastWorldPosition = glm::vec3(0.f);
@@ -296,5 +352,6 @@ namespace cro
         friend class ModelRenderer;
         friend class ShadowMapRenderer;
         friend class DeferredRenderSystem;
+        friend class VisibilitySystem;
     };
 }
\ No newline at end of file
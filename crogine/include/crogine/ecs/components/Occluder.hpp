@@ -0,0 +1,90 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+
+#pragma once
+
+#include <crogine/Config.hpp>
+#include <crogine/graphics/BoundingBox.hpp>
+
+#include <crogine/detail/glm/vec3.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace cro
+{
+    /*!
+    \brief Occluder component.
+    Entities with a Model component which also have an Occluder component
+    are rasterised into the ModelRenderer's software depth buffer, when
+    occlusion culling is enabled, and hide any Models entirely behind them.
+    The occluder geometry is usually a simplified version of the Model's
+    mesh, such as a box for a wall, and must never extend outside of it,
+    else Models which ought to be visible may be culled.
+    \see ModelRenderer::setOcclusionCulling()
+    */
+    struct CRO_EXPORT_API Occluder final
+    {
+        Occluder() = default;
+
+        /*!
+        \brief Creates occluder geometry from the given box, in model space
+        */
+        explicit Occluder(const Box& box)
+        {
+            for (auto i = 0u; i < 8u; ++i)
+            {
+                vertices.emplace_back(
+                    (i & 0x1) ? box[1].x : box[0].x,
+                    (i & 0x2) ? box[1].y : box[0].y,
+                    (i & 0x4) ? box[1].z : box[0].z);
+            }
+
+            indices =
+            {
+                0, 1, 3,  0, 3, 2,
+                4, 6, 7,  4, 7, 5,
+                0, 4, 5,  0, 5, 1,
+                2, 3, 7,  2, 7, 6,
+                0, 2, 6,  0, 6, 4,
+                1, 5, 7,  1, 7, 3
+            };
+        }
+
+        //vertex positions in model space
+        std::vector<glm::vec3> vertices;
+
+        //triangle list indices into the vertices
+        std::vector<std::uint32_t> indices;
+
+        bool active = true;
+    };
+}
@@ -0,0 +1,67 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <crogine/Config.hpp>
+
+#include <cstdint>
+
+namespace cro
+{
+    /*!
+    \brief Marks an entity as having its Transform replicated from
+    the server to connected clients.
+    The netID must be unique among replicated entities on the server,
+    and is used by the client to map received states to its own
+    entities. A netID of 0 is invalid and is not replicated.
+    \see ReplicationServerSystem, ReplicationClientSystem
+    */
+    struct CRO_EXPORT_API Replicated final
+    {
+        std::uint32_t netID = 0;
+
+        /*!
+        \brief When a client's bandwidth is limited, entities with a
+        higher priority are updated more often. The priority is scaled
+        by the entity's distance from the client's view position.
+        \see ReplicationServerSystem::setBandwidthLimit()
+        */
+        float priority = 1.f;
+
+        /*!
+        \brief If true the entity is sent to all clients regardless
+        of their view area. Use this for entities such as game objectives
+        which should always be visible.
+        \see ReplicationServerSystem::setClientView()
+        */
+        bool alwaysRelevant = false;
+    };
+}
@@ -37,5 +37,12 @@ namespace cro
     {
         bool skinned = false;
         bool active = true;
+
+        //static casters are rendered once into a cached depth map which
+        //is only redrawn when the light or shadow cascade moves, or the set
+        //of static casters changes. Static casters are assumed not to move,
+        //call ShadowMapRenderer::invalidateStaticCasters() if one does.
+        //Skinned casters are always treated as dynamic.
+        bool isStatic = false;
     };
 }
\ No newline at end of file
@@ -59,6 +59,7 @@ namespace cro
 
         const std::vector<Entity>& getCameras() const;
     private:
+        std::vector<Entity> m_activeCameras;
 
         void resizeGBuffer(Entity);
         void onEntityAdded(Entity) override;
@@ -84,6 +84,7 @@ namespace cro
             Entity entity; //model entity
             std::vector<std::int32_t> materialIDs; //index into the model submesh array
             float distanceFromCamera = 0.f; //sort criteria
+            std::uint32_t lod = 0; //mesh LOD level selected for this camera
         };
 
         struct VisibleList final
@@ -125,6 +126,10 @@ namespace cro
                 LightProjMat, //actually multiplied with invView for shadow mapping
                 ShadowMap,
 
+                LightClusters,
+                LightClusterParams,
+                LightClusterMatrices,
+
                 Count
             };
         };
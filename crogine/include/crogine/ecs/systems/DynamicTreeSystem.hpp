@@ -33,9 +33,13 @@ source distribution.
 #include <crogine/ecs/System.hpp>
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace cro
 {
+    struct DynamicTreeComponent;
+    class Transform;
     class CRO_EXPORT_API DynamicTreeSystem final : public System
     {
     public:
@@ -63,7 +67,75 @@ namespace cro
         */
         std::vector<Entity> query(Box area, std::uint64_t filter = std::numeric_limits<std::uint64_t>::max()) const;
 
+        /*!
+        \brief Appends the entities whose dynamic tree component bounds
+        intersect the given area to the given vector. Reusing the destination
+        vector between queries avoids allocating memory for each query.
+        \param area Area in world coordinates to query
+        \param dst Vector to which results are appended. This is not cleared first.
+        \param filter Only entities with DynamicTreeComponents matching
+        the given bit flags are returned. Defaults to all flags set.
+        */
+        void query(Box area, std::vector<Entity>& dst, std::uint64_t filter = std::numeric_limits<std::uint64_t>::max()) const;
+
+        /*!
+        \brief Appends the entities whose dynamic tree component bounds
+        intersect the given sphere to the given vector.
+        \see query()
+        */
+        void query(Sphere sphere, std::vector<Entity>& dst, std::uint64_t filter = std::numeric_limits<std::uint64_t>::max()) const;
+
+        /*!
+        \brief Appends the entities whose dynamic tree component bounds
+        are at least partially inside the given frustum to the given vector.
+        Branches of the tree entirely inside the frustum are added without
+        any further testing.
+        \see query(), Spatial::updateFrustum()
+        */
+        void query(const Frustum& frustum, std::vector<Entity>& dst, std::uint64_t filter = std::numeric_limits<std::uint64_t>::max()) const;
+
+        /*!
+        \brief Appends the entities whose dynamic tree component bounds
+        are hit by the given ray to the given vector. Results are not sorted
+        by distance.
+        \param origin World position of the start of the ray
+        \param direction Normalised direction of the ray
+        \param length Distance along the ray to test
+        \param dst Vector to which results are appended
+        \param filter Only entities with DynamicTreeComponents matching
+        the given bit flags are returned. Defaults to all flags set.
+        */
+        void queryRay(glm::vec3 origin, glm::vec3 direction, float length, std::vector<Entity>& dst, std::uint64_t filter = std::numeric_limits<std::uint64_t>::max()) const;
+
+        /*!
+        \brief Appends each pair of entities whose dynamic tree component
+        bounds overlap to the given vector. Each pair is reported once.
+        Useful as the broad phase before performing narrow phase collision
+        between all entities in the tree.
+        \param dst Vector to which pairs are appended
+        \param filter Only entities with DynamicTreeComponents matching
+        the given bit flags are paired. Defaults to all flags set.
+        */
+        void queryPairs(std::vector<std::pair<Entity, Entity>>& dst, std::uint64_t filter = std::numeric_limits<std::uint64_t>::max()) const;
+
+        /*!
+        \brief Performs a query for each of the given areas at once.
+        This is faster than querying each area individually as the tree is
+        traversed only once for each group of areas, which are tested against
+        each node together.
+        \param areas Areas in world coordinates to query
+        \param dst Results for areas[n] are placed in dst[n]. The vector is
+        resized to match the number of areas, and each list of results is cleared
+        first, so reusing the vector between queries avoids allocating memory.
+        \param filter Only entities with DynamicTreeComponents matching
+        the given bit flags are returned. Defaults to all flags set.
+        */
+        void query(const std::vector<Box>& areas, std::vector<std::vector<Entity>>& dst, std::uint64_t filter = std::numeric_limits<std::uint64_t>::max()) const;
+
     private:
         Detail::BalancedTree m_tree;
+
+        std::vector<std::pair<DynamicTreeComponent*, const Transform*>> m_components;
+        std::vector<Detail::NodeUpdate> m_updates;
     };
 }
\ No newline at end of file
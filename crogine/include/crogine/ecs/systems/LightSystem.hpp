@@ -0,0 +1,124 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <crogine/Config.hpp>
+#include <crogine/ecs/System.hpp>
+#include <crogine/ecs/Renderable.hpp>
+#include <crogine/detail/LightClusters.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace cro
+{
+    /*!
+    \brief Assigns point and spot lights to the view space clusters of each Camera.
+    Entities with a Light and Transform component are gathered once per frame,
+    then for each active Camera the lights are assigned to a grid of clusters
+    (froxels) dividing the Camera's frustum. The light data and cluster lists are
+    uploaded to a buffer texture owned by the system, and bound by the ModelRenderer
+    and DeferredRenderSystem to materials which use the u_lightClusters uniform,
+    such as the built in PBR shader.
+
+    The cluster assignment is done on the CPU and so is also available in headless
+    scenes, although no data is uploaded. Clusters are rebuilt every frame, so lights
+    may move freely. A Scene can contain any number of lights, but each cluster only
+    references the first LightClusters::MaxLightsPerCluster which touch it.
+
+    Buffer textures are not available on mobile platforms, where the clusters are
+    still built but the lights are not rendered.
+    */
+    class CRO_EXPORT_API LightSystem final : public System, public Renderable
+    {
+    public:
+        explicit LightSystem(MessageBus&);
+        ~LightSystem();
+
+        LightSystem(const LightSystem&) = delete;
+        LightSystem(LightSystem&&) = delete;
+        LightSystem& operator = (const LightSystem&) = delete;
+        LightSystem& operator = (LightSystem&&) = delete;
+
+        void process(float) override;
+
+        void updateDrawList(Entity camera) override;
+
+        void render(Entity, const RenderTarget&) override {}
+
+        /*!
+        \brief Returns the number of active lights gathered during the last update
+        */
+        std::size_t getActiveLightCount() const { return m_worldLights.size(); }
+
+        /*!
+        \brief Returns the clusters built for the given camera during the last
+        update, or nullptr if the camera has not been updated.
+        */
+        const Detail::LightClusters* getClusters(Entity camera) const;
+
+    private:
+
+        //world space light properties as they are uploaded
+        struct WorldLight final
+        {
+            glm::vec3 position = glm::vec3(0.f);
+            float radius = 0.f;
+            glm::vec3 colour = glm::vec3(0.f);
+            float cosOuter = -2.f;
+            glm::vec3 direction = glm::vec3(0.f);
+            float cosInner = -1.f;
+        };
+        std::vector<WorldLight> m_worldLights;
+        std::vector<Detail::LightClusters::Light> m_viewLights;
+
+        struct CameraSlot final
+        {
+            Entity camera;
+            std::unique_ptr<Detail::LightClusters> clusters;
+            glm::mat4 projection = glm::mat4(0.f);
+            float nearPlane = 0.f;
+            float farPlane = 0.f;
+
+            std::uint32_t buffer = 0;
+            std::uint32_t texture = 0;
+            std::size_t bufferSize = 0;
+        };
+        std::vector<CameraSlot> m_cameraSlots;
+        std::size_t m_cameraCount;
+
+        std::vector<std::uint32_t> m_uploadBuffer;
+        std::int32_t m_maxTexels;
+
+        void gatherLights();
+        bool upload(CameraSlot&);
+    };
+}
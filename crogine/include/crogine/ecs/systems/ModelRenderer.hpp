@@ -36,20 +36,24 @@ source distribution.
 #include <crogine/ecs/components/Model.hpp>
 #include <crogine/graphics/MaterialData.hpp>
 #include <crogine/detail/BalancedTree.hpp>
+#include <crogine/detail/OcclusionBuffer.hpp>
 #include <crogine/detail/SDLResource.hpp>
 
+#include <utility>
 #include <vector>
 
 namespace cro
 {
     class MessageBus;
     struct Camera;
+    class Transform;
 
     //don't export this, used internally.
     struct SortData final
     {
         std::int64_t flags = 0;
         std::vector<std::int32_t> matIDs;
+        std::uint32_t lod = 0;
     };
 
     using MaterialPair = std::pair<Entity, SortData>;
@@ -87,16 +91,54 @@ namespace cro
 
         void onEntityRemoved(Entity) override;
 
+        /*!
+        \brief Enables or disables software occlusion culling.
+        When enabled, Models which also have an Occluder component are
+        rasterised on the CPU into a low resolution depth buffer for the
+        final pass of each Camera, and Models hidden entirely behind them
+        are removed from the draw list. Disabled by default.
+        \see Occluder
+        */
+        void setOcclusionCulling(bool enabled) { m_occlusionCulling = enabled; }
+
+        /*!
+        \brief Returns true if occlusion culling is enabled
+        */
+        bool getOcclusionCulling() const { return m_occlusionCulling; }
+
+        /*!
+        \brief Returns the occlusion buffer as it was for the last updated
+        Camera, for example to change its resolution or debug its output.
+        */
+        Detail::OcclusionBuffer& getOcclusionBuffer() { return m_occlusionBuffer; }
+
+        /*!
+        \brief Returns the number of triangles submitted by this system for
+        all cameras and passes during the last frame, after level of detail
+        selection.
+        */
+        std::size_t getTriangleCount() const { return m_lastTriangleCount; }
+
     private:
         std::array<MaterialList, 2u> m_visibleEnts;
         Mesh::IndexData::Pass m_pass;
 
         Detail::BalancedTree m_tree;
+        std::vector<Entity> m_treeResults;
+        std::vector<std::pair<Model*, const Transform*>> m_treeComponents;
+        std::vector<Detail::NodeUpdate> m_treeUpdates;
         bool m_useTreeQueries;
 
+        Detail::OcclusionBuffer m_occlusionBuffer;
+        bool m_occlusionCulling;
+
+        std::size_t m_triangleCount;
+        std::size_t m_lastTriangleCount;
+
         void updateDrawListDefault(Entity);
         void updateDrawListBalancedTree(Entity);
-        std::vector<Entity> queryTree(Box) const;
+        void updateOcclusionBuffer(Entity);
+        bool occluded(const Model&, const glm::mat4& worldTransform) const;
 
         friend class DeferredRenderSystem;
         //these funcs are shared with above system - should probably be free funcs somewhere?
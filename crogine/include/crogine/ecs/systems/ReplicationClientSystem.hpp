@@ -0,0 +1,129 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <crogine/ecs/System.hpp>
+#include <crogine/network/NetData.hpp>
+#include <crogine/network/ReplicationSettings.hpp>
+
+#include <deque>
+#include <functional>
+#include <memory>
+
+namespace cro
+{
+    class NetClient;
+
+    namespace Detail
+    {
+        struct Snapshot;
+        class SnapshotHistory;
+    }
+
+    /*!
+    \brief Applies snapshots sent by a ReplicationServerSystem to the
+    Transform of entities with a matching Replicated component.
+    Received snapshots are buffered and the client renders
+    ReplicationSettings::interpolationDelay seconds behind the server,
+    interpolating between the two snapshots either side of the current
+    render time so that movement is smooth regardless of the server
+    tick rate or packet jitter. If no newer snapshot arrives entities
+    hold their last known state.
+
+    All received packets should be passed to handlePacket().
+    \see ReplicationServerSystem
+    */
+    class CRO_EXPORT_API ReplicationClientSystem final : public cro::System
+    {
+    public:
+        /*!
+        \brief Constructor.
+        \param mb Reference to the active MessageBus
+        \param client Reference to the NetClient used to acknowledge
+        snapshots. This must outlive the system.
+        \param settings ReplicationSettings matching those of the server
+        */
+        ReplicationClientSystem(MessageBus& mb, NetClient& client, const ReplicationSettings& settings = {});
+        ~ReplicationClientSystem();
+
+        ReplicationClientSystem(const ReplicationClientSystem&) = delete;
+        ReplicationClientSystem(ReplicationClientSystem&&) = delete;
+        ReplicationClientSystem& operator = (const ReplicationClientSystem&) = delete;
+        ReplicationClientSystem& operator = (ReplicationClientSystem&&) = delete;
+
+        /*!
+        \brief Reads snapshot packets and acknowledges them to the server.
+        \returns true if the event was consumed by the system, else false
+        */
+        bool handlePacket(const NetEvent&);
+
+        /*!
+        \brief Sets a callback which is executed when a netID appears in
+        the snapshots for the first time, as the render time reaches it.
+        Use this to create an entity with a Replicated component with
+        the given ID.
+        */
+        void setAddedCallback(const std::function<void(std::uint32_t)>& cb) { m_addedCallback = cb; }
+
+        /*!
+        \brief Sets a callback which is executed when a netID is removed
+        from the snapshots, as the render time reaches the removal.
+        */
+        void setRemovedCallback(const std::function<void(std::uint32_t)>& cb) { m_removedCallback = cb; }
+
+        /*!
+        \brief Returns the number of snapshots which failed to decode,
+        usually because their baseline was no longer available.
+        */
+        std::size_t getDroppedCount() const { return m_droppedCount; }
+
+        const ReplicationSettings& getSettings() const { return m_settings; }
+
+        void process(float) override;
+
+    private:
+        NetClient& m_client;
+        ReplicationSettings m_settings;
+
+        std::unique_ptr<Detail::SnapshotHistory> m_history;
+        std::deque<std::uint16_t> m_buffer; //sequence numbers of snapshots in the history waiting to be rendered
+        double m_renderTime;
+        bool m_hasRenderTime;
+        std::size_t m_droppedCount;
+
+        std::vector<std::uint32_t> m_activeIDs;
+        std::int32_t m_activeSequence;
+        std::function<void(std::uint32_t)> m_addedCallback;
+        std::function<void(std::uint32_t)> m_removedCallback;
+
+        void updateActiveIDs(const Detail::Snapshot&);
+    };
+}
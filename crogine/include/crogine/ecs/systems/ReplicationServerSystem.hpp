@@ -0,0 +1,217 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <crogine/ecs/System.hpp>
+#include <crogine/network/NetData.hpp>
+#include <crogine/network/ReplicationSettings.hpp>
+
+#include <crogine/detail/glm/vec3.hpp>
+
+#include <limits>
+#include <memory>
+#include <unordered_map>
+
+namespace cro
+{
+    class NetHost;
+    class DynamicTreeSystem;
+
+    namespace Util::Net
+    {
+        class BitWriter;
+    }
+
+    namespace Detail
+    {
+        struct EntityState;
+        struct Snapshot;
+        class SnapshotHistory;
+    }
+
+    /*!
+    \brief Replicates the Transform of entities with a Replicated component
+    to connected clients.
+    On each server tick a snapshot of all replicated entities is taken,
+    quantised according to the ReplicationSettings, and sent to each
+    client as a delta of the most recent snapshot the client acknowledged.
+    Entities which have not changed since then cost no bandwidth at all.
+    Snapshots are sent unreliably, lost snapshots are simply superseded
+    by the next tick.
+
+    Clients should be added with addClient() when they connect, and
+    removed with removeClient() when they disconnect. All received
+    packets should be passed to handlePacket() so that acknowledgements
+    sent by the ReplicationClientSystem can be processed.
+
+    By default every client receives every replicated entity. Setting a
+    view area with setClientView() limits a client to the entities near
+    it, and setBandwidthLimit() caps the size of each client's snapshots,
+    in which case the entities with the highest accumulated priority are
+    updated first and the remainder hold their last sent state.
+    \see ReplicationClientSystem
+    */
+    class CRO_EXPORT_API ReplicationServerSystem final : public cro::System
+    {
+    public:
+        /*!
+        \brief Constructor.
+        \param mb Reference to the active MessageBus
+        \param host Reference to the NetHost used to send snapshots.
+        This must outlive the system.
+        \param settings ReplicationSettings which match those used
+        by connecting clients
+        */
+        ReplicationServerSystem(MessageBus& mb, NetHost& host, const ReplicationSettings& settings = {});
+        ~ReplicationServerSystem();
+
+        ReplicationServerSystem(const ReplicationServerSystem&) = delete;
+        ReplicationServerSystem(ReplicationServerSystem&&) = delete;
+        ReplicationServerSystem& operator = (const ReplicationServerSystem&) = delete;
+        ReplicationServerSystem& operator = (ReplicationServerSystem&&) = delete;
+
+        /*!
+        \brief Starts sending snapshots to the given peer.
+        The first snapshot is sent in full.
+        */
+        void addClient(const NetPeer&);
+
+        /*!
+        \brief Stops sending snapshots to the given peer
+        */
+        void removeClient(const NetPeer&);
+
+        /*!
+        \brief Processes acknowledgement packets sent by clients.
+        \returns true if the event was consumed by the system, else false
+        */
+        bool handlePacket(const NetEvent&);
+
+        /*!
+        \brief Limits the entities sent to the given client to those within
+        radius of position, plus any marked Replicated::alwaysRelevant.
+        Entities leaving the area are removed on the client. This should be
+        updated as the client's view moves, for example each time the client's
+        player entity is updated.
+        */
+        void setClientView(const NetPeer&, glm::vec3 position, float radius);
+
+        /*!
+        \brief Removes the view area from the given client, so that it
+        receives all replicated entities
+        */
+        void clearClientView(const NetPeer&);
+
+        /*!
+        \brief Uses the given DynamicTreeSystem to find the entities within
+        client view areas, rather than testing the position of every replicated
+        entity. Only replicated entities which also have a DynamicTreeComponent
+        are found. The system must belong to the same Scene as this one.
+        \param tree Pointer to the DynamicTreeSystem to query, or nullptr to
+        test every entity (default)
+        \param filter Flags used to filter the query results
+        */
+        void setRelevancyTree(const DynamicTreeSystem* tree, std::uint64_t filter = std::numeric_limits<std::uint64_t>::max());
+
+        /*!
+        \brief Limits the number of snapshot bytes sent to each client per second.
+        When the limit is reached entities which changed but were not sent hold
+        their last sent state, and have their priority accumulated until they
+        are. At least one entity is updated each tick regardless of the limit.
+        \param bytesPerSecond The limit, or 0 for no limit (default)
+        */
+        void setBandwidthLimit(std::size_t bytesPerSecond) { m_bandwidthLimit = bytesPerSecond; }
+
+        /*!
+        \brief Returns the total number of snapshot bytes sent
+        to all clients since the system was created
+        */
+        std::size_t getBytesSent() const { return m_bytesSent; }
+
+        const ReplicationSettings& getSettings() const { return m_settings; }
+
+        void process(float) override;
+
+    private:
+        NetHost& m_host;
+        ReplicationSettings m_settings;
+
+        struct Client final
+        {
+            NetPeer peer;
+            std::uint16_t ackSequence = 0;
+            bool hasAck = false;
+
+            //each client is sent a different subset of entities
+            //so keeps its own history of snapshots as baselines
+            std::unique_ptr<Detail::SnapshotHistory> history;
+            std::uint16_t lastSequence = 0;
+            bool hasSent = false;
+
+            glm::vec3 viewPosition = glm::vec3(0.f);
+            float viewRadius = 0.f;
+            bool hasView = false;
+
+            std::unordered_map<std::uint32_t, float> priorities;
+        };
+        std::vector<Client> m_clients;
+
+        //state of all replicated entities this tick, sorted by netID
+        struct EntityInfo final
+        {
+            glm::vec3 position = glm::vec3(0.f);
+            float priority = 1.f;
+            bool alwaysRelevant = false;
+        };
+        std::vector<Detail::EntityState> m_states;
+        std::vector<EntityInfo> m_entityInfo;
+        std::unordered_map<std::uint32_t, std::size_t> m_stateIndices;
+
+        std::vector<std::size_t> m_relevant;
+        std::unique_ptr<Detail::Snapshot> m_outgoing;
+        std::unique_ptr<Util::Net::BitWriter> m_writer;
+
+        const DynamicTreeSystem* m_tree;
+        std::uint64_t m_treeFilter;
+        std::size_t m_bandwidthLimit;
+
+        std::uint16_t m_sequence;
+        float m_accumulator;
+        double m_serverTime;
+        std::size_t m_bytesSent;
+
+        Client* getClient(const NetPeer&);
+        void updateStates();
+        void updateRelevant(const Client&);
+        void updateSnapshot(Client&);
+        void sendSnapshot();
+    };
+}
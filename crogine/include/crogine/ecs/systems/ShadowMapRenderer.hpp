@@ -34,10 +34,12 @@ source distribution.
 #include <crogine/ecs/Renderable.hpp>
 #include <crogine/graphics/RenderTexture.hpp>
 #include <crogine/graphics/DepthTexture.hpp>
+#include <crogine/graphics/BoundingBox.hpp>
 
 namespace cro
 {
     class Texture;
+    struct Camera;
 
     /*!
     \brief Shadow map renderer.
@@ -84,6 +86,16 @@ namespace cro
 
     Note that the Camera's depthBuffer must be explicitly created:
     any camera without a valid depthBuffer will be skipped.
+
+    Each cascade's light frustum is sized to the bounding sphere of its
+    split and its origin snapped to a grid in light space, so that it
+    only moves in whole steps as the camera moves. On desktop platforms
+    ShadowCasters marked as static are drawn into a separate cached depth
+    map for each cascade which is only redrawn when the cascade steps or
+    the light direction changes. Each frame the cached depth is copied
+    into the Camera's depthBuffer and only dynamic casters are drawn on top.
+    Cascades further from the camera can be updated less frequently
+    with setCascadeInterval().
     \see Camera
     */
     class CRO_EXPORT_API ShadowMapRenderer final : public cro::System, public cro::Renderable
@@ -118,13 +130,53 @@ namespace cro
         */
         void setRenderInterval(std::uint32_t interval) { m_interval = std::max(interval, 1u); }
 
+        /*!
+        \brief Sets the interval at which the given cascade is updated.
+        Cascades are updated every Nth time the shadow maps are rendered,
+        offset by the cascade index so that far cascades with the same
+        interval are updated on alternate frames. Cascade 0 is closest
+        to the camera. Defaults to 1 (every frame) for all cascades.
+        Note that skipped cascades keep their previous projection, so
+        shadows in them lag behind moving casters.
+        \param cascade Index of the cascade to set
+        \param interval Must be greater than 0
+        */
+        void setCascadeInterval(std::size_t cascade, std::uint32_t interval);
+
+        /*!
+        \brief Forces the cached static shadow depth of every camera to be
+        redrawn. Call this if a static ShadowCaster is moved, or its Model
+        changes. Adding or removing static casters, hiding their Model or
+        setting them inactive is detected automatically.
+        */
+        void invalidateStaticCasters();
+
+        struct CascadeStats final
+        {
+            std::uint32_t culled = 0; //!< Casters tested and found to be outside the cascade
+            std::uint32_t drawn = 0; //!< Casters drawn into the cascade, static and dynamic
+            std::uint32_t cachedStatic = 0; //!< Static casters copied from the cache instead of being drawn
+            bool updated = false; //!< False if the cascade was skipped by its interval
+            bool staticRedrawn = false; //!< True if the static cache was redrawn
+        };
+
+        /*!
+        \brief Returns the stats for each cascade of the given camera from
+        the last time its shadow map was updated, or an empty vector if the
+        camera isn't rendered by this system.
+        */
+        const std::vector<CascadeStats>& getCascadeStats(Entity camera) const;
+
         void process(float) override;
 
+        void updateVisibility(Entity, VisibilitySystem&) override;
         void updateDrawList(Entity) override;
         void render(Entity, const RenderTarget&) override {};
 
     private:
         std::uint32_t m_interval;
+        std::uint32_t m_renderCount;
+        std::vector<std::uint32_t> m_cascadeIntervals;
         
         std::vector<Entity> m_activeCameras;
 
@@ -138,7 +190,44 @@ namespace cro
         //for each camera, for each camera cascade, a vector of entities
         std::vector<std::vector<std::vector<Drawable>>> m_drawLists;
 
+        struct CascadeState final
+        {
+            glm::mat4 staticViewProjection = glm::mat4(0.f);
+            bool staticDirty = true;
+            bool updated = false;
+            bool valid = false; //has been rendered at least once
+            std::vector<Drawable> staticList;
+        };
+
+        //cached state for each camera, in the same order as m_drawLists
+        struct CameraCache final
+        {
+            Entity camera;
+            glm::uvec2 bufferSize = glm::uvec2(0);
+            std::uint64_t renderFlags = 0;
+            std::uint64_t staticHash = 0;
+            std::uint32_t staticCount = 0;
+#ifdef PLATFORM_DESKTOP
+            DepthTexture staticDepth;
+#endif
+            std::vector<CascadeState> cascades;
+            std::vector<CascadeStats> stats;
+
+            //light space bounds of each cascade and their
+            //volume index in the Scene's VisibilitySystem
+            std::vector<glm::vec3> lightPositions;
+            std::vector<Box> frustums;
+            std::vector<std::size_t> volumes;
+        };
+        std::vector<CameraCache> m_cameraCaches;
+
+        //scratch buffers reused each update
+        std::vector<Entity> m_staticCasters;
+
+        std::size_t prepareCascades(Entity);
+        void updateCache(CameraCache&, Entity);
         void render();
+        std::uint32_t drawCasters(const std::vector<Drawable>&, const Camera&, std::uint32_t cameraIndex, std::size_t cascade, glm::vec3 cameraPosition, const glm::mat4& cameraView);
 
         void onEntityAdded(cro::Entity) override;
     };
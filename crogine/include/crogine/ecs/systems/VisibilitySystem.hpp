@@ -0,0 +1,190 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <crogine/Config.hpp>
+#include <crogine/ecs/System.hpp>
+#include <crogine/graphics/Spatial.hpp>
+
+#include <crogine/detail/glm/mat4x4.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace cro
+{
+    class Renderable;
+
+    /*!
+    \brief Shared visibility pass for entities with a Model and Transform component.
+    A VisibilitySystem is added automatically to every Scene. Once per frame, after
+    the CameraSystem has updated all active Cameras and before any draw lists are
+    updated, the world space bounding sphere of every visible Model is calculated
+    once, then tested against the culling volumes of all active Cameras in a single
+    parallel sweep.
+
+    Each Camera has a volume for its final pass and, if the Camera has a reflection
+    buffer, one for its reflection pass, at the indices Camera::Pass::Final and
+    Camera::Pass::Reflection. Renderable systems may add further volumes, such as
+    shadow map cascades, with addVolume() from Renderable::updateVisibility().
+
+    Renderables can then read the results with getCameraVisibility() from
+    updateDrawList() rather than each re-culling the Scene for every pass. If there
+    are no results for a Camera, for example because Scene::updateDrawLists() was
+    called directly, Renderables should fall back to culling the Camera themselves.
+    */
+    class CRO_EXPORT_API VisibilitySystem final : public System
+    {
+    public:
+        explicit VisibilitySystem(MessageBus&);
+
+        static constexpr std::uint32_t NoSlot = std::numeric_limits<std::uint32_t>::max();
+        static constexpr std::size_t NoVolume = std::numeric_limits<std::size_t>::max();
+
+        /*!
+        \brief Visibility results for a single Camera.
+        Each volume stores one bit per slot.
+        */
+        class CRO_EXPORT_API CameraVisibility final
+        {
+        public:
+            /*!
+            \brief Returns true if the entity in the given slot intersects the given volume
+            \param slot Entity slot returned by VisibilitySystem::getSlot()
+            \param volume Index of the volume, as returned by VisibilitySystem::addVolume()
+            */
+            bool isVisible(std::uint32_t slot, std::size_t volume) const
+            {
+                return (m_bits[(volume * m_wordCount) + (slot / 64)] & (std::uint64_t(1) << (slot % 64))) != 0;
+            }
+
+            /*!
+            \brief Returns the number of volumes tested for this Camera
+            */
+            std::size_t getVolumeCount() const { return m_volumes.size(); }
+
+            /*!
+            \brief Returns true if neither the Camera, its volumes nor the bounds of
+            any entity changed since the previous sweep, in which case the results
+            are the same as those of the previous frame and were not re-tested.
+            Renderables may use this to reuse draw lists built on the previous frame,
+            provided they depend on nothing more than the Camera and entity bounds.
+            */
+            bool isUnchanged() const { return m_unchanged; }
+
+        private:
+            Entity m_camera;
+            std::vector<Frustum> m_volumes;
+            std::vector<Frustum> m_previousVolumes;
+            std::vector<std::uint64_t> m_bits;
+            std::size_t m_wordCount = 0;
+            bool m_unchanged = false;
+
+            friend class VisibilitySystem;
+        };
+
+        /*!
+        \brief Updates the world bounds of all Models and tests them against each
+        of the given Cameras. This is called automatically by the CameraSystem via
+        Scene::updateVisibility()
+        \param cameras List of active Cameras which have been updated this frame
+        \param renderables Renderable systems which may add volumes to each Camera
+        */
+        void update(const std::vector<Entity>& cameras, const std::vector<Renderable*>& renderables);
+
+        /*!
+        \brief Adds a culling volume to the given Camera.
+        This is only valid from Renderable::updateVisibility(), and the volume is
+        tested in the sweep which follows.
+        \param camera The Camera entity currently being passed to Renderable::updateVisibility()
+        \param volume Six planes with normals pointing inwards
+        \returns Index of the volume used to query CameraVisibility::isVisible(),
+        or NoVolume if the Camera is not part of the current update.
+        */
+        std::size_t addVolume(Entity camera, const Frustum& volume);
+
+        /*!
+        \brief Returns the results for the given Camera, or nullptr if the Camera
+        was not updated in the last sweep.
+        */
+        const CameraVisibility* getCameraVisibility(Entity camera) const;
+
+        /*!
+        \brief Returns the slot of the given entity in the last sweep, or NoSlot
+        if the entity was not included, for example because its Model is hidden.
+        */
+        std::uint32_t getSlot(Entity entity) const
+        {
+            return entity.getIndex() < m_slots.size() ? m_slots[entity.getIndex()] : NoSlot;
+        }
+
+        /*!
+        \brief Returns the world space bounding sphere of the entity in the given slot
+        */
+        const Sphere& getWorldSphere(std::uint32_t slot) const { return m_worldSpheres[slot]; }
+
+        /*!
+        \brief Returns the world transform of the entity in the given slot,
+        as it was when the last sweep was performed.
+        */
+        const glm::mat4& getWorldTransform(std::uint32_t slot) const { return m_worldTransforms[slot]; }
+
+        /*!
+        \brief Returns true if any entity was added, removed, hidden, moved or had
+        its bounds or materials changed since the previous sweep.
+        */
+        bool sceneChanged() const { return m_sceneChanged; }
+
+    private:
+
+        std::vector<std::uint32_t> m_slots; //indexed by entity ID
+        std::vector<Entity> m_slotEntities;
+        std::vector<glm::mat4> m_worldTransforms;
+        std::vector<Sphere> m_worldSpheres;
+        std::vector<glm::vec3> m_scales;
+
+        //local bounds and transforms from the previous sweep, used to
+        //decide if the previous results for each camera can be kept
+        std::vector<Entity> m_previousEntities;
+        std::vector<glm::mat4> m_previousTransforms;
+        std::vector<Sphere> m_localSpheres;
+        std::vector<Sphere> m_previousSpheres;
+        bool m_sceneChanged;
+
+        std::vector<std::size_t> m_dirtyCameras;
+
+        std::vector<CameraVisibility> m_cameras;
+        std::size_t m_cameraCount;
+
+        CameraVisibility* findCamera(Entity);
+    };
+}
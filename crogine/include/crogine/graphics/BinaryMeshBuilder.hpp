@@ -31,10 +31,24 @@ source distribution.
 
 #include <crogine/graphics/MeshBuilder.hpp>
 
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace cro
 {
+    class MeshResource;
+
+    namespace Detail
+    {
+        class MappedFile;
+    }
+
     /*!
     \brief Class for loading the CroModelBinary format aka *.cmb files
+    Files are memory mapped when the mesh is built, and vertex and
+    index data are uploaded directly from the mapping where possible,
+    so no intermediate copies of the data are made.
     */
     class CRO_EXPORT_API BinaryMeshBuilder final : public cro::MeshBuilder
     {
@@ -44,10 +58,28 @@ namespace cro
         std::size_t getUID() const override;
         Skeleton getSkeleton() const override;
 
+        /*!
+        \brief Loads many *.cmb files into the given MeshResource at once.
+        All the files are mapped up front so that the OS can read them
+        in the background while the meshes are built in turn. Each
+        mapping is released as soon as its mesh has been uploaded.
+        Meshes are assigned the same IDs as they would be by
+        MeshResource::loadMesh(BinaryMeshBuilder(path)), so models
+        subsequently loaded with ModelDefinition using the same path
+        will reuse the preloaded mesh.
+        \param resources The MeshResource to load the meshes into
+        \param paths A vector of paths to *.cmb files to load
+        \returns A vector of mesh IDs, one for each path, which are 0
+        if the corresponding mesh failed to load.
+        */
+        static std::vector<std::size_t> loadBatch(MeshResource& resources, const std::vector<std::string>& paths);
+
     private:
         std::string m_path;
         std::size_t m_uid;
         mutable Skeleton m_skeleton;
+        mutable std::shared_ptr<Detail::MappedFile> m_file;
         Mesh::Data build() const override;
+        Mesh::Data build(const std::uint8_t* fileData, std::size_t fileSize) const;
     };
-}
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <crogine/Config.hpp>
+
+#include <crogine/detail/glm/vec2.hpp>
+
+#include <string>
+#include <vector>
+
+namespace cro
+{
+    namespace CompressedFormat
+    {
+        /*!
+        \brief Block compression formats supported by CompressedImage.
+        BCn formats are available on desktop platforms, ETC2 formats
+        on mobile (GLES3) and desktop drivers supporting GL 4.3
+        */
+        enum Type
+        {
+            None,
+            BC1, //!< RGB, 8 bytes per block
+            BC1A, //!< RGB with 1 bit alpha, 8 bytes per block
+            BC2, //!< RGBA with explicit alpha, 16 bytes per block
+            BC3, //!< RGBA with interpolated alpha, 16 bytes per block
+            BC4, //!< Single channel, 8 bytes per block
+            BC5, //!< Two channel, 16 bytes per block
+            BC6H, //!< RGB unsigned half float, 16 bytes per block
+            BC7, //!< RGBA, 16 bytes per block
+            ETC2_RGB, //!< RGB, 8 bytes per block
+            ETC2_RGBA1, //!< RGB with 1 bit alpha, 8 bytes per block
+            ETC2_RGBA, //!< RGBA, 16 bytes per block
+
+            Count
+        };
+    }
+
+    /*!
+    \brief CPU side representation of a block compressed, pre-mipmapped image.
+    CompressedImages can be loaded from DDS (including the DX10 extended
+    header) or KTX2 files which contain no supercompression. Loading and
+    validation require no OpenGL context, the image data is uploaded by
+    Texture::loadFromImage() or loaded directly with Texture::loadFromFile(),
+    CubemapTexture::loadFromFile() or EnvironmentMap::loadFromFile()
+    when passed a *.dds or *.ktx2 file.
+
+    Note that, like Image, textures are expected to be stored bottom row
+    first. Files created with the texture_converter tool are written this
+    way, else textures will need to be flipped vertically when they are
+    compressed. Cubemap faces are expected top row first.
+    */
+    class CRO_EXPORT_API CompressedImage final
+    {
+    public:
+        CompressedImage();
+
+        /*!
+        \brief Attempts to load a *.dds or *.ktx2 file
+        \returns true on success, else false
+        */
+        bool loadFromFile(const std::string& path);
+
+        /*!
+        \brief Attempts to parse a DDS or KTX2 file from memory.
+        The file type is determined from its header. The data
+        is copied so the source memory can be freed afterwards.
+        \param data Pointer to the beginning of the file in memory
+        \param size Size of the file in bytes
+        \returns true if the file was parsed and the mip chain was
+        found to be valid, else false
+        */
+        bool loadFromMemory(const std::uint8_t* data, std::size_t size);
+
+        /*!
+        \brief Returns the compression format of the image, or
+        CompressedFormat::None if no image is loaded.
+        */
+        CompressedFormat::Type getFormat() const { return m_format; }
+
+        /*!
+        \brief Returns the size of the base (largest) level of the image
+        */
+        glm::uvec2 getSize() const { return m_size; }
+
+        /*!
+        \brief Returns the number of mip levels, including the base level
+        */
+        std::uint32_t getLevelCount() const { return m_levelCount; }
+
+        /*!
+        \brief Returns the number of faces - 6 for cubemaps, else 1
+        */
+        std::uint32_t getFaceCount() const { return m_faceCount; }
+
+        /*!
+        \brief Returns true if the image format has an alpha channel
+        */
+        bool hasAlpha() const;
+
+        /*!
+        \brief Returns a pointer to the compressed data of the given level and face
+        or nullptr if either are out of range.
+        */
+        const std::uint8_t* getLevelData(std::uint32_t level, std::uint32_t face = 0) const;
+
+        /*!
+        \brief Returns the size in bytes of the given level, or 0 if out of range
+        */
+        std::size_t getLevelByteSize(std::uint32_t level) const;
+
+        /*!
+        \brief Returns the dimensions of the given mip level
+        */
+        glm::uvec2 getLevelSize(std::uint32_t level) const;
+
+        /*!
+        \brief Returns the number of bytes used for each 4x4 block
+        of pixels by the given format
+        */
+        static std::size_t getBlockByteSize(CompressedFormat::Type);
+
+        /*!
+        \brief Returns the number of bytes required to store an image
+        of the given dimensions in the given format
+        */
+        static std::size_t calcByteSize(CompressedFormat::Type, std::uint32_t width, std::uint32_t height);
+
+    private:
+        CompressedFormat::Type m_format;
+        glm::uvec2 m_size;
+        std::uint32_t m_levelCount;
+        std::uint32_t m_faceCount;
+
+        std::vector<std::uint8_t> m_data;
+        std::vector<std::size_t> m_offsets; //level * faceCount + face
+
+        bool parseDDS(const std::uint8_t*, std::size_t);
+        bool parseKTX2(const std::uint8_t*, std::size_t);
+        bool validate(std::size_t dataSize) const;
+        void reset();
+    };
+}
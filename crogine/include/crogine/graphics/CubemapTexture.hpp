@@ -34,6 +34,8 @@ source distribution.
 
 namespace cro
 {
+    class CompressedImage;
+
     class CRO_EXPORT_API CubemapTexture : public Detail::SDLResource
     {
     public:
@@ -49,11 +51,19 @@ namespace cro
         std::uint32_t getGLHandle() const;
 
         /*
-        \brief Attempts to load a cubemap from a *.ccm configuration file
+        \brief Attempts to load a cubemap from a *.ccm configuration file,
+        or a compressed *.dds or *.ktx2 cubemap file.
         \returns true on success else false.
         */
         bool loadFromFile(const std::string& path);
 
+        /*
+        \brief Attempts to create the cubemap from a compressed image
+        containing 6 faces. Any mip levels stored in the image are used.
+        \returns true on success else false.
+        */
+        bool loadFromImage(const CompressedImage& image);
+
     private:
         std::uint32_t m_handle;
 
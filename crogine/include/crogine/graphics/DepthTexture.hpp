@@ -87,6 +87,17 @@ namespace cro
         */
         void clear(std::uint32_t layer = 0);
 
+        /*!
+        \brief Activates the given layer for drawing, as clear() does, but
+        initialises it with the contents of a layer of another DepthTexture
+        instead of clearing it. The source must have been created with the
+        same size. display() must still be called once drawing is complete.
+        \param layer Index of the layer to render to
+        \param source DepthTexture from which to copy the depth values
+        \param sourceLayer Index of the layer in source to copy
+        */
+        void clear(std::uint32_t layer, const DepthTexture& source, std::uint32_t sourceLayer);
+
         /*!
         \brief This must be called once for each call to clear to properly validate
         the final state of the depth texture. Failing to do this will result in undefined
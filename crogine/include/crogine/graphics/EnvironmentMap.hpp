@@ -36,6 +36,8 @@ source distribution.
 
 namespace cro
 {
+    class CompressedImage;
+
     /*!
     An HDR (High Dynamic Range) Environment map.
     When rendering with PBR materials the PBR shader requires
@@ -57,7 +59,8 @@ namespace cro
     this can be automated by supplying a pointer to an EnironmentMap
     as a parameter to the load function.
 
-    EnvironmentMaps load their data from radiance *.hdr files.
+    EnvironmentMaps load their data from radiance *.hdr files, or
+    from pre-baked compressed cubemaps such as BC6H *.dds files.
     For visual feedback an environment map can be set as a Scene's
     skybox, using Scene::setCubemap()
 
@@ -87,12 +90,24 @@ namespace cro
         EnvironmentMap& operator = (EnvironmentMap&&) = delete;
 
         /*!
-        \brief Attempts to load and process a radiance *.hdr file
+        \brief Attempts to load and process a radiance *.hdr file,
+        or a compressed *.dds or *.ktx2 cubemap
         \param path A string containing the path to the file to load
         \returns bool - true on success, else false if loading failed.
         */
         bool loadFromFile(const std::string& path);
 
+        /*!
+        \brief Creates the environment map from a compressed cubemap,
+        such as a BC6H *.dds or *.ktx2 file. The cubemap is used directly
+        as the skybox, and any mip levels it contains are used when
+        rendering the prefiltered map. Passing a *.dds or *.ktx2 file to
+        loadFromFile() will also load it via this function.
+        \param image A CompressedImage containing 6 faces
+        \returns true on success, else false
+        */
+        bool loadFromImage(const CompressedImage& image);
+
         /*!
         \brief Returns the texture ID for the skybox cubemap.
         This can be bound to material properties for shaders which have
@@ -144,6 +159,7 @@ namespace cro
         void renderIrradianceMap(std::uint32_t fbo, std::uint32_t rbo, Shader&);
         void renderPrefilterMap(std::uint32_t fbo, std::uint32_t rbo, Shader&);
         void renderBRDFMap(std::uint32_t fbo, std::uint32_t rbo, Shader&);
+        bool renderMaps(std::uint32_t fbo, std::uint32_t rbo);
 
         std::uint32_t m_cubeVBO;
         std::uint32_t m_cubeVAO;
@@ -107,6 +107,9 @@ namespace cro
             RefractionMap,
             ReflectionMatrix,
             SkyBox,
+            LightClusterSampler,
+            LightClusterParams,
+            LightClusterMatrices,
             Total
         };
         
@@ -304,7 +307,7 @@ namespace cro
             //for example skinning and projection map data which is
             //used internally, and not user-definable
             std::size_t optionalUniformCount = 0;
-            std::array<std::int32_t, 10> optionalUniforms{};
+            std::array<std::int32_t, Uniform::Total> optionalUniforms{};
 
         private:
             std::unordered_map<std::string, bool> m_warnings;
@@ -113,6 +113,7 @@ namespace cro
         static std::size_t getAttributeSize(const std::array<std::size_t, Mesh::Attribute::Total>& attrib);
         static std::size_t getVertexSize(const std::array<std::size_t, Mesh::Attribute::Total>& attrib);
         static void createVBO(Mesh::Data& meshData, const std::vector<float>& vertexData);
+        static void createVBO(Mesh::Data& meshData, const float* vertexData);
         static void createIBO(Mesh::Data& meshData, const void* idxData, std::size_t idx, std::int32_t dataSize);
     };
 }
\ No newline at end of file
@@ -32,6 +32,7 @@ source distribution.
 #include <crogine/Config.hpp>
 #include <crogine/detail/Types.hpp>
 #include <crogine/detail/SDLResource.hpp>
+#include <crogine/detail/ResourceTracker.hpp>
 #include <crogine/graphics/MeshData.hpp>
 #include <crogine/ecs/components/Skeleton.hpp>
 
@@ -48,6 +49,10 @@ namespace cro
     also creates the mesh data structs required by model components.
     The mesh resource needs to live at least as long as the Scene
     which uses the meshes curated by it.
+    Meshes are reference counted, starting with a count of 1 when they
+    are loaded. If a memory budget is set with setMemoryBudget() then
+    meshes which have been released down to a count of 0 are deleted,
+    least recently used first, whenever the budget is exceeded.
     */
     class CRO_EXPORT_API MeshResource final : public Detail::SDLResource
     {
@@ -97,6 +102,39 @@ namespace cro
         */
         Skeleton getSkeltalAnimation(std::size_t ID) const;
 
+        /*!
+        \brief Returns true if a mesh is loaded with the given ID
+        */
+        bool hasMesh(std::size_t ID) const;
+
+        /*!
+        \brief Increments the reference count of the mesh with the given ID.
+        \returns false if no mesh exists with the given ID
+        */
+        bool acquire(std::size_t ID);
+
+        /*!
+        \brief Decrements the reference count of the mesh with the given ID.
+        Once the count reaches 0 the mesh may be deleted at any time to
+        stay within the memory budget. Make sure all entities with a Model
+        using the mesh have been destroyed before releasing it.
+        \returns false if no mesh exists with the given ID
+        */
+        bool release(std::size_t ID);
+
+        /*!
+        \brief Sets the amount of memory in bytes used by vertex and index
+        buffers before unused meshes are deleted.
+        Defaults to 0, which never deletes any meshes.
+        */
+        void setMemoryBudget(std::size_t bytes);
+
+        /*!
+        \brief Returns the number of meshes loaded and the size of their
+        vertex and index buffers.
+        */
+        ResourceStats getMemoryStats() const;
+
         /*!
         \brief Forcefully deletes all meshes
         Generally not needed as this is taken care of when the resource manager
@@ -108,7 +146,9 @@ namespace cro
     private:
         std::unordered_map<std::size_t, Mesh::Data> m_meshData;
         std::unordered_map<std::size_t, Skeleton> m_skeletalData;
+        Detail::ResourceTracker m_tracker;
 
         void deleteMesh(Mesh::Data);
+        void evict();
     };
 }
\ No newline at end of file
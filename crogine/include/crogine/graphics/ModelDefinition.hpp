@@ -41,6 +41,7 @@ source distribution.
 
 #include <array>
 #include <memory>
+#include <vector>
 
 namespace cro
 {
@@ -101,6 +102,19 @@ namespace cro
     Note that models without PBR materials are unaffected and will
     load correctly whether the EnvironmentMap pointer is passed or not
 
+    Models loaded from file may list additional meshes as levels of
+    detail, ordered from finest to coarsest. Each level must have the
+    same vertex layout and sub-mesh count as the main mesh, and
+    becomes active when the model's projected size drops below screen_size
+    \begincode
+    lod
+    {
+        mesh = "assets/models/crate_lod1.cmb"
+        screen_size = 0.25
+    }
+    \endcode
+    \see Model::addLod()
+
     */
     class CRO_EXPORT_API ModelDefinition final
     {
@@ -180,12 +194,19 @@ namespace cro
         */
         std::size_t getMaterialCount() const { return m_materialCount; }
 
+        /*!
+        \brief Returns the number of additional LOD meshes loaded
+        with this definition, not including the main mesh
+        */
+        std::size_t getLodCount() const { return m_lodIDs.size(); }
+
     private:
         ResourceCollection& m_resources;
         EnvironmentMap* m_envMap;
         std::string m_workingDir;
 
         std::size_t m_meshID = 0; //!< ID of the mesh in the mesh resource
+        std::vector<std::pair<std::size_t, float>> m_lodIDs; //!< mesh IDs and screen sizes of any LOD levels
         std::array<std::int32_t, Mesh::IndexData::MaxBuffers> m_materialIDs = {}; //!< list of material IDs in the order in which they appear on the model
         std::array<std::int32_t, Mesh::IndexData::MaxBuffers> m_shadowIDs = {}; //!< IDs of shadow map materials if this model casts shadows
 
@@ -36,6 +36,7 @@ source distribution.
 
 #include <string>
 #include <array>
+#include <vector>
 #include <unordered_map>
 
 namespace cro
@@ -117,9 +118,27 @@ namespace cro
 
 
     private:
+        friend class ShaderResource;
+
         bool loadFromSource(const char* v, const char* g, const char* f, const char* d);
 
+        //compiles and links without waiting for the result so that
+        //several programs can be compiled in parallel by the driver
+        bool beginCompile(const char* v, const char* g, const char* f, const char* d, bool retrievable);
+        //blocks until linking is complete and checks the result
+        bool endCompile();
+
+        bool loadFromBinary(std::uint32_t format, const std::vector<std::uint8_t>& data);
+        bool getBinary(std::uint32_t& format, std::vector<std::uint8_t>& dst) const;
+
+        //version and precision strings prepended to all sources
+        static std::string getPreamble();
+
+        void reset();
+        void deleteStages();
+
         std::uint32_t m_handle;
+        std::array<std::uint32_t, 3u> m_stages; //vert, geom, frag, until linked
         std::array<std::int32_t, AttributeID::Count> m_attribMap;
         bool fillAttribMap();
         void resetAttribMap();
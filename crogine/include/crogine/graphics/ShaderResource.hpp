@@ -32,15 +32,27 @@ source distribution.
 #include <crogine/Config.hpp>
 #include <crogine/detail/Types.hpp>
 #include <crogine/detail/SDLResource.hpp>
+#include <crogine/detail/ResourceTracker.hpp>
+#include <crogine/detail/ShaderCache.hpp>
 #include <crogine/graphics/Shader.hpp>
 
 #include <string>
+#include <vector>
 #include <unordered_map>
 
 namespace cro
 {    
     /*!
     \brief Manages the lifetime of shader programs.
+    Shaders are reference counted, starting with a count of 1 when they
+    are loaded. If a memory budget is set with setMemoryBudget() then
+    shaders which have been released down to a count of 0 are destroyed,
+    least recently used first, whenever the budget is exceeded.
+
+    On desktop platforms shaders loaded from strings, including the built in
+    shaders, are linked once and the resulting program binary is stored in
+    a cache directory. Subsequent runs load the binary directly, skipping
+    compilation, as long as the source and driver are unchanged.
     */
     class CRO_EXPORT_API ShaderResource final : public Detail::SDLResource
     {
@@ -131,9 +143,97 @@ namespace cro
         */
         bool hasShader(std::int32_t shaderID) const;
 
+        /*!
+        \brief Increments the reference count of the shader with the given ID.
+        \returns false if no shader exists with the given ID
+        */
+        bool acquire(std::int32_t shaderID);
+
+        /*!
+        \brief Decrements the reference count of the shader with the given ID.
+        Once the count reaches 0 the shader may be destroyed at any time to
+        stay within the memory budget. Make sure no materials still use the
+        shader before releasing it.
+        \returns false if no shader exists with the given ID
+        */
+        bool release(std::int32_t shaderID);
+
+        /*!
+        \brief Sets the amount of memory in bytes used by linked programs
+        before unused shaders are destroyed.
+        Defaults to 0, which never destroys any shaders.
+        */
+        void setMemoryBudget(std::size_t bytes);
+
+        /*!
+        \brief Returns the number of shaders loaded and the size of their
+        program binaries, as reported by the driver.
+        */
+        ResourceStats getMemoryStats() const;
+
+        /*!
+        \brief Sets the directory in which program binaries are cached.
+        By default this is a directory named shader_cache in the App's
+        preference path. Pass an empty string to disable caching.
+        \returns false if the directory could not be created or the driver
+        doesn't support program binaries, in which case caching is disabled.
+        Shaders loaded from files are never cached.
+        */
+        bool setCacheDirectory(const std::string& path);
+
+        /*!
+        \brief Returns the current cache directory, or an empty string
+        if caching is disabled.
+        */
+        const std::string& getCacheDirectory() const { return m_cache.getDirectory(); }
+
+        /*!
+        \brief Loads the given built in shader IDs, as returned by loadBuiltIn()
+        in one batch. Cached binaries are loaded directly and the remaining
+        shaders are all submitted to the driver before any results are
+        requested, allowing drivers which support it to compile them in parallel.
+        Call this from a loading screen to prevent hitches the first time a
+        shader variant is requested with loadBuiltIn().
+        \returns The number of shaders which were successfully loaded. IDs which
+        are already loaded are skipped and not counted.
+        */
+        std::size_t precompile(const std::vector<std::int32_t>& builtInIDs);
+
+        /*!
+        \brief Precompiles the built in shaders listed in the given manifest file
+        \see saveManifest()
+        */
+        std::size_t precompile(const std::string& manifestPath);
+
+        /*!
+        \brief Saves a list of every built in shader variant loaded so far.
+        Save this once a play session has loaded its assets, then pass the path
+        to precompile() on subsequent runs.
+        */
+        bool saveManifest(const std::string& path) const;
+
     private:
 
         Shader m_defaultShader;
         std::unordered_map<std::int32_t, Shader> m_shaders;
+        Detail::ResourceTracker m_tracker;
+        Detail::ShaderCache m_cache;
+        Detail::ShaderManifest m_manifest;
+
+        void track(std::int32_t shaderID);
+        void evict();
+
+        struct BuiltInSource final
+        {
+            const std::string* vertex = nullptr;
+            const std::string* fragment = nullptr;
+            std::string defines;
+        };
+        BuiltInSource getBuiltInSource(std::int32_t id) const;
+
+        std::uint64_t getCacheKey(const char* v, const char* g, const char* f, const std::string& defines) const;
+        bool loadCached(std::int32_t id, const char* v, const char* g, const char* f, const std::string& defines);
+        bool loadBinary(std::uint64_t key, Shader&) const;
+        void storeBinary(std::uint64_t key, const Shader&) const;
     };
 }
\ No newline at end of file
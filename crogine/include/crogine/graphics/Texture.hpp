@@ -41,6 +41,7 @@ source distribution.
 namespace cro
 {
     class Image;
+    class CompressedImage;
 
     /*!
     \brief Generic texture wrapper for OpenGL RGB or RGBA textures.
@@ -74,8 +75,10 @@ namespace cro
 
         /*!
         \brief Attempts to load the file in the given file path.
-        \param path Path to file to load. The image file should have pow2 dimensions on mobile platforms
-        \param createMipMaps Set true to automatically create mipmap levels for this texture
+        \param path Path to file to load. The image file should have pow2 dimensions on mobile platforms.
+        *.dds and *.ktx2 files are loaded as compressed textures via CompressedImage
+        \param createMipMaps Set true to automatically create mipmap levels for this texture.
+        This is ignored by compressed textures, which use their stored mip levels.
         \returns true on success, else false
         */
         bool loadFromFile(const std::string& path, bool createMipMaps = false);
@@ -89,6 +92,17 @@ namespace cro
         */
         bool loadFromImage(const Image& image, bool createMipmaps = false);
 
+        /*!
+        \brief Attempts to create the texture from a block compressed image.
+        Compressed textures use the mip levels stored in the image and
+        cannot be modified with update().
+        \param image A reference to a loaded CompressedImage
+        \returns true on success, else false if the image is empty or
+        its format is unsupported by the current device
+        \see CompressedImage
+        */
+        bool loadFromImage(const CompressedImage& image);
+
         /*!
         \brief Updates the pixel data for the texture.
         Ensure the texture is valid by calling create() or successfully calling loadFromFile()
@@ -140,6 +154,11 @@ namespace cro
         */
         bool isRepeated() const;
 
+        /*!
+        \brief Returns true if this texture was loaded from a CompressedImage
+        */
+        bool isCompressed() const;
+
         /*!
         \brief Returns the max texture size for the current platform
         */
@@ -177,12 +196,15 @@ namespace cro
         bool saveToImage(cro::Image& image) const;
 
     private:
+        friend class TextureResource;
+
         glm::uvec2 m_size;
         ImageFormat::Type m_format;
         std::uint32_t m_handle;
         bool m_smooth;
         bool m_repeated;
         bool m_hasMipMaps;
+        bool m_compressed;
 
         bool isFloat(SDL_RWops* file);
         bool loadAsFloat(SDL_RWops* file, bool createMipmaps);
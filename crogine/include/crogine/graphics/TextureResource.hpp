@@ -1,6 +1,6 @@
 /*-----------------------------------------------------------------------
 
-Matt Marchant 2017 - 2020
+Matt Marchant 2017 - 2022
 http://trederia.blogspot.com
 
 crogine - Zlib license.
@@ -30,6 +30,7 @@ source distribution.
 #pragma once
 
 #include <crogine/Config.hpp>
+#include <crogine/detail/ResourceTracker.hpp>
 #include <crogine/graphics/Texture.hpp>
 #include <crogine/graphics/Colour.hpp>
 
@@ -52,20 +53,30 @@ namespace std
 
 namespace cro
 {
+    namespace Detail
+    {
+        class ImageDecoder;
+        class UploadQueue;
+    }
+
     /*!
     \brief Used to manage the lifetime of textures as well as ensure single instances
     are loaded.
+    Textures are reference counted, starting with a count of 1 when they
+    are loaded. If a memory budget is set with setMemoryBudget() then
+    textures which have been released down to a count of 0 are destroyed,
+    least recently used first, whenever the budget is exceeded.
     */
     class CRO_EXPORT_API TextureResource final : public Detail::SDLResource
     {
     public:
         TextureResource();
-        ~TextureResource() = default;
+        ~TextureResource();
 
         TextureResource(const TextureResource&) = delete;
-        TextureResource(TextureResource&&) noexcept = default;
+        TextureResource(TextureResource&&) noexcept;
         const TextureResource& operator = (const TextureResource&) = delete;
-        TextureResource& operator = (TextureResource&&) noexcept = default;
+        TextureResource& operator = (TextureResource&&) noexcept;
         
         /*!
         \brief Attempts to load the image at the given path
@@ -78,6 +89,47 @@ namespace cro
         */
         bool load(std::uint32_t id, const std::string& path, bool createMipMaps = false);
 
+        /*!
+        \brief Loads the image at the given path without blocking.
+        The image is decoded on a worker thread, and uploaded to the GPU
+        the next time update() is called once decoding has finished.
+        Until then get(id) returns a texture filled with the fallback
+        colour. The OpenGL handle of this texture remains the same once
+        the image has been uploaded, so it can be assigned to materials
+        straight away - however the size of the texture will change.
+        Compressed *.dds and *.ktx2 files require no decoding and are
+        loaded immediately with load().
+        \param id ID to assign to the loaded texture
+        \param path String containing the path of the image to load
+        \param createMipMaps Attempts to create the default MipMap levels
+        when uploading the texture.
+        \returns false if the ID is already assigned to a different path
+        */
+        bool loadAsync(std::uint32_t id, const std::string& path, bool createMipMaps = false);
+
+        /*!
+        \brief Uploads any textures which have finished loading with loadAsync().
+        This must be called from the thread which owns the OpenGL context,
+        usually once per frame. The amount uploaded each call is limited by
+        setUploadBudget().
+        \returns The number of bytes uploaded
+        */
+        std::size_t update();
+
+        /*!
+        \brief Sets the maximum number of bytes and the maximum time in
+        seconds spent uploading textures with each call to update().
+        At least one texture is uploaded per call, if available, regardless
+        of its size. Defaults to 8MB and 4ms.
+        */
+        void setUploadBudget(std::size_t bytes, float seconds);
+
+        /*!
+        \brief Returns the number of textures queued with loadAsync()
+        which have not yet been uploaded.
+        */
+        std::size_t getPendingCount() const;
+
         /*!
         \brief Returns a reference to the texture currently assigned to the given ID
         If the ID doesn't correspond to a loaded texture then a reference to the fallback
@@ -85,6 +137,35 @@ namespace cro
         */
         Texture& get(std::uint32_t id);
 
+        /*!
+        \brief Increments the reference count of the texture with the given ID.
+        \returns false if no texture is assigned to the ID
+        */
+        bool acquire(std::uint32_t id);
+
+        /*!
+        \brief Decrements the reference count of the texture with the given ID.
+        Once the count reaches 0 the texture may be destroyed at any time
+        to stay within the memory budget, after which get() returns the
+        fallback texture for this ID. Make sure no materials still use the
+        texture before releasing it.
+        \returns false if no texture is assigned to the ID
+        */
+        bool release(std::uint32_t id);
+
+        /*!
+        \brief Sets the estimated amount of memory in bytes textures
+        are allowed to use before unused textures are destroyed.
+        Defaults to 0, which never destroys any textures.
+        */
+        void setMemoryBudget(std::size_t bytes);
+
+        /*!
+        \brief Returns the number of textures loaded and their
+        estimated memory usage.
+        */
+        ResourceStats getMemoryStats() const;
+
         /*!
         \brief Sets the current fallback colour.
         If a texture fails to load then a texture filled with the current
@@ -107,7 +188,20 @@ namespace cro
 
     private:
         std::unordered_map<std::uint32_t, std::pair<std::string, std::unique_ptr<Texture>>> m_textures;
+        std::unordered_map<std::string, std::uint32_t> m_pathIDs;
         std::unordered_map<Colour, std::unique_ptr<Texture>> m_fallbackTextures;
         Colour m_fallbackColour;
+        Detail::ResourceTracker m_tracker;
+
+        //these are only created the first time loadAsync() is used
+        class GLUploader;
+        std::unique_ptr<Detail::ImageDecoder> m_decoder;
+        std::unique_ptr<Detail::UploadQueue> m_uploadQueue;
+        std::unique_ptr<GLUploader> m_uploader;
+
+        Texture& getFallbackTexture();
+        void evict();
+        static std::size_t getByteSize(const Texture&);
+        static std::size_t uploadImage(Texture&, const Image&, bool createMipMaps, std::uint32_t& pixelBuffer);
     };
 }
\ No newline at end of file
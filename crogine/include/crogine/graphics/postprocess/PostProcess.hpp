@@ -40,6 +40,7 @@ source distribution.
 #include <crogine/detail/glm/vec4.hpp>
 
 #include <map>
+#include <vector>
 #include <string>
 
 namespace cro
@@ -99,6 +100,16 @@ namespace cro
         */
         void drawQuad(std::size_t passIndex, FloatRect size);
 
+        /*!
+        \brief Draws a quad using the given viewport rather than the viewport
+        of the active target. Use this when drawing to framebuffers which are
+        not managed by a RenderTarget, and which are a different size to it.
+        \param passIndex Index retrieved from addPass() to use when rendering
+        \param size Size of the quad to draw
+        \param viewport Viewport to apply, in device coordinates
+        */
+        void drawQuad(std::size_t passIndex, FloatRect size, IntRect viewport);
+
         /*!
         \brief Sets the value of a uniform in the given shader, if it exists
         */
@@ -132,6 +143,26 @@ namespace cro
         */
         std::size_t addPass(const Shader&);
 
+        /*!
+        \brief Declares an intermediate render target used by this effect.
+        Rather than creating its own RenderTextures an effect can declare the
+        targets it needs, which are then allocated by the Scene. As each target
+        is only in use while apply() is called the Scene may share its memory
+        with the targets of other effects, so the contents are not preserved
+        between frames and the target should be cleared before drawing to it.
+        Targets should be declared on construction.
+        \param scale Size of the target relative to the output buffer
+        \param depthBuffer True if the target requires a depth buffer
+        \returns index of the target to pass to getTarget()
+        */
+        std::size_t addTarget(glm::vec2 scale = glm::vec2(1.f), bool depthBuffer = false);
+
+        /*!
+        \brief Returns the render target with the given index as returned
+        by addTarget(). This is only valid during apply()
+        */
+        RenderTexture& getTarget(std::size_t index) const;
+
     private:
         glm::uvec2 m_currentBufferSize;
         
@@ -141,6 +172,14 @@ namespace cro
 
         std::vector<std::pair<const Shader*, std::uint32_t>> m_passes;
 
+        struct TargetInfo final
+        {
+            glm::vec2 scale = glm::vec2(1.f);
+            bool depthBuffer = false;
+            RenderTexture* texture = nullptr; //assigned by the scene
+        };
+        std::vector<TargetInfo> m_targets;
+
         struct UniformData final
         {
             enum
@@ -163,5 +202,7 @@ namespace cro
         std::map<std::uint32_t, std::map<std::uint32_t, UniformData>> m_uniforms;
 
         void createVBO();
+
+        friend class Scene;
     };
 }
\ No newline at end of file
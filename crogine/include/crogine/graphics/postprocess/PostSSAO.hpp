@@ -31,6 +31,10 @@ source distribution.
 
 #include <crogine/graphics/postprocess/PostProcess.hpp>
 #include <crogine/graphics/Shader.hpp>
+#include <crogine/graphics/MaterialData.hpp>
+#include <crogine/ecs/Entity.hpp>
+
+#include <crogine/detail/glm/mat4x4.hpp>
 
 #include <vector>
 #include <array>
@@ -40,8 +44,6 @@ namespace cro
     class MultiRenderTexture;
 
     /*!
-    DEPRECATED. Left here for legacy reasons, will eventually be removed.
-
     \brief Screen space ambient occlusion.
     This effect is not available on mobile platforms.
     To render this post process the Scene must first be buffered to
@@ -62,8 +64,9 @@ namespace cro
     targets. This can also be shared with other screen space post processes.
     \see MultiRenderTexture
 
-    Render the Scene with post processes disabled and GBuffer materials
-    active to the MultiRenderTexture:
+    Set the camera used to render the GBuffer with setCamera(), then render
+    the Scene with post processes disabled and GBuffer materials active to
+    the MultiRenderTexture:
 
     \begincode
         m_scene.getSystem<cro::ModelRenderer>().setRenderMaterial(cro::Model::MaterialPass::GBuffer);
@@ -81,10 +84,41 @@ namespace cro
         m_overlayScene.render(rt);
     \endcode
 
+    The cost of the effect can be reduced on lower end hardware by rendering
+    the occlusion at a lower resolution, reducing the number of samples taken
+    per pixel, and by accumulating the samples over several frames. These can
+    be changed at any time, either individually or with setQuality().
     */
-    class PostSSAO final : public cro::PostProcess
+    class CRO_EXPORT_API PostSSAO final : public cro::PostProcess
     {
     public:
+        /*!
+        \brief Resolution at which the occlusion is calculated, relative
+        to the output. Lower resolutions are upsampled with a depth aware
+        filter so that occlusion doesn't bleed across the edges of models.
+        */
+        enum class Resolution
+        {
+            Full, Half, Quarter
+        };
+
+        /*!
+        \brief Presets which set the resolution, sample count
+        and temporal accumulation together.
+        Low - Quarter resolution, 8 samples, temporal
+        Medium - Half resolution, 16 samples, temporal
+        High - Full resolution, 32 samples (default)
+        */
+        enum class Quality
+        {
+            Low, Medium, High
+        };
+
+        /*!
+        \brief Maximum number of samples which can be taken per pixel
+        */
+        static constexpr std::int32_t MaxSamples = 64;
+
         /*!
         \brief Constructor
         \param mrt A reference to the MRT which contains the
@@ -102,9 +136,21 @@ namespace cro
         /*!
         \brief Automatically called by Scene::render()
         */
-        void apply(const RenderTexture& source, const Camera&) override;
+        void apply(const RenderTexture& source) override;
 
-        TextureID getSSAOTexture() const { return TextureID(m_ssaoTexture); }
+        /*!
+        \brief Sets the camera entity used to render the g-buffer.
+        This must have a Camera component, whose projection and view
+        matrices are used to calculate and reproject the occlusion.
+        */
+        void setCamera(Entity camera);
+
+        /*!
+        \brief Returns the ID of the texture containing the blurred occlusion
+        value in the red channel, and the view space depth in the green channel.
+        This may be smaller than the output if a lower Resolution is set.
+        */
+        TextureID getSSAOTexture() const { return TextureID(m_buffers[BufferID::Blur].texture); }
 
         /*
         \brief Sets the intensity of the effect.
@@ -129,30 +175,99 @@ namespace cro
         */
         float getBias() const { return m_bias; }
 
+        /*!
+        \brief Sets the resolution, sample count and temporal
+        accumulation from the given preset.
+        */
+        void setQuality(Quality quality);
+
+        /*!
+        \brief Sets the resolution at which the occlusion is calculated
+        */
+        void setResolution(Resolution resolution);
+
+        /*!
+        \brief Returns the current resolution
+        */
+        Resolution getResolution() const { return m_resolution; }
+
+        /*!
+        \brief Sets the number of samples taken per pixel each frame.
+        Valid between 4 and MaxSamples
+        */
+        void setSampleCount(std::int32_t count);
+
+        /*!
+        \brief Returns the current number of samples per pixel
+        */
+        std::int32_t getSampleCount() const { return m_sampleCount; }
+
+        /*!
+        \brief Enables accumulating the occlusion over several frames.
+        When enabled each frame uses a different set of samples, which are
+        blended with the previous frames' results, reprojected with the camera's
+        movement. This allows a low sample count to give results similar to a
+        higher one, at the cost of some lag when the view changes quickly.
+        */
+        void setTemporalEnabled(bool enabled);
+
+        /*!
+        \brief Returns true if temporal accumulation is enabled
+        */
+        bool getTemporalEnabled() const { return m_temporalEnabled; }
+
     private:
         const MultiRenderTexture& m_mrt;
         Shader m_ssaoShader;
+        Shader m_temporalShader;
         Shader m_blurShader;
         Shader m_blendShader;
 
         std::vector<glm::vec3> m_kernel;
         std::uint32_t m_noiseTexture;
-        std::uint32_t m_ssaoTexture;
-        std::uint32_t m_blurTexture;
 
-        std::uint32_t m_ssaoFBO;
-        std::uint32_t m_blurFBO;
+        struct Buffer final
+        {
+            std::uint32_t fbo = 0;
+            std::uint32_t texture = 0;
+        };
+
+        struct BufferID final
+        {
+            enum
+            {
+                SSAO, Blur,
+                HistoryA, HistoryB,
+
+                Count
+            };
+        };
+        std::array<Buffer, BufferID::Count> m_buffers = {};
         glm::vec2 m_bufferSize;
 
+        Entity m_camera;
+
         float m_intensity;
         float m_bias;
 
+        Resolution m_resolution;
+        std::int32_t m_sampleCount;
+        bool m_temporalEnabled;
+
+        //temporal state
+        std::uint32_t m_frameIndex;
+        std::size_t m_historyIndex;
+        bool m_historyValid;
+        glm::mat4 m_previousViewMatrix;
+        glm::mat4 m_previousProjectionMatrix;
+
         struct SSAOUniformID final
         {
             enum
             {
                 Position, Normal, Noise,
-                Samples, ProjectionMatrix,
+                Samples, SampleCount, SampleOffset,
+                NoiseOffset, ProjectionMatrix,
                 BufferSize, BufferViewport,
                 Bias, Intensity,
 
@@ -161,6 +276,19 @@ namespace cro
         };
         std::array<std::int32_t, SSAOUniformID::Count> m_ssaoUniforms;
 
+        struct TemporalUniformID final
+        {
+            enum
+            {
+                Position, Current, History,
+                ReprojectionMatrix, ProjectionMatrix,
+                BufferViewport, Blend, HistoryValid,
+
+                Count
+            };
+        };
+        std::array<std::int32_t, TemporalUniformID::Count> m_temporalUniforms;
+
         struct BlurUniformID final
         {
             enum
@@ -177,6 +305,7 @@ namespace cro
             enum
             {
                 Base, SSAO,
+                Position, SSAOSize,
                 Count
             };
         };
@@ -186,13 +315,14 @@ namespace cro
         {
             enum
             {
-                SSAO, Blur, Final,
+                SSAO, Temporal, Blur, Final,
                 Count
             };
         };
         std::array<std::size_t, PassID::Count> m_passIDs;
 
         void createNoiseSampler();
+        void createBuffers();
         void bufferResized() override;
     };
 }
\ No newline at end of file
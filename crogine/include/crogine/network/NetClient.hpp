@@ -44,6 +44,11 @@ struct _ENetHost;
 
 namespace cro
 {
+    namespace Detail
+    {
+        class NetThread;
+    }
+
     /*!
     \brief Creates a clientside host which can be used to create
     a peer connected to a NetHost server.
@@ -96,6 +101,23 @@ namespace cro
         */
         void disconnect();
 
+        /*!
+        \brief Enables or disables servicing the connection on a dedicated thread.
+        When enabled the connection is serviced continuously in the background
+        while connected, so that it is kept alive during long loading times,
+        and received packets are queued for pollEvent() as soon as they arrive
+        regardless of the frame rate. sendPacket() may then be called from any
+        thread, although pollEvent() must only ever be called from one.
+        Disabled by default.
+        */
+        void setIOThreadEnabled(bool enabled);
+
+        /*!
+        \brief Returns true if the connection is serviced on a dedicated thread
+        \see setIOThreadEnabled()
+        */
+        bool getIOThreadEnabled() const { return m_useIOThread; }
+
         /*!
         \brief Polls the connection for events.
         This must be called at least once per frame to make sure all
@@ -151,12 +173,8 @@ namespace cro
         _ENetHost* m_client;
         NetPeer m_peer;
 
-        std::unique_ptr<std::thread> m_thread;
-        std::mutex m_mutex;
-        std::list<std::any> m_evtBuffer;
-        std::list<std::any> m_activeBuffer;
-        std::atomic_bool m_threadRunning;
-        void threadFunc();
+        bool m_useIOThread;
+        std::unique_ptr<Detail::NetThread> m_thread;
     };
 
 #include "NetClient.inl"
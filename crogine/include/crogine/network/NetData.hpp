@@ -34,6 +34,7 @@ source distribution.
 #include <crogine/detail/Types.hpp>
 
 #include <cstring>
+#include <iterator>
 #include <string>
 
 struct _ENetPacket;
@@ -79,6 +80,97 @@ namespace cro
         friend class NetHost;
     };
 
+    /*!
+    \brief A single record unpacked from an aggregate packet.
+    Records are created with NetHost::queuePacket() or NetHost::queueBroadcast()
+    and can be read in the same way as NetEvent::Packet.
+    \see NetEvent::Packet::getRecords()
+    */
+    struct CRO_EXPORT_API NetRecord final
+    {
+        /*!
+        \brief The unique ID this record was tagged with when queued
+        */
+        std::uint8_t getID() const { return m_id; }
+
+        /*!
+        \brief Used to retreive the data as a specific type.
+        Trying to read data as an incorrect type will lead to
+        undefined behaviour.
+        */
+        template <typename T>
+        T as() const;
+
+        /*!
+        \brief Returns a pointer to the raw record data
+        */
+        const void* getData() const { return m_data; }
+
+        /*!
+        \brief Returns the size of the data, in bytes
+        */
+        std::size_t getSize() const { return m_size; }
+
+    private:
+        std::uint8_t m_id = 0;
+        const std::uint8_t* m_data = nullptr;
+        std::size_t m_size = 0;
+
+        friend class NetRecordIterator;
+    };
+
+    /*!
+    \brief Forward iterator over the records in an aggregate packet.
+    Iteration stops early if a record is truncated.
+    */
+    class CRO_EXPORT_API NetRecordIterator final
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = NetRecord;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const NetRecord*;
+        using reference = const NetRecord&;
+
+        NetRecordIterator() = default;
+        NetRecordIterator(const std::uint8_t* position, const std::uint8_t* end);
+
+        reference operator * () const { return m_record; }
+        pointer operator -> () const { return &m_record; }
+
+        NetRecordIterator& operator ++ ();
+        NetRecordIterator operator ++ (int);
+
+        bool operator == (const NetRecordIterator& other) const { return m_position == other.m_position; }
+        bool operator != (const NetRecordIterator& other) const { return m_position != other.m_position; }
+
+    private:
+        const std::uint8_t* m_position = nullptr;
+        const std::uint8_t* m_end = nullptr;
+        NetRecord m_record;
+
+        void read();
+    };
+
+    /*!
+    \brief Range of records returned by NetEvent::Packet::getRecords()
+    for use with range based for loops.
+    */
+    struct CRO_EXPORT_API NetRecordRange final
+    {
+        NetRecordRange() = default;
+        NetRecordRange(NetRecordIterator first, NetRecordIterator last)
+            : m_begin(first), m_end(last) {}
+
+        NetRecordIterator begin() const { return m_begin; }
+        NetRecordIterator end() const { return m_end; }
+        bool empty() const { return m_begin == m_end; }
+
+    private:
+        NetRecordIterator m_begin;
+        NetRecordIterator m_end;
+    };
+
     /*!
     \brief Network event.
     These are used to poll NetHost and NetClient objects
@@ -110,11 +202,33 @@ namespace cro
             Packet& operator = (const Packet&) = delete;
             Packet& operator = (Packet&&) noexcept;
 
+            /*!
+            \brief ID reserved for packets sent by NetHost::sendQueued()
+            containing multiple records. This shouldn't be used as the
+            ID of any other packet.
+            */
+            static constexpr std::uint8_t AggregateID = 0xff;
+
             /*!
             \brief The unique ID this packet was tagged with when sent
             */
             std::uint8_t getID() const;
 
+            /*!
+            \brief Returns the records contained in this packet if
+            getID() returns AggregateID, else returns an empty range.
+            \code
+            if (evt.packet.getID() == cro::NetEvent::Packet::AggregateID)
+            {
+                for (const auto& record : evt.packet.getRecords())
+                {
+                    handlePacket(record.getID(), record.as<MyData>());
+                }
+            }
+            \endcode
+            */
+            NetRecordRange getRecords() const;
+
             /*!
             \brief Used to retreive the data as a specific type.
             Trying to read data as an incorrect type will lead to
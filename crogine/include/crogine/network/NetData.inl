@@ -27,6 +27,18 @@ source distribution.
 
 -----------------------------------------------------------------------*/
 
+template <typename T>
+T NetRecord::as() const
+{
+    CRO_ASSERT(m_data, "Not a valid record");
+    CRO_ASSERT(sizeof(T) == getSize(), "This type's size does not match data size");
+
+    T returnData;
+    std::memcpy(&returnData, m_data, m_size);
+
+    return returnData;
+}
+
 template <typename T>
 T NetEvent::Packet::as() const
 {
@@ -34,6 +34,8 @@ source distribution.
 #include <crogine/network/NetData.hpp>
 
 #include <string>
+#include <memory>
+#include <vector>
 
 struct _ENetHost;
 
@@ -41,11 +43,21 @@ namespace cro
 {
     struct NetEvent;
     struct NetPeer;
+
+    namespace Detail
+    {
+        class NetThread;
+        class PacketPool;
+    }
     
     /*!
     \brief Creates a network host.
     Network hosts, or servers, can have multiple clients connected
     to them, via a reliable UDP stream.
+    The memory for outgoing packets is taken from a pool, so sending
+    many small packets does not allocate for each one. Small packets
+    sent every tick can be further combined with queuePacket() and
+    queueBroadcast(), which pack multiple records into a single packet.
     */
     class CRO_EXPORT_API NetHost final
     {
@@ -78,6 +90,23 @@ namespace cro
         */
         void stop();
 
+        /*!
+        \brief Enables or disables servicing the host on a dedicated thread.
+        When enabled the host is serviced continuously in the background
+        while running, so that client connections are kept alive if the
+        server thread stalls, and received packets are queued for pollEvent()
+        as soon as they arrive regardless of the tick rate. Packets may then
+        be sent, and peers disconnected, from any thread, although pollEvent()
+        must only ever be called from one. Disabled by default.
+        */
+        void setIOThreadEnabled(bool enabled);
+
+        /*!
+        \brief Returns true if the host is serviced on a dedicated thread
+        \see setIOThreadEnabled()
+        */
+        bool getIOThreadEnabled() const { return m_useIOThread; }
+
         /*!
         \brief Polls the connection for events.
         This must be called at least once per frame to make sure all
@@ -152,6 +181,57 @@ namespace cro
         */
         void sendPacket(const NetPeer& peer, std::uint8_t id, const void* data, std::size_t size, NetFlag flags, std::uint8_t channel = 0);
 
+        /*!
+        \brief Queues a record to be sent to the given peer the next time
+        sendQueued() is called.
+        All the records queued for the same peer, channel and flags are packed
+        into a single packet with the ID NetEvent::Packet::AggregateID, the
+        records of which are read with NetEvent::Packet::getRecords().
+        This saves the overhead of sending a separate packet for each of the
+        many small updates usually sent every network tick. If the packet
+        would grow larger than a single datagram it is sent immediately and
+        a new one started, and data too large to fit in a single datagram is
+        sent as a regular packet.
+        Unlike the send functions this should only be called from the thread
+        which calls sendQueued().
+        \param peer The peer to which the record should be sent
+        \param id Unique ID for this record
+        \param data Struct of simple data to send
+        \param flags Used to denote reliability of the packet containing the record
+        \param channel Stream channel over which to send the data.
+        */
+        template <typename T>
+        void queuePacket(const NetPeer& peer, std::uint8_t id, const T& data, NetFlag flags, std::uint8_t channel = 0);
+
+        /*!
+        \brief Queues an array of bytes to be sent to the given peer as a
+        single record the next time sendQueued() is called.
+        \see queuePacket()
+        */
+        void queuePacket(const NetPeer& peer, std::uint8_t id, const void* data, std::size_t size, NetFlag flags, std::uint8_t channel = 0);
+
+        /*!
+        \brief Queues a record to be broadcast to all connected clients the
+        next time sendQueued() is called.
+        \see queuePacket()
+        */
+        template <typename T>
+        void queueBroadcast(std::uint8_t id, const T& data, NetFlag flags, std::uint8_t channel = 0);
+
+        /*!
+        \brief Queues an array of bytes to be broadcast to all connected
+        clients as a single record the next time sendQueued() is called.
+        \see queuePacket()
+        */
+        void queueBroadcast(std::uint8_t id, const void* data, std::size_t size, NetFlag flags, std::uint8_t channel = 0);
+
+        /*!
+        \brief Sends all the records queued with queuePacket() and
+        queueBroadcast(). This should usually be called once per
+        network tick, after all the updates have been queued.
+        */
+        void sendQueued();
+
 
         /*!
         \brief Disconnects the given peer from this host, if it is valid
@@ -167,6 +247,25 @@ namespace cro
     private:
 
         _ENetHost* m_host;
+
+        bool m_useIOThread;
+        std::unique_ptr<Detail::NetThread> m_thread;
+        std::unique_ptr<Detail::PacketPool> m_packetPool;
+
+        struct AggregateBuffer final
+        {
+            _ENetPeer* peer = nullptr; //nullptr for broadcasts
+            std::uint8_t channel = 0;
+            NetFlag flags = NetFlag::Reliable;
+            _ENetPacket* packet = nullptr;
+            std::size_t size = 0;
+        };
+        std::vector<AggregateBuffer> m_aggregateBuffers;
+
+        void queueRecord(_ENetPeer*, std::uint8_t id, const void* data, std::size_t size, NetFlag flags, std::uint8_t channel);
+        void sendBuffer(AggregateBuffer&);
+        void removeBuffers(_ENetPeer*, bool sendQueued);
+        void send(_ENetPeer*, std::uint8_t channel, _ENetPacket*);
     };
 
 #include "NetHost.inl"
@@ -0,0 +1,196 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <crogine/Config.hpp>
+#include <crogine/detail/Types.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cro
+{
+    /*!
+    \brief Simulates network conditions between NetClient and NetHost
+    instances running on the same machine.
+    The simulator acts as a loopback relay: it listens on its own port and
+    each client connecting to that port is given a dedicated link to the
+    host, so the host sees one peer per client as usual. Every datagram
+    relayed in either direction is subject to the configured latency,
+    jitter, loss, duplication, reordering and bandwidth limit. ENet runs
+    unmodified on both ends, so reliable delivery, sequencing, fragmentation
+    and round trip times are all exercised exactly as they would be over a
+    real connection.
+
+    All random decisions are drawn from generators seeded with Settings::seed,
+    one for each direction of each link (numbered in the order in which clients
+    first send to the simulator), so the same traffic is always subject to the
+    same conditions regardless of what happens on other links.
+
+    \code
+    cro::NetHost host;
+    host.start("", 5000, 64, 4);
+
+    cro::NetSimulator::Settings settings;
+    settings.latency = 50;
+    settings.jitter = 10;
+    settings.packetLoss = 0.02f;
+
+    cro::NetSimulator simulator;
+    simulator.start(5001, "127.0.0.1", 5000, settings);
+
+    //bots connect to the simulator instead of the host
+    client.connect("127.0.0.1", 5001);
+    \endcode
+    */
+    class CRO_EXPORT_API NetSimulator final
+    {
+    public:
+        /*!
+        \brief Network conditions applied to each direction of each link.
+        */
+        struct Settings final
+        {
+            std::uint32_t latency = 0; //!< One way latency in milliseconds
+            std::uint32_t jitter = 0; //!< Maximum random variation of the latency in milliseconds, either way
+            float packetLoss = 0.f; //!< Probability, 0-1, that a datagram is dropped
+            float duplication = 0.f; //!< Probability, 0-1, that a datagram is delivered twice
+            float reordering = 0.f; //!< Probability, 0-1, that a datagram is held back and delivered after those following it
+            std::uint32_t bandwidth = 0; //!< Bytes per second. Datagrams queue once this is exceeded, and are dropped when the queue is full. 0 is unlimited
+            std::uint32_t seed = 0; //!< Seeds the random number generators of all links
+        };
+
+        /*!
+        \brief Totals for all links since the simulator was started.
+        */
+        struct Stats final
+        {
+            std::uint64_t received = 0; //!< Datagrams received from either end
+            std::uint64_t delivered = 0; //!< Datagrams passed on, including duplicates
+            std::uint64_t dropped = 0; //!< Datagrams lost to packetLoss
+            std::uint64_t overflowed = 0; //!< Datagrams dropped because the bandwidth queue was full
+            std::uint64_t duplicated = 0; //!< Extra copies delivered
+            std::uint64_t reordered = 0; //!< Datagrams held back
+            std::uint64_t bytesDelivered = 0; //!< Total size of delivered datagrams
+            std::size_t linkCount = 0; //!< Number of currently open links
+        };
+
+        NetSimulator();
+        ~NetSimulator();
+
+        NetSimulator(const NetSimulator&) = delete;
+        NetSimulator(NetSimulator&&) = delete;
+        NetSimulator& operator = (const NetSimulator&) = delete;
+        NetSimulator& operator = (NetSimulator&&) = delete;
+
+        /*!
+        \brief Starts relaying datagrams sent to the given listen port
+        on to the host at the given address and port.
+        \param listenPort Port on the loopback interface to which clients should connect
+        \param hostAddress IPv4 address of the NetHost, usually "127.0.0.1"
+        \param hostPort Port on which the NetHost is listening
+        \param settings Network conditions to simulate
+        \returns true on success, else false
+        */
+        bool start(std::uint16_t listenPort, const std::string& hostAddress, std::uint16_t hostPort, const Settings& settings);
+
+        /*!
+        \brief Closes all links and stops the simulator.
+        Any datagrams still in flight are discarded.
+        */
+        void stop();
+
+        /*!
+        \brief Updates the conditions applied to datagrams received from
+        now on. This does not reseed existing links.
+        */
+        void setSettings(const Settings&);
+
+        /*!
+        \brief Returns the current settings
+        */
+        Settings getSettings() const;
+
+        /*!
+        \brief Enables or disables relaying on a dedicated thread.
+        When disabled, update() must be called regularly (at least once
+        per frame, the same as NetHost::pollEvent()) to relay datagrams.
+        Driving the simulator from the same thread as the host and clients
+        keeps the order in which datagrams are relayed independent of thread
+        scheduling, which makes soak tests easier to reproduce. Enabled by default.
+        */
+        void setThreadEnabled(bool enabled);
+
+        /*!
+        \brief Returns true if the simulator runs on its own thread
+        */
+        bool getThreadEnabled() const { return m_useThread; }
+
+        /*!
+        \brief Receives any pending datagrams and delivers those which are due.
+        This is called automatically when the simulator runs on its own thread.
+        */
+        void update();
+
+        /*!
+        \brief Returns the traffic totals since start() was called
+        */
+        Stats getStats() const;
+
+    private:
+        struct Listener;
+        struct Link;
+
+        mutable std::mutex m_mutex;
+        Settings m_settings;
+        Stats m_stats;
+
+        std::unique_ptr<Listener> m_listener;
+        std::vector<std::unique_ptr<Link>> m_links;
+        std::uint32_t m_linkCount; //used to seed each new link
+
+        bool m_useThread;
+        std::atomic_bool m_running;
+        std::thread m_thread;
+
+        void startThread();
+        void stopThread();
+        void threadFunc();
+
+        Link* getLink(std::uint32_t host, std::uint16_t port, std::int64_t now);
+        void receive(std::int64_t now);
+        void deliver(std::int64_t now);
+    };
+}
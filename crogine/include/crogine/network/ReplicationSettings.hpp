@@ -0,0 +1,98 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <crogine/Config.hpp>
+
+#include <cstdint>
+
+namespace cro
+{
+    /*!
+    \brief Settings shared by the ReplicationServerSystem and ReplicationClientSystem.
+    These must be identical on both the server and the client, else snapshots
+    will fail to decode.
+    */
+    struct CRO_EXPORT_API ReplicationSettings final
+    {
+        /*!
+        \brief Packet ID used for snapshots sent from the server.
+        This should not be used as the ID of any other packet.
+        */
+        std::uint8_t snapshotPacketID = 0xfe;
+
+        /*!
+        \brief Packet ID used by clients to acknowledge received snapshots.
+        This should not be used as the ID of any other packet.
+        */
+        std::uint8_t ackPacketID = 0xfd;
+
+        /*!
+        \brief Channel on which snapshots and acknowledgements are sent
+        */
+        std::uint8_t channel = 0;
+
+        /*!
+        \brief Number of snapshots sent per second by the server
+        */
+        float tickRate = 20.f;
+
+        /*!
+        \brief Positions are quantised to a multiple of this value.
+        Smaller values are more accurate but use more bandwidth.
+        */
+        float positionPrecision = 1.f / 512.f;
+
+        /*!
+        \brief Scales are quantised to a multiple of this value.
+        */
+        float scalePrecision = 1.f / 256.f;
+
+        /*!
+        \brief Number of bits used for each of the three quaternion components
+        sent with a rotation. Clamped to the range 4 - 10
+        */
+        std::uint32_t rotationBits = 10;
+
+        /*!
+        \brief If false the scale of replicated entities is not sent
+        */
+        bool replicateScale = false;
+
+        /*!
+        \brief Time in seconds the client renders behind the most recently
+        received snapshot. This should be at least two server ticks
+        so that the client always has a pair of snapshots to interpolate
+        between when an occasional packet is lost.
+        */
+        float interpolationDelay = 0.1f;
+    };
+}
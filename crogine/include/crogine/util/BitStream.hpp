@@ -0,0 +1,334 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <crogine/Config.hpp>
+
+#include <crogine/detail/glm/vec3.hpp>
+#include <crogine/detail/glm/gtc/quaternion.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace cro
+{
+    namespace Util
+    {
+        namespace Net
+        {
+            /*!
+            \brief Returns the number of bits required to store
+            any value in the range 0 - maxValue
+            */
+            static inline constexpr std::uint32_t bitsRequired(std::uint32_t maxValue)
+            {
+                std::uint32_t bits = 0;
+                while (maxValue)
+                {
+                    bits++;
+                    maxValue >>= 1;
+                }
+                return bits;
+            }
+
+            /*!
+            \brief Packs a quaternion into 2 + (3 * bitsPerComponent) bits using
+            'smallest three' encoding. The largest component is omitted and
+            reconstructed when unpacking, as the quaternion is unit length.
+            \param q The quaternion to pack. This is normalised first.
+            \param bitsPerComponent Precision of each of the three sent components,
+            in the range 2 - 10. 10 bits has an error of less than 0.1 degrees.
+            \see unpackQuat()
+            */
+            std::uint32_t CRO_EXPORT_API packQuat(glm::quat q, std::uint32_t bitsPerComponent = 10);
+
+            /*!
+            \brief Unpacks a quaternion packed with packQuat()
+            \param packed Value returned from packQuat()
+            \param bitsPerComponent The value with which the quaternion was packed
+            \returns Normalised quaternion
+            */
+            glm::quat CRO_EXPORT_API unpackQuat(std::uint32_t packed, std::uint32_t bitsPerComponent = 10);
+
+            /*!
+            \brief Writes values to a buffer using only the number of bits each requires.
+            Values can be written directly, or packet structs can declare a single
+            templated serialise() function which is used with both the BitWriter
+            and the BitReader:
+            \code
+            struct PlayerInfo final
+            {
+                std::uint8_t playerID = 0;
+                glm::vec3 position = glm::vec3(0.f);
+                std::int32_t health = 100;
+
+                template <typename Stream>
+                bool serialise(Stream& stream)
+                {
+                    return stream.serialiseInt(playerID, 0, 3)
+                        && stream.serialiseVec3(position, -256.f, 256.f, 1.f / 256.f)
+                        && stream.serialiseInt(health, 0, 100);
+                }
+            };
+
+            //sending
+            cro::Util::Net::BitWriter writer;
+            cro::Util::Net::write(writer, playerInfo);
+            host.broadcastPacket(PacketID::PlayerInfo, writer.getData(), writer.getSize(), cro::NetFlag::Unreliable);
+
+            //receiving
+            cro::Util::Net::BitReader reader(evt.packet.getData(), evt.packet.getSize());
+            PlayerInfo info;
+            if (cro::Util::Net::read(reader, info))
+            {
+                //do stuff with info
+            }
+            \endcode
+            The reading and writing of values must be done in the same order
+            and with the same parameters, which serialise() ensures.
+            \see BitReader
+            */
+            class CRO_EXPORT_API BitWriter final
+            {
+            public:
+                /*!
+                \brief Writes the lowest bitCount bits of value.
+                bitCount must be 32 or less.
+                */
+                void writeBits(std::uint32_t value, std::uint32_t bitCount);
+
+                /*!
+                \brief Writes a boolean value as a single bit
+                */
+                void writeBool(bool value);
+
+                /*!
+                \brief Writes an integer in the range min - max, using only the
+                number of bits required by the range. Values outside the range
+                are clamped.
+                */
+                void writeInt(std::int32_t value, std::int32_t min, std::int32_t max);
+
+                /*!
+                \brief Writes an unsigned value in groups of 7 bits, so that
+                smaller values use fewer bytes. Useful for values such as IDs
+                which are usually small but have no fixed upper limit.
+                */
+                void writeVarint(std::uint32_t value);
+
+                /*!
+                \brief Writes a signed value as a varint. Small negative values
+                use as few bytes as small positive values.
+                */
+                void writeSignedVarint(std::int32_t value);
+
+                /*!
+                \brief Writes an unquantised 32 bit float
+                */
+                void writeFloat(float value);
+
+                /*!
+                \brief Writes a float quantised to a multiple of precision within
+                the range min - max. Values outside the range are clamped.
+                */
+                void writeFloat(float value, float min, float max, float precision);
+
+                /*!
+                \brief Writes each component of a vector with writeFloat()
+                */
+                void writeVec3(glm::vec3 value, float min, float max, float precision);
+
+                /*!
+                \brief Writes a quaternion packed with packQuat()
+                */
+                void writeQuat(glm::quat value, std::uint32_t bitsPerComponent = 10);
+
+                /*!
+                \brief Returns a pointer to the written data
+                */
+                const std::uint8_t* getData() const { return m_data.data(); }
+
+                /*!
+                \brief Returns the size of the written data in bytes,
+                rounded up to the nearest byte
+                */
+                std::size_t getSize() const { return m_data.size(); }
+
+                /*!
+                \brief Returns the exact number of bits written
+                */
+                std::size_t getBitCount() const { return m_bitCount; }
+
+                /*!
+                \brief Clears the written data so that the writer can be reused
+                */
+                void clear();
+
+                //serialise interface shared with BitReader, see the class description
+                bool serialiseBool(bool& value) { writeBool(value); return true; }
+
+                template <typename T>
+                bool serialiseInt(T& value, std::int32_t min, std::int32_t max) { writeInt(static_cast<std::int32_t>(value), min, max); return true; }
+
+                template <typename T>
+                bool serialiseVarint(T& value) { writeVarint(static_cast<std::uint32_t>(value)); return true; }
+
+                template <typename T>
+                bool serialiseSignedVarint(T& value) { writeSignedVarint(static_cast<std::int32_t>(value)); return true; }
+
+                bool serialiseFloat(float& value) { writeFloat(value); return true; }
+                bool serialiseFloat(float& value, float min, float max, float precision) { writeFloat(value, min, max, precision); return true; }
+                bool serialiseVec3(glm::vec3& value, float min, float max, float precision) { writeVec3(value, min, max, precision); return true; }
+                bool serialiseQuat(glm::quat& value, std::uint32_t bitsPerComponent = 10) { writeQuat(value, bitsPerComponent); return true; }
+
+            private:
+                std::vector<std::uint8_t> m_data;
+                std::size_t m_bitCount = 0;
+            };
+
+            /*!
+            \brief Reads values written with a BitWriter.
+            All reads are bounds checked, and values read with a range are validated
+            against it. A read which fails returns false, sets the error flag and
+            leaves the destination unmodified, and all subsequent reads also fail.
+            This means malformed or malicious packets can be safely rejected by
+            checking the result of serialise(), or hasError() once all values are read.
+            \see BitWriter
+            */
+            class CRO_EXPORT_API BitReader final
+            {
+            public:
+                /*!
+                \brief Constructor.
+                \param data Pointer to the data to read. This must remain
+                valid for the lifetime of the reader
+                \param size Size of the data in bytes
+                */
+                BitReader(const void* data, std::size_t size);
+
+                bool readBits(std::uint32_t& dst, std::uint32_t bitCount);
+                bool readBool(bool& dst);
+                bool readInt(std::int32_t& dst, std::int32_t min, std::int32_t max);
+                bool readVarint(std::uint32_t& dst);
+                bool readSignedVarint(std::int32_t& dst);
+                bool readFloat(float& dst);
+                bool readFloat(float& dst, float min, float max, float precision);
+                bool readVec3(glm::vec3& dst, float min, float max, float precision);
+                bool readQuat(glm::quat& dst, std::uint32_t bitsPerComponent = 10);
+
+                /*!
+                \brief Returns true if any read has failed
+                */
+                bool hasError() const { return m_error; }
+
+                /*!
+                \brief Returns the number of unread bits.
+                As the data is a whole number of bytes this may
+                include up to 7 bits of padding.
+                */
+                std::size_t getBitsRemaining() const { return m_bitSize - m_bitPosition; }
+
+                //serialise interface shared with BitWriter, see the class description
+                bool serialiseBool(bool& value) { return readBool(value); }
+
+                template <typename T>
+                bool serialiseInt(T& value, std::int32_t min, std::int32_t max)
+                {
+                    std::int32_t result = 0;
+                    if (readInt(result, min, max))
+                    {
+                        value = static_cast<T>(result);
+                        return true;
+                    }
+                    return false;
+                }
+
+                template <typename T>
+                bool serialiseVarint(T& value)
+                {
+                    std::uint32_t result = 0;
+                    if (readVarint(result))
+                    {
+                        value = static_cast<T>(result);
+                        return true;
+                    }
+                    return false;
+                }
+
+                template <typename T>
+                bool serialiseSignedVarint(T& value)
+                {
+                    std::int32_t result = 0;
+                    if (readSignedVarint(result))
+                    {
+                        value = static_cast<T>(result);
+                        return true;
+                    }
+                    return false;
+                }
+
+                bool serialiseFloat(float& value) { return readFloat(value); }
+                bool serialiseFloat(float& value, float min, float max, float precision) { return readFloat(value, min, max, precision); }
+                bool serialiseVec3(glm::vec3& value, float min, float max, float precision) { return readVec3(value, min, max, precision); }
+                bool serialiseQuat(glm::quat& value, std::uint32_t bitsPerComponent = 10) { return readQuat(value, bitsPerComponent); }
+
+            private:
+                const std::uint8_t* m_data;
+                std::size_t m_bitSize;
+                std::size_t m_bitPosition;
+                bool m_error;
+            };
+
+            /*!
+            \brief Writes a struct which declares a serialise() function
+            \see BitWriter
+            */
+            template <typename T>
+            void write(BitWriter& writer, T data)
+            {
+                data.serialise(writer);
+            }
+
+            /*!
+            \brief Reads a struct which declares a serialise() function
+            \returns false if the data is invalid, in which case the
+            contents of dst are undefined.
+            \see BitReader
+            */
+            template <typename T>
+            bool read(BitReader& reader, T& dst)
+            {
+                return dst.serialise(reader) && !reader.hasError();
+            }
+        }
+    }
+}
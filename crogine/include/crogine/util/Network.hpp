@@ -30,6 +30,7 @@ source distribution.
 #pragma once
 
 #include <crogine/Config.hpp>
+#include <crogine/util/BitStream.hpp>
 
 #include <crogine/detail/glm/gtc/quaternion.hpp>
 #include <crogine/detail/glm/vec3.hpp>
@@ -34,6 +34,7 @@ source distribution.
 #include <crogine/core/ConfigFile.hpp>
 #include <crogine/core/SysTime.hpp>
 #include <crogine/core/HiResTimer.hpp>
+#include <crogine/core/Profiler.hpp>
 #include <crogine/detail/Assert.hpp>
 #include <crogine/audio/AudioMixer.hpp>
 #include <crogine/gui/Gui.hpp>
@@ -151,6 +152,7 @@ App::App(std::uint32_t styleFlags)
     : m_windowStyleFlags(styleFlags),
     m_frameClock        (nullptr),
     m_running           (false),
+    m_headless          ((styleFlags & Headless) != 0),
     m_controllerCount   (0),
     m_orgString         ("Trederia"),
     m_appString         ("CrogineApp")
@@ -165,7 +167,8 @@ App::App(std::uint32_t styleFlags)
 #define INIT_FLAGS SDL_INIT_EVERYTHING
 #endif
 
-    if (SDL_Init(INIT_FLAGS) < 0)
+    //headless apps only need the timer and event loop (for SDL_QUIT)
+    if (SDL_Init(m_headless ? (SDL_INIT_TIMER | SDL_INIT_EVENTS) : INIT_FLAGS) < 0)
     {
         const std::string err(SDL_GetError());
         Logger::log("Failed init: " + err, Logger::Type::Error, cro::Logger::Output::All);
@@ -208,7 +211,8 @@ App::App(std::uint32_t styleFlags)
         //    }
         //}
 
-        if (!AudioRenderer::init())
+        if (!m_headless
+            && !AudioRenderer::init())
         {
             Logger::log("Failed to initialise audio renderer", Logger::Type::Error);
         }
@@ -229,7 +233,10 @@ App::App(std::uint32_t styleFlags)
 
 App::~App()
 {
-    AudioRenderer::shutdown();
+    if (!m_headless)
+    {
+        AudioRenderer::shutdown();
+    }
     
     for (auto js : m_joysticks)
     {
@@ -257,6 +264,12 @@ void App::run()
 
     LogI << "Using SDL " << (int)v.major << "." << (int)v.minor << "." << (int)v.patch << std::endl;
 
+    if (m_headless)
+    {
+        runHeadless();
+        return;
+    }
+
     auto settings = loadSettings();
     glm::uvec2 size = settings.fullscreen ? glm::uvec2(settings.windowedSize) : glm::uvec2(settings.width, settings.height);
 
@@ -314,10 +327,12 @@ void App::run()
 
     while (m_running)
     {
+        Profiler::newFrame();
         timeSinceLastUpdate += frameClock.restart();
 
         while (timeSinceLastUpdate > frameTime)
         {
+            CRO_PROFILE_SCOPE("App::simulate");
             timeSinceLastUpdate -= frameTime;
 
             Console::newFrame();
@@ -328,17 +343,28 @@ void App::run()
             simulate(frameTime);
         }
         //DPRINT("Frame time", std::to_string(timeSinceLastUpdate.asMilliseconds()));
-        doImGui();
+        {
+            CRO_PROFILE_SCOPE("App::doImGui");
+            doImGui();
+        }
+
+        {
+            CRO_PROFILE_SCOPE("App::render");
+            CRO_PROFILE_GPU_SCOPE("App::render");
 
-        ImGui::Render();
-        m_window.clear();
-        render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            ImGui::Render();
+            m_window.clear();
+            render();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
+
+        CRO_PROFILE_SCOPE("Window::display");
         m_window.display();
     }
 
     saveSettings();
 
+    Profiler::finalise();
     Console::finalise();
     m_messageBus.disable(); //prevents spamming a load of quit messages
     finalise();
@@ -351,6 +377,10 @@ void App::run()
 void App::setClearColour(Colour colour)
 {
     m_clearColour = colour;
+    if (m_headless)
+    {
+        return;
+    }
     glCheck(glClearColor(colour.getRed(), colour.getGreen(), colour.getBlue(), colour.getAlpha()));
 }
 
@@ -397,6 +427,11 @@ bool App::isValid()
     return m_instance != nullptr;
 }
 
+bool App::isHeadless()
+{
+    return m_instance == nullptr || m_instance->m_headless;
+}
+
 //protected
 void App::setApplicationStrings(const std::string& organisation, const std::string& appName)
 {
@@ -570,6 +605,53 @@ void App::handleMessages()
     }
 }
 
+void App::runHeadless()
+{
+    //no window, context, gui or console - just the fixed
+    //update loop, which sleeps between steps rather than spinning
+    HiResTimer frameClock;
+    m_frameClock = &frameClock;
+    m_running = initialise();
+
+    float timeSinceLastUpdate = 0.f;
+
+    while (m_running)
+    {
+        Profiler::newFrame();
+        timeSinceLastUpdate += frameClock.restart();
+
+        while (timeSinceLastUpdate > frameTime)
+        {
+            CRO_PROFILE_SCOPE("App::simulate");
+            timeSinceLastUpdate -= frameTime;
+
+            cro::Event evt;
+            while (SDL_PollEvent(&evt))
+            {
+                handleEvent(evt);
+
+                //raised by SDL on SIGINT/SIGTERM
+                if (evt.type == SDL_QUIT)
+                {
+                    quit();
+                }
+            }
+            handleMessages();
+
+            simulate(frameTime);
+        }
+
+        const auto remain = static_cast<std::uint32_t>((frameTime - timeSinceLastUpdate) * 1000.f);
+        if (remain != 0)
+        {
+            SDL_Delay(remain);
+        }
+    }
+
+    m_messageBus.disable();
+    finalise();
+}
+
 void App::doImGui()
 {
     ImGui_ImplOpenGL3_NewFrame();
@@ -692,6 +774,12 @@ App::WindowSettings App::loadSettings()
 
 void App::saveSettings()
 {
+    if (m_headless)
+    {
+        //there's no window or mixer state worth saving
+        return;
+    }
+
     auto size = m_window.getSize();
 
     ConfigFile saveSettings;
@@ -39,6 +39,8 @@ source distribution.
 
 #include <sstream>
 #include <algorithm>
+#include <cstring>
+#include <string_view>
 
 using namespace cro;
 using json = nlohmann::json;
@@ -46,7 +48,6 @@ using json = nlohmann::json;
 namespace
 {
     const std::string indentBlock("    ");
-    std::size_t currentLine = 0;
 
     template <typename T>
     void addToObject(ConfigObject* dst, const std::string& key, json& value)
@@ -54,6 +55,145 @@ namespace
         T v = value;
         dst->addProperty(key).setValue(v);
     }
+
+    //splits a buffer containing the entire file into lines. Each line
+    //is cleaned in place, removing line endings, tabs, comments and
+    //leading white space, so no intermediate strings are created.
+    class LineReader final
+    {
+    public:
+        LineReader(char* begin, char* end)
+            : m_current(begin), m_end(end) {}
+
+        bool eof() const { return m_current == m_end; }
+
+        std::string_view nextLine()
+        {
+            if (eof())
+            {
+                return {};
+            }
+
+            auto* lineStart = m_current;
+            auto* lineEnd = static_cast<char*>(std::memchr(m_current, '\n', m_end - m_current));
+            if (lineEnd)
+            {
+                m_current = lineEnd + 1;
+            }
+            else
+            {
+                lineEnd = m_end;
+                m_current = m_end;
+            }
+            m_lineNumber++;
+
+            //remove any tabs or carriage returns
+            lineEnd = std::remove_if(lineStart, lineEnd, [](char c) {return c == '\t' || c == '\r'; });
+            std::string_view line(lineStart, lineEnd - lineStart);
+
+            //make sure to only crop comments outside of string literals
+            auto quotePos = line.find_last_of('\"');
+            auto commentPos = line.find("//", quotePos == std::string_view::npos ? 0 : quotePos);
+            if (commentPos != std::string_view::npos)
+            {
+                line = line.substr(0, commentPos);
+            }
+
+            //and preceding spaces
+            auto start = line.find_first_not_of(' ');
+            line = (start == std::string_view::npos) ? std::string_view() : line.substr(start);
+
+            if (line.find(';') != std::string_view::npos)
+            {
+                LogW << "Line " << m_lineNumber << " contains semi-colon, is this intentional?" << std::endl;
+            }
+
+            return line;
+        }
+
+    private:
+        char* m_current;
+        char* m_end;
+        std::size_t m_lineNumber = 0;
+    };
+
+    bool isProperty(std::string_view line)
+    {
+        auto pos = line.find('=');
+        return(pos != std::string_view::npos && pos > 1 && line.length() > 5);
+    }
+
+    ConfigObject::NameValue getObjectName(std::string_view line)
+    {
+        auto result = line.find(' ');
+        if (result != std::string_view::npos)
+        {
+            auto first = line.substr(0, result);
+            auto second = line.substr(result + 1);
+            //make sure id has no spaces by truncating it
+            second = second.substr(0, second.find(' '));
+
+            return std::make_pair(std::string(first), std::string(second));
+        }
+        return std::make_pair(std::string(line), std::string());
+    }
+
+    ConfigObject::NameValue getPropertyName(std::string_view line)
+    {
+        auto result = line.find('=');
+        CRO_ASSERT(result != std::string_view::npos, "");
+
+        std::string first;
+        first.reserve(result);
+        for (auto c : line.substr(0, result))
+        {
+            if (c != ' ')
+            {
+                first.push_back(c);
+            }
+        }
+
+        auto value = line.substr(result + 1);
+        std::string second;
+
+        //check for string literal
+        result = value.find('\"');
+        if (result != std::string_view::npos)
+        {
+            auto otherResult = value.find_last_of('\"');
+            if (otherResult != result)
+            {
+                value = value.substr(result + 1, otherResult - (result + 1));
+                second.reserve(value.size());
+                for (auto c : value)
+                {
+                    if (c != '\"')
+                    {
+                        second.push_back(c);
+                    }
+                }
+                if (!second.empty() && second[0] == '/') second.erase(0, 1);
+            }
+            else
+            {
+                Logger::log("String property \'" + first + "\' has missing \'\"\', value may not be as expected", Logger::Type::Warning);
+                second = value;
+            }
+        }
+        else
+        {
+            second.reserve(value.size());
+            for (auto c : value)
+            {
+                if (c != ' ')
+                {
+                    second.push_back(c);
+                }
+            }
+        }
+
+        return std::make_pair(std::move(first), std::move(second));
+    }
 }
 
 //--------------------//
@@ -64,59 +204,70 @@ ConfigProperty::ConfigProperty(const std::string& name, const std::string& value
     m_isStringValue = !value.empty()
         && ((value.front() == '\"' && value.back() == '\"')
         || value.find(' ') != std::string::npos);
+
+    parseFloatValues();
 }
 
 void ConfigProperty::setValue(const std::string& value)
 {
     m_value = value;
+    parseFloatValues();
     m_isStringValue = true;
 }
 
 void ConfigProperty::setValue(std::int32_t value)
 {
     m_value = std::to_string(value);
+    parseFloatValues();
     m_isStringValue = false;
 }
 
 void ConfigProperty::setValue(std::uint32_t value)
 {
     m_value = std::to_string(value);
+    parseFloatValues();
     m_isStringValue = false;
 }
 
 void ConfigProperty::setValue(float value)
 {
     m_value = std::to_string(value);
+    parseFloatValues();
     m_isStringValue = false;
 }
 
 void ConfigProperty::setValue(bool value)
 {
     m_value = (value) ? "true" : "false";
+    parseFloatValues();
     m_isStringValue = false;
 }
 
 void ConfigProperty::setValue(const glm::vec2& v)
 {
     m_value = std::to_string(v.x) + "," + std::to_string(v.y);
+    parseFloatValues();
     m_isStringValue = false;
 }
 
 void ConfigProperty::setValue(const glm::vec3& v)
 {
     m_value = std::to_string(v.x) + "," + std::to_string(v.y) + "," + std::to_string(v.z);
+    parseFloatValues();
     m_isStringValue = false;
 }
 
 void ConfigProperty::setValue(const glm::vec4& v)
 {
     m_value = std::to_string(v.x) + "," + std::to_string(v.y) + "," + std::to_string(v.z) + "," + std::to_string(v.w);
+    parseFloatValues();
     m_isStringValue = false;
 }
 
 void ConfigProperty::setValue(const cro::FloatRect& r)
 {
     m_value = std::to_string(r.left) + "," + std::to_string(r.bottom) + "," + std::to_string(r.width) + "," + std::to_string(r.height);
+    parseFloatValues();
     m_isStringValue = false;
 }
 
@@ -126,32 +277,29 @@ void ConfigProperty::setValue(const cro::Colour& v)
     m_isStringValue = false;
 }
 
-std::vector<float> ConfigProperty::valueAsArray() const
+void ConfigProperty::parseFloatValues()
 {
-    std::vector<float> retval;
-    std::size_t start = 0u;
-    std::size_t next = m_value.find_first_of(',');
-    std::size_t end = std::min(m_value.length(), std::size_t(200));
+    //strtof rather than istringstream - this is called for every
+    //property as it is loaded, so avoid allocating anything
+    m_floatValues = {};
 
-    while (next != std::string::npos && start < end)
+    const char* str = m_value.c_str();
+    for (auto i = 0u; i < m_floatValues.size(); ++i)
     {
-        float val;
-        std::istringstream is(m_value.substr(start, next));
-        if (is >> val) retval.push_back(val);
-        else retval.push_back(0.f);
+        char* end = nullptr;
+        auto val = std::strtof(str, &end);
+        if (end != str)
+        {
+            m_floatValues[i] = val;
+        }
 
-        start = ++next;
-        next = m_value.find_first_of(',', start);
-        if (next > m_value.length()) next = m_value.length();
-    }
-    
-    //pack out to max supported size
-    while (retval.size() < 4)
-    {
-        retval.push_back(0.f);
+        str = std::strchr(end, ',');
+        if (str == nullptr)
+        {
+            break;
+        }
+        str++;
     }
-
-    return retval;
 }
 
 //-------------------------------------
@@ -162,7 +310,6 @@ ConfigObject::ConfigObject(const std::string& name, const std::string& id)
 bool ConfigObject::loadFromFile(const std::string& filePath, bool relative)
 {
     auto path = relative ? FileSystem::getResourcePath() + filePath : filePath;
-    currentLine = 0;
 
     m_id = "";
     setName("");
@@ -180,138 +327,128 @@ bool ConfigObject::loadFromFile(const std::string& filePath, bool relative)
     
     //fetch file size
     auto fileSize = SDL_RWsize(rr.file);
-    if (fileSize == 0)
+    if (fileSize < 1)
     {
         LOG(path + ": file empty", Logger::Type::Warning);
         return false;
     }
 
-    if (rr.file)
+    if (cro::FileSystem::getFileExtension(path) == ".json")
     {
-        if (cro::FileSystem::getFileExtension(path) == ".json")
-        {
-            return parseAsJson(rr.file);
-        }
+        return parseAsJson(rr.file);
+    }
 
-        //remove any opening comments
-        std::string data;
-        std::int64_t readTotal = 0;
-        static const std::int32_t DEST_SIZE = 256;
-        char dest[DEST_SIZE];
-        while (data.empty() && readTotal < fileSize)
-        {
-            data = std::string(Util::String::rwgets(dest, DEST_SIZE, rr.file, &readTotal));
-            removeComment(data);       
-        }
-        //check config is not opened with a property
-        if (isProperty(data))
-        {
-            Logger::log(path + ": Cannot start configuration file with a property", Logger::Type::Error);
-            return false;
-        }
-        
-        //make sure next line is a brace to ensure we have an object
-        std::string lastLine = data;
-        data = std::string(Util::String::rwgets(dest, DEST_SIZE, rr.file, &readTotal));
-        removeComment(data);
+    //read the whole file in one go and parse it in place
+    std::vector<char> buffer(static_cast<std::size_t>(fileSize));
+    if (SDL_RWread(rr.file, buffer.data(), buffer.size(), 1) != 1)
+    {
+        Logger::log(path + ": failed reading file", Logger::Type::Error);
+        return false;
+    }
 
-        //tracks brace balance
-        std::vector<ConfigObject*> objStack;
+    return parse(buffer.data(), buffer.data() + buffer.size(), path);
+}
 
-        if (data[0] == '{')
-        {
-            //we have our opening object
-            auto objectName = getObjectName(lastLine);
-            setName(objectName.first);
-            m_id = objectName.second;
-            
-            objStack.push_back(this);
-        }
-        else
-        {
-            Logger::log(path + " Invalid configuration header (missing '{' ?)", Logger::Type::Error);
-            return false;
-        }
+bool ConfigObject::parse(char* begin, char* end, const std::string& path)
+{
+    LineReader reader(begin, end);
 
+    //remove any opening comments
+    std::string_view line;
+    while (line.empty() && !reader.eof())
+    {
+        line = reader.nextLine();
+    }
 
-        while (readTotal < fileSize)
+    //check config is not opened with a property
+    if (isProperty(line))
+    {
+        Logger::log(path + ": Cannot start configuration file with a property", Logger::Type::Error);
+        return false;
+    }
+
+    //make sure next line is a brace to ensure we have an object
+    //(files may also open with an unnamed object)
+    std::string_view lastLine;
+    if (line.empty() || line[0] != '{')
+    {
+        lastLine = line;
+        line = reader.nextLine();
+    }
+
+    //tracks brace balance
+    std::vector<ConfigObject*> objStack;
+
+    if (!line.empty() && line[0] == '{')
+    {
+        //we have our opening object
+        auto objectName = getObjectName(lastLine);
+        setName(objectName.first);
+        m_id = objectName.second;
+
+        objStack.push_back(this);
+    }
+    else
+    {
+        Logger::log(path + " Invalid configuration header (missing '{' ?)", Logger::Type::Error);
+        return false;
+    }
+
+    while (!reader.eof()
+        && !objStack.empty())
+    {
+        line = reader.nextLine();
+        if (!line.empty())
         {
-            data = std::string(Util::String::rwgets(dest, DEST_SIZE, rr.file, &readTotal));
-            removeComment(data);
-            if (!data.empty())
+            if (line[0] == '}')
+            {
+                //close current object and move to parent
+                objStack.pop_back();
+            }
+            else if (isProperty(line))
             {
-                if (data[0] == '}')
+                //insert name / value property into current object
+                auto prop = getPropertyName(line);
+                //TODO need to reinstate this and create a property
+                //capable of storing arrays
+                /*if (currentObject->findProperty(prop.first))
                 {
-                    //close current object and move to parent
-                    objStack.pop_back();
-                }
-                else if (isProperty(data))
-                {           
-                    //insert name / value property into current object
-                    auto prop = getPropertyName(data);
-                    //TODO need to reinstate this and create a property
-                    //capable of storing arrays
-                    /*if (currentObject->findProperty(prop.first))
-                    {
-                        Logger::log("Property \'" + prop.first + "\' already exists in \'" + currentObject->getName() + "\', skipping entry...", Logger::Type::Warning);
-                        continue;
-                    }*/
+                    Logger::log("Property \'" + prop.first + "\' already exists in \'" + currentObject->getName() + "\', skipping entry...", Logger::Type::Warning);
+                    continue;
+                }*/
 
-                    if (prop.second.empty())
-                    {
-                        Logger::log("\'" + objStack.back()->getName() + "\' property \'" + prop.first + "\' has no valid value", Logger::Type::Warning);
-                        continue;
-                    }
-                    objStack.back()->addProperty(prop.first, prop.second);
+                if (prop.second.empty())
+                {
+                    Logger::log("\'" + objStack.back()->getName() + "\' property \'" + prop.first + "\' has no valid value", Logger::Type::Warning);
+                    continue;
                 }
-                else
+                objStack.back()->addProperty(prop.first, prop.second);
+            }
+            else
+            {
+                //add a new object and make it current
+                auto prevLine = line;
+                line = reader.nextLine();
+                if (!line.empty() && line[0] == '{')
                 {
-                    //add a new object and make it current
-                    std::string prevLine = data;
-                    data = std::string(Util::String::rwgets(dest, DEST_SIZE, rr.file, &readTotal));
-                    removeComment(data);
-                    if (data[0] == '{')
-                    {
-                        //TODO we have to allow mutliple objects with the same name in this instance
-                        //as a model may have multiple material defs.
-                        auto name = getObjectName(prevLine);
-                        //if (name.second.empty() || objStack.back()->findObjectWithId(name.second) == nullptr)
-                        //{
-                        //    //safe to add new object as the name doesn't exist
-                        //    objStack.push_back(objStack.back()->addObject(name.first, name.second));
-                        //}
-                        //else
-                        //{
-                        //    Logger::log("Object with ID " + name.second + " has already been added, duplicate is skipped...", Logger::Type::Warning);
-
-                        //    //fast forward to closing brace
-                        //    while (data[0] != '}')
-                        //    {
-                        //        data = std::string(Util::String::rwgets(dest, DEST_SIZE, rr.file, &readTotal));
-                        //        removeComment(data);
-                        //    }
-                        //}
-
-                        objStack.push_back(objStack.back()->addObject(name.first, name.second));
-                    }
-                    else //last line was probably garbage or nothing but spaces
-                    {
-                        //LogW << filePath << ": Missing line or incorrect syntax at " << currentLine << std::endl;
-                        continue;
-                    }
+                    //TODO we have to allow mutliple objects with the same name in this instance
+                    //as a model may have multiple material defs.
+                    auto name = getObjectName(prevLine);
+                    objStack.push_back(objStack.back()->addObject(name.first, name.second));
+                }
+                else //last line was probably garbage or nothing but spaces
+                {
+                    continue;
                 }
-            }       
+            }
         }
+    }
 
-        if (!objStack.empty())
-        {
-            Logger::log("Brace count not at 0 after parsing \'" + path + "\'. Config data may not be correct.", Logger::Type::Warning);
-        }
-        return true;
+    if (!objStack.empty())
+    {
+        Logger::log("Brace count not at 0 after parsing \'" + path + "\'. Config data may not be correct.", Logger::Type::Warning);
     }
-    
-    Logger::log(filePath + " file invalid or not found.", Logger::Type::Error);
-    return false;
+    return true;
 }
 
 const std::string& ConfigObject::getId() const
@@ -321,10 +458,16 @@ const std::string& ConfigObject::getId() const
 
 ConfigProperty* ConfigObject::findProperty(const std::string& name) const
 {
+    return findProperty(name, std::hash<std::string>()(name));
+}
+
+ConfigProperty* ConfigObject::findProperty(const std::string& name, std::size_t hash) const
+{
+    //compare the hashes first so we only compare strings on a likely match
     auto result = std::find_if(m_properties.begin(), m_properties.end(),
-        [&name](const ConfigProperty& p)
+        [&name, hash](const ConfigProperty& p)
     {
-        return (p.getName() == name);
+        return (p.getNameHash() == hash && p.getName() == name);
     });
 
     if (result != m_properties.end())
@@ -334,7 +477,7 @@ ConfigProperty* ConfigObject::findProperty(const std::string& name) const
     //recurse
     for (auto& o : m_objects)
     {
-        auto p = o.findProperty(name);
+        auto p = o.findProperty(name, hash);
         if (p) return p;
     }
 
@@ -371,11 +514,16 @@ ConfigObject* ConfigObject::findObjectWithId(const std::string& id) const
 }
 
 ConfigObject* ConfigObject::findObjectWithName(const std::string& name) const
+{
+    return findObjectWithName(name, std::hash<std::string>()(name));
+}
+
+ConfigObject* ConfigObject::findObjectWithName(const std::string& name, std::size_t hash) const
 {
     auto result = std::find_if(m_objects.begin(), m_objects.end(),
-        [&name](const ConfigObject& p)
+        [&name, hash](const ConfigObject& p)
     {
-        return (p.getName() == name);
+        return (p.getNameHash() == hash && p.getName() == name);
     });
 
     if (result != m_objects.end())
@@ -386,7 +534,7 @@ ConfigObject* ConfigObject::findObjectWithName(const std::string& name) const
     //recurse
     for (auto& o : m_objects)
     {
-        auto p = o.findObjectWithName(name);
+        auto p = o.findObjectWithName(name, hash);
         if (p) return p;
     }
 
@@ -463,97 +611,6 @@ ConfigObject ConfigObject::removeObject(const std::string& name)
     return {};
 }
 
-ConfigObject::NameValue ConfigObject::getObjectName(const std::string& line)
-{
-    auto result = line.find_first_of(' ');
-    if (result != std::string::npos)
-    {
-        std::string first = line.substr(0, result);
-        std::string second = line.substr(result + 1);
-        //make sure id has no spaces by truncating it
-        result = second.find_first_of(' ');
-        if (result != std::string::npos)
-            second = second.substr(0, result);
-
-        return std::make_pair(first, second);
-    }
-    return std::make_pair(line, "");
-}
-
-ConfigObject::NameValue ConfigObject::getPropertyName(const std::string& line)
-{
-    auto result = line.find_first_of("=");
-    assert(result != std::string::npos);
-
-    std::string first = line.substr(0, result);
-    Util::String::removeChar(first, ' ');
-
-    std::string second = line.substr(result + 1);
-    
-    //check for string literal
-    result = second.find_first_of("\"");
-    if (result != std::string::npos)
-    {
-        auto otherResult = second.find_last_of("\"");
-        if (otherResult != std::string::npos
-            && otherResult != result)
-        {
-            second = second.substr(result, otherResult);
-            Util::String::removeChar(second, '\"');
-            if (second[0] == '/') second = second.substr(1);
-        }
-        else
-        {
-            Logger::log("String property \'" + first + "\' has missing \'\"\', value may not be as expected", Logger::Type::Warning);
-        }
-    }
-    else
-    {
-        Util::String::removeChar(second, ' ');
-    }
-
-    return std::make_pair(first, second);
-}
-
-bool ConfigObject::isProperty(const std::string& line)
-{
-    auto pos = line.find('=');
-    return(pos != std::string::npos && pos > 1 && line.length() > 5);
-}
-
-void ConfigObject::removeComment(std::string& line)
-{
-    auto result = line.find_first_of("//");
-
-    //make sure to only crop comments outside of string literals
-    //for some reason it appears result also matches '/' so unquoted paths get truncated
-    if (result < line.size() - 1 && line[result + 1] == '/')
-    {
-        auto otherResult = line.find_last_of('\"');
-        if (result != std::string::npos && (result > otherResult || otherResult == std::string::npos))
-        {
-            line = line.substr(0, result);
-        }
-    }
-
-    //remove any tabs while we're at it
-    Util::String::removeChar(line, '\t');
-    //Util::String::removeChar(line, ' ');
-
-    //and preceding spaces
-    auto start = line.find_first_not_of(' ');
-    if (start != std::string::npos)
-    {
-        line = line.substr(start);
-    }
-
-    if (line.find(';') != std::string::npos)
-    {
-        LogW << "Line " << currentLine << " contains semi-colon, is this intentional?" << std::endl;
-    }
-    currentLine++;
-}
-
 bool ConfigObject::parseAsJson(SDL_RWops* file)
 {
     json j;
@@ -749,7 +806,8 @@ std::size_t ConfigObject::write(SDL_RWops* file, std::uint16_t depth)
 //--------------------//
 ConfigItem::ConfigItem(const std::string& name)
     : m_parent  (nullptr),
-    m_name      (name){}
+    m_name      (name),
+    m_nameHash  (std::hash<std::string>()(name)){}
 
 ConfigItem* ConfigItem::getParent() const
 {
@@ -769,4 +827,5 @@ void ConfigItem::setParent(ConfigItem* parent)
 void ConfigItem::setName(const std::string& name)
 {
     m_name = name;
+    m_nameHash = std::hash<std::string>()(name);
 }
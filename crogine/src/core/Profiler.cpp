@@ -0,0 +1,436 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include <crogine/core/Profiler.hpp>
+#include <crogine/core/App.hpp>
+#include <crogine/core/Log.hpp>
+#include <crogine/detail/Types.hpp>
+
+#include "../detail/GLCheck.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+using namespace cro;
+
+namespace
+{
+    constexpr std::size_t DefaultFrameCapacity = 120;
+    constexpr std::uint32_t NoQuery = std::numeric_limits<std::uint32_t>::max();
+
+    //GPU scopes are dropped rather than growing the pool if
+    //results are being collected more slowly than they're queued
+    constexpr std::size_t MaxPendingQueries = 1024;
+
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point Epoch = Clock::now();
+
+    std::int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - Epoch).count();
+    }
+
+    struct ProfileEvent final
+    {
+        const char* name = nullptr;
+        std::int64_t start = 0; //ns since Epoch
+        std::int64_t duration = 0;
+        std::uint64_t frame = 0;
+    };
+
+    struct ThreadData final
+    {
+        std::mutex mutex;
+        std::deque<ProfileEvent> events;
+        const char* name = "Worker";
+        std::uint32_t id = 0;
+    };
+
+    std::atomic<bool> enabled(true);
+    std::atomic<std::uint64_t> frameIndex(0);
+    std::atomic<std::size_t> frameCapacity(DefaultFrameCapacity);
+
+    //thread data is never freed so that events recorded by a thread
+    //remain available to saveTrace() after the thread has exited
+    std::mutex threadMutex;
+    std::vector<std::unique_ptr<ThreadData>> threads;
+
+    ThreadData* acquireThreadData()
+    {
+        std::scoped_lock lock(threadMutex);
+        auto& data = threads.emplace_back(std::make_unique<ThreadData>());
+        data->id = static_cast<std::uint32_t>(threads.size());
+        return data.get();
+    }
+
+    ThreadData& getThreadData()
+    {
+        thread_local ThreadData* data = acquireThreadData();
+        return *data;
+    }
+
+    void record(ThreadData& data, const ProfileEvent& evt)
+    {
+        const auto capacity = frameCapacity.load(std::memory_order_relaxed);
+
+        std::scoped_lock lock(data.mutex);
+        while (!data.events.empty()
+            && data.events.front().frame + capacity <= evt.frame)
+        {
+            data.events.pop_front();
+        }
+        data.events.push_back(evt);
+    }
+
+    //GPU scopes are recorded on their own lane, with id 0
+    ThreadData gpuData;
+
+    struct PendingQuery final
+    {
+        const char* name = nullptr;
+        std::uint32_t query = NoQuery; //index of the begin query, end query is next
+        std::int64_t offset = 0; //GPU clock - CPU clock when recorded
+        std::uint64_t frame = 0;
+    };
+
+    std::vector<std::uint32_t> queryPool; //pairs of query objects
+    std::vector<std::uint32_t> freeQueries;
+    std::deque<PendingQuery> pendingQueries;
+    std::int64_t gpuClockOffset = 0;
+    bool gpuCalibrated = false;
+
+    bool gpuAvailable()
+    {
+#ifdef PLATFORM_DESKTOP
+        return !App::isHeadless() && glQueryCounter != nullptr;
+#else
+        return false;
+#endif
+    }
+
+    void calibrateGpuClock()
+    {
+#ifdef PLATFORM_DESKTOP
+        GLint64 gpuTime = 0;
+        glCheck(glGetInteger64v(GL_TIMESTAMP, &gpuTime));
+        gpuClockOffset = static_cast<std::int64_t>(gpuTime) - now();
+        gpuCalibrated = true;
+#endif
+    }
+
+    void collectGpuQueries()
+    {
+#ifdef PLATFORM_DESKTOP
+        //results arrive in submission order so stop at the first which isn't ready
+        while (!pendingQueries.empty())
+        {
+            const auto& pending = pendingQueries.front();
+
+            GLuint available = GL_FALSE;
+            glCheck(glGetQueryObjectuiv(queryPool[pending.query + 1], GL_QUERY_RESULT_AVAILABLE, &available));
+            if (!available)
+            {
+                break;
+            }
+
+            GLuint64 begin = 0;
+            GLuint64 end = 0;
+            glCheck(glGetQueryObjectui64v(queryPool[pending.query], GL_QUERY_RESULT, &begin));
+            glCheck(glGetQueryObjectui64v(queryPool[pending.query + 1], GL_QUERY_RESULT, &end));
+
+            ProfileEvent evt;
+            evt.name = pending.name;
+            evt.start = static_cast<std::int64_t>(begin) - pending.offset;
+            evt.duration = static_cast<std::int64_t>(end - begin);
+            evt.frame = pending.frame;
+            record(gpuData, evt);
+
+            freeQueries.push_back(pending.query);
+            pendingQueries.pop_front();
+        }
+#endif
+    }
+
+    void writeEscaped(std::ostream& stream, const char* str)
+    {
+        for (; *str != 0; ++str)
+        {
+            if (*str == '"' || *str == '\\')
+            {
+                stream << '\\';
+            }
+
+            if (static_cast<unsigned char>(*str) >= 0x20)
+            {
+                stream << *str;
+            }
+        }
+    }
+}
+
+void Profiler::setEnabled(bool enable)
+{
+    enabled.store(enable, std::memory_order_relaxed);
+}
+
+bool Profiler::isEnabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void Profiler::setFrameCapacity(std::size_t frameCount)
+{
+    frameCapacity.store(std::max(std::size_t(1), frameCount), std::memory_order_relaxed);
+}
+
+std::size_t Profiler::getFrameCapacity()
+{
+    return frameCapacity.load(std::memory_order_relaxed);
+}
+
+std::uint64_t Profiler::getFrameIndex()
+{
+    return frameIndex.load(std::memory_order_relaxed);
+}
+
+void Profiler::setThreadName(const char* name)
+{
+    CRO_ASSERT(name, "Must not be nullptr");
+    getThreadData().name = name;
+}
+
+bool Profiler::saveTrace(const std::string& path)
+{
+    const auto frame = frameIndex.load(std::memory_order_relaxed);
+    const auto capacity = frameCapacity.load(std::memory_order_relaxed);
+    const auto firstFrame = frame >= capacity ? frame - capacity + 1 : 0;
+
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    const auto writeLane = [&](ThreadData& data)
+    {
+        std::scoped_lock lock(data.mutex);
+        if (data.events.empty())
+        {
+            return;
+        }
+
+        ss << (first ? "\n" : ",\n");
+        first = false;
+        ss << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << data.id << ",\"args\":{\"name\":\"";
+        if (&data == &gpuData)
+        {
+            ss << "GPU";
+        }
+        else
+        {
+            writeEscaped(ss, data.name);
+            ss << " " << data.id;
+        }
+        ss << "\"}}";
+
+        for (const auto& evt : data.events)
+        {
+            if (evt.frame < firstFrame)
+            {
+                continue;
+            }
+
+            //chrome traces are measured in microseconds
+            ss << ",\n{\"name\":\"";
+            writeEscaped(ss, evt.name);
+            ss << "\",\"cat\":\"" << (&data == &gpuData ? "gpu" : "cpu") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << data.id
+                << ",\"ts\":" << (static_cast<double>(evt.start) / 1000.0)
+                << ",\"dur\":" << (static_cast<double>(evt.duration) / 1000.0)
+                << ",\"args\":{\"frame\":" << evt.frame << "}}";
+        }
+    };
+
+    {
+        std::scoped_lock lock(threadMutex);
+        for (auto& data : threads)
+        {
+            writeLane(*data);
+        }
+    }
+    writeLane(gpuData);
+
+    ss << "\n]}\n";
+
+    RaiiRWops file;
+    file.file = SDL_RWFromFile(path.c_str(), "w");
+    if (!file.file)
+    {
+        LogE << "Failed opening " << path << " for writing: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    const auto str = ss.str();
+    if (SDL_RWwrite(file.file, str.data(), str.size(), 1) != 1)
+    {
+        LogE << "Failed writing profiler trace to " << path << std::endl;
+        return false;
+    }
+
+    LogI << "Saved profiler trace of " << (frame - firstFrame + 1) << " frames to " << path << std::endl;
+    return true;
+}
+
+void Profiler::clear()
+{
+    std::scoped_lock lock(threadMutex);
+    for (auto& data : threads)
+    {
+        std::scoped_lock dataLock(data->mutex);
+        data->events.clear();
+    }
+
+    std::scoped_lock gpuLock(gpuData.mutex);
+    gpuData.events.clear();
+}
+
+//scopes
+Profiler::CpuScope::CpuScope(const char* name)
+    : m_name    (nullptr),
+    m_start     (0)
+{
+    if (enabled.load(std::memory_order_relaxed))
+    {
+        m_name = name;
+        m_start = now();
+    }
+}
+
+Profiler::CpuScope::~CpuScope()
+{
+    if (m_name)
+    {
+        ProfileEvent evt;
+        evt.name = m_name;
+        evt.start = m_start;
+        evt.duration = now() - m_start;
+        evt.frame = frameIndex.load(std::memory_order_relaxed);
+        record(getThreadData(), evt);
+    }
+}
+
+Profiler::GpuScope::GpuScope(const char* name)
+    : m_name    (nullptr),
+    m_query     (NoQuery)
+{
+#ifdef PLATFORM_DESKTOP
+    if (enabled.load(std::memory_order_relaxed)
+        && pendingQueries.size() < MaxPendingQueries
+        && gpuAvailable())
+    {
+        if (freeQueries.empty())
+        {
+            const auto first = static_cast<std::uint32_t>(queryPool.size());
+            queryPool.resize(queryPool.size() + 2);
+            glCheck(glGenQueries(2, &queryPool[first]));
+            freeQueries.push_back(first);
+        }
+
+        if (!gpuCalibrated)
+        {
+            calibrateGpuClock();
+        }
+
+        m_name = name;
+        m_query = freeQueries.back();
+        freeQueries.pop_back();
+
+        glCheck(glQueryCounter(queryPool[m_query], GL_TIMESTAMP));
+    }
+#endif
+}
+
+Profiler::GpuScope::~GpuScope()
+{
+#ifdef PLATFORM_DESKTOP
+    if (m_query != NoQuery)
+    {
+        glCheck(glQueryCounter(queryPool[m_query + 1], GL_TIMESTAMP));
+
+        auto& pending = pendingQueries.emplace_back();
+        pending.name = m_name;
+        pending.query = m_query;
+        pending.offset = gpuClockOffset;
+        pending.frame = frameIndex.load(std::memory_order_relaxed);
+    }
+#endif
+}
+
+//private
+void Profiler::newFrame()
+{
+    static bool mainNamed = false;
+    if (!mainNamed)
+    {
+        setThreadName("Main");
+        mainNamed = true;
+    }
+
+    frameIndex.fetch_add(1, std::memory_order_relaxed);
+
+    if (!queryPool.empty())
+    {
+        collectGpuQueries();
+
+        //the clocks drift, so keep the offset up to date
+        calibrateGpuClock();
+    }
+}
+
+void Profiler::finalise()
+{
+#ifdef PLATFORM_DESKTOP
+    //called while the context is still valid
+    if (!queryPool.empty())
+    {
+        glCheck(glDeleteQueries(static_cast<GLsizei>(queryPool.size()), queryPool.data()));
+    }
+#endif
+    queryPool.clear();
+    freeQueries.clear();
+    pendingQueries.clear();
+    gpuCalibrated = false;
+}
@@ -32,12 +32,182 @@ source distribution.
 
 #include <crogine/ecs/components/Transform.hpp>
 
+#include <algorithm>
+#include <array>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CRO_TREE_SSE
+#include <emmintrin.h>
+#endif
+
 using namespace cro;
 using namespace cro::Detail;
 
 namespace
 {
     const float DisplacementMultiplier = 2.f;
+
+    //when automatically updating, fewer than this fraction of moved
+    //leaves are reinserted individually
+    constexpr float ReinsertFraction = 0.05f;
+
+    //and more than this fraction rebuilds the tree, else the tree is refit
+    constexpr float RebuildFraction = 0.5f;
+
+    //refitted trees are rebuilt when the combined area of their
+    //nodes grows beyond this much of the area after the last build
+    constexpr float MaxRefitGrowth = 1.25f;
+
+    //number of bins used when evaluating the surface area heuristic
+    constexpr std::size_t BinCount = 16;
+
+    //branches deeper than this are split at the median to guarantee the depth
+    constexpr std::int32_t MaxBuildDepth = 64;
+
+    float surfaceArea(glm::vec3 minBounds, glm::vec3 maxBounds)
+    {
+        const auto size = maxBounds - minBounds;
+        return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    //number of areas tested per traversal by a batched query
+    constexpr std::size_t BatchSize = 32;
+
+    //traversal stack which only touches the heap should the
+    //tree be deeper than the fixed storage allows
+    template <typename T>
+    class TreeStack final
+    {
+    public:
+        void push(T data)
+        {
+            if (m_size < m_data.size())
+            {
+                m_data[m_size] = data;
+            }
+            else
+            {
+                m_overflow.push_back(data);
+            }
+            m_size++;
+        }
+
+        T pop()
+        {
+            CRO_ASSERT(m_size != 0, "Stack is empty!");
+            m_size--;
+
+            if (m_size < m_data.size())
+            {
+                return m_data[m_size];
+            }
+
+            auto retVal = m_overflow.back();
+            m_overflow.pop_back();
+            return retVal;
+        }
+
+        bool empty() const
+        {
+            return m_size == 0;
+        }
+
+    private:
+        std::array<T, 256> m_data = {};
+        std::vector<T> m_overflow;
+        std::size_t m_size = 0;
+    };
+
+    //spreads the lower 10 bits of a value so that every third bit is used
+    std::uint32_t interleave(std::uint32_t v)
+    {
+        v &= 0x3ff;
+        v = (v | (v << 16)) & 0x030000ff;
+        v = (v | (v << 8)) & 0x0300f00f;
+        v = (v | (v << 4)) & 0x030c30c3;
+        v = (v | (v << 2)) & 0x09249249;
+        return v;
+    }
+
+    bool isCandidate(const TreeNode& node, std::uint64_t filter)
+    {
+        return (node.filterFlags & filter) && node.entity.isValid();
+    }
+
+    //adds all the leaves below the given node without further testing
+    void addSubtree(const std::vector<TreeNode>& nodes, std::int32_t treeID, std::uint64_t filter, std::vector<Entity>& dst)
+    {
+        TreeStack<std::int32_t> stack;
+        stack.push(treeID);
+
+        while (!stack.empty())
+        {
+            const auto& node = nodes[stack.pop()];
+            if (node.isLeaf())
+            {
+                if (isCandidate(node, filter))
+                {
+                    dst.push_back(node.entity);
+                }
+            }
+            else
+            {
+                stack.push(node.childA);
+                stack.push(node.childB);
+            }
+        }
+    }
+
+    //areas stored as structure of arrays so that 4 can be tested at once
+    struct QueryBatch final
+    {
+        alignas(16) std::array<float, BatchSize> minX = {};
+        alignas(16) std::array<float, BatchSize> minY = {};
+        alignas(16) std::array<float, BatchSize> minZ = {};
+        alignas(16) std::array<float, BatchSize> maxX = {};
+        alignas(16) std::array<float, BatchSize> maxY = {};
+        alignas(16) std::array<float, BatchSize> maxZ = {};
+
+        //returns a bit set for each active area which intersects the box
+        std::uint32_t intersects(const Box& box, std::uint32_t active) const
+        {
+            std::uint32_t retVal = 0;
+#ifdef CRO_TREE_SSE
+            const auto boxMinX = _mm_set1_ps(box[0].x);
+            const auto boxMinY = _mm_set1_ps(box[0].y);
+            const auto boxMinZ = _mm_set1_ps(box[0].z);
+            const auto boxMaxX = _mm_set1_ps(box[1].x);
+            const auto boxMaxY = _mm_set1_ps(box[1].y);
+            const auto boxMaxZ = _mm_set1_ps(box[1].z);
+
+            for (auto i = 0u; i < BatchSize; i += 4)
+            {
+                if ((active >> i) & 0xf)
+                {
+                    auto result = _mm_and_ps(_mm_cmple_ps(_mm_load_ps(&minX[i]), boxMaxX), _mm_cmpge_ps(_mm_load_ps(&maxX[i]), boxMinX));
+                    result = _mm_and_ps(result, _mm_and_ps(_mm_cmple_ps(_mm_load_ps(&minY[i]), boxMaxY), _mm_cmpge_ps(_mm_load_ps(&maxY[i]), boxMinY)));
+                    result = _mm_and_ps(result, _mm_and_ps(_mm_cmple_ps(_mm_load_ps(&minZ[i]), boxMaxZ), _mm_cmpge_ps(_mm_load_ps(&maxZ[i]), boxMinZ)));
+
+                    retVal |= static_cast<std::uint32_t>(_mm_movemask_ps(result)) << i;
+                }
+            }
+#else
+            for (auto i = 0u; i < BatchSize; ++i)
+            {
+                if ((active >> i) & 1)
+                {
+                    const bool result = minX[i] <= box[1].x && maxX[i] >= box[0].x
+                        && minY[i] <= box[1].y && maxY[i] >= box[0].y
+                        && minZ[i] <= box[1].z && maxZ[i] >= box[0].z;
+
+                    retVal |= static_cast<std::uint32_t>(result) << i;
+                }
+            }
+#endif
+            return retVal & active;
+        }
+    };
 }
 
 BalancedTree::BalancedTree(float fattenAmount)
@@ -47,7 +217,8 @@ BalancedTree::BalancedTree(float fattenAmount)
     m_nodes         (m_nodeCapacity),
     m_freeList      (0),
     m_insertionCount(0),
-    m_fattenAmount  (fattenAmount)
+    m_fattenAmount  (fattenAmount),
+    m_builtAreaRatio(0.f)
 {
     CRO_ASSERT(fattenAmount > 0, "Must be a positive value");
 
@@ -61,7 +232,7 @@ BalancedTree::BalancedTree(float fattenAmount)
 }
 
 //public
-std::int32_t BalancedTree::addToTree(Entity entity, Box bounds)
+std::int32_t BalancedTree::addToTree(Entity entity, Box bounds, std::uint64_t filterFlags)
 {
     auto treeID = allocateNode();
 
@@ -78,6 +249,7 @@ std::int32_t BalancedTree::addToTree(Entity entity, Box bounds)
     m_nodes[treeID].fatBounds = bounds;
     m_nodes[treeID].entity = entity;
     m_nodes[treeID].height = 0;
+    m_nodes[treeID].filterFlags = filterFlags;
 
     insertLeaf(treeID);
 
@@ -93,6 +265,226 @@ void BalancedTree::removeFromTree(std::int32_t treeID)
     freeNode(treeID);
 }
 
+void BalancedTree::setFilterFlags(std::int32_t treeID, std::uint64_t flags)
+{
+    CRO_ASSERT(treeID > -1 && treeID < m_nodeCapacity, "Invalid tree id");
+    CRO_ASSERT(m_nodes[treeID].isLeaf(), "Not a leaf node!");
+
+    m_nodes[treeID].filterFlags = flags;
+}
+
+std::uint64_t BalancedTree::getFilterFlags(std::int32_t treeID) const
+{
+    CRO_ASSERT(treeID > -1 && treeID < m_nodeCapacity, "Invalid tree id");
+    return m_nodes[treeID].filterFlags;
+}
+
+void BalancedTree::query(const Box& area, std::uint64_t filter, std::vector<Entity>& dst) const
+{
+    TreeStack<std::int32_t> stack;
+    stack.push(m_root);
+
+    while (!stack.empty())
+    {
+        auto treeID = stack.pop();
+        if (treeID == TreeNode::Null)
+        {
+            continue;
+        }
+
+        const auto& node = m_nodes[treeID];
+        if (area.intersects(node.fatBounds))
+        {
+            if (node.isLeaf())
+            {
+                if (isCandidate(node, filter))
+                {
+                    dst.push_back(node.entity);
+                }
+            }
+            else
+            {
+                stack.push(node.childA);
+                stack.push(node.childB);
+            }
+        }
+    }
+}
+
+void BalancedTree::query(const Sphere& sphere, std::uint64_t filter, std::vector<Entity>& dst) const
+{
+    TreeStack<std::int32_t> stack;
+    stack.push(m_root);
+
+    while (!stack.empty())
+    {
+        auto treeID = stack.pop();
+        if (treeID == TreeNode::Null)
+        {
+            continue;
+        }
+
+        const auto& node = m_nodes[treeID];
+        if (node.fatBounds.intersects(sphere))
+        {
+            if (node.isLeaf())
+            {
+                if (isCandidate(node, filter))
+                {
+                    dst.push_back(node.entity);
+                }
+            }
+            else
+            {
+                stack.push(node.childA);
+                stack.push(node.childB);
+            }
+        }
+    }
+}
+
+void BalancedTree::query(const Frustum& frustum, std::uint64_t filter, std::vector<Entity>& dst) const
+{
+    TreeStack<std::int32_t> stack;
+    stack.push(m_root);
+
+    while (!stack.empty())
+    {
+        auto treeID = stack.pop();
+        if (treeID == TreeNode::Null)
+        {
+            continue;
+        }
+
+        const auto& node = m_nodes[treeID];
+
+        bool inside = true;
+        bool outside = false;
+        for (const auto& plane : frustum)
+        {
+            auto result = Spatial::intersects(plane, node.fatBounds);
+            if (result == Planar::Back)
+            {
+                outside = true;
+                break;
+            }
+            inside = inside && (result == Planar::Front);
+        }
+
+        if (outside)
+        {
+            continue;
+        }
+
+        if (inside)
+        {
+            //no need to test anything further down this branch
+            addSubtree(m_nodes, treeID, filter, dst);
+        }
+        else if (node.isLeaf())
+        {
+            if (isCandidate(node, filter))
+            {
+                dst.push_back(node.entity);
+            }
+        }
+        else
+        {
+            stack.push(node.childA);
+            stack.push(node.childB);
+        }
+    }
+}
+
+void BalancedTree::queryRay(glm::vec3 origin, glm::vec3 direction, float length, std::uint64_t filter, std::vector<Entity>& dst) const
+{
+    //division by zero is fine here, the infinities resolve correctly in the slab test
+    const glm::vec3 invDirection = 1.f / direction;
+
+    const auto hit = [&](const Box& box)
+    {
+        const auto t0 = (box[0] - origin) * invDirection;
+        const auto t1 = (box[1] - origin) * invDirection;
+
+        const auto nearT = glm::min(t0, t1);
+        const auto farT = glm::max(t0, t1);
+
+        const auto enter = std::max(std::max(nearT.x, nearT.y), std::max(nearT.z, 0.f));
+        const auto exit = std::min(std::min(farT.x, farT.y), std::min(farT.z, length));
+
+        return enter <= exit;
+    };
+
+    TreeStack<std::int32_t> stack;
+    stack.push(m_root);
+
+    while (!stack.empty())
+    {
+        auto treeID = stack.pop();
+        if (treeID == TreeNode::Null)
+        {
+            continue;
+        }
+
+        const auto& node = m_nodes[treeID];
+        if (hit(node.fatBounds))
+        {
+            if (node.isLeaf())
+            {
+                if (isCandidate(node, filter))
+                {
+                    dst.push_back(node.entity);
+                }
+            }
+            else
+            {
+                stack.push(node.childA);
+                stack.push(node.childB);
+            }
+        }
+    }
+}
+
+void BalancedTree::queryPairs(std::uint64_t filter, std::vector<std::pair<Entity, Entity>>& dst) const
+{
+    //query the tree with the bounds of each leaf
+    std::vector<Box> areas;
+    std::vector<std::int32_t> leafIDs;
+    for (auto i = 0u; i < m_nodeCapacity; ++i)
+    {
+        const auto& leaf = m_nodes[i];
+        if (leaf.height == 0
+            && isCandidate(leaf, filter))
+        {
+            areas.push_back(leaf.fatBounds);
+            leafIDs.push_back(static_cast<std::int32_t>(i));
+        }
+    }
+
+    queryBatched(areas, filter, [&](std::size_t areaIndex, std::int32_t treeID)
+        {
+            //only report each pair once
+            if (treeID > leafIDs[areaIndex])
+            {
+                dst.emplace_back(m_nodes[leafIDs[areaIndex]].entity, m_nodes[treeID].entity);
+            }
+        });
+}
+
+void BalancedTree::query(const std::vector<Box>& areas, std::uint64_t filter, std::vector<std::vector<Entity>>& dst) const
+{
+    dst.resize(areas.size());
+    for (auto& results : dst)
+    {
+        results.clear();
+    }
+
+    queryBatched(areas, filter, [&](std::size_t areaIndex, std::int32_t treeID)
+        {
+            dst[areaIndex].push_back(m_nodes[treeID].entity);
+        });
+}
+
 //private
 bool BalancedTree::moveNode(std::int32_t treeID, Box worldArea, glm::vec3 displacement)
 {
@@ -106,7 +498,136 @@ bool BalancedTree::moveNode(std::int32_t treeID, Box worldArea, glm::vec3 displa
 
     removeLeaf(treeID);
 
-    //expand the new aabb and reinsert in tree
+    //reinsert
+    m_nodes[treeID].fatBounds = fatten(worldArea, displacement);
+    insertLeaf(treeID);
+
+    return true;
+}
+
+std::size_t BalancedTree::moveNodes(const std::vector<NodeUpdate>& updates, UpdateStrategy strategy)
+{
+    m_movedIDs.clear();
+    for (auto i = 0u; i < updates.size(); ++i)
+    {
+        const auto& update = updates[i];
+        if (update.treeID != TreeNode::Null)
+        {
+            CRO_ASSERT(update.treeID < m_nodeCapacity, "Invalid tree id");
+            CRO_ASSERT(m_nodes[update.treeID].isLeaf(), "Not a leaf node!");
+
+            if (!m_nodes[update.treeID].fatBounds.contains(update.worldBounds))
+            {
+                m_movedIDs.push_back(static_cast<std::int32_t>(i));
+            }
+        }
+    }
+
+    if (m_movedIDs.empty())
+    {
+        return 0;
+    }
+
+    const bool automatic = (strategy == UpdateStrategy::Automatic);
+    if (automatic)
+    {
+        //a full tree has one fewer branches than leaves
+        const auto leafCount = (m_nodeCount + 1) / 2;
+        const auto movedFraction = static_cast<float>(m_movedIDs.size()) / leafCount;
+
+        if (movedFraction < ReinsertFraction)
+        {
+            strategy = UpdateStrategy::Reinsert;
+        }
+        else if (movedFraction < RebuildFraction)
+        {
+            strategy = UpdateStrategy::Refit;
+        }
+        else
+        {
+            strategy = UpdateStrategy::Rebuild;
+        }
+    }
+
+    if (strategy == UpdateStrategy::Reinsert)
+    {
+        for (auto i : m_movedIDs)
+        {
+            moveNode(updates[i].treeID, updates[i].worldBounds, updates[i].displacement);
+        }
+    }
+    else
+    {
+        for (auto i : m_movedIDs)
+        {
+            m_nodes[updates[i].treeID].fatBounds = fatten(updates[i].worldBounds, updates[i].displacement);
+        }
+
+        if (strategy == UpdateStrategy::Refit)
+        {
+            if (m_builtAreaRatio == 0)
+            {
+                //use the tree as it was built by insertion as the baseline
+                m_builtAreaRatio = getAreaRatio();
+            }
+
+            refit();
+
+            if (automatic
+                && getAreaRatio() > m_builtAreaRatio * MaxRefitGrowth)
+            {
+                rebuild();
+            }
+        }
+        else
+        {
+            rebuild();
+        }
+    }
+
+    return m_movedIDs.size();
+}
+
+void BalancedTree::rebuild()
+{
+    if (m_root == TreeNode::Null)
+    {
+        return;
+    }
+
+    //internal nodes are all recreated, leaves keep their IDs
+    std::vector<BuildEntry> leaves;
+    leaves.reserve((m_nodeCount + 1) / 2);
+
+    for (auto i = 0u; i < m_nodeCapacity; ++i)
+    {
+        if (m_nodes[i].height == 0)
+        {
+            auto& entry = leaves.emplace_back();
+            entry.minBounds = m_nodes[i].fatBounds[0];
+            entry.maxBounds = m_nodes[i].fatBounds[1];
+            entry.centre = (entry.minBounds + entry.maxBounds) / 2.f;
+            entry.treeID = static_cast<std::int32_t>(i);
+        }
+        else if (m_nodes[i].height > 0)
+        {
+            freeNode(static_cast<std::int32_t>(i));
+        }
+    }
+
+    m_root = build(leaves.data(), leaves.size(), TreeNode::Null, 0);
+    m_builtAreaRatio = getAreaRatio();
+}
+
+Box BalancedTree::getFatAABB(std::int32_t treeID) const
+{
+    CRO_ASSERT(treeID > -1 && treeID < m_nodeCapacity, "Invalid tree id");
+    return m_nodes[treeID].fatBounds;
+}
+
+Box BalancedTree::fatten(Box worldArea, glm::vec3 displacement) const
+{
+    //expand the new aabb
     worldArea[0] -= m_fattenAmount;
     worldArea[1] += m_fattenAmount;
 
@@ -141,17 +662,7 @@ bool BalancedTree::moveNode(std::int32_t treeID, Box worldArea, glm::vec3 displa
         worldArea[1].z += displacement.z;
     }
 
-    //reinsert
-    m_nodes[treeID].fatBounds = worldArea;
-    insertLeaf(treeID);
-
-    return true;
-}
-
-Box BalancedTree::getFatAABB(std::int32_t treeID) const
-{
-    CRO_ASSERT(treeID > -1 && treeID < m_nodeCapacity, "Invalid tree id");
-    return m_nodes[treeID].fatBounds;
+    return worldArea;
 }
 
 std::int32_t BalancedTree::getMaxBalance() const
@@ -371,7 +882,7 @@ void BalancedTree::insertLeaf(std::int32_t treeID)
         CRO_ASSERT(childA != TreeNode::Null, "Can't be null");
         CRO_ASSERT(childB != TreeNode::Null, "Can't be null");
 
-        m_nodes[index].height = std::max(m_nodes[childA].height, m_nodes[childB].height);
+        m_nodes[index].height = std::max(m_nodes[childA].height, m_nodes[childB].height) + 1;
         m_nodes[index].fatBounds = Box::merge(m_nodes[childA].fatBounds, m_nodes[childB].fatBounds);
 
         index = m_nodes[index].parent;
@@ -582,6 +1093,156 @@ std::int32_t BalancedTree::balance(std::int32_t iA)
     return iA;
 }
 
+void BalancedTree::refit()
+{
+    if (m_root != TreeNode::Null)
+    {
+        refit(m_root);
+    }
+}
+
+void BalancedTree::refit(std::int32_t treeID)
+{
+    auto& node = m_nodes[treeID];
+    if (!node.isLeaf())
+    {
+        refit(node.childA);
+        refit(node.childB);
+
+        node.fatBounds = Box::merge(m_nodes[node.childA].fatBounds, m_nodes[node.childB].fatBounds);
+    }
+}
+
+std::int32_t BalancedTree::build(BuildEntry* entries, std::size_t count, std::int32_t parent, std::int32_t depth)
+{
+    CRO_ASSERT(count != 0, "No leaves to build from");
+
+    if (count == 1)
+    {
+        m_nodes[entries[0].treeID].parent = parent;
+        return entries[0].treeID;
+    }
+
+    //split along the longest axis of the leaves' centres
+    auto minBounds = entries[0].minBounds;
+    auto maxBounds = entries[0].maxBounds;
+    auto minCentre = entries[0].centre;
+    auto maxCentre = entries[0].centre;
+    for (auto i = 1u; i < count; ++i)
+    {
+        minBounds = glm::min(minBounds, entries[i].minBounds);
+        maxBounds = glm::max(maxBounds, entries[i].maxBounds);
+        minCentre = glm::min(minCentre, entries[i].centre);
+        maxCentre = glm::max(maxCentre, entries[i].centre);
+    }
+
+    const auto size = maxCentre - minCentre;
+    std::size_t axis = 0;
+    if (size.y > size[axis])
+    {
+        axis = 1;
+    }
+    if (size.z > size[axis])
+    {
+        axis = 2;
+    }
+
+    std::size_t split = count / 2;
+
+    if (size[axis] > 0)
+    {
+        const auto binScale = static_cast<float>(BinCount) / size[axis];
+        const auto getBin = [&](const BuildEntry& entry)
+        {
+            return std::min(static_cast<std::size_t>((entry.centre[axis] - minCentre[axis]) * binScale), BinCount - 1);
+        };
+
+        std::int32_t bestBin = -1;
+        if (count > 2
+            && depth < MaxBuildDepth)
+        {
+            std::array<std::size_t, BinCount> binCounts = {};
+            std::array<glm::vec3, BinCount> binMin;
+            std::array<glm::vec3, BinCount> binMax;
+            binMin.fill(glm::vec3(std::numeric_limits<float>::max()));
+            binMax.fill(glm::vec3(std::numeric_limits<float>::lowest()));
+
+            for (auto i = 0u; i < count; ++i)
+            {
+                const auto bin = getBin(entries[i]);
+                binMin[bin] = glm::min(binMin[bin], entries[i].minBounds);
+                binMax[bin] = glm::max(binMax[bin], entries[i].maxBounds);
+                binCounts[bin]++;
+            }
+
+            //cost of the leaves to the right of each split
+            std::array<float, BinCount> rightCost = {};
+            auto totalMin = binMin[BinCount - 1];
+            auto totalMax = binMax[BinCount - 1];
+            std::size_t total = 0;
+            for (auto i = BinCount - 1; i > 0; --i)
+            {
+                totalMin = glm::min(totalMin, binMin[i]);
+                totalMax = glm::max(totalMax, binMax[i]);
+                total += binCounts[i];
+                rightCost[i - 1] = total == 0 ? 0.f : total * surfaceArea(totalMin, totalMax);
+            }
+
+            //and then sweep from the left to find the cheapest
+            auto bestCost = std::numeric_limits<float>::max();
+            totalMin = binMin[0];
+            totalMax = binMax[0];
+            total = 0;
+            for (auto i = 0u; i < BinCount - 1; ++i)
+            {
+                totalMin = glm::min(totalMin, binMin[i]);
+                totalMax = glm::max(totalMax, binMax[i]);
+                total += binCounts[i];
+
+                if (total != 0 && total != count)
+                {
+                    const auto cost = total * surfaceArea(totalMin, totalMax) + rightCost[i];
+                    if (cost < bestCost)
+                    {
+                        bestCost = cost;
+                        bestBin = static_cast<std::int32_t>(i);
+                    }
+                }
+            }
+        }
+
+        if (bestBin != -1)
+        {
+            auto* middle = std::partition(entries, entries + count, [&](const BuildEntry& entry)
+                {
+                    return getBin(entry) <= static_cast<std::size_t>(bestBin);
+                });
+            split = static_cast<std::size_t>(middle - entries);
+        }
+        else
+        {
+            std::nth_element(entries, entries + split, entries + count, [axis](const BuildEntry& a, const BuildEntry& b)
+                {
+                    return a.centre[axis] < b.centre[axis];
+                });
+        }
+    }
+
+    //careful, don't hold on to references as this may resize the node list
+    const auto treeID = allocateNode();
+    const auto childA = build(entries, split, treeID, depth + 1);
+    const auto childB = build(entries + split, count - split, treeID, depth + 1);
+
+    auto& node = m_nodes[treeID];
+    node.parent = parent;
+    node.childA = childA;
+    node.childB = childB;
+    node.fatBounds = Box(minBounds, maxBounds);
+    node.height = std::max(m_nodes[childA].height, m_nodes[childB].height) + 1;
+
+    return treeID;
+}
+
 std::int32_t BalancedTree::computeHeight() const
 {
     return computeHeight(m_root);
@@ -600,4 +1261,99 @@ std::int32_t BalancedTree::computeHeight(std::int32_t treeID) const
     auto heightB = computeHeight(m_nodes[treeID].childB);
 
     return std::max(heightA, heightB) + 1;
-}
\ No newline at end of file
+}
+
+template <typename F>
+void BalancedTree::queryBatched(const std::vector<Box>& areas, std::uint64_t filter, F&& output) const
+{
+    if (areas.empty()
+        || m_root == TreeNode::Null)
+    {
+        return;
+    }
+
+    //batches traverse the union of their areas' paths through the tree
+    //so sort the areas along a z-order curve to keep each batch close together
+    auto bounds = areas[0];
+    for (const auto& area : areas)
+    {
+        bounds = Box::merge(bounds, area);
+    }
+    const auto scale = 1023.f / glm::max(bounds.getSize(), glm::vec3(std::numeric_limits<float>::epsilon()));
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> order(areas.size());
+    for (auto i = 0u; i < areas.size(); ++i)
+    {
+        const auto centre = (areas[i][0] + areas[i][1]) / 2.f;
+        const auto cell = glm::uvec3((centre - bounds[0]) * scale);
+        order[i] = std::make_pair(interleave(cell.x) | (interleave(cell.y) << 1) | (interleave(cell.z) << 2), i);
+    }
+    std::sort(order.begin(), order.end());
+
+    //each entry carries the set of areas still overlapping its parent
+    struct Entry final
+    {
+        std::int32_t treeID = TreeNode::Null;
+        std::uint32_t active = 0;
+    };
+    TreeStack<Entry> stack;
+
+    for (auto first = 0u; first < order.size(); first += BatchSize)
+    {
+        const auto count = std::min(BatchSize, order.size() - first);
+
+        QueryBatch batch;
+        for (auto i = 0u; i < BatchSize; ++i)
+        {
+            if (i < count)
+            {
+                const auto& area = areas[order[first + i].second];
+                batch.minX[i] = area[0].x;
+                batch.minY[i] = area[0].y;
+                batch.minZ[i] = area[0].z;
+                batch.maxX[i] = area[1].x;
+                batch.maxY[i] = area[1].y;
+                batch.maxZ[i] = area[1].z;
+            }
+            else
+            {
+                //inverted so that unused slots never intersect
+                batch.minX[i] = batch.minY[i] = batch.minZ[i] = std::numeric_limits<float>::max();
+                batch.maxX[i] = batch.maxY[i] = batch.maxZ[i] = std::numeric_limits<float>::lowest();
+            }
+        }
+
+        stack.push({ m_root, count == BatchSize ? 0xffffffff : (1u << count) - 1 });
+
+        while (!stack.empty())
+        {
+            auto entry = stack.pop();
+            const auto& node = m_nodes[entry.treeID];
+
+            auto active = batch.intersects(node.fatBounds, entry.active);
+            if (active == 0)
+            {
+                continue;
+            }
+
+            if (node.isLeaf())
+            {
+                if (isCandidate(node, filter))
+                {
+                    for (auto i = 0u; active != 0; ++i, active >>= 1)
+                    {
+                        if (active & 1)
+                        {
+                            output(order[first + i].second, entry.treeID);
+                        }
+                    }
+                }
+            }
+            else
+            {
+                stack.push({ node.childA, active });
+                stack.push({ node.childB, active });
+            }
+        }
+    }
+}
@@ -0,0 +1,350 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include <crogine/detail/LightClusters.hpp>
+#include <crogine/detail/Assert.hpp>
+
+#include <crogine/detail/glm/geometric.hpp>
+#include <crogine/detail/glm/matrix.hpp>
+
+#include "ParallelFor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace cro;
+using namespace cro::Detail;
+
+namespace
+{
+    constexpr std::size_t MinLightsPerThread = 256;
+    constexpr std::size_t MinSlicesPerThread = 4;
+
+    bool sphereIntersects(glm::vec3 centre, float radius, glm::vec3 boundsMin, glm::vec3 boundsMax)
+    {
+        float distSqr = 0.f;
+        for (auto i = 0; i < 3; ++i)
+        {
+            if (centre[i] < boundsMin[i])
+            {
+                const float d = boundsMin[i] - centre[i];
+                distSqr += d * d;
+            }
+            else if (centre[i] > boundsMax[i])
+            {
+                const float d = centre[i] - boundsMax[i];
+                distSqr += d * d;
+            }
+        }
+        return distSqr <= radius * radius;
+    }
+
+    //tests a spot light cone against the bounding sphere of a cluster
+    //see Bart Wronski - Cull that cone! https://bartwronski.com/2017/04/13/cull-that-cone/
+    bool coneIntersects(const LightClusters::Light& light, float sinOuter, glm::vec3 centre, float radius)
+    {
+        const auto v = centre - light.position;
+        const float vLenSqr = glm::dot(v, v);
+        const float v1Len = glm::dot(v, light.direction);
+        const float closest = light.cosOuter * std::sqrt(std::max(vLenSqr - (v1Len * v1Len), 0.f)) - (v1Len * sinOuter);
+
+        return !(closest > radius
+            || v1Len > radius + light.radius
+            || v1Len < -radius);
+    }
+
+    std::uint16_t toTile(float ndc, std::uint32_t tileCount)
+    {
+        const auto tile = static_cast<std::int32_t>(std::floor((ndc * 0.5f + 0.5f) * tileCount));
+        return static_cast<std::uint16_t>(std::clamp(tile, 0, static_cast<std::int32_t>(tileCount) - 1));
+    }
+}
+
+LightClusters::LightClusters()
+    : m_projection  (1.f),
+    m_nearPlane     (0.1f),
+    m_farPlane      (100.f),
+    m_sliceScale    (0.f),
+    m_sliceBias     (0.f),
+    m_sliceDepths   (),
+    m_bounds        (ClusterCount),
+    m_sliceIndices  (ClusterCount * MaxLightsPerCluster),
+    m_sliceCounts   (ClusterCount),
+    m_clusters      (ClusterCount)
+{
+
+}
+
+//public
+void LightClusters::setProjection(const glm::mat4& projection, float nearPlane, float farPlane)
+{
+    CRO_ASSERT(nearPlane > 0.f && farPlane > nearPlane, "Invalid clip planes");
+
+    m_projection = projection;
+    m_nearPlane = nearPlane;
+    m_farPlane = farPlane;
+
+    const float logRatio = std::log(farPlane / nearPlane);
+    m_sliceScale = static_cast<float>(SliceCount) / logRatio;
+    m_sliceBias = -static_cast<float>(SliceCount) * std::log(nearPlane) / logRatio;
+
+    //the corners of each tile are unprojected to a line, which is then
+    //clipped at the slice depths. This works for both perspective and
+    //orthographic projections.
+    const auto inverse = glm::inverse(projection);
+    const auto unproject = [&inverse](float x, float y, float z)
+    {
+        auto p = inverse * glm::vec4(x, y, z, 1.f);
+        return glm::vec3(p) / p.w;
+    };
+
+    for (auto z = 0u; z < m_sliceDepths.size(); ++z)
+    {
+        m_sliceDepths[z] = nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(z) / SliceCount);
+    }
+
+    for (auto y = 0u; y < TileCountY; ++y)
+    {
+        for (auto x = 0u; x < TileCountX; ++x)
+        {
+            std::array<glm::vec3, 4u> nearPoints = {};
+            std::array<glm::vec3, 4u> farPoints = {};
+            for (auto i = 0u; i < 4u; ++i)
+            {
+                const float ndcX = -1.f + 2.f * static_cast<float>(x + (i & 1)) / TileCountX;
+                const float ndcY = -1.f + 2.f * static_cast<float>(y + (i >> 1)) / TileCountY;
+                nearPoints[i] = unproject(ndcX, ndcY, -1.f);
+                farPoints[i] = unproject(ndcX, ndcY, 1.f);
+            }
+
+            for (auto z = 0u; z < SliceCount; ++z)
+            {
+                auto& bounds = m_bounds[(z * TilesPerSlice) + (y * TileCountX) + x];
+                bounds.min = glm::vec3(std::numeric_limits<float>::max());
+                bounds.max = glm::vec3(std::numeric_limits<float>::lowest());
+
+                for (auto i = 0u; i < 4u; ++i)
+                {
+                    const auto ray = farPoints[i] - nearPoints[i];
+                    for (auto d : { m_sliceDepths[z], m_sliceDepths[z + 1] })
+                    {
+                        const float t = (-d - nearPoints[i].z) / ray.z;
+                        const auto p = nearPoints[i] + (ray * t);
+                        bounds.min = glm::min(bounds.min, p);
+                        bounds.max = glm::max(bounds.max, p);
+                    }
+                }
+                bounds.centre = (bounds.min + bounds.max) / 2.f;
+                bounds.radius = glm::length(bounds.max - bounds.centre);
+            }
+        }
+    }
+}
+
+void LightClusters::build(const std::vector<Light>& lights)
+{
+    CRO_ASSERT(lights.size() <= std::numeric_limits<std::uint32_t>::max(), "");
+
+    m_lightRanges.resize(lights.size());
+    parallelFor(lights.size(), MinLightsPerThread,
+        [&](std::size_t begin, std::size_t end)
+        {
+            for (auto i = begin; i < end; ++i)
+            {
+                m_lightRanges[i] = getLightRange(lights[i]);
+            }
+        });
+
+    //each slice writes only to its own part of the scratch buffers, and
+    //visits the lights in order, so each list is sorted by light index
+    parallelFor(SliceCount, MinSlicesPerThread,
+        [&](std::size_t begin, std::size_t end)
+        {
+            for (auto z = begin; z < end; ++z)
+            {
+                auto* counts = &m_sliceCounts[z * TilesPerSlice];
+                auto* indices = &m_sliceIndices[z * TilesPerSlice * MaxLightsPerCluster];
+                const auto* bounds = &m_bounds[z * TilesPerSlice];
+                std::fill(counts, counts + TilesPerSlice, 0u);
+
+                for (auto i = 0u; i < lights.size(); ++i)
+                {
+                    const auto& range = m_lightRanges[i];
+                    if (z < range.minZ || z > range.maxZ)
+                    {
+                        continue;
+                    }
+
+                    const auto& light = lights[i];
+
+                    //narrow the tile range to the part of the light inside this slice
+                    auto tiles = range;
+                    if (range.minZ != range.maxZ
+                        && !getTileRange(light, std::max(m_sliceDepths[z], -light.position.z - light.radius),
+                                        std::min(m_sliceDepths[z + 1], -light.position.z + light.radius), tiles))
+                    {
+                        continue;
+                    }
+
+                    const bool isSpot = light.cosOuter > 0.f;
+                    const float sinOuter = isSpot ? std::sqrt(1.f - (light.cosOuter * light.cosOuter)) : 0.f;
+
+                    for (auto y = tiles.minY; y <= tiles.maxY; ++y)
+                    {
+                        for (auto x = tiles.minX; x <= tiles.maxX; ++x)
+                        {
+                            const auto tile = (y * TileCountX) + x;
+                            const auto& b = bounds[tile];
+                            if (counts[tile] < MaxLightsPerCluster
+                                && sphereIntersects(light.position, light.radius, b.min, b.max)
+                                && (!isSpot || coneIntersects(light, sinOuter, b.centre, b.radius)))
+                            {
+                                indices[(tile * MaxLightsPerCluster) + counts[tile]++] = i;
+                            }
+                        }
+                    }
+                }
+            }
+        });
+
+    //compact the lists in cluster order
+    std::uint32_t offset = 0;
+    for (auto i = 0u; i < ClusterCount; ++i)
+    {
+        m_clusters[i].offset = offset;
+        m_clusters[i].count = m_sliceCounts[i];
+        offset += m_sliceCounts[i];
+    }
+
+    m_indices.resize(offset);
+    for (auto i = 0u; i < ClusterCount; ++i)
+    {
+        const auto* src = &m_sliceIndices[i * MaxLightsPerCluster];
+        std::copy(src, src + m_clusters[i].count, m_indices.begin() + m_clusters[i].offset);
+    }
+}
+
+std::uint32_t LightClusters::getClusterIndex(glm::vec3 viewPosition) const
+{
+    const float depth = -viewPosition.z;
+    if (depth < m_nearPlane || depth > m_farPlane)
+    {
+        return ClusterCount;
+    }
+
+    const auto clip = m_projection * glm::vec4(viewPosition, 1.f);
+    const auto ndc = glm::vec2(clip) / clip.w;
+    if (std::abs(ndc.x) > 1.f || std::abs(ndc.y) > 1.f)
+    {
+        return ClusterCount;
+    }
+
+    const auto slice = std::clamp(static_cast<std::int32_t>(std::floor(getSlice(depth))), 0, static_cast<std::int32_t>(SliceCount) - 1);
+    return (slice * TilesPerSlice) + (toTile(ndc.y, TileCountY) * TileCountX) + toTile(ndc.x, TileCountX);
+}
+
+//private
+float LightClusters::getSlice(float depth) const
+{
+    return (std::log(depth) * m_sliceScale) + m_sliceBias;
+}
+
+LightClusters::LightRange LightClusters::getLightRange(const Light& light) const
+{
+    LightRange range;
+
+    const float nearDepth = -light.position.z - light.radius;
+    const float farDepth = -light.position.z + light.radius;
+    if (farDepth < m_nearPlane || nearDepth > m_farPlane)
+    {
+        return range;
+    }
+
+    if (!getTileRange(light, std::max(nearDepth, m_nearPlane), std::min(farDepth, m_farPlane), range))
+    {
+        //off screen
+        return range;
+    }
+
+    const auto lastSlice = static_cast<std::int32_t>(SliceCount) - 1;
+    range.minZ = nearDepth > m_nearPlane ?
+        static_cast<std::uint16_t>(std::clamp(static_cast<std::int32_t>(std::floor(getSlice(nearDepth))), 0, lastSlice)) : 0;
+    range.maxZ = static_cast<std::uint16_t>(std::clamp(static_cast<std::int32_t>(std::floor(getSlice(farDepth))), 0, lastSlice));
+
+    return range;
+}
+
+bool LightClusters::getTileRange(const Light& light, float minDepth, float maxDepth, LightRange& range) const
+{
+    //project the corners of the light's bounding box, clipped to the given depth
+    //range. The projected box contains the projected sphere as the depth range
+    //is always in front of the near plane. Each corner is the sum of one of two
+    //terms for each axis, so the projection is split by column rather than
+    //multiplying the matrix by each corner.
+    const std::array<glm::vec4, 2u> x =
+    {
+        m_projection[0] * (light.position.x - light.radius),
+        m_projection[0] * (light.position.x + light.radius)
+    };
+    const std::array<glm::vec4, 2u> y =
+    {
+        m_projection[1] * (light.position.y - light.radius),
+        m_projection[1] * (light.position.y + light.radius)
+    };
+    const std::array<glm::vec4, 2u> z =
+    {
+        (m_projection[2] * -maxDepth) + m_projection[3],
+        (m_projection[2] * -minDepth) + m_projection[3]
+    };
+
+    glm::vec2 ndcMin(std::numeric_limits<float>::max());
+    glm::vec2 ndcMax(std::numeric_limits<float>::lowest());
+    for (auto i = 0u; i < 8u; ++i)
+    {
+        const auto clip = x[i & 1] + y[(i >> 1) & 1] + z[i >> 2];
+        const auto ndc = glm::vec2(clip) / clip.w;
+        ndcMin = glm::min(ndcMin, ndc);
+        ndcMax = glm::max(ndcMax, ndc);
+    }
+
+    if (ndcMax.x < -1.f || ndcMin.x > 1.f
+        || ndcMax.y < -1.f || ndcMin.y > 1.f)
+    {
+        return false;
+    }
+
+    range.minX = toTile(ndcMin.x, TileCountX);
+    range.maxX = toTile(ndcMax.x, TileCountX);
+    range.minY = toTile(ndcMin.y, TileCountY);
+    range.maxY = toTile(ndcMax.y, TileCountY);
+
+    return true;
+}
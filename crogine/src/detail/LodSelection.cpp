@@ -0,0 +1,75 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+
+#include <crogine/detail/LodSelection.hpp>
+
+#include <algorithm>
+#include <limits>
+
+using namespace cro;
+
+float Detail::getLodScreenSize(const glm::mat4& projection, float radius, float distance)
+{
+    //projection[1][1] scales view space y to NDC, in which the view is 2 units high
+    if (projection[3][3] == 1.f)
+    {
+        //orthographic projections don't change with distance
+        return radius * projection[1][1];
+    }
+
+    if (distance <= radius)
+    {
+        //camera is inside the bounds
+        return std::numeric_limits<float>::max();
+    }
+    return (radius * projection[1][1]) / distance;
+}
+
+std::size_t Detail::selectLod(const std::vector<float>& screenSizes, float screenSize, std::size_t currentLevel, float hysteresis)
+{
+    auto level = std::min(currentLevel, screenSizes.size());
+
+    //move to coarser levels once the size is far enough below their thresholds...
+    while (level < screenSizes.size()
+        && screenSize < screenSizes[level] * (1.f - hysteresis))
+    {
+        level++;
+    }
+
+    //...or finer ones once it's far enough above the threshold of the current level
+    while (level > 0
+        && screenSize > screenSizes[level - 1] * (1.f + hysteresis))
+    {
+        level--;
+    }
+
+    return level;
+}
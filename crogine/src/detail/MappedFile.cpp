@@ -0,0 +1,202 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include "MappedFile.hpp"
+
+#include <crogine/core/Log.hpp>
+#include <crogine/detail/Types.hpp>
+
+#include <SDL_rwops.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#elif !defined(__ANDROID__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace cro::Detail;
+
+MappedFile::MappedFile()
+    : m_data    (nullptr),
+    m_size      (0)
+#ifdef _WIN32
+    , m_file    (INVALID_HANDLE_VALUE),
+    m_mapping   (nullptr)
+#endif
+{
+
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+//public
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+#ifdef _WIN32
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        LogE << "Failed opening " << path << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+    {
+        LogE << path << ": file is empty" << std::endl;
+        close();
+        return false;
+    }
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping)
+    {
+        LogE << "Failed mapping " << path << std::endl;
+        close();
+        return false;
+    }
+
+    m_data = static_cast<const std::uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_data)
+    {
+        LogE << "Failed mapping " << path << std::endl;
+        close();
+        return false;
+    }
+    m_size = static_cast<std::size_t>(size.QuadPart);
+
+#elif defined(__ANDROID__)
+    //assets live inside the APK so we have to read them
+    RaiiRWops file;
+    file.file = SDL_RWFromFile(path.c_str(), "rb");
+    if (!file.file)
+    {
+        LogE << "Failed opening " << path << std::endl;
+        return false;
+    }
+
+    auto size = SDL_RWsize(file.file);
+    if (size < 1)
+    {
+        LogE << path << ": file is empty" << std::endl;
+        return false;
+    }
+
+    m_fallback.resize(static_cast<std::size_t>(size));
+    if (SDL_RWread(file.file, m_fallback.data(), m_fallback.size(), 1) != 1)
+    {
+        LogE << path << ": failed reading file" << std::endl;
+        m_fallback.clear();
+        return false;
+    }
+    m_data = m_fallback.data();
+    m_size = m_fallback.size();
+
+#else
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        LogE << "Failed opening " << path << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        LogE << path << ": file is empty" << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    //the mapping remains valid after the descriptor is closed
+    auto* data = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        LogE << "Failed mapping " << path << std::endl;
+        return false;
+    }
+    m_data = static_cast<const std::uint8_t*>(data);
+    m_size = static_cast<std::size_t>(st.st_size);
+#endif
+
+    return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+    }
+
+    if (m_mapping)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+#elif !defined(__ANDROID__)
+    if (m_data)
+    {
+        munmap(const_cast<std::uint8_t*>(m_data), m_size);
+    }
+#endif
+
+    m_fallback.clear();
+    m_fallback.shrink_to_fit();
+    m_data = nullptr;
+    m_size = 0;
+}
+
+void MappedFile::prefetch() const
+{
+#if !defined(_WIN32) && !defined(__ANDROID__)
+    if (m_data)
+    {
+        madvise(const_cast<std::uint8_t*>(m_data), m_size, MADV_WILLNEED);
+    }
+#endif
+}
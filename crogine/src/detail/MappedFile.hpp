@@ -0,0 +1,93 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cro::Detail
+{
+    /*!
+    \brief Read-only memory mapping of a file.
+    Files are mapped with mmap() or MapViewOfFile() so that their
+    contents can be read without first copying them to the heap.
+    The mapped pages belong to the OS file cache and can be
+    discarded at any time under memory pressure, so they don't
+    contribute to the peak private memory of the process.
+
+    On Android, where assets are stored in the APK and can't be
+    mapped, the file is read into a buffer via SDL_RWops instead.
+    */
+    class MappedFile final
+    {
+    public:
+        MappedFile();
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile(MappedFile&&) = delete;
+        MappedFile& operator = (const MappedFile&) = delete;
+        MappedFile& operator = (MappedFile&&) = delete;
+
+        /*!
+        \brief Maps the file at the given path. The path is used as-is,
+        it is not prepended with the resource path.
+        \returns true on success
+        */
+        bool open(const std::string& path);
+
+        /*!
+        \brief Unmaps the file if it is open. Any pointers returned by
+        getData() are invalid after calling this.
+        */
+        void close();
+
+        /*!
+        \brief Hints to the OS that the whole file will be read soon
+        so that it can start reading it in the background
+        */
+        void prefetch() const;
+
+        const std::uint8_t* getData() const { return m_data; }
+        std::size_t getSize() const { return m_size; }
+
+    private:
+        const std::uint8_t* m_data;
+        std::size_t m_size;
+
+#ifdef _WIN32
+        void* m_file;
+        void* m_mapping;
+#endif
+        std::vector<std::uint8_t> m_fallback;
+    };
+}
@@ -389,6 +389,13 @@ cro::Mesh::Data cro::Detail::ModelBinary::read(const std::string& binPath, std::
                 LogE << "No position data in mesh" << std::endl;
                 return {};
             }
+            if (meshHeader.indexArrayCount == 0
+                || meshHeader.indexArrayCount > cro::Mesh::IndexData::MaxBuffers)
+            {
+                LogE << "Invalid index array count " << meshHeader.indexArrayCount << std::endl;
+                return {};
+            }
+
             std::vector<std::uint32_t> sizes(meshHeader.indexArrayCount);
             dstIdx.resize(meshHeader.indexArrayCount);
 
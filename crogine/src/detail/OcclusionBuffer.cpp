@@ -0,0 +1,509 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+
+#include <crogine/detail/OcclusionBuffer.hpp>
+#include <crogine/detail/Assert.hpp>
+
+#include "ParallelFor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CRO_OCCLUSION_SSE
+#include <emmintrin.h>
+#endif
+
+using namespace cro;
+using namespace cro::Detail;
+
+namespace
+{
+    constexpr std::size_t MinRowsPerThread = 16;
+
+    //triangles smaller than this (in square pixels) can't cover a pixel centre
+    constexpr float MinArea = 0.0001f;
+
+    //edge equation ax + by + c, which is positive to the left of a->b
+    glm::vec3 edgeEquation(const glm::vec3& a, const glm::vec3& b)
+    {
+        return { a.y - b.y, b.x - a.x, (a.x * b.y) - (a.y * b.x) };
+    }
+}
+
+OcclusionBuffer::OcclusionBuffer(std::uint32_t width, std::uint32_t height)
+    : m_width       (0),
+    m_height        (0),
+    m_tileCountX    (0),
+    m_tileCountY    (0),
+    m_viewProjection(1.f)
+{
+    setSize(width, height);
+}
+
+//public
+void OcclusionBuffer::setSize(std::uint32_t width, std::uint32_t height)
+{
+    CRO_ASSERT(width > 0 && height > 0, "Invalid buffer size");
+
+    m_tileCountX = (std::max(1u, width) + TileWidth - 1) / TileWidth;
+    m_tileCountY = (std::max(1u, height) + TileHeight - 1) / TileHeight;
+    m_width = m_tileCountX * TileWidth;
+    m_height = m_tileCountY * TileHeight;
+
+    m_tileBins.resize(m_tileCountX * m_tileCountY);
+
+    m_levels.clear();
+    auto& base = m_levels.emplace_back();
+    base.width = m_width;
+    base.height = m_height;
+    base.maxDepth.assign(m_width * m_height, 1.f);
+
+    auto w = m_width;
+    auto h = m_height;
+    while (w > 1 || h > 1)
+    {
+        w = std::max(1u, (w + 1) / 2);
+        h = std::max(1u, (h + 1) / 2);
+
+        auto& level = m_levels.emplace_back();
+        level.width = w;
+        level.height = h;
+        level.minDepth.assign(w * h, 1.f);
+        level.maxDepth.assign(w * h, 1.f);
+    }
+
+    m_triangles.clear();
+}
+
+void OcclusionBuffer::begin(const glm::mat4& viewProjection)
+{
+    m_viewProjection = viewProjection;
+    m_triangles.clear();
+}
+
+void OcclusionBuffer::addOccluder(const std::vector<glm::vec3>& vertices, const std::vector<std::uint32_t>& indices, const glm::mat4& worldTransform)
+{
+    CRO_ASSERT(indices.size() % 3 == 0, "Indices must be a triangle list");
+
+    const auto transform = m_viewProjection * worldTransform;
+    m_clipVertices.resize(vertices.size());
+    for (auto i = 0u; i < vertices.size(); ++i)
+    {
+        m_clipVertices[i] = transform * glm::vec4(vertices[i], 1.f);
+    }
+
+    for (auto i = 0u; i + 2 < indices.size(); i += 3)
+    {
+        CRO_ASSERT(indices[i] < vertices.size() && indices[i + 1] < vertices.size() && indices[i + 2] < vertices.size(), "Index out of range");
+        const std::array<glm::vec4, 3u> tri =
+        {
+            m_clipVertices[indices[i]],
+            m_clipVertices[indices[i + 1]],
+            m_clipVertices[indices[i + 2]]
+        };
+
+        //reject triangles entirely outside one of the clip planes
+        std::uint32_t outside = 0x3f;
+        for (const auto& v : tri)
+        {
+            std::uint32_t code = 0;
+            code |= (v.x < -v.w) ? 0x1 : 0;
+            code |= (v.x > v.w) ? 0x2 : 0;
+            code |= (v.y < -v.w) ? 0x4 : 0;
+            code |= (v.y > v.w) ? 0x8 : 0;
+            code |= (v.z < -v.w) ? 0x10 : 0;
+            code |= (v.z > v.w) ? 0x20 : 0;
+            outside &= code;
+        }
+        if (outside)
+        {
+            continue;
+        }
+
+        //clip against the near plane, which may split the triangle in two
+        std::array<glm::vec4, 4u> clipped = {};
+        std::size_t count = 0;
+        for (auto j = 0u; j < 3u; ++j)
+        {
+            const auto& a = tri[j];
+            const auto& b = tri[(j + 1) % 3];
+            const float distA = a.z + a.w;
+            const float distB = b.z + b.w;
+
+            if (distA >= 0.f)
+            {
+                clipped[count++] = a;
+            }
+
+            if ((distA >= 0.f) != (distB >= 0.f))
+            {
+                clipped[count++] = a + ((b - a) * (distA / (distA - distB)));
+            }
+        }
+
+        if (count > 2)
+        {
+            addTriangle(clipped[0], clipped[1], clipped[2]);
+        }
+
+        if (count > 3)
+        {
+            addTriangle(clipped[0], clipped[2], clipped[3]);
+        }
+    }
+}
+
+void OcclusionBuffer::rasterise()
+{
+    for (auto& bin : m_tileBins)
+    {
+        bin.clear();
+    }
+
+    for (auto i = 0u; i < m_triangles.size(); ++i)
+    {
+        const auto& tri = m_triangles[i];
+        const auto minX = tri.minX / TileWidth;
+        const auto maxX = tri.maxX / TileWidth;
+        const auto minY = tri.minY / TileHeight;
+        const auto maxY = tri.maxY / TileHeight;
+
+        for (auto y = minY; y <= maxY; ++y)
+        {
+            for (auto x = minX; x <= maxX; ++x)
+            {
+                m_tileBins[(y * m_tileCountX) + x].push_back(i);
+            }
+        }
+    }
+
+    //each tile is cleared and drawn by a single job, so
+    //no two threads ever write to the same pixel
+    parallelFor(m_tileBins.size(), 1,
+        [&](std::size_t begin, std::size_t end)
+        {
+            for (auto i = begin; i < end; ++i)
+            {
+                rasteriseTile(static_cast<std::uint32_t>(i));
+            }
+        });
+
+    for (auto i = 1u; i < m_levels.size(); ++i)
+    {
+        buildLevel(i);
+    }
+}
+
+bool OcclusionBuffer::isVisible(const Box& worldBounds) const
+{
+    glm::vec3 minPos(std::numeric_limits<float>::max());
+    glm::vec3 maxPos(std::numeric_limits<float>::lowest());
+
+    //each corner is the sum of one column of the matrix scaled by either
+    //the min or max of each axis, so these are calculated once and shared
+    const auto boxMin = worldBounds[0];
+    const auto boxMax = worldBounds[1];
+    const std::array<glm::vec4, 2u> xCols = { m_viewProjection[0] * boxMin.x, m_viewProjection[0] * boxMax.x };
+    const std::array<glm::vec4, 2u> yCols = { m_viewProjection[1] * boxMin.y, m_viewProjection[1] * boxMax.y };
+    const std::array<glm::vec4, 2u> zCols = { (m_viewProjection[2] * boxMin.z) + m_viewProjection[3], (m_viewProjection[2] * boxMax.z) + m_viewProjection[3] };
+
+    for (auto i = 0u; i < 8u; ++i)
+    {
+        const auto clip = xCols[i & 0x1] + yCols[(i >> 1) & 0x1] + zCols[(i >> 2) & 0x1];
+        if (clip.w <= 0.f || clip.z < -clip.w)
+        {
+            //crosses the near plane
+            return true;
+        }
+
+        const auto ndc = glm::vec3(clip) / clip.w;
+        minPos = glm::min(minPos, ndc);
+        maxPos = glm::max(maxPos, ndc);
+    }
+
+    if (maxPos.x < -1.f || minPos.x > 1.f
+        || maxPos.y < -1.f || minPos.y > 1.f
+        || minPos.z > 1.f)
+    {
+        //outside the view - leave this to frustum culling
+        return true;
+    }
+
+    const auto toPixel = [](float ndc, std::uint32_t size)
+    {
+        const float pos = std::floor(((ndc * 0.5f) + 0.5f) * static_cast<float>(size));
+        return static_cast<std::int32_t>(std::clamp(pos, 0.f, static_cast<float>(size - 1)));
+    };
+
+    const auto minX = toPixel(minPos.x, m_width);
+    const auto maxX = toPixel(maxPos.x, m_width);
+    const auto minY = toPixel(minPos.y, m_height);
+    const auto maxY = toPixel(maxPos.y, m_height);
+    const float depth = (minPos.z * 0.5f) + 0.5f;
+
+    //start at the level where the rectangle covers at most 2x2 texels
+    const auto extent = std::max(maxX - minX, maxY - minY);
+    std::size_t level = 0;
+    while ((extent >> level) > 1
+        && level + 1 < m_levels.size())
+    {
+        level++;
+    }
+
+    for (auto y = minY >> level; y <= (maxY >> level); ++y)
+    {
+        for (auto x = minX >> level; x <= (maxX >> level); ++x)
+        {
+            if (testTexel(level, x, y, depth, minX, minY, maxX, maxY))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+//private
+void OcclusionBuffer::addTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c)
+{
+    //to screen space, where z is depth in the range 0 - 1
+    std::array<glm::vec3, 3u> v = {};
+    const std::array<const glm::vec4*, 3u> src = { &a, &b, &c };
+    for (auto i = 0u; i < 3u; ++i)
+    {
+        const auto ndc = glm::vec3(*src[i]) / src[i]->w;
+        v[i].x = ((ndc.x * 0.5f) + 0.5f) * static_cast<float>(m_width);
+        v[i].y = ((ndc.y * 0.5f) + 0.5f) * static_cast<float>(m_height);
+        v[i].z = (ndc.z * 0.5f) + 0.5f;
+    }
+
+    float area = ((v[1].x - v[0].x) * (v[2].y - v[0].y)) - ((v[2].x - v[0].x) * (v[1].y - v[0].y));
+    if (std::abs(area) < MinArea)
+    {
+        return;
+    }
+
+    //bounds of the pixels whose centres may be covered
+    const float minX = std::min(v[0].x, std::min(v[1].x, v[2].x));
+    const float maxX = std::max(v[0].x, std::max(v[1].x, v[2].x));
+    const float minY = std::min(v[0].y, std::min(v[1].y, v[2].y));
+    const float maxY = std::max(v[0].y, std::max(v[1].y, v[2].y));
+
+    const float width = static_cast<float>(m_width);
+    const float height = static_cast<float>(m_height);
+    if (maxX < 0.f || minX >= width
+        || maxY < 0.f || minY >= height)
+    {
+        return;
+    }
+
+    Triangle tri;
+    tri.minX = static_cast<std::int32_t>(std::floor(std::max(minX, 0.f)));
+    tri.maxX = static_cast<std::int32_t>(std::min(std::floor(maxX), width - 1.f));
+    tri.minY = static_cast<std::int32_t>(std::floor(std::max(minY, 0.f)));
+    tri.maxY = static_cast<std::int32_t>(std::min(std::floor(maxY), height - 1.f));
+
+    //each edge is positive on the inside, whichever way the triangle is wound
+    tri.edges[0] = edgeEquation(v[1], v[2]);
+    tri.edges[1] = edgeEquation(v[2], v[0]);
+    tri.edges[2] = edgeEquation(v[0], v[1]);
+    if (area < 0.f)
+    {
+        for (auto& edge : tri.edges)
+        {
+            edge = -edge;
+        }
+        area = -area;
+    }
+
+    //the edge equations divided by the area are the barycentric coords
+    //which interpolate the depth as a plane equation in screen space
+    tri.depth = ((tri.edges[0] * v[0].z) + (tri.edges[1] * v[1].z) + (tri.edges[2] * v[2].z)) / area;
+
+    //depth is sampled at pixel centres, so move it to the furthest value
+    //within the pixel to make sure the occluder never appears nearer than it is
+    tri.depth.z += (std::abs(tri.depth.x) + std::abs(tri.depth.y)) * 0.5f;
+
+    m_triangles.push_back(tri);
+}
+
+void OcclusionBuffer::rasteriseTile(std::uint32_t tile)
+{
+    const std::int32_t tileX = static_cast<std::int32_t>((tile % m_tileCountX) * TileWidth);
+    const std::int32_t tileY = static_cast<std::int32_t>((tile / m_tileCountX) * TileHeight);
+    const std::int32_t tileMaxX = tileX + static_cast<std::int32_t>(TileWidth) - 1;
+    const std::int32_t tileMaxY = tileY + static_cast<std::int32_t>(TileHeight) - 1;
+
+    auto& depth = m_levels[0].maxDepth;
+    for (auto y = tileY; y <= tileMaxY; ++y)
+    {
+        std::fill_n(depth.begin() + (y * m_width) + tileX, TileWidth, 1.f);
+    }
+
+    for (auto index : m_tileBins[tile])
+    {
+        const auto& tri = m_triangles[index];
+
+        //tile widths are a multiple of 4, so aligning the start
+        //down keeps each group of 4 pixels inside the tile
+        const auto startX = std::max(tri.minX, tileX) & ~3;
+        const auto endX = std::min(tri.maxX, tileMaxX);
+        const auto startY = std::max(tri.minY, tileY);
+        const auto endY = std::min(tri.maxY, tileMaxY);
+
+        for (auto y = startY; y <= endY; ++y)
+        {
+            const float py = static_cast<float>(y) + 0.5f;
+            const float row0 = (tri.edges[0].y * py) + tri.edges[0].z;
+            const float row1 = (tri.edges[1].y * py) + tri.edges[1].z;
+            const float row2 = (tri.edges[2].y * py) + tri.edges[2].z;
+            const float rowZ = (tri.depth.y * py) + tri.depth.z;
+            float* dst = &depth[y * m_width];
+
+#ifdef CRO_OCCLUSION_SSE
+            const auto offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+            const auto zero = _mm_setzero_ps();
+            const auto a0 = _mm_set1_ps(tri.edges[0].x);
+            const auto a1 = _mm_set1_ps(tri.edges[1].x);
+            const auto a2 = _mm_set1_ps(tri.edges[2].x);
+            const auto az = _mm_set1_ps(tri.depth.x);
+            const auto r0 = _mm_set1_ps(row0);
+            const auto r1 = _mm_set1_ps(row1);
+            const auto r2 = _mm_set1_ps(row2);
+            const auto rz = _mm_set1_ps(rowZ);
+
+            for (auto x = startX; x <= endX; x += 4)
+            {
+                const auto px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+                auto mask = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0, px), r0), zero);
+                mask = _mm_and_ps(mask, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1, px), r1), zero));
+                mask = _mm_and_ps(mask, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2, px), r2), zero));
+
+                if (_mm_movemask_ps(mask) == 0)
+                {
+                    continue;
+                }
+
+                const auto z = _mm_add_ps(_mm_mul_ps(az, px), rz);
+                const auto current = _mm_loadu_ps(dst + x);
+                const auto nearest = _mm_min_ps(current, z);
+                _mm_storeu_ps(dst + x, _mm_or_ps(_mm_and_ps(mask, nearest), _mm_andnot_ps(mask, current)));
+            }
+#else
+            for (auto x = startX; x <= endX; ++x)
+            {
+                const float px = static_cast<float>(x) + 0.5f;
+                if ((tri.edges[0].x * px) + row0 >= 0.f
+                    && (tri.edges[1].x * px) + row1 >= 0.f
+                    && (tri.edges[2].x * px) + row2 >= 0.f)
+                {
+                    dst[x] = std::min(dst[x], (tri.depth.x * px) + rowZ);
+                }
+            }
+#endif
+        }
+    }
+}
+
+void OcclusionBuffer::buildLevel(std::size_t index)
+{
+    CRO_ASSERT(index > 0 && index < m_levels.size(), "Invalid level");
+
+    const auto& src = m_levels[index - 1];
+    auto& dst = m_levels[index];
+
+    //the base level stores the same value for min and max
+    const auto& srcMin = (index == 1) ? src.maxDepth : src.minDepth;
+    const auto& srcMax = src.maxDepth;
+
+    parallelFor(dst.height, MinRowsPerThread,
+        [&](std::size_t begin, std::size_t end)
+        {
+            for (auto y = begin; y < end; ++y)
+            {
+                const auto y0 = (y * 2) * src.width;
+                const auto y1 = std::min<std::size_t>((y * 2) + 1, src.height - 1) * src.width;
+
+                for (auto x = 0u; x < dst.width; ++x)
+                {
+                    const auto x0 = x * 2;
+                    const auto x1 = std::min((x * 2) + 1, src.width - 1);
+
+                    const auto i = (y * dst.width) + x;
+                    dst.minDepth[i] = std::min(std::min(srcMin[y0 + x0], srcMin[y0 + x1]), std::min(srcMin[y1 + x0], srcMin[y1 + x1]));
+                    dst.maxDepth[i] = std::max(std::max(srcMax[y0 + x0], srcMax[y0 + x1]), std::max(srcMax[y1 + x0], srcMax[y1 + x1]));
+                }
+            }
+        });
+}
+
+bool OcclusionBuffer::testTexel(std::size_t level, std::int32_t x, std::int32_t y, float depth,
+    std::int32_t minX, std::int32_t minY, std::int32_t maxX, std::int32_t maxY) const
+{
+    const auto& current = m_levels[level];
+    const auto i = (static_cast<std::size_t>(y) * current.width) + x;
+
+    //further than everything in this texel
+    if (depth > current.maxDepth[i])
+    {
+        return false;
+    }
+
+    //nearer than everything in this texel
+    if (level == 0
+        || depth <= current.minDepth[i])
+    {
+        return true;
+    }
+
+    //else refine the parts of the rectangle this texel covers
+    const auto child = level - 1;
+    const auto& next = m_levels[child];
+    const auto startX = std::max(x * 2, minX >> child);
+    const auto endX = std::min(std::min((x * 2) + 1, static_cast<std::int32_t>(next.width) - 1), maxX >> child);
+    const auto startY = std::max(y * 2, minY >> child);
+    const auto endY = std::min(std::min((y * 2) + 1, static_cast<std::int32_t>(next.height) - 1), maxY >> child);
+
+    for (auto cy = startY; cy <= endY; ++cy)
+    {
+        for (auto cx = startX; cx <= endX; ++cx)
+        {
+            if (testTexel(child, cx, cy, depth, minX, minY, maxX, maxY))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,170 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include "ParallelFor.hpp"
+
+using namespace cro::Detail;
+
+namespace
+{
+    thread_local bool isWorkerThread = false;
+}
+
+WorkerPool& WorkerPool::instance()
+{
+    static WorkerPool pool;
+    return pool;
+}
+
+WorkerPool::WorkerPool()
+    : m_generation  (0),
+    m_busyCount     (0),
+    m_quit          (false),
+    m_task          (nullptr),
+    m_context       (nullptr),
+    m_taskCount     (0),
+    m_nextTask      (0),
+    m_pendingCount  (0)
+{
+    //the thread calling run() always takes part, so one fewer is needed
+    const auto threadCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    for (auto i = 0u; i < threadCount; ++i)
+    {
+        m_threads.emplace_back(&WorkerPool::threadFunc, this);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_quit = true;
+    }
+    m_wakeCondition.notify_all();
+
+    for (auto& t : m_threads)
+    {
+        t.join();
+    }
+}
+
+//public
+bool WorkerPool::run(std::size_t taskCount, Task task, void* context)
+{
+    if (m_threads.empty() || isWorkerThread)
+    {
+        return false;
+    }
+
+    std::unique_lock runLock(m_runMutex, std::try_to_lock);
+    if (!runLock.owns_lock())
+    {
+        return false;
+    }
+
+    {
+        //workers which woke late for the previous batch still hold
+        //a copy of its task, so wait for them before replacing it
+        std::unique_lock lock(m_mutex);
+        m_doneCondition.wait(lock, [&]() {return m_busyCount == 0; });
+
+        m_task = task;
+        m_context = context;
+        m_taskCount = taskCount;
+        m_nextTask = 0;
+        m_pendingCount = taskCount;
+        m_generation++;
+    }
+    m_wakeCondition.notify_all();
+
+    execute(task, context, taskCount);
+
+    std::unique_lock lock(m_mutex);
+    m_doneCondition.wait(lock, [&]() {return m_pendingCount == 0; });
+
+    return true;
+}
+
+//private
+void WorkerPool::threadFunc()
+{
+    isWorkerThread = true;
+#ifdef CRO_PROFILING
+    cro::Profiler::setThreadName("Worker Pool");
+#endif
+
+    std::uint64_t generation = 0;
+    while (true)
+    {
+        Task task = nullptr;
+        void* context = nullptr;
+        std::size_t taskCount = 0;
+
+        {
+            std::unique_lock lock(m_mutex);
+            m_wakeCondition.wait(lock, [&]() {return m_quit || m_generation != generation; });
+
+            if (m_quit)
+            {
+                return;
+            }
+
+            generation = m_generation;
+            task = m_task;
+            context = m_context;
+            taskCount = m_taskCount;
+            m_busyCount++;
+        }
+
+        execute(task, context, taskCount);
+
+        {
+            std::scoped_lock lock(m_mutex);
+            m_busyCount--;
+        }
+        m_doneCondition.notify_all();
+    }
+}
+
+void WorkerPool::execute(Task task, void* context, std::size_t taskCount)
+{
+    for (auto i = m_nextTask++; i < taskCount; i = m_nextTask++)
+    {
+        task(context, i);
+
+        if (--m_pendingCount == 0)
+        {
+            //lock so the notification can't be missed between
+            //the waiting thread testing the count and sleeping
+            std::scoped_lock lock(m_mutex);
+            m_doneCondition.notify_all();
+        }
+    }
+}
@@ -0,0 +1,153 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <crogine/core/Profiler.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace cro::Detail
+{
+    /*!
+    \brief Fixed set of worker threads shared by every call to parallelFor().
+    The threads are started on first use and live until the program exits,
+    so that the work split across them each frame doesn't pay for creating
+    and joining threads.
+    */
+    class WorkerPool final
+    {
+    public:
+        using Task = void(*)(void* context, std::size_t index);
+
+        static WorkerPool& instance();
+
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool(WorkerPool&&) = delete;
+        WorkerPool& operator = (const WorkerPool&) = delete;
+        WorkerPool& operator = (WorkerPool&&) = delete;
+
+        /*!
+        \brief Returns the number of threads which can run tasks at once,
+        including the thread which calls run()
+        */
+        std::size_t getThreadCount() const { return m_threads.size() + 1; }
+
+        /*!
+        \brief Calls task(context, i) for each i in [0, taskCount) across the
+        workers and the calling thread, and returns once all are complete.
+        \returns false without running anything if the pool is already busy
+        with another caller, or this is called from a worker. In which case
+        the caller should perform the work itself.
+        */
+        bool run(std::size_t taskCount, Task task, void* context);
+
+    private:
+        WorkerPool();
+
+        std::vector<std::thread> m_threads;
+
+        std::mutex m_runMutex; //held by the caller of run() for its duration
+
+        std::mutex m_mutex;
+        std::condition_variable m_wakeCondition;
+        std::condition_variable m_doneCondition;
+        std::uint64_t m_generation;
+        std::size_t m_busyCount; //workers currently in execute()
+        bool m_quit;
+
+        Task m_task;
+        void* m_context;
+        std::size_t m_taskCount;
+        std::atomic<std::size_t> m_nextTask;
+        std::atomic<std::size_t> m_pendingCount;
+
+        void threadFunc();
+        void execute(Task, void*, std::size_t);
+    };
+
+    /*!
+    \brief Calls func(begin, end) over sub-ranges of [0, count), spread across
+    the threads of the WorkerPool when there is enough work to share.
+    The calling thread processes ranges too, and the function returns once
+    all ranges are complete. If the pool is in use by another thread the
+    whole range is processed by the calling thread.
+    \param count Total number of items
+    \param minPerThread Smallest number of items worth giving to a thread
+    \param func Callable taking the std::size_t begin and end of a range
+    */
+    template <typename F>
+    void parallelFor(std::size_t count, std::size_t minPerThread, F&& func)
+    {
+        auto& pool = WorkerPool::instance();
+        const auto threadCount = std::clamp(count / std::max(minPerThread, std::size_t(1)), std::size_t(1), pool.getThreadCount());
+
+        if (threadCount == 1)
+        {
+            func(std::size_t(0), count);
+            return;
+        }
+
+        struct Context final
+        {
+            std::remove_reference_t<F>* func = nullptr;
+            std::size_t rangeSize = 0;
+            std::size_t count = 0;
+        }context;
+        context.func = &func;
+        context.rangeSize = (count + threadCount - 1) / threadCount;
+        context.count = count;
+
+        const auto rangeCount = (count + context.rangeSize - 1) / context.rangeSize;
+        const auto task = [](void* data, std::size_t index)
+        {
+            CRO_PROFILE_SCOPE("parallelFor");
+
+            const auto& ctx = *static_cast<Context*>(data);
+            const auto begin = index * ctx.rangeSize;
+            (*ctx.func)(begin, std::min(begin + ctx.rangeSize, ctx.count));
+        };
+
+        if (!pool.run(rangeCount, task, &context))
+        {
+            func(std::size_t(0), count);
+        }
+    }
+}
@@ -33,6 +33,9 @@ source distribution.
 #include <crogine/ecs/components/Drawable2D.hpp>
 #include <crogine/ecs/components/Transform.hpp>
 
+#include <algorithm>
+#include <array>
+
 namespace
 {
     struct Direction final
@@ -45,16 +48,46 @@ namespace
             Count
         };
     };
+
+    //don't bother compacting small trees
+    constexpr std::size_t MinCompactCount = 256;
+
+    cro::FloatRect normalise(cro::FloatRect rect)
+    {
+        if (rect.width < 0)
+        {
+            rect.left += rect.width;
+            rect.width = -rect.width;
+        }
+
+        if (rect.height < 0)
+        {
+            rect.bottom += rect.height;
+            rect.height = -rect.height;
+        }
+        return rect;
+    }
+
+    //as FloatRect::intersects() but assumes both rectangles
+    //are normalised, which all those stored in the tree are
+    bool overlaps(const cro::FloatRect& a, const cro::FloatRect& b)
+    {
+        return std::max(a.left, b.left) < std::min(a.left + a.width, b.left + b.width)
+            && std::max(a.bottom, b.bottom) < std::min(a.bottom + a.height, b.bottom + b.height);
+    }
 }
 
 using namespace cro;
 using namespace cro::Detail;
 
 QuadTree::QuadTree(FloatRect rootArea)
-    : m_rootArea    (rootArea),
-    m_rootNode      (std::make_unique<QuadTree::Node>())
+    : m_rootArea    (normalise(rootArea)),
+    m_freeNodes     (Null),
+    m_freeMembers   (Null),
+    m_memberCount   (0),
+    m_linkCount     (0)
 {
-
+    clear();
 }
 
 //public
@@ -62,35 +95,199 @@ void QuadTree::add(Entity member)
 {
     CRO_ASSERT(member.hasComponent<Drawable2D>(), "");
     CRO_ASSERT(member.hasComponent<Transform>(), "");
-    add(m_rootNode.get(), 0, m_rootArea, member);
+    add(member, getAABB(member));
+}
+
+void QuadTree::add(Entity member, FloatRect bounds)
+{
+    CRO_ASSERT(!contains(member), "Entity already in quad tree");
+
+    const auto index = member.getIndex();
+    if (index >= m_memberIDs.size())
+    {
+        m_memberIDs.resize(index + 1, Null);
+    }
+
+    const auto memberID = allocateMember();
+    m_members[memberID].bounds = normalise(bounds);
+    m_members[memberID].entity = member;
+    m_memberIDs[index] = memberID;
+    m_memberCount++;
+
+    insert(memberID, 0);
+    compact();
 }
 
 void QuadTree::remove(Entity member)
 {
-    removeFromNode(m_rootNode.get(), m_rootArea, member);
+    const auto memberID = getMemberID(member);
+    if (memberID != Null)
+    {
+        const auto nodeID = m_members[memberID].node;
+        unlink(memberID);
+
+        m_members[memberID].entity = {};
+        m_members[memberID].next = m_freeMembers;
+        m_freeMembers = memberID;
+        m_memberIDs[member.getIndex()] = Null;
+        m_memberCount--;
+
+        tryMerge(m_nodes[nodeID].parent);
+        compact();
+    }
+}
+
+bool QuadTree::update(Entity member)
+{
+    CRO_ASSERT(member.hasComponent<Drawable2D>(), "");
+    CRO_ASSERT(member.hasComponent<Transform>(), "");
+    return update(member, getAABB(member));
+}
+
+bool QuadTree::update(Entity member, FloatRect bounds)
+{
+    const auto memberID = getMemberID(member);
+    CRO_ASSERT(memberID != Null, "Entity not in quad tree");
+    if (memberID == Null)
+    {
+        return false;
+    }
+
+    bounds = normalise(bounds);
+    m_members[memberID].bounds = bounds;
+
+    //if the member still fits the loose bounds of its node and
+    //can't be moved any deeper there's no need to reinsert it.
+    //The root node holds everything which fits nowhere else.
+    const auto nodeID = m_members[memberID].node;
+    const auto& node = m_nodes[nodeID];
+    if ((nodeID == 0 || getLooseArea(node).contains(bounds))
+        && (isLeaf(node) || findChild(nodeID, bounds) == Null))
+    {
+        return false;
+    }
+
+    unlink(memberID);
+    insert(memberID, 0);
+
+    if (m_members[memberID].node != nodeID)
+    {
+        tryMerge(m_nodes[nodeID].parent);
+    }
+    compact();
+    return true;
+}
+
+bool QuadTree::contains(Entity member) const
+{
+    return getMemberID(member) != Null;
+}
+
+void QuadTree::clear()
+{
+    m_nodes.clear();
+    m_nodes.emplace_back().area = m_rootArea;
+    m_freeNodes = Null;
+
+    m_members.clear();
+    m_freeMembers = Null;
+    m_memberCount = 0;
+    m_linkCount = 0;
+
+    m_memberIDs.clear();
 }
 
 std::vector<Entity> QuadTree::query(FloatRect queryArea) const
 {
     std::vector<Entity> retVal;
-    query(m_rootNode.get(), m_rootArea, queryArea, retVal);
+    query(queryArea, retVal);
 
     return retVal;
 }
 
+void QuadTree::query(FloatRect queryArea, std::vector<Entity>& dst) const
+{
+    queryArea = normalise(queryArea);
+
+    //each level adds at most 4 nodes after removing 1
+    std::array<std::int32_t, (MaxDepth * 3) + 2> stack = {};
+    std::size_t stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize != 0)
+    {
+        //the root is always searched as it also holds members outside of the root area
+        const auto& node = m_nodes[stack[--stackSize]];
+        for (auto memberID = node.firstMember; memberID != Null; memberID = m_members[memberID].next)
+        {
+            if (overlaps(queryArea, m_members[memberID].bounds))
+            {
+                dst.push_back(m_members[memberID].entity);
+            }
+        }
+
+        if (!isLeaf(node))
+        {
+            for (auto i = 0; i < Direction::Count; ++i)
+            {
+                const auto& child = m_nodes[node.firstChild + i];
+                if (child.memberCount != 0 || !isLeaf(child))
+                {
+                    const auto looseArea = getLooseArea(child);
+                    if (queryArea.contains(looseArea))
+                    {
+                        //everything in this branch is inside the query area
+                        addBranch(node.firstChild + i, dst);
+                    }
+                    else if (overlaps(queryArea, looseArea))
+                    {
+                        stack[stackSize++] = node.firstChild + i;
+                    }
+                }
+            }
+        }
+    }
+}
+
 std::vector<std::pair<Entity, Entity>> QuadTree::getIntersecting() const
 {
     std::vector<std::pair<Entity, Entity>> retVal;
-    findIntersections(m_rootNode.get(), retVal);
+    getIntersecting(retVal);
 
     return retVal;
 }
 
+void QuadTree::getIntersecting(std::vector<std::pair<Entity, Entity>>& dst) const
+{
+    //loose cells overlap their neighbours so members may intersect
+    //those in any other cell, not just those of their descendants.
+    //Query the tree with each member, and only keep pairs with members
+    //further along in the pool so that each pair is found only once.
+    std::vector<Entity> results;
+    for (auto i = 0u; i < m_members.size(); ++i)
+    {
+        const auto& member = m_members[i];
+        if (member.node != Null)
+        {
+            results.clear();
+            query(member.bounds, results);
+
+            for (auto other : results)
+            {
+                if (m_memberIDs[other.getIndex()] > static_cast<std::int32_t>(i))
+                {
+                    dst.emplace_back(member.entity, other);
+                }
+            }
+        }
+    }
+}
+
 
 //private
-bool QuadTree::isLeaf(const Node* node) const
+bool QuadTree::isLeaf(const Node& node) const
 {
-    return node->children[0] == nullptr;
+    return node.firstChild == Null;
 }
 
 FloatRect QuadTree::calcBox(FloatRect aabb, std::int32_t direction) const
@@ -114,243 +311,293 @@ FloatRect QuadTree::calcBox(FloatRect aabb, std::int32_t direction) const
     }
 }
 
-std::int32_t QuadTree::getQuadrant(FloatRect nodeBounds, FloatRect aabb) const
+FloatRect QuadTree::getLooseArea(const Node& node) const
 {
-    glm::vec2 centre(nodeBounds.left + (nodeBounds.width / 2.f), nodeBounds.bottom + (nodeBounds.height / 2.f));
-    if (aabb.left + aabb.width < centre.x)
-    {
-        if (aabb.bottom > centre.y)
-        {
-            return Direction::NW;
-        }
+    return { node.area.left - (node.area.width / 2.f), node.area.bottom - (node.area.height / 2.f), node.area.width * 2.f, node.area.height * 2.f };
+}
 
-        if (aabb.bottom + aabb.height <= centre.y)
-        {
-            return Direction::SW;
-        }
+std::int32_t QuadTree::findChild(std::int32_t nodeID, FloatRect bounds) const
+{
+    //members belong to the quadrant containing their centre,
+    //as long as they fit in its loose bounds
+    const auto& node = m_nodes[nodeID];
+    CRO_ASSERT(!isLeaf(node), "");
 
-        //not completely contained
-        return Direction::None;
-    }
+    glm::vec2 centre(node.area.left + (node.area.width / 2.f), node.area.bottom + (node.area.height / 2.f));
+    glm::vec2 memberCentre(bounds.left + (bounds.width / 2.f), bounds.bottom + (bounds.height / 2.f));
 
-    if (aabb.left >= centre.x)
+    std::int32_t dir = Direction::None;
+    if (memberCentre.x < centre.x)
     {
-        if (aabb.bottom > centre.y)
-        {
-            return Direction::NE;
-        }
-
-        if (aabb.bottom + aabb.height <= centre.y)
-        {
-            return Direction::SE;
-        }
-
-        //not completely contained
-        return Direction::None;
+        dir = memberCentre.y < centre.y ? Direction::SW : Direction::NW;
+    }
+    else
+    {
+        dir = memberCentre.y < centre.y ? Direction::SE : Direction::NE;
     }
 
-    return Direction::None;
+    const auto childID = node.firstChild + dir;
+    if (getLooseArea(m_nodes[childID]).contains(bounds))
+    {
+        return childID;
+    }
+    return Null;
 }
 
-void QuadTree::add(Node* node, std::size_t depth, FloatRect area, Entity member)
+void QuadTree::addBranch(std::int32_t nodeID, std::vector<Entity>& dst) const
 {
-    CRO_ASSERT(node, "");
-    CRO_ASSERT(area.contains(getAABB(member)), "");
+    const auto& node = m_nodes[nodeID];
+    for (auto memberID = node.firstMember; memberID != Null; memberID = m_members[memberID].next)
+    {
+        dst.push_back(m_members[memberID].entity);
+    }
 
-    if (isLeaf(node))
+    if (!isLeaf(node))
     {
-        if (depth >= MaxDepth || node->members.size() < Threshold)
+        for (auto i = 0; i < Direction::Count; ++i)
         {
-            node->members.push_back(member);
-        }
-        else
-        {
-            //no room at the inn
-            split(node, area);
-            add(node, depth, area, member);
+            addBranch(node.firstChild + i, dst);
         }
     }
-    else
+}
+
+void QuadTree::insert(std::int32_t memberID, std::int32_t nodeID)
+{
+    const auto bounds = m_members[memberID].bounds;
+
+    while (true)
     {
-        //place in child if fully contained, else add to
-        //this node
-        auto dir = getQuadrant(area, getAABB(member));
-        if (dir != Direction::None)
+        if (isLeaf(m_nodes[nodeID]))
         {
-            add(node->children[dir].get(), depth + 1, calcBox(area, dir), member);
+            if (m_nodes[nodeID].depth >= static_cast<std::int32_t>(MaxDepth)
+                || m_nodes[nodeID].memberCount < static_cast<std::int32_t>(Threshold))
+            {
+                link(memberID, nodeID);
+                return;
+            }
+
+            //no room at the inn
+            split(nodeID);
         }
-        else
+
+        //place in child if it fits, else add to this node
+        const auto childID = findChild(nodeID, bounds);
+        if (childID == Null)
         {
-            node->members.push_back(member);
+            link(memberID, nodeID);
+            return;
         }
+        nodeID = childID;
     }
 }
 
-void QuadTree::split(Node* node, FloatRect area)
+void QuadTree::link(std::int32_t memberID, std::int32_t nodeID)
 {
-    CRO_ASSERT(node, "");
-    CRO_ASSERT(isLeaf(node), "");
+    auto& member = m_members[memberID];
+    auto& node = m_nodes[nodeID];
 
-    for (auto& c : node->children)
-    {
-        c = std::make_unique<Node>();
-    }
+    member.node = nodeID;
+    member.prev = Null;
+    member.next = node.firstMember;
 
-    std::vector<Entity> newMembers;
-    for (auto m : node->members)
+    if (node.firstMember != Null)
     {
-        auto dir = getQuadrant(area, getAABB(m));
-        if (dir != Direction::None)
-        {
-            node->children[dir]->members.push_back(m);
-        }
-        else
-        {
-            newMembers.push_back(m);
-        }
+        m_members[node.firstMember].prev = memberID;
     }
-    node->members.swap(newMembers);
+    node.firstMember = memberID;
+    node.memberCount++;
+
+    m_linkCount++;
 }
 
-bool QuadTree::removeFromNode(Node* node, FloatRect area, Entity member)
+void QuadTree::unlink(std::int32_t memberID)
 {
-    CRO_ASSERT(node, "");
-    CRO_ASSERT(area.contains(getAABB(member)), "");
+    auto& member = m_members[memberID];
+    auto& node = m_nodes[member.node];
 
-    if (isLeaf(node))
+    if (member.prev != Null)
+    {
+        m_members[member.prev].next = member.next;
+    }
+    else
     {
-        removeMember(node, member);
-        return true;
+        node.firstMember = member.next;
     }
 
-    auto dir = getQuadrant(area, getAABB(member));
-    if (dir != Direction::None)
+    if (member.next != Null)
     {
-        if (removeFromNode(node->children[dir].get(), calcBox(area, dir), member))
-        {
-            return tryMerge(node);
-        }
+        m_members[member.next].prev = member.prev;
     }
-    removeMember(node, member);
-    return false;
+
+    node.memberCount--;
+    member.node = Null;
+    member.prev = Null;
+    member.next = Null;
 }
 
-void QuadTree::removeMember(Node* node, Entity member)
+void QuadTree::split(std::int32_t nodeID)
 {
-    auto result = std::find_if(node->members.begin(), node->members.end(),
-        [member](Entity e)
-        {
-            return member == e;
-        });
+    CRO_ASSERT(isLeaf(m_nodes[nodeID]), "");
 
-    //should always exist when searching...
-    CRO_ASSERT(result != node->members.end(), "");
-    *result = node->members.back();
-    node->members.pop_back();
-}
+    //may resize the pool, so don't take any references before this
+    const auto firstChild = allocateNodes();
 
-bool QuadTree::tryMerge(Node* node)
-{
-    CRO_ASSERT(node, "");
-    CRO_ASSERT(!isLeaf(node), "");
+    auto& node = m_nodes[nodeID];
+    for (auto i = 0; i < Direction::Count; ++i)
+    {
+        auto& child = m_nodes[firstChild + i];
+        child = Node();
+        child.area = calcBox(node.area, i);
+        child.parent = nodeID;
+        child.depth = node.depth + 1;
+    }
+    node.firstChild = firstChild;
 
-    auto memberCount = node->members.size();
-    for (const auto& c : node->children)
+    auto memberID = node.firstMember;
+    while (memberID != Null)
     {
-        if (isLeaf(c.get()))
+        const auto next = m_members[memberID].next;
+        const auto childID = findChild(nodeID, m_members[memberID].bounds);
+        if (childID != Null)
         {
-            return false;
+            unlink(memberID);
+            link(memberID, childID);
         }
-        memberCount += c->members.size();
+        memberID = next;
     }
+}
 
-    if (memberCount < Threshold)
+void QuadTree::tryMerge(std::int32_t nodeID)
+{
+    //walk up the tree collapsing any branches which
+    //have too few members to be worth splitting
+    while (nodeID != Null)
     {
-        for (auto& c : node->children)
+        auto& node = m_nodes[nodeID];
+        CRO_ASSERT(!isLeaf(node), "");
+
+        auto memberCount = node.memberCount;
+        for (auto i = 0; i < Direction::Count; ++i)
         {
-            for (auto m : c->members)
+            const auto& child = m_nodes[node.firstChild + i];
+            if (!isLeaf(child))
             {
-                node->members.push_back(m);
+                return;
             }
-            c.reset();
+            memberCount += child.memberCount;
         }
-        return true;
-    }
-
-    return false;
-}
-
-void QuadTree::query(Node* node, FloatRect area, FloatRect queryArea, std::vector<Entity>& dst) const
-{
-    CRO_ASSERT(node, "");
-    CRO_ASSERT(queryArea.intersects(area), "");
 
-    for (auto m : node->members)
-    {
-        if (queryArea.intersects(getAABB(m)))
+        if (memberCount >= static_cast<std::int32_t>(Threshold))
         {
-            dst.push_back(m);
+            return;
         }
-    }
 
-    if (!isLeaf(node))
-    {
         for (auto i = 0; i < Direction::Count; ++i)
         {
-            auto childArea = calcBox(area, i);
-            if (childArea.intersects(queryArea))
+            const auto childID = node.firstChild + i;
+            while (m_nodes[childID].firstMember != Null)
             {
-                query(node->children[i].get(), childArea, queryArea, dst);
+                const auto memberID = m_nodes[childID].firstMember;
+                unlink(memberID);
+                link(memberID, nodeID);
             }
+            m_nodes[childID].depth = Null;
         }
+
+        //free nodes are linked through the first child of each block
+        m_nodes[node.firstChild].firstChild = m_freeNodes;
+        m_freeNodes = node.firstChild;
+        node.firstChild = Null;
+
+        nodeID = node.parent;
     }
 }
 
-void QuadTree::findIntersections(Node* node, std::vector<std::pair<Entity, Entity>>& dst) const
+void QuadTree::compact()
 {
-    for (auto i = 0u; i < node->members.size(); ++i)
+    //members are traversed by their links, so over time as they're
+    //added and moved they become scattered through the pool. Once
+    //enough have been relinked rebuild the pool in node order so that
+    //queries read members of the same node from consecutive memory.
+    if (m_linkCount < std::max(m_memberCount / 4, MinCompactCount))
     {
-        for (auto j = 0u; j < i; ++j)
-        {
-            if (getAABB(node->members[i]).intersects(getAABB(node->members[j])))
-            {
-                dst.emplace_back(node->members[i], node->members[j]);
-            }
-        }
+        return;
     }
 
-    if (!isLeaf(node))
+    std::vector<Member> members;
+    members.reserve(m_memberCount);
+
+    for (auto& node : m_nodes)
     {
-        for (const auto& c : node->children)
+        auto memberID = node.firstMember;
+        node.firstMember = Null;
+
+        while (memberID != Null)
         {
-            for (auto m : c->members)
+            const auto newID = static_cast<std::int32_t>(members.size());
+            auto& member = members.emplace_back(m_members[memberID]);
+            member.next = Null;
+
+            if (newID == 0 || members[newID - 1].node != member.node)
+            {
+                member.prev = Null;
+                node.firstMember = newID;
+            }
+            else
             {
-                findChildIntersections(c.get(), m, dst);
+                member.prev = newID - 1;
+                members[newID - 1].next = newID;
             }
 
-            findIntersections(c.get(), dst);
+            m_memberIDs[member.entity.getIndex()] = newID;
+            memberID = m_members[memberID].next;
         }
     }
+
+    m_members.swap(members);
+    m_freeMembers = Null;
+    m_linkCount = 0;
 }
 
-void QuadTree::findChildIntersections(Node* node, Entity member, std::vector<std::pair<Entity, Entity>>& dst) const
+std::int32_t QuadTree::allocateNodes()
 {
-    auto memberBounds = getAABB(member);
-    for (auto m : node->members)
+    if (m_freeNodes != Null)
     {
-        if (memberBounds.intersects(getAABB(m)))
-        {
-            dst.emplace_back(member, m);
-        }
+        const auto nodeID = m_freeNodes;
+        m_freeNodes = m_nodes[nodeID].firstChild;
+        return nodeID;
     }
 
-    if (!isLeaf(node))
+    const auto nodeID = static_cast<std::int32_t>(m_nodes.size());
+    m_nodes.resize(m_nodes.size() + Direction::Count);
+    return nodeID;
+}
+
+std::int32_t QuadTree::allocateMember()
+{
+    if (m_freeMembers != Null)
     {
-        for (const auto& c : node->children)
-        {
-            findChildIntersections(c.get(), member, dst);
-        }
+        const auto memberID = m_freeMembers;
+        m_freeMembers = m_members[memberID].next;
+        m_members[memberID].next = Null;
+        return memberID;
+    }
+
+    const auto memberID = static_cast<std::int32_t>(m_members.size());
+    m_members.emplace_back();
+    return memberID;
+}
+
+std::int32_t QuadTree::getMemberID(Entity entity) const
+{
+    const auto index = entity.getIndex();
+    if (index < m_memberIDs.size()
+        && m_memberIDs[index] != Null
+        && m_members[m_memberIDs[index]].entity == entity)
+    {
+        return m_memberIDs[index];
     }
+    return Null;
 }
 
 FloatRect QuadTree::getAABB(Entity entity) const
@@ -0,0 +1,362 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include <crogine/detail/RenderGraph.hpp>
+#include <crogine/detail/Assert.hpp>
+#include <crogine/core/Log.hpp>
+
+#include <algorithm>
+
+using namespace cro;
+using namespace cro::Detail;
+
+RenderGraph::RenderGraph()
+    : m_output  (Invalid),
+    m_compiled  (false)
+{
+
+}
+
+//public
+std::size_t RenderGraph::addImportedTarget(const std::string& name)
+{
+    auto& target = m_targets.emplace_back();
+    target.name = name;
+    target.imported = true;
+
+    m_compiled = false;
+    return m_targets.size() - 1;
+}
+
+std::size_t RenderGraph::addTransientTarget(const std::string& name, const RenderTargetDesc& desc)
+{
+    auto& target = m_targets.emplace_back();
+    target.name = name;
+    target.desc = desc;
+
+    m_compiled = false;
+    return m_targets.size() - 1;
+}
+
+std::size_t RenderGraph::addPass(const std::string& name, const std::vector<std::size_t>& reads, const std::vector<std::size_t>& writes)
+{
+    auto& pass = m_passes.emplace_back();
+    pass.name = name;
+    pass.reads = reads;
+    pass.writes = writes;
+
+    m_compiled = false;
+    return m_passes.size() - 1;
+}
+
+void RenderGraph::setOutput(std::size_t target)
+{
+    m_output = target;
+    m_compiled = false;
+}
+
+bool RenderGraph::compile()
+{
+    m_compiled = false;
+    m_executionOrder.clear();
+    m_physicalTargets.clear();
+
+    for (auto& target : m_targets)
+    {
+        target.writer = Invalid;
+        target.physicalIndex = Invalid;
+        target.firstUse = Invalid;
+        target.lastUse = 0;
+    }
+
+    if (m_output >= m_targets.size())
+    {
+        LogE << "Render graph has no output target" << std::endl;
+        return false;
+    }
+
+    if (!resolveWriters())
+    {
+        return false;
+    }
+
+    cullPasses();
+
+    if (!sortPasses())
+    {
+        return false;
+    }
+
+    assignPhysicalTargets();
+
+    m_compiled = true;
+    return true;
+}
+
+bool RenderGraph::isCulled(std::size_t pass) const
+{
+    CRO_ASSERT(pass < m_passes.size(), "Pass ID out of range");
+    return m_passes[pass].culled;
+}
+
+std::size_t RenderGraph::getPhysicalIndex(std::size_t target) const
+{
+    CRO_ASSERT(target < m_targets.size(), "Target ID out of range");
+    return m_targets[target].physicalIndex;
+}
+
+const std::vector<std::size_t>& RenderGraph::getReads(std::size_t pass) const
+{
+    CRO_ASSERT(pass < m_passes.size(), "Pass ID out of range");
+    return m_passes[pass].reads;
+}
+
+const std::vector<std::size_t>& RenderGraph::getWrites(std::size_t pass) const
+{
+    CRO_ASSERT(pass < m_passes.size(), "Pass ID out of range");
+    return m_passes[pass].writes;
+}
+
+void RenderGraph::clear()
+{
+    m_targets.clear();
+    m_passes.clear();
+    m_output = Invalid;
+    m_compiled = false;
+    m_executionOrder.clear();
+    m_physicalTargets.clear();
+}
+
+//private
+bool RenderGraph::resolveWriters()
+{
+    for (auto i = 0u; i < m_passes.size(); ++i)
+    {
+        for (auto id : m_passes[i].writes)
+        {
+            if (id >= m_targets.size())
+            {
+                LogE << m_passes[i].name << ": writes to invalid target ID " << id << std::endl;
+                return false;
+            }
+
+            auto& target = m_targets[id];
+            if (target.writer != Invalid)
+            {
+                LogE << target.name << ": written by both " << m_passes[target.writer].name << " and " << m_passes[i].name << std::endl;
+                return false;
+            }
+            target.writer = i;
+        }
+    }
+
+    for (const auto& pass : m_passes)
+    {
+        for (auto id : pass.reads)
+        {
+            if (id >= m_targets.size())
+            {
+                LogE << pass.name << ": reads from invalid target ID " << id << std::endl;
+                return false;
+            }
+
+            const auto& target = m_targets[id];
+            if (!target.imported
+                && target.writer == Invalid)
+            {
+                LogE << pass.name << ": reads from " << target.name << " which is never written" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    if (m_targets[m_output].writer == Invalid)
+    {
+        LogE << "Render graph output " << m_targets[m_output].name << " is never written" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void RenderGraph::cullPasses()
+{
+    for (auto& pass : m_passes)
+    {
+        pass.culled = true;
+    }
+
+    //walk back from the output marking each pass it depends on
+    std::vector<std::size_t> pending = { m_targets[m_output].writer };
+    while (!pending.empty())
+    {
+        auto idx = pending.back();
+        pending.pop_back();
+
+        auto& pass = m_passes[idx];
+        if (!pass.culled)
+        {
+            continue;
+        }
+        pass.culled = false;
+
+        for (auto id : pass.reads)
+        {
+            if (auto writer = m_targets[id].writer; writer != Invalid)
+            {
+                pending.push_back(writer);
+            }
+        }
+    }
+}
+
+bool RenderGraph::sortPasses()
+{
+    //count the passes each live pass waits on
+    std::vector<std::size_t> dependencyCount(m_passes.size());
+    std::size_t liveCount = 0;
+    for (auto i = 0u; i < m_passes.size(); ++i)
+    {
+        const auto& pass = m_passes[i];
+        if (pass.culled)
+        {
+            continue;
+        }
+        liveCount++;
+
+        for (auto id : pass.reads)
+        {
+            if (m_targets[id].writer != Invalid)
+            {
+                dependencyCount[i]++;
+            }
+        }
+    }
+
+    //when several passes are ready take them in the order they
+    //were added, so the result is deterministic
+    std::vector<bool> scheduled(m_passes.size(), false);
+    while (m_executionOrder.size() < liveCount)
+    {
+        auto next = Invalid;
+        for (auto i = 0u; i < m_passes.size(); ++i)
+        {
+            if (!m_passes[i].culled
+                && !scheduled[i]
+                && dependencyCount[i] == 0)
+            {
+                next = i;
+                break;
+            }
+        }
+
+        if (next == Invalid)
+        {
+            LogE << "Render graph contains a cycle" << std::endl;
+            m_executionOrder.clear();
+            return false;
+        }
+
+        scheduled[next] = true;
+        m_executionOrder.push_back(next);
+
+        for (auto id : m_passes[next].writes)
+        {
+            for (auto i = 0u; i < m_passes.size(); ++i)
+            {
+                if (!m_passes[i].culled)
+                {
+                    dependencyCount[i] -= std::count(m_passes[i].reads.begin(), m_passes[i].reads.end(), id);
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+void RenderGraph::assignPhysicalTargets()
+{
+    //each target lives from its first use to its last use
+    for (auto i = 0u; i < m_executionOrder.size(); ++i)
+    {
+        const auto& pass = m_passes[m_executionOrder[i]];
+        for (const auto* ids : { &pass.reads, &pass.writes })
+        {
+            for (auto id : *ids)
+            {
+                auto& target = m_targets[id];
+                target.firstUse = std::min(target.firstUse, std::size_t(i));
+                target.lastUse = std::max(target.lastUse, std::size_t(i));
+            }
+        }
+    }
+
+    std::vector<std::size_t> transients;
+    for (auto i = 0u; i < m_targets.size(); ++i)
+    {
+        if (!m_targets[i].imported
+            && m_targets[i].firstUse != Invalid)
+        {
+            transients.push_back(i);
+        }
+    }
+    std::sort(transients.begin(), transients.end(),
+        [&](std::size_t a, std::size_t b)
+        {
+            return m_targets[a].firstUse == m_targets[b].firstUse ?
+                a < b : m_targets[a].firstUse < m_targets[b].firstUse;
+        });
+
+    //a physical target can be reused by a target with the same description
+    //once the pass which last used it has finished. Targets used by the same
+    //pass always overlap, so a pass never reads and writes the same memory
+    std::vector<std::size_t> physicalLastUse;
+    for (auto id : transients)
+    {
+        auto& target = m_targets[id];
+        for (auto i = 0u; i < m_physicalTargets.size(); ++i)
+        {
+            if (m_physicalTargets[i] == target.desc
+                && physicalLastUse[i] < target.firstUse)
+            {
+                target.physicalIndex = i;
+                physicalLastUse[i] = target.lastUse;
+                break;
+            }
+        }
+
+        if (target.physicalIndex == Invalid)
+        {
+            target.physicalIndex = m_physicalTargets.size();
+            m_physicalTargets.push_back(target.desc);
+            physicalLastUse.push_back(target.lastUse);
+        }
+    }
+}
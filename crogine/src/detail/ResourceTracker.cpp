@@ -0,0 +1,161 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include <crogine/detail/ResourceTracker.hpp>
+
+#include <algorithm>
+
+using namespace cro;
+using namespace cro::Detail;
+
+ResourceTracker::ResourceTracker()
+    : m_clock       (0),
+    m_bytesUsed     (0),
+    m_budget        (0),
+    m_evictionCount (0)
+{
+
+}
+
+//public
+void ResourceTracker::add(std::size_t id, std::size_t byteSize)
+{
+    remove(id);
+
+    Entry entry;
+    entry.byteSize = byteSize;
+    entry.lastUsed = ++m_clock;
+    m_entries.insert(std::make_pair(id, entry));
+
+    m_bytesUsed += byteSize;
+}
+
+void ResourceTracker::remove(std::size_t id)
+{
+    if (auto result = m_entries.find(id); result != m_entries.end())
+    {
+        m_bytesUsed -= result->second.byteSize;
+        m_entries.erase(result);
+    }
+}
+
+void ResourceTracker::setByteSize(std::size_t id, std::size_t byteSize)
+{
+    if (auto result = m_entries.find(id); result != m_entries.end())
+    {
+        m_bytesUsed -= result->second.byteSize;
+        m_bytesUsed += byteSize;
+        result->second.byteSize = byteSize;
+    }
+}
+
+void ResourceTracker::touch(std::size_t id)
+{
+    if (auto result = m_entries.find(id); result != m_entries.end())
+    {
+        result->second.lastUsed = ++m_clock;
+    }
+}
+
+bool ResourceTracker::acquire(std::size_t id)
+{
+    if (auto result = m_entries.find(id); result != m_entries.end())
+    {
+        result->second.refCount++;
+        result->second.lastUsed = ++m_clock;
+        return true;
+    }
+    return false;
+}
+
+bool ResourceTracker::release(std::size_t id)
+{
+    if (auto result = m_entries.find(id); result != m_entries.end()
+        && result->second.refCount > 0)
+    {
+        result->second.refCount--;
+        return true;
+    }
+    return false;
+}
+
+std::int32_t ResourceTracker::getRefCount(std::size_t id) const
+{
+    if (auto result = m_entries.find(id); result != m_entries.end())
+    {
+        return result->second.refCount;
+    }
+    return -1;
+}
+
+std::vector<std::size_t> ResourceTracker::collect()
+{
+    std::vector<std::size_t> retVal;
+    if (m_budget == 0
+        || m_bytesUsed <= m_budget)
+    {
+        return retVal;
+    }
+
+    std::vector<std::pair<std::uint64_t, std::size_t>> candidates;
+    for (const auto& [id, entry] : m_entries)
+    {
+        if (entry.refCount == 0)
+        {
+            candidates.emplace_back(entry.lastUsed, id);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (auto i = 0u; i < candidates.size() && m_bytesUsed > m_budget; ++i)
+    {
+        retVal.push_back(candidates[i].second);
+        remove(candidates[i].second);
+    }
+    m_evictionCount += retVal.size();
+
+    return retVal;
+}
+
+void ResourceTracker::clear()
+{
+    m_entries.clear();
+    m_bytesUsed = 0;
+}
+
+ResourceStats ResourceTracker::getStats() const
+{
+    ResourceStats stats;
+    stats.resourceCount = m_entries.size();
+    stats.bytesUsed = m_bytesUsed;
+    stats.budget = m_budget;
+    stats.evictionCount = m_evictionCount;
+    return stats;
+}
@@ -0,0 +1,111 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace cro::Detail
+{
+    /*!
+    \brief Fixed size, lock free queue with a single producer and a single consumer.
+    push() must only ever be called from one thread, and pop() from one
+    other thread. Capacity must be a power of two.
+    */
+    template <typename T, std::size_t Capacity>
+    class SPSCQueue final
+    {
+        static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        SPSCQueue() = default;
+
+        SPSCQueue(const SPSCQueue&) = delete;
+        SPSCQueue(SPSCQueue&&) = delete;
+        SPSCQueue& operator = (const SPSCQueue&) = delete;
+        SPSCQueue& operator = (SPSCQueue&&) = delete;
+
+        /*!
+        \brief Pushes a copy of the given item on to the queue.
+        Only call this from the producer thread.
+        \returns false if the queue is full
+        */
+        bool push(const T& item)
+        {
+            const auto tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+            {
+                return false;
+            }
+
+            m_buffer[tail & (Capacity - 1)] = item;
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /*!
+        \brief Pops the item at the front of the queue into dst.
+        Only call this from the consumer thread.
+        \returns false if the queue is empty
+        */
+        bool pop(T& dst)
+        {
+            const auto head = m_head.load(std::memory_order_relaxed);
+            if (head == m_tail.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+
+            dst = m_buffer[head & (Capacity - 1)];
+            m_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /*!
+        \brief Returns the number of items in the queue.
+        This is only a snapshot when called while the other thread is active.
+        */
+        std::size_t size() const
+        {
+            return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+        }
+
+        bool empty() const { return size() == 0; }
+
+    private:
+        //keep the indices on separate cache lines so the
+        //producer and consumer don't keep invalidating each other
+        alignas(64) std::atomic<std::size_t> m_head = 0;
+        alignas(64) std::atomic<std::size_t> m_tail = 0;
+        alignas(64) std::array<T, Capacity> m_buffer = {};
+    };
+}
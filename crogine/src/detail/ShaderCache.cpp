@@ -0,0 +1,349 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include <crogine/detail/ShaderCache.hpp>
+#include <crogine/detail/Types.hpp>
+#include <crogine/core/FileSystem.hpp>
+#include <crogine/core/Log.hpp>
+
+#include <SDL_rwops.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+using namespace cro;
+using namespace cro::Detail;
+
+namespace
+{
+    //bump this if the file format changes to invalidate existing files
+    constexpr std::uint32_t CacheVersion = 1;
+    constexpr std::uint32_t CacheMagic = 0x48535243; //CRSH
+
+    struct CacheHeader final
+    {
+        std::uint32_t magic = CacheMagic;
+        std::uint32_t version = CacheVersion;
+        std::uint64_t key = 0;
+        std::uint32_t format = 0;
+        std::uint32_t size = 0;
+    };
+
+    //no binary is ever this large, so it's probably a corrupt file
+    constexpr std::uint32_t MaxBinarySize = 64 * 1024 * 1024;
+}
+
+ShaderCache::ShaderCache()
+    : m_driverHash(0)
+{
+
+}
+
+//public
+bool ShaderCache::setDirectory(const std::string& path)
+{
+    m_directory.clear();
+
+    if (path.empty())
+    {
+        return true;
+    }
+
+    auto directory = path;
+    std::replace(directory.begin(), directory.end(), '\\', '/');
+    if (directory.back() != '/')
+    {
+        directory.push_back('/');
+    }
+
+    if (!FileSystem::directoryExists(directory)
+        && !FileSystem::createDirectory(directory))
+    {
+        LogW << "Could not create shader cache directory " << directory << ", shader cache is disabled" << std::endl;
+        return false;
+    }
+
+    m_directory = directory;
+    return true;
+}
+
+void ShaderCache::setDriverString(const std::string& driver)
+{
+    m_driverHash = hash(driver.data(), driver.size());
+}
+
+std::uint64_t ShaderCache::getKey(std::initializer_list<const char*> sources) const
+{
+    auto key = hash(&CacheVersion, sizeof(CacheVersion));
+    key = hash(&m_driverHash, sizeof(m_driverHash), key);
+
+    for (const auto* source : sources)
+    {
+        //include the length so that moving text between
+        //stages doesn't create the same key
+        const std::uint64_t length = source ? std::strlen(source) : std::numeric_limits<std::uint64_t>::max();
+        key = hash(&length, sizeof(length), key);
+
+        if (source)
+        {
+            key = hash(source, length, key);
+        }
+    }
+
+    return key;
+}
+
+std::string ShaderCache::getPath(std::uint64_t key) const
+{
+    char name[17] = {};
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+    return m_directory + name + ".bin";
+}
+
+bool ShaderCache::read(std::uint64_t key, std::uint32_t& format, std::vector<std::uint8_t>& dst) const
+{
+    if (!isEnabled())
+    {
+        return false;
+    }
+
+    const auto path = getPath(key);
+    if (!FileSystem::fileExists(path))
+    {
+        return false;
+    }
+
+    RaiiRWops file;
+    file.file = SDL_RWFromFile(path.c_str(), "rb");
+    if (!file.file)
+    {
+        return false;
+    }
+
+    const auto fileSize = SDL_RWsize(file.file);
+
+    CacheHeader header;
+    if (fileSize < static_cast<Sint64>(sizeof(header))
+        || SDL_RWread(file.file, &header, sizeof(header), 1) != 1)
+    {
+        LogW << path << ": invalid shader cache file" << std::endl;
+        return false;
+    }
+
+    if (header.magic != CacheMagic
+        || header.version != CacheVersion
+        || header.key != key
+        || header.size == 0
+        || header.size > MaxBinarySize
+        || static_cast<Sint64>(sizeof(header) + header.size) != fileSize)
+    {
+        LogW << path << ": invalid shader cache file" << std::endl;
+        return false;
+    }
+
+    dst.resize(header.size);
+    if (SDL_RWread(file.file, dst.data(), header.size, 1) != 1)
+    {
+        LogW << path << ": failed reading shader cache file" << std::endl;
+        dst.clear();
+        return false;
+    }
+
+    format = header.format;
+    return true;
+}
+
+bool ShaderCache::write(std::uint64_t key, std::uint32_t format, const std::vector<std::uint8_t>& data) const
+{
+    if (!isEnabled()
+        || data.empty()
+        || data.size() > MaxBinarySize)
+    {
+        return false;
+    }
+
+    CacheHeader header;
+    header.key = key;
+    header.format = format;
+    header.size = static_cast<std::uint32_t>(data.size());
+
+    //write to a temp file first so that a crash part way
+    //through doesn't leave a broken file in the cache
+    const auto path = getPath(key);
+    const auto tempPath = path + ".tmp";
+
+    SDL_RWops* file = SDL_RWFromFile(tempPath.c_str(), "wb");
+    if (!file)
+    {
+        LogW << "Failed opening " << tempPath << " for writing" << std::endl;
+        return false;
+    }
+
+    bool success = SDL_RWwrite(file, &header, sizeof(header), 1) == 1
+        && SDL_RWwrite(file, data.data(), data.size(), 1) == 1;
+
+    if (SDL_RWclose(file) != 0)
+    {
+        success = false;
+    }
+
+    if (success)
+    {
+        std::remove(path.c_str());
+        success = std::rename(tempPath.c_str(), path.c_str()) == 0;
+    }
+
+    if (!success)
+    {
+        LogW << "Failed writing " << path << std::endl;
+        std::remove(tempPath.c_str());
+    }
+
+    return success;
+}
+
+std::uint64_t ShaderCache::hash(const void* data, std::size_t size, std::uint64_t seed)
+{
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    for (auto i = 0u; i < size; ++i)
+    {
+        seed ^= bytes[i];
+        seed *= 0x100000001b3;
+    }
+    return seed;
+}
+
+
+//manifest
+void ShaderManifest::add(std::int32_t id)
+{
+    auto result = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+    if (result == m_ids.end() || *result != id)
+    {
+        m_ids.insert(result, id);
+    }
+}
+
+std::string ShaderManifest::serialise() const
+{
+    std::string retVal = "#crogine shader manifest\n";
+
+    char line[16] = {};
+    for (auto id : m_ids)
+    {
+        std::snprintf(line, sizeof(line), "%08x\n", static_cast<std::uint32_t>(id));
+        retVal += line;
+    }
+
+    return retVal;
+}
+
+bool ShaderManifest::deserialise(const std::string& str)
+{
+    m_ids.clear();
+
+    std::istringstream stream(str);
+    std::string line;
+    std::size_t lineNumber = 0;
+    while (std::getline(stream, line))
+    {
+        lineNumber++;
+
+        line.erase(0, line.find_first_not_of(" \t"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        char* end = nullptr;
+        const auto value = std::strtoul(line.c_str(), &end, 16);
+        if (*end != 0
+            || value > std::numeric_limits<std::uint32_t>::max())
+        {
+            LogE << "Shader manifest line " << lineNumber << ": invalid ID " << line << std::endl;
+            m_ids.clear();
+            return false;
+        }
+        add(static_cast<std::int32_t>(value));
+    }
+
+    return true;
+}
+
+bool ShaderManifest::loadFromFile(const std::string& path)
+{
+    RaiiRWops file;
+    file.file = SDL_RWFromFile(path.c_str(), "rb");
+    if (!file.file)
+    {
+        LogE << "Failed opening shader manifest " << path << std::endl;
+        return false;
+    }
+
+    std::string str(static_cast<std::size_t>(std::max(Sint64(0), SDL_RWsize(file.file))), '\0');
+    if (!str.empty()
+        && SDL_RWread(file.file, str.data(), str.size(), 1) != 1)
+    {
+        LogE << "Failed reading shader manifest " << path << std::endl;
+        return false;
+    }
+
+    return deserialise(str);
+}
+
+bool ShaderManifest::saveToFile(const std::string& path) const
+{
+    const auto str = serialise();
+
+    SDL_RWops* file = SDL_RWFromFile(path.c_str(), "wb");
+    if (!file)
+    {
+        LogE << "Failed opening " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    bool success = SDL_RWwrite(file, str.data(), str.size(), 1) == 1;
+    if (SDL_RWclose(file) != 0)
+    {
+        success = false;
+    }
+
+    if (!success)
+    {
+        LogE << "Failed writing shader manifest " << path << std::endl;
+    }
+    return success;
+}
@@ -34,14 +34,17 @@ source distribution.
 #include <crogine/ecs/components/Transform.hpp>
 #include <crogine/ecs/components/AudioListener.hpp>
 #include <crogine/ecs/Renderable.hpp>
+#include <crogine/ecs/systems/VisibilitySystem.hpp>
 
 #include <crogine/core/Clock.hpp>
 #include <crogine/core/App.hpp>
 #include <crogine/core/ConfigFile.hpp>
+#include <crogine/core/Profiler.hpp>
 
 #include <crogine/graphics/Image.hpp>
 #include <crogine/graphics/EnvironmentMap.hpp>
 #include <crogine/util/Constants.hpp>
+#include <crogine/detail/GlobalConsts.hpp>
 #include <crogine/detail/glm/gtc/matrix_transform.hpp>
 #include <crogine/detail/glm/gtc/type_ptr.hpp>
 
@@ -127,7 +130,7 @@ namespace
 
     void updateView(cro::Camera& camera)
     {
-        glm::vec2 size(cro::App::getWindow().getSize());
+        glm::vec2 size = cro::App::isHeadless() ? cro::Detail::HeadlessWindowSize : glm::vec2(cro::App::getWindow().getSize());
         if (camera.isOrthographic())
         {
             camera.setOrthographic(0.f, size.x, 0.f, size.y, 0.f, 10.f);
@@ -149,18 +152,26 @@ namespace
 Scene::Scene(MessageBus& mb, std::size_t initialPoolSize, std::uint32_t infoFlags)
     : m_messageBus          (mb),
     m_uid                   (++uid),
+    m_headless              ((infoFlags & SCENE_FLAG_HEADLESS) != 0 || App::isHeadless()),
     m_entityManager         (mb, m_componentManager, initialPoolSize),
-    m_systemManager         (*this, m_componentManager, infoFlags),
+    //info windows require ImGui, which is unavailable without an App window
+    m_systemManager         (*this, m_componentManager, App::isHeadless() ? 0 : (infoFlags & ~SCENE_FLAG_HEADLESS)),
+    m_visibilitySystem      (nullptr),
     m_projectionMapCount    (0),
     m_waterLevel            (0.f),
     m_activeSkyboxTexture   (0),
     m_shaderIndex           (0)
 {
+    m_visibilitySystem = addSystem<VisibilitySystem>(mb);
+
     auto defaultCamera = createEntity();
     defaultCamera.addComponent<Transform>();
     defaultCamera.addComponent<Camera>().resizeCallback = std::bind(&updateView, std::placeholders::_1);
     defaultCamera.addComponent<AudioListener>();
-    updateView(defaultCamera.getComponent<Camera>());
+    if (!m_headless)
+    {
+        updateView(defaultCamera.getComponent<Camera>());
+    }
 
     m_defaultCamera = defaultCamera;
     m_activeCamera = m_defaultCamera;
@@ -239,7 +250,8 @@ void Scene::setPostEnabled(bool enabled)
 {
     using namespace std::placeholders;
 
-    if (enabled && !m_postEffects.empty())
+    if (enabled && !m_postEffects.empty()
+        && !m_headless)
     {
         currentRenderPath = std::bind(&Scene::postRenderPath, this, _1, _2, _3);
         auto size = App::getWindow().getSize();
@@ -264,6 +276,12 @@ Entity Scene::getSunlight() const
 
 void Scene::enableSkybox()
 {
+    if (m_headless)
+    {
+        LogW << "Skybox is not available in headless scenes" << std::endl;
+        return;
+    }
+
     if (!m_skybox.vbo)
     {
         if (m_skyboxShaders[SkyboxType::Coloured].getGLHandle() ||
@@ -354,6 +372,12 @@ void Scene::disableSkybox()
 
 void Scene::setCubemap(const std::string& path)
 {
+    if (m_headless)
+    {
+        LogW << "Cubemaps are not available in headless scenes" << std::endl;
+        return;
+    }
+
     //TODO replace this with the CubemapTexture class
     //once I can be bothered to implement move operators for it :3
 
@@ -464,6 +488,12 @@ void Scene::setCubemap(const std::string& path)
 
 void Scene::setCubemap(const EnvironmentMap& map)
 {
+    if (m_headless)
+    {
+        LogW << "Cubemaps are not available in headless scenes" << std::endl;
+        return;
+    }
+
     enableSkybox();
 
     if (m_skyboxShaders[SkyboxType::Environment].getGLHandle() == 0)
@@ -574,6 +604,11 @@ void Scene::forwardMessage(const Message& msg)
 
 void Scene::render(bool doPost)
 {
+    if (m_headless)
+    {
+        return;
+    }
+
     if (doPost)
     {
         currentRenderPath(*RenderTarget::getActiveTarget(), &m_activeCamera, 1);
@@ -586,6 +621,11 @@ void Scene::render(bool doPost)
 
 void Scene::render(const std::vector<Entity>& cameras, bool doPost)
 {
+    if (m_headless)
+    {
+        return;
+    }
+
     if (doPost)
     {
         currentRenderPath(*RenderTarget::getActiveTarget(), cameras.data(), cameras.size());
@@ -608,10 +648,17 @@ void Scene::updateDrawLists(Entity camera)
 
     for (auto r : m_renderables)
     {
+        CRO_PROFILE_SCOPE(typeid(*r).name());
         r->updateDrawList(camera);
     }
 }
 
+void Scene::updateVisibility(const std::vector<Entity>& cameras)
+{
+    CRO_PROFILE_SCOPE("VisibilitySystem::update");
+    m_visibilitySystem->update(cameras, m_renderables);
+}
+
 void Scene::setSkyboxOrientation(glm::quat q)
 {
     m_skybox.modelMatrix = glm::mat4(q);
@@ -699,6 +746,8 @@ void Scene::defaultRenderPath(const RenderTarget& rt, const Entity* cameraList,
         //and not other systems.... hum. Ideas on a postcard please.
         for (auto r : m_renderables)
         {
+            CRO_PROFILE_SCOPE(typeid(*r).name());
+            CRO_PROFILE_GPU_SCOPE(typeid(*r).name());
             r->render(cameraList[i], rt);
         }
     }
@@ -713,19 +762,31 @@ void Scene::postRenderPath(const RenderTarget&, const Entity* cameraList, std::s
     defaultRenderPath(m_sceneBuffer, cameraList, cameraCount);
     m_sceneBuffer.display();
 
-    RenderTexture* inTex = &m_sceneBuffer;
-    RenderTexture* outTex = nullptr;
-
-    for (auto i = 0u; i < m_postEffects.size() - 1; ++i)
+    for (auto passID : m_postGraph.getExecutionOrder())
     {
-        outTex = &m_postBuffers[i % 2];
-        outTex->clear();
-        m_postEffects[i]->apply(*inTex);
-        outTex->display();
-        inTex = outTex;
-    }
+        auto& effect = m_postEffects[passID];
 
-    m_postEffects.back()->apply(*inTex);
+        CRO_PROFILE_SCOPE(typeid(*effect).name());
+        CRO_PROFILE_GPU_SCOPE(typeid(*effect).name());
+
+        //imported targets have no physical index
+        auto inputIndex = m_postGraph.getPhysicalIndex(m_postGraph.getReads(passID)[0]);
+        const auto& input = inputIndex == Detail::RenderGraph::Invalid ? m_sceneBuffer : m_postBuffers[inputIndex];
+
+        auto outputIndex = m_postGraph.getPhysicalIndex(m_postOutputs[passID]);
+        if (outputIndex == Detail::RenderGraph::Invalid)
+        {
+            //final effect draws to the active target
+            effect->apply(input);
+        }
+        else
+        {
+            auto& output = m_postBuffers[outputIndex];
+            output.clear();
+            effect->apply(input);
+            output.display();
+        }
+    }
 }
 
 void Scene::destroySkybox()
@@ -759,16 +820,87 @@ void Scene::resizeBuffers(glm::uvec2 size)
             {
                 p->resizeBuffer(size.x, size.y);
             }
+            buildPostGraph(size);
         }
+    }
+}
+
+void Scene::buildPostGraph(glm::uvec2 size)
+{
+    //copy these so existing buffers can be kept if they still match
+    const auto previousTargets = m_postGraph.getPhysicalTargets();
+
+    m_postGraph.clear();
+    m_postOutputs.clear();
+
+    if (m_postEffects.empty())
+    {
+        return;
+    }
+
+    //each effect is a pass which reads the output of the previous effect,
+    //writes any intermediate targets it declared, and writes its own output
+    //which is the active target for the last effect
+    const auto sceneTarget = m_postGraph.addImportedTarget("Scene Buffer");
+    const auto finalTarget = m_postGraph.addImportedTarget("Active Target");
+
+    auto input = sceneTarget;
+    for (auto i = 0u; i < m_postEffects.size(); ++i)
+    {
+        const std::string name = typeid(*m_postEffects[i]).name();
 
-        if (m_postBuffers[0].available())
+        std::vector<std::size_t> writes;
+        for (const auto& target : m_postEffects[i]->m_targets)
         {
-            m_postBuffers[0].create(size.x, size.y, false);
+            Detail::RenderTargetDesc desc;
+            desc.size.x = std::max(1u, static_cast<std::uint32_t>(static_cast<float>(size.x) * target.scale.x));
+            desc.size.y = std::max(1u, static_cast<std::uint32_t>(static_cast<float>(size.y) * target.scale.y));
+            desc.depthBuffer = target.depthBuffer;
+            writes.push_back(m_postGraph.addTransientTarget(name + " Target", desc));
         }
 
-        if (m_postBuffers[1].available())
+        auto output = finalTarget;
+        if (i < m_postEffects.size() - 1)
+        {
+            Detail::RenderTargetDesc desc;
+            desc.size = size;
+            output = m_postGraph.addTransientTarget(name + " Output", desc);
+        }
+        writes.push_back(output);
+        m_postOutputs.push_back(output);
+
+        m_postGraph.addPass(name, { input }, writes);
+        input = output;
+    }
+    m_postGraph.setOutput(finalTarget);
+
+    if (!m_postGraph.compile())
+    {
+        LogE << "Failed compiling post process graph" << std::endl;
+        return;
+    }
+
+    const auto& physicalTargets = m_postGraph.getPhysicalTargets();
+    m_postBuffers.resize(physicalTargets.size());
+    for (auto i = 0u; i < physicalTargets.size(); ++i)
+    {
+        const auto& desc = physicalTargets[i];
+        if (i >= previousTargets.size()
+            || previousTargets[i] != desc
+            || !m_postBuffers[i].available())
+        {
+            m_postBuffers[i].create(desc.size.x, desc.size.y, desc.depthBuffer, desc.stencilBuffer);
+        }
+    }
+
+    for (auto i = 0u; i < m_postEffects.size(); ++i)
+    {
+        auto& targets = m_postEffects[i]->m_targets;
+        const auto& writes = m_postGraph.getWrites(i);
+        for (auto j = 0u; j < targets.size(); ++j)
         {
-            m_postBuffers[1].create(size.x, size.y, false);
+            auto index = m_postGraph.getPhysicalIndex(writes[j]);
+            targets[j].texture = index == Detail::RenderGraph::Invalid ? nullptr : &m_postBuffers[index];
         }
     }
 }
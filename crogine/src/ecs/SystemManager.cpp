@@ -28,6 +28,7 @@ source distribution.
 -----------------------------------------------------------------------*/
 
 #include <crogine/core/Clock.hpp>
+#include <crogine/core/Profiler.hpp>
 #include <crogine/core/SysTime.hpp>
 #include <crogine/ecs/InfoFlags.hpp>
 #include <crogine/ecs/Scene.hpp>
@@ -104,6 +105,16 @@ SystemManager::SystemManager(Scene& scene, ComponentManager& cm, std::uint32_t i
 
             if (ImGui::Begin("System Time"))
             {
+#ifdef CRO_PROFILING
+                //writes the last Profiler::getFrameCapacity() frames
+                if (ImGui::Button("Save Trace"))
+                {
+                    std::string filename = "trace-" + SysTime::timeString() + "-" + SysTime::dateString() + ".json";
+                    std::replace(filename.begin(), filename.end(), '/', '-');
+                    std::replace(filename.begin(), filename.end(), ':', '-');
+                    Profiler::saveTrace(filename);
+                }
+#endif
                 std::sort(m_systemSamples.begin(), m_systemSamples.end(), 
                     [](const SystemSample& a, const SystemSample& b)
                 {
@@ -163,7 +174,10 @@ void SystemManager::process(float dt)
         
             for (auto& system : m_activeSystems)
             {
-                system->process(dt);
+                {
+                    CRO_PROFILE_SCOPE(system->getType().name());
+                    system->process(dt);
+                }
                 m_systemSamples.emplace_back(system, m_systemTimer.restart() * 1000.f);
             }
         }
@@ -171,6 +185,7 @@ void SystemManager::process(float dt)
         {
             for (auto& system : m_activeSystems)
             {
+                CRO_PROFILE_SCOPE(system->getType().name());
                 system->process(dt);
             }
         }
@@ -179,6 +194,7 @@ void SystemManager::process(float dt)
     {
         for (auto& system : m_activeSystems)
         {
+            CRO_PROFILE_SCOPE(system->getType().name());
             system->process(dt);
         }
     }
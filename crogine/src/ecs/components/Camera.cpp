@@ -31,6 +31,7 @@ source distribution.
 
 #include <crogine/ecs/components/Camera.hpp>
 #include <crogine/util/Matrix.hpp>
+#include <crogine/detail/GlobalConsts.hpp>
 
 using namespace cro;
 
@@ -44,7 +45,8 @@ Camera::Camera()
     m_maxShadowDistance (std::numeric_limits<float>::max()),
     m_shadowExpansion   (0.f)
 {
-    glm::vec2 windowSize(App::getWindow().getSize());
+    //there's no window to measure when running headless
+    glm::vec2 windowSize = App::isHeadless() ? Detail::HeadlessWindowSize : glm::vec2(App::getWindow().getSize());
     m_aspectRatio = windowSize.x / windowSize.y;
     m_projectionMatrix = glm::perspective(m_verticalFOV, m_aspectRatio, m_nearPlane, m_farPlane);
 
@@ -137,6 +139,7 @@ const Camera::DrawList& Camera::getDrawList(std::uint32_t pass) const
 void Camera::setPerspective(float fov, float aspect, float nearPlane, float farPlane, std::uint32_t numSplits)
 {
     m_projectionMatrix = glm::perspective(fov, aspect, nearPlane, farPlane);
+    m_projectionGeneration++;
     m_verticalFOV = fov;
     m_aspectRatio = aspect;
     m_nearPlane = nearPlane;
@@ -170,6 +173,7 @@ void Camera::setPerspective(float fov, float aspect, float nearPlane, float farP
 void Camera::setOrthographic(float left, float right, float bottom, float top, float nearPlane, float farPlane, std::uint32_t numSplits)
 {
     m_projectionMatrix = glm::ortho(left, right, bottom, top, nearPlane, farPlane);
+    m_projectionGeneration++;
     m_verticalFOV = -1.f;
     m_aspectRatio = (right - left) / (bottom - top);
     m_nearPlane = nearPlane;
@@ -280,19 +284,52 @@ void Camera::updateMatrices(const Transform& tx, float level)
     auto& finalPass = m_passes[Camera::Pass::Final];
     auto& reflectionPass = m_passes[Camera::Pass::Reflection];
 
+    //only update what changed since the last call - the
+    //frustum update alone requires 6 sqrts per pass
     const auto worldTx = tx.getWorldTransform();
-    finalPass.viewMatrix = glm::inverse(worldTx);
-    finalPass.viewProjectionMatrix = m_projectionMatrix * finalPass.viewMatrix;
-    finalPass.m_aabb = Spatial::updateFrustum(finalPass.m_frustum, finalPass.viewProjectionMatrix);
-    finalPass.forwardVector = Util::Matrix::getForwardVector(worldTx);
+    const bool viewChanged = (worldTx != m_lastWorldTransform);
+    const bool projectionChanged = (m_projectionGeneration != m_lastProjectionGeneration);
+
+    if (viewChanged)
+    {
+        m_lastWorldTransform = worldTx;
+        m_transformGeneration++;
+
+        finalPass.viewMatrix = glm::inverse(worldTx);
+        finalPass.forwardVector = Util::Matrix::getForwardVector(worldTx);
+    }
+
+    if (viewChanged || projectionChanged)
+    {
+        m_lastProjectionGeneration = m_projectionGeneration;
+
+        finalPass.viewProjectionMatrix = m_projectionMatrix * finalPass.viewMatrix;
+        finalPass.m_aabb = Spatial::updateFrustum(finalPass.m_frustum, finalPass.viewProjectionMatrix);
+    }
+    m_changed = viewChanged || projectionChanged;
 
     if (reflectionBuffer.available())
     {
-        reflectionPass.viewMatrix = glm::scale(finalPass.viewMatrix, glm::vec3(1.f, -1.f, 1.f));
-        reflectionPass.viewMatrix = glm::translate(reflectionPass.viewMatrix, glm::vec3(0.f, level, 0.f));
-        reflectionPass.viewProjectionMatrix = m_projectionMatrix * reflectionPass.viewMatrix;
-        reflectionPass.m_aabb = Spatial::updateFrustum(reflectionPass.m_frustum, reflectionPass.viewProjectionMatrix);
-        reflectionPass.forwardVector = glm::reflect(finalPass.forwardVector, Transform::Y_AXIS);
+        if (m_changed
+            || !m_reflectionValid
+            || level != m_reflectionLevel)
+        {
+            reflectionPass.viewMatrix = glm::scale(finalPass.viewMatrix, glm::vec3(1.f, -1.f, 1.f));
+            reflectionPass.viewMatrix = glm::translate(reflectionPass.viewMatrix, glm::vec3(0.f, level, 0.f));
+            reflectionPass.viewProjectionMatrix = m_projectionMatrix * reflectionPass.viewMatrix;
+            reflectionPass.m_aabb = Spatial::updateFrustum(reflectionPass.m_frustum, reflectionPass.viewProjectionMatrix);
+            reflectionPass.forwardVector = glm::reflect(finalPass.forwardVector, Transform::Y_AXIS);
+
+            m_reflectionLevel = level;
+            m_reflectionValid = true;
+            m_changed = true;
+        }
+    }
+    else
+    {
+        //make sure the pass is updated if a buffer is created later
+        m_changed = m_changed || m_reflectionValid;
+        m_reflectionValid = false;
     }
 }
 
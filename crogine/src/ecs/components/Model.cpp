@@ -29,6 +29,7 @@ source distribution.
 
 #include <crogine/ecs/components/Model.hpp>
 #include <crogine/detail/Assert.hpp>
+#include <crogine/detail/LodSelection.hpp>
 #include "../../detail/GLCheck.hpp"
 
 #include <crogine/detail/glm/gtc/matrix_inverse.hpp>
@@ -102,6 +103,22 @@ Model::~Model()
         }
     }
 
+    for (auto& lod : m_lods)
+    {
+        for (auto& [p1, p2] : lod.vaos)
+        {
+            if (p1)
+            {
+                glCheck(glDeleteVertexArrays(1, &p1));
+            }
+
+            if (p2)
+            {
+                glCheck(glDeleteVertexArrays(1, &p2));
+            }
+        }
+    }
+
     if (m_instanceBuffers.instanceCount != 0)
     {
         glCheck(glDeleteBuffers(1, &m_instanceBuffers.normalBuffer));
@@ -124,6 +141,9 @@ Model::Model(Model&& other) noexcept
     std::swap(m_materials, other.m_materials);
 
     std::swap(m_vaos, other.m_vaos);
+    std::swap(m_lods, other.m_lods);
+    std::swap(m_lodScreenSizes, other.m_lodScreenSizes);
+    std::swap(m_lodLevels, other.m_lodLevels);
 
     std::swap(m_skeleton, other.m_skeleton);
     std::swap(m_jointCount, other.m_jointCount);
@@ -178,6 +198,32 @@ Model& Model::operator=(Model&& other) noexcept
             std::fill(pair.begin(), pair.end(), 0);
         }
 
+        for (auto& lod : m_lods)
+        {
+            for (auto& [p1, p2] : lod.vaos)
+            {
+                if (p1)
+                {
+                    glCheck(glDeleteVertexArrays(1, &p1));
+                }
+
+                if (p2)
+                {
+                    glCheck(glDeleteVertexArrays(1, &p2));
+                }
+            }
+        }
+
+        //moving the vector leaves the other with no VAOs to delete
+        m_lods = std::move(other.m_lods);
+        other.m_lods.clear();
+        m_lodScreenSizes = std::move(other.m_lodScreenSizes);
+        other.m_lodScreenSizes.clear();
+        m_lodLevels = std::move(other.m_lodLevels);
+        other.m_lodLevels.clear();
+        m_activeLod = 0;
+        m_drawListDirty = true;
+
         m_skeleton = other.m_skeleton;
         other.m_skeleton = nullptr;
 
@@ -213,6 +259,8 @@ void Model::setMaterial(std::size_t idx, Material::Data data)
 {
     CRO_ASSERT(idx < m_materials[Mesh::IndexData::Final].size(), "Index out of range");
     
+    m_drawListDirty = true;
+
     if (m_meshData.vbo)
     {
         //remove any existing animations
@@ -338,6 +386,52 @@ void Model::setInstanceTransforms(const std::vector<glm::mat4>& transforms)
 #endif
 }
 
+bool Model::addLod(Mesh::Data meshData, float screenSize)
+{
+    if (meshData.submeshCount != m_meshData.submeshCount
+        || meshData.attributes != m_meshData.attributes
+        || meshData.vertexSize != m_meshData.vertexSize)
+    {
+        LogE << "LOD mesh does not match the layout of the Model's mesh" << std::endl;
+        return false;
+    }
+
+    if (screenSize <= 0.f
+        || (!m_lodScreenSizes.empty() && screenSize >= m_lodScreenSizes.back()))
+    {
+        LogE << screenSize << ": LOD screen size must be greater than zero and smaller than the previous level" << std::endl;
+        return false;
+    }
+
+    auto& lod = m_lods.emplace_back();
+    lod.meshData = meshData;
+    m_lodScreenSizes.push_back(screenSize);
+    m_drawListDirty = true;
+
+#ifdef PLATFORM_DESKTOP
+    //make sure the new level is bound to any existing materials
+    for (auto i = 0u; i < m_meshData.submeshCount; ++i)
+    {
+        if (m_materials[Mesh::IndexData::Final][i].shader)
+        {
+            updateVAO(i, Mesh::IndexData::Final);
+        }
+
+        if (m_materials[Mesh::IndexData::Shadow][i].shader)
+        {
+            updateVAO(i, Mesh::IndexData::Shadow);
+        }
+    }
+#endif
+    return true;
+}
+
+const Mesh::Data& Model::getLodMeshData(std::size_t level) const
+{
+    CRO_ASSERT(level < getLodCount(), "LOD index out of range");
+    return level == 0 ? m_meshData : m_lods[level - 1].meshData;
+}
+
 //private
 void Model::initMaterialAnimation(std::size_t index)
 {
@@ -412,6 +506,62 @@ void Model::bindMaterial(Material::Data& material)
     }
 }
 
+std::uint32_t Model::selectLod(std::uint32_t cameraIndex, std::size_t pass, float screenSize)
+{
+    auto result = std::find_if(m_lodLevels.begin(), m_lodLevels.end(),
+        [cameraIndex](const LodState& s) {return s.cameraIndex == cameraIndex; });
+
+    if (result == m_lodLevels.end())
+    {
+        result = m_lodLevels.insert(m_lodLevels.end(), LodState());
+        result->cameraIndex = cameraIndex;
+    }
+
+    CRO_ASSERT(pass < result->levels.size(), "Pass index out of range");
+    auto& level = result->levels[pass];
+    level = static_cast<std::uint32_t>(Detail::selectLod(m_lodScreenSizes, screenSize, level));
+    return level;
+}
+
+std::uint32_t Model::getLodLevel(std::uint32_t cameraIndex, std::size_t pass) const
+{
+    CRO_ASSERT(pass < 2, "Pass index out of range");
+    for (const auto& state : m_lodLevels)
+    {
+        if (state.cameraIndex == cameraIndex)
+        {
+            return state.levels[pass];
+        }
+    }
+    return 0;
+}
+
+std::size_t Model::getTriangleCount(std::size_t submesh) const
+{
+    const auto& indexData = getActiveMeshData().indexData[submesh];
+
+    std::size_t count = 0;
+    switch (indexData.primitiveType)
+    {
+    default: break;
+    case GL_TRIANGLES:
+        count = indexData.indexCount / 3;
+        break;
+    case GL_TRIANGLE_STRIP:
+    case GL_TRIANGLE_FAN:
+        count = indexData.indexCount > 2 ? indexData.indexCount - 2 : 0;
+        break;
+    }
+
+#ifdef PLATFORM_DESKTOP
+    if (m_instanceBuffers.instanceCount != 0)
+    {
+        count *= m_instanceBuffers.instanceCount;
+    }
+#endif
+    return count;
+}
+
 void Model::updateBounds()
 {
     //we can't currently do this if we've got instancing enabled
@@ -435,8 +585,17 @@ void Model::updateBounds()
 #ifdef PLATFORM_DESKTOP
 void Model::updateVAO(std::size_t idx, std::int32_t passIndex)
 {
-    auto& submesh = m_meshData.indexData[idx];
-    auto& vaoPair = m_vaos[idx];
+    //each level of detail has its own vertex buffer so needs its own VAO
+    for (auto level = 0u; level < getLodCount(); ++level)
+    {
+        updateVAO(idx, passIndex, level == 0 ? m_meshData : m_lods[level - 1].meshData,
+            level == 0 ? m_vaos[idx] : m_lods[level - 1].vaos[idx]);
+    }
+}
+
+void Model::updateVAO(std::size_t idx, std::int32_t passIndex, const Mesh::Data& meshData, VAOPair& vaoPair)
+{
+    auto& submesh = meshData.indexData[idx];
 
     //I guess we have to remove any old binding
     //if there's an existing material
@@ -449,7 +608,7 @@ void Model::updateVAO(std::size_t idx, std::int32_t passIndex)
     glCheck(glGenVertexArrays(1, &vaoPair[passIndex]));
 
     glCheck(glBindVertexArray(vaoPair[passIndex]));
-    glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_meshData.vbo));
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, meshData.vbo));
     glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, submesh.ibo));
 
     const auto& attribs = m_materials[passIndex][idx].attribs;
@@ -457,7 +616,7 @@ void Model::updateVAO(std::size_t idx, std::int32_t passIndex)
     {
         glCheck(glEnableVertexAttribArray(attribs[j][Material::Data::Index]));
         glCheck(glVertexAttribPointer(attribs[j][Material::Data::Index], attribs[j][Material::Data::Size],
-            GL_FLOAT, GL_FALSE, static_cast<GLsizei>(m_meshData.vertexSize),
+            GL_FLOAT, GL_FALSE, static_cast<GLsizei>(meshData.vertexSize),
             reinterpret_cast<void*>(static_cast<intptr_t>(attribs[j][Material::Data::Offset]))));
     }
     
@@ -500,15 +659,17 @@ void Model::updateVAO(std::size_t idx, std::int32_t passIndex)
 //draw functions
 void Model::DrawSingle::operator()(std::int32_t matID, std::int32_t pass) const
 {
-    const auto& indexData = m_model.m_meshData.indexData[matID];
-    glCheck(glBindVertexArray(m_model.m_vaos[matID][pass]));
+    const auto& indexData = m_model.getActiveMeshData().indexData[matID];
+    const auto& vaos = m_model.m_activeLod == 0 ? m_model.m_vaos : m_model.m_lods[m_model.m_activeLod - 1].vaos;
+    glCheck(glBindVertexArray(vaos[matID][pass]));
     glCheck(glDrawElements(static_cast<GLenum>(indexData.primitiveType), indexData.indexCount, static_cast<GLenum>(indexData.format), NULL));
 }
 
 void Model::DrawInstanced::operator()(std::int32_t matID, std::int32_t pass) const
 {
-    const auto& indexData = m_model.m_meshData.indexData[matID];
-    glCheck(glBindVertexArray(m_model.m_vaos[matID][pass]));
+    const auto& indexData = m_model.getActiveMeshData().indexData[matID];
+    const auto& vaos = m_model.m_activeLod == 0 ? m_model.m_vaos : m_model.m_lods[m_model.m_activeLod - 1].vaos;
+    glCheck(glBindVertexArray(vaos[matID][pass]));
     glCheck(glDrawElementsInstanced(static_cast<GLenum>(indexData.primitiveType), indexData.indexCount, static_cast<GLenum>(indexData.format), NULL, m_model.m_instanceBuffers.instanceCount));
 }
 
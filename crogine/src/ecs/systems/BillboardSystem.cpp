@@ -32,6 +32,7 @@ source distribution.
 #include <crogine/ecs/systems/BillboardSystem.hpp>
 #include <crogine/ecs/components/BillboardCollection.hpp>
 #include <crogine/ecs/components/Model.hpp>
+#include <crogine/ecs/Scene.hpp>
 
 #include <crogine/detail/OpenGL.hpp>
 
@@ -46,6 +47,12 @@ BillboardSystem::BillboardSystem(MessageBus& mb)
 //public
 void BillboardSystem::process(float)
 {
+    //billboard geometry only exists on the GPU
+    if (getScene()->isHeadless())
+    {
+        return;
+    }
+
     auto& entities = getEntities();
     for (auto entity : entities)
     {
@@ -71,11 +71,11 @@ void CameraSystem::process(float)
 {
     auto& entities = getEntities();
 
+    m_activeCameras.clear();
     for (auto entity : entities)
     {
-        //TODO could dirty flag optimise as updating the frustum
-        //requires 6(!!) sqrts
-
+        //cameras only recalculate matrices and frustums which
+        //have changed since the last update
         auto& camera = entity.getComponent<Camera>();
 
         if (camera.active)
@@ -83,15 +83,25 @@ void CameraSystem::process(float)
             const auto& tx = entity.getComponent<Transform>();
             camera.updateMatrices(tx, -getScene()->getWaterLevel() * 2.f);
 
-            //don't clear these then systems updating them can just do swaps
-            //finalPass.drawList.clear();
-            //reflectionPass.drawList.clear();
-            getScene()->updateDrawLists(entity);
+            m_activeCameras.push_back(entity);
+        }
+    }
 
-            if (camera.isStatic)
-            {
-                camera.active = false;
-            }
+    //cull everything against all cameras at once, so
+    //that draw list updates can share the results
+    getScene()->updateVisibility(m_activeCameras);
+
+    for (auto entity : m_activeCameras)
+    {
+        //don't clear these then systems updating them can just do swaps
+        //finalPass.drawList.clear();
+        //reflectionPass.drawList.clear();
+        getScene()->updateDrawLists(entity);
+
+        auto& camera = entity.getComponent<Camera>();
+        if (camera.isStatic)
+        {
+            camera.active = false;
         }
     }
 }
@@ -104,7 +114,8 @@ const std::vector<Entity>& CameraSystem::getCameras() const
 //private
 void CameraSystem::resizeGBuffer(Entity entity)
 {
-    if (entity.hasComponent<GBuffer>())
+    if (entity.hasComponent<GBuffer>()
+        && !getScene()->isHeadless())
     {
         glm::vec2 size(App::getWindow().getSize());
         const auto& cam = entity.getComponent<Camera>();
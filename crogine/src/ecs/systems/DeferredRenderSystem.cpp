@@ -37,11 +37,14 @@ source distribution.
 #include <crogine/ecs/components/Camera.hpp>
 
 #include <crogine/ecs/systems/ModelRenderer.hpp>
+#include <crogine/ecs/systems/VisibilitySystem.hpp>
 
 #include <crogine/ecs/Scene.hpp>
+#include <crogine/core/App.hpp>
 
 #include <crogine/util/Matrix.hpp>
 #include <crogine/graphics/EnvironmentMap.hpp>
+#include <crogine/detail/LodSelection.hpp>
 
 #include <crogine/detail/glm/gtc/type_ptr.hpp>
 #include <crogine/detail/glm/gtc/matrix_transform.hpp>
@@ -111,7 +114,10 @@ DeferredRenderSystem::DeferredRenderSystem(MessageBus& mb)
         cro::Colour::White
     };
 
-    setupRenderQuad();
+    if (!App::isHeadless())
+    {
+        setupRenderQuad();
+    }
 }
 
 DeferredRenderSystem::~DeferredRenderSystem()
@@ -147,6 +153,9 @@ void DeferredRenderSystem::updateDrawList(Entity camera)
     auto cameraPos = camera.getComponent<Transform>().getWorldPosition();
     auto& entities = getEntities();
 
+    const auto& visibilitySystem = getScene()->getVisibilitySystem();
+    const auto* visibility = visibilitySystem.getCameraVisibility(camera);
+
     if (m_visibleLists.size() == m_cameraCount)
     {
         m_visibleLists.emplace_back();
@@ -163,14 +172,24 @@ void DeferredRenderSystem::updateDrawList(Entity camera)
             continue;
         }
 
-        //cull entities from frustum - TODO using a dynamic tree could improve this
-        //on bigger scenes
-        auto sphere = model.m_meshData.boundingSphere;
-        const auto& tx = entity.getComponent<Transform>();
+        //cull entities from frustum - these are shared with other renderers
+        //if the camera was part of this frame's visibility sweep
+        const auto slot = visibility ? visibilitySystem.getSlot(entity) : VisibilitySystem::NoSlot;
+
+        Sphere sphere;
+        if (slot != VisibilitySystem::NoSlot)
+        {
+            sphere = visibilitySystem.getWorldSphere(slot);
+        }
+        else
+        {
+            sphere = model.m_meshData.boundingSphere;
+            const auto& tx = entity.getComponent<Transform>();
 
-        sphere.centre = glm::vec3(tx.getWorldTransform() * glm::vec4(sphere.centre, 1.f));
-        auto scale = tx.getScale();
-        sphere.radius *= ((scale.x + scale.y + scale.z) / 3.f);
+            sphere.centre = glm::vec3(tx.getWorldTransform() * glm::vec4(sphere.centre, 1.f));
+            auto scale = tx.getScale();
+            sphere.radius *= ((scale.x + scale.y + scale.z) / 3.f);
+        }
 
         //TODO we *could* do every camera pass - but for now we're
         //expecting screen space reflections rather than using camera reflection mapping
@@ -180,11 +199,18 @@ void DeferredRenderSystem::updateDrawList(Entity camera)
             const auto& frustum = cam.getPass(Camera::Pass::Final).getFrustum();
             auto forwardVector = cro::Util::Matrix::getForwardVector(cam.getPass(Camera::Pass::Final).viewMatrix);
 
-            model.m_visible = true;
             std::size_t i = 0;
-            while (model.m_visible && i < frustum.size())
+            if (slot != VisibilitySystem::NoSlot)
             {
-                model.m_visible = (Spatial::intersects(frustum[i++], sphere) != Planar::Back);
+                model.m_visible = visibility->isVisible(slot, Camera::Pass::Final);
+            }
+            else
+            {
+                model.m_visible = true;
+                while (model.m_visible && i < frustum.size())
+                {
+                    model.m_visible = (Spatial::intersects(frustum[i++], sphere) != Planar::Back);
+                }
             }
 
             if (model.m_visible)
@@ -200,6 +226,12 @@ void DeferredRenderSystem::updateDrawList(Entity camera)
                 f.entity = entity;
                 d.distanceFromCamera = distance;
 
+                if (model.getLodCount() > 1)
+                {
+                    d.lod = f.lod = model.selectLod(camera.getIndex(), Camera::Pass::Final,
+                        Detail::getLodScreenSize(cam.getProjectionMatrix(), sphere.radius, glm::length(direction)));
+                }
+
                 //TODO a large model with a centre behind the camera
                 //might still intersect the view but register as being
                 //further away than smaller objects in front
@@ -272,7 +304,7 @@ void DeferredRenderSystem::render(Entity camera, const RenderTarget& rt)
     auto& buffer = camera.getComponent<GBuffer>().buffer;
     buffer.clear(ClearColours);
 
-    for (auto [entity, matIDs, depth] : deferred)
+    for (const auto& [entity, matIDs, depth, lod] : deferred)
     {
         //foreach submesh / material:
         const auto& model = entity.getComponent<Model>();
@@ -307,8 +339,10 @@ void DeferredRenderSystem::render(Entity camera, const RenderTarget& rt)
             glCheck(glUniformMatrix4fv(model.m_materials[Mesh::IndexData::Final][i].uniforms[Material::WorldView], 1, GL_FALSE, glm::value_ptr(worldView)));
             glCheck(glUniformMatrix3fv(model.m_materials[Mesh::IndexData::Final][i].uniforms[Material::Normal], 1, GL_FALSE, glm::value_ptr(glm::inverseTranspose(glm::mat3(worldView)))));
 
-            const auto& indexData = model.m_meshData.indexData[i];
-            glCheck(glBindVertexArray(model.m_vaos[i][Mesh::IndexData::Final]));
+            const auto& meshData = lod == 0 ? model.m_meshData : model.m_lods[lod - 1].meshData;
+            const auto& vaos = lod == 0 ? model.m_vaos : model.m_lods[lod - 1].vaos;
+            const auto& indexData = meshData.indexData[i];
+            glCheck(glBindVertexArray(vaos[i][Mesh::IndexData::Final]));
             glCheck(glDrawElements(static_cast<GLenum>(indexData.primitiveType), indexData.indexCount, static_cast<GLenum>(indexData.format), 0));
         }
     }
@@ -325,7 +359,7 @@ void DeferredRenderSystem::render(Entity camera, const RenderTarget& rt)
     glCheck(glBlendEquationi(TextureIndex::Accum, GL_FUNC_ADD));
     glCheck(glBlendEquationi(TextureIndex::Reveal, GL_FUNC_ADD));
 
-    for (auto [entity, matIDs, depth] : forward)
+    for (const auto& [entity, matIDs, depth, lod] : forward)
     {
         //foreach submesh / material:
         const auto& model = entity.getComponent<Model>();
@@ -360,8 +394,10 @@ void DeferredRenderSystem::render(Entity camera, const RenderTarget& rt)
             glCheck(glUniformMatrix3fv(model.m_materials[Mesh::IndexData::Final][i].uniforms[Material::Normal], 1, GL_FALSE, glm::value_ptr(glm::inverseTranspose(glm::mat3(worldMat)))));
 
             //and... draw.
-            const auto& indexData = model.m_meshData.indexData[i];
-            glCheck(glBindVertexArray(model.m_vaos[i][Mesh::IndexData::Final]));
+            const auto& meshData = lod == 0 ? model.m_meshData : model.m_lods[lod - 1].meshData;
+            const auto& vaos = lod == 0 ? model.m_vaos : model.m_lods[lod - 1].vaos;
+            const auto& indexData = meshData.indexData[i];
+            glCheck(glBindVertexArray(vaos[i][Mesh::IndexData::Final]));
             glCheck(glDrawElements(static_cast<GLenum>(indexData.primitiveType), indexData.indexCount, static_cast<GLenum>(indexData.format), 0));
         }
     }
@@ -440,6 +476,13 @@ void DeferredRenderSystem::render(Entity camera, const RenderTarget& rt)
     glCheck(glUniformMatrix4fv(m_pbrUniforms[PBRUniformIDs::InverseViewMat], 1, GL_FALSE, &invViewMatrix[0][0]));
     glCheck(glUniformMatrix4fv(m_pbrUniforms[PBRUniformIDs::LightProjMat], 1, GL_FALSE, &lightProjMatrix[0][0]));
 
+    //point and spot lights, if there's a LightSystem in the Scene
+    glCheck(glActiveTexture(GL_TEXTURE8));
+    glCheck(glBindTexture(GL_TEXTURE_BUFFER, cam.m_lightClusters.texture));
+    glCheck(glUniform1i(m_pbrUniforms[PBRUniformIDs::LightClusters], 8));
+    glCheck(glUniform4fv(m_pbrUniforms[PBRUniformIDs::LightClusterParams], 1, &cam.m_lightClusters.params[0]));
+    glCheck(glUniformMatrix4fv(m_pbrUniforms[PBRUniformIDs::LightClusterMatrices], 2, GL_FALSE, &cam.m_lightClusters.matrices[0][0][0]));
+
     glCheck(glBindVertexArray(m_deferredVao));
     glCheck(glDrawArrays(GL_TRIANGLE_STRIP, 0, 4));
 
@@ -550,6 +593,19 @@ bool DeferredRenderSystem::loadPBRShader()
         {
             m_pbrUniforms[PBRUniformIDs::ShadowMap] = uniforms.at("u_shadowMap");
         }
+
+        if (uniforms.count("u_lightClusters"))
+        {
+            m_pbrUniforms[PBRUniformIDs::LightClusters] = uniforms.at("u_lightClusters");
+        }
+        if (uniforms.count("u_lightClusterParams"))
+        {
+            m_pbrUniforms[PBRUniformIDs::LightClusterParams] = uniforms.at("u_lightClusterParams");
+        }
+        if (uniforms.count("u_lightClusterMatrices[0]"))
+        {
+            m_pbrUniforms[PBRUniformIDs::LightClusterMatrices] = uniforms.at("u_lightClusterMatrices[0]");
+        }
     }
 
     return result;
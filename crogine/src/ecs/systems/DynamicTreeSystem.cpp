@@ -32,8 +32,16 @@ source distribution.
 #include <crogine/ecs/components/DynamicTreeComponent.hpp>
 #include <crogine/ecs/systems/DynamicTreeSystem.hpp>
 
+#include "../../detail/ParallelFor.hpp"
+
 using namespace cro;
 
+namespace
+{
+    //fewer than this isn't worth starting another thread for
+    constexpr std::size_t MinUpdatesPerThread = 256;
+}
+
 DynamicTreeSystem::DynamicTreeSystem(MessageBus& mb, float unitsPerMetre)
     : System(mb, typeid(DynamicTreeSystem)),
     m_tree  (unitsPerMetre)
@@ -45,6 +53,10 @@ DynamicTreeSystem::DynamicTreeSystem(MessageBus& mb, float unitsPerMetre)
 //public
 void DynamicTreeSystem::process(float)
 {
+    //transforms update their cached matrices when read, which
+    //isn't thread safe, so make sure they're up to date first
+    m_components.clear();
+
     auto& entities = getEntities();
     for (auto entity : entities)
     {
@@ -52,22 +64,46 @@ void DynamicTreeSystem::process(float)
         {
             auto& bpc = entity.getComponent<DynamicTreeComponent>();
             const auto& tx = entity.getComponent<Transform>();
-            auto worldPosition = tx.getWorldPosition();
-            auto worldBounds = bpc.m_bounds;
-
-            worldBounds += tx.getOrigin();
-            worldBounds = tx.getWorldTransform() * worldBounds;
+            tx.getWorldTransform();
 
-            m_tree.moveNode(bpc.m_treeID, worldBounds, worldPosition - bpc.m_lastWorldPosition);
+            m_components.emplace_back(&bpc, &tx);
 
-            bpc.m_lastWorldPosition = worldPosition;
+            if (m_tree.getFilterFlags(bpc.m_treeID) != bpc.m_filterFlags)
+            {
+                m_tree.setFilterFlags(bpc.m_treeID, bpc.m_filterFlags);
+            }
         }
     }
+
+    m_updates.resize(m_components.size());
+    Detail::parallelFor(m_components.size(), MinUpdatesPerThread, 
+        [&](std::size_t begin, std::size_t end)
+        {
+            for (auto i = begin; i < end; ++i)
+            {
+                auto& bpc = *m_components[i].first;
+                const auto& tx = *m_components[i].second;
+                auto worldPosition = tx.getWorldPosition();
+                auto worldBounds = bpc.m_bounds;
+
+                worldBounds += tx.getOrigin();
+                worldBounds = tx.getWorldTransform() * worldBounds;
+
+                m_updates[i].treeID = bpc.m_treeID;
+                m_updates[i].worldBounds = worldBounds;
+                m_updates[i].displacement = worldPosition - bpc.m_lastWorldPosition;
+
+                bpc.m_lastWorldPosition = worldPosition;
+            }
+        });
+
+    m_tree.moveNodes(m_updates);
 }
 
 void DynamicTreeSystem::onEntityAdded(Entity entity)
 {
-    entity.getComponent<DynamicTreeComponent>().m_treeID = m_tree.addToTree(entity, entity.getComponent<DynamicTreeComponent>().m_bounds);
+    auto& bpc = entity.getComponent<DynamicTreeComponent>();
+    bpc.m_treeID = m_tree.addToTree(entity, bpc.m_bounds, bpc.m_filterFlags);
 }
 
 void DynamicTreeSystem::onEntityRemoved(Entity entity)
@@ -77,38 +113,41 @@ void DynamicTreeSystem::onEntityRemoved(Entity entity)
 
 std::vector<Entity> DynamicTreeSystem::query(Box area, std::uint64_t filter) const
 {
-    Detail::FixedStack<std::int32_t, 256> stack;
-    stack.push(m_tree.getRoot());
-
     std::vector<Entity> retVal;
     retVal.reserve(256);
+    m_tree.query(area, filter, retVal);
 
-    while (stack.size() > 0)
-    {
-        auto treeID = stack.pop();
-        if (treeID == Detail::TreeNode::Null)
-        {
-            continue;
-        }
-
-        const auto& node = m_tree.getNodes()[treeID];
-        if (area.intersects(node.fatBounds))
-        {
-            //TODO it would be nice to precache the filter fetch, but it would miss changes at the component level
-            if (node.isLeaf() && node.entity.isValid()
-                && (node.entity.getComponent<DynamicTreeComponent>().m_filterFlags & filter)) 
-            {
-                //we have a candidate, stash
-                retVal.push_back(node.entity);
-            }
-            else
-            {
-                stack.push(node.childA);
-                stack.push(node.childB);
-            }
-        }
-    }
     return retVal;
 }
 
+void DynamicTreeSystem::query(Box area, std::vector<Entity>& dst, std::uint64_t filter) const
+{
+    m_tree.query(area, filter, dst);
+}
+
+void DynamicTreeSystem::query(Sphere sphere, std::vector<Entity>& dst, std::uint64_t filter) const
+{
+    m_tree.query(sphere, filter, dst);
+}
+
+void DynamicTreeSystem::query(const Frustum& frustum, std::vector<Entity>& dst, std::uint64_t filter) const
+{
+    m_tree.query(frustum, filter, dst);
+}
+
+void DynamicTreeSystem::queryRay(glm::vec3 origin, glm::vec3 direction, float length, std::vector<Entity>& dst, std::uint64_t filter) const
+{
+    m_tree.queryRay(origin, direction, length, filter, dst);
+}
+
+void DynamicTreeSystem::queryPairs(std::vector<std::pair<Entity, Entity>>& dst, std::uint64_t filter) const
+{
+    m_tree.queryPairs(filter, dst);
+}
+
+void DynamicTreeSystem::query(const std::vector<Box>& areas, std::vector<std::vector<Entity>>& dst, std::uint64_t filter) const
+{
+    m_tree.query(areas, filter, dst);
+}
+
 //private
\ No newline at end of file
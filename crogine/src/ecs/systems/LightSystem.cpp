@@ -0,0 +1,289 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include "../../detail/GLCheck.hpp"
+
+#include <crogine/ecs/systems/LightSystem.hpp>
+#include <crogine/ecs/components/Light.hpp>
+#include <crogine/ecs/components/Camera.hpp>
+#include <crogine/ecs/components/Transform.hpp>
+#include <crogine/ecs/Scene.hpp>
+#include <crogine/core/Log.hpp>
+
+#include <crogine/detail/glm/gtc/matrix_access.hpp>
+
+#include <cmath>
+#include <cstring>
+
+using namespace cro;
+
+namespace
+{
+    //keeps the spot cone test valid
+    constexpr float MaxOuterAngle = 1.55f;
+
+    //cluster texels, followed by 3 texels per light, followed by the indices
+    constexpr std::size_t TexelsPerLight = 3;
+
+    std::uint32_t toBits(float f)
+    {
+        std::uint32_t bits = 0;
+        std::memcpy(&bits, &f, sizeof(bits));
+        return bits;
+    }
+}
+
+LightSystem::LightSystem(MessageBus& mb)
+    : System        (mb, typeid(LightSystem)),
+    m_cameraCount   (0),
+    m_maxTexels     (0)
+{
+    requireComponent<Light>();
+    requireComponent<Transform>();
+}
+
+LightSystem::~LightSystem()
+{
+#ifdef PLATFORM_DESKTOP
+    for (const auto& slot : m_cameraSlots)
+    {
+        if (slot.texture)
+        {
+            glCheck(glDeleteTextures(1, &slot.texture));
+        }
+
+        if (slot.buffer)
+        {
+            glCheck(glDeleteBuffers(1, &slot.buffer));
+        }
+    }
+#endif
+}
+
+//public
+void LightSystem::process(float)
+{
+    //lights are gathered again by the first camera
+    //to be updated in the next frame
+    m_cameraCount = 0;
+}
+
+void LightSystem::updateDrawList(Entity camEnt)
+{
+    if (m_cameraCount == 0)
+    {
+        gatherLights();
+    }
+
+    if (m_cameraSlots.size() == m_cameraCount)
+    {
+        auto& slot = m_cameraSlots.emplace_back();
+        slot.clusters = std::make_unique<Detail::LightClusters>();
+    }
+    auto& slot = m_cameraSlots[m_cameraCount++];
+    slot.camera = camEnt;
+
+    auto& camera = camEnt.getComponent<Camera>();
+    auto& clusterData = camera.m_lightClusters;
+    clusterData.params.w = 0.f;
+
+    if (slot.projection != camera.getProjectionMatrix()
+        || slot.nearPlane != camera.getNearPlane()
+        || slot.farPlane != camera.getFarPlane())
+    {
+        slot.projection = camera.getProjectionMatrix();
+        slot.nearPlane = camera.getNearPlane();
+        slot.farPlane = camera.getFarPlane();
+        slot.clusters->setProjection(slot.projection, slot.nearPlane, slot.farPlane);
+    }
+
+    const auto& viewMatrix = camera.getPass(Camera::Pass::Final).viewMatrix;
+    m_viewLights.resize(m_worldLights.size());
+    for (auto i = 0u; i < m_worldLights.size(); ++i)
+    {
+        const auto& src = m_worldLights[i];
+        auto& dst = m_viewLights[i];
+
+        dst.position = glm::vec3(viewMatrix * glm::vec4(src.position, 1.f));
+        dst.radius = src.radius;
+        dst.direction = glm::vec3(viewMatrix * glm::vec4(src.direction, 0.f));
+        dst.cosOuter = std::max(src.cosOuter, -1.f);
+    }
+    slot.clusters->build(m_viewLights);
+
+    if (!m_worldLights.empty()
+        && !getScene()->isHeadless()
+        && upload(slot))
+    {
+        const auto& clusters = *slot.clusters;
+        clusterData.texture = slot.texture;
+        clusterData.params =
+        {
+            clusters.getSliceScale(),
+            clusters.getSliceBias(),
+            static_cast<float>(Detail::LightClusters::ClusterCount + (m_worldLights.size() * TexelsPerLight)),
+            1.f
+        };
+        clusterData.matrices[0] = viewMatrix;
+        clusterData.matrices[1] = slot.projection;
+    }
+}
+
+const Detail::LightClusters* LightSystem::getClusters(Entity camera) const
+{
+    for (auto i = 0u; i < m_cameraCount; ++i)
+    {
+        if (m_cameraSlots[i].camera == camera
+            && m_cameraSlots[i].camera.getGeneration() == camera.getGeneration())
+        {
+            return m_cameraSlots[i].clusters.get();
+        }
+    }
+    return nullptr;
+}
+
+//private
+void LightSystem::gatherLights()
+{
+    m_worldLights.clear();
+
+    const auto& entities = getEntities();
+    for (auto entity : entities)
+    {
+        const auto& light = entity.getComponent<Light>();
+        if (!light.active
+            || light.radius <= 0.f)
+        {
+            continue;
+        }
+
+        const auto worldTx = entity.getComponent<Transform>().getWorldTransform();
+
+        auto& dst = m_worldLights.emplace_back();
+        dst.position = glm::vec3(worldTx[3]);
+        dst.radius = light.radius;
+        dst.colour = glm::vec3(light.colour.getVec4()) * light.intensity;
+
+        if (light.type == Light::Type::Spot)
+        {
+            const float outer = std::clamp(light.outerAngle, 0.f, MaxOuterAngle);
+            const float inner = std::clamp(light.innerAngle, 0.f, outer);
+
+            dst.direction = glm::normalize(-glm::vec3(glm::column(worldTx, 2)));
+            dst.cosOuter = std::cos(outer);
+            dst.cosInner = std::cos(inner);
+
+            if (dst.cosInner <= dst.cosOuter)
+            {
+                //prevent the shader's smoothstep dividing by zero
+                dst.cosInner = dst.cosOuter + 0.0001f;
+            }
+        }
+    }
+}
+
+bool LightSystem::upload(CameraSlot& slot)
+{
+#ifdef PLATFORM_DESKTOP
+    const auto& clusters = slot.clusters->getClusters();
+    const auto& indices = slot.clusters->getIndices();
+
+    const auto lightOffset = clusters.size();
+    const auto indexOffset = lightOffset + (m_worldLights.size() * TexelsPerLight);
+    const auto texelCount = indexOffset + ((indices.size() + 3) / 4);
+
+    //queried on first upload as the scene, and so whether or
+    //not it's headless, isn't known when the system is created
+    if (m_maxTexels == 0)
+    {
+        glCheck(glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &m_maxTexels));
+    }
+
+    if (texelCount > static_cast<std::size_t>(m_maxTexels))
+    {
+        LogW << m_worldLights.size() << " lights require " << texelCount << " texels, which is more than the max texture buffer size of " << m_maxTexels << std::endl;
+        return false;
+    }
+
+    m_uploadBuffer.resize(texelCount * 4);
+    for (auto i = 0u; i < clusters.size(); ++i)
+    {
+        m_uploadBuffer[i * 4] = clusters[i].offset;
+        m_uploadBuffer[(i * 4) + 1] = clusters[i].count;
+        m_uploadBuffer[(i * 4) + 2] = 0;
+        m_uploadBuffer[(i * 4) + 3] = 0;
+    }
+
+    auto* lightData = &m_uploadBuffer[lightOffset * 4];
+    for (const auto& light : m_worldLights)
+    {
+        *lightData++ = toBits(light.position.x);
+        *lightData++ = toBits(light.position.y);
+        *lightData++ = toBits(light.position.z);
+        *lightData++ = toBits(light.radius);
+        *lightData++ = toBits(light.colour.r);
+        *lightData++ = toBits(light.colour.g);
+        *lightData++ = toBits(light.colour.b);
+        *lightData++ = toBits(light.cosOuter);
+        *lightData++ = toBits(light.direction.x);
+        *lightData++ = toBits(light.direction.y);
+        *lightData++ = toBits(light.direction.z);
+        *lightData++ = toBits(light.cosInner);
+    }
+
+    std::copy(indices.begin(), indices.end(), m_uploadBuffer.begin() + (indexOffset * 4));
+    std::fill(m_uploadBuffer.begin() + (indexOffset * 4) + indices.size(), m_uploadBuffer.end(), 0u);
+
+    if (slot.buffer == 0)
+    {
+        glCheck(glGenBuffers(1, &slot.buffer));
+        glCheck(glGenTextures(1, &slot.texture));
+
+        glCheck(glBindBuffer(GL_TEXTURE_BUFFER, slot.buffer));
+        glCheck(glBindTexture(GL_TEXTURE_BUFFER, slot.texture));
+        glCheck(glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32UI, slot.buffer));
+        glCheck(glBindTexture(GL_TEXTURE_BUFFER, 0));
+    }
+
+    //orphan the previous contents so we don't wait on
+    //any draw calls which are still reading them
+    const auto size = m_uploadBuffer.size() * sizeof(std::uint32_t);
+    slot.bufferSize = std::max(size, slot.bufferSize);
+
+    glCheck(glBindBuffer(GL_TEXTURE_BUFFER, slot.buffer));
+    glCheck(glBufferData(GL_TEXTURE_BUFFER, slot.bufferSize, nullptr, GL_STREAM_DRAW));
+    glCheck(glBufferSubData(GL_TEXTURE_BUFFER, 0, size, m_uploadBuffer.data()));
+    glCheck(glBindBuffer(GL_TEXTURE_BUFFER, 0));
+
+    return true;
+#else
+    return false;
+#endif
+}
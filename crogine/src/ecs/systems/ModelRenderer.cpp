@@ -28,16 +28,20 @@ source distribution.
 -----------------------------------------------------------------------*/
 
 #include "../../detail/GLCheck.hpp"
+#include "../../detail/ParallelFor.hpp"
 
 #include <crogine/core/Clock.hpp>
 #include <crogine/core/Console.hpp>
 #include <crogine/ecs/Scene.hpp>
 #include <crogine/ecs/systems/ModelRenderer.hpp>
+#include <crogine/ecs/systems/VisibilitySystem.hpp>
 #include <crogine/ecs/components/Camera.hpp>
 #include <crogine/ecs/components/Transform.hpp>
 #include <crogine/ecs/components/Model.hpp>
+#include <crogine/ecs/components/Occluder.hpp>
 #include <crogine/util/Matrix.hpp>
 #include <crogine/util/Frustum.hpp>
+#include <crogine/detail/LodSelection.hpp>
 
 #include <crogine/detail/Assert.hpp>
 #include <crogine/detail/glm/gtc/type_ptr.hpp>
@@ -49,14 +53,18 @@ using namespace cro;
 
 namespace
 {
-
+    //fewer than this isn't worth starting another thread for
+    constexpr std::size_t MinTreeUpdatesPerThread = 256;
 }
 
 ModelRenderer::ModelRenderer(MessageBus& mb)
     : System        (mb, typeid(ModelRenderer)),
     m_pass          (Mesh::IndexData::Final),
     m_tree          (1.f),
-    m_useTreeQueries(false)
+    m_useTreeQueries(false),
+    m_occlusionCulling(false),
+    m_triangleCount (0),
+    m_lastTriangleCount(0)
 {
     requireComponent<Transform>();
     requireComponent<Model>();
@@ -65,6 +73,36 @@ ModelRenderer::ModelRenderer(MessageBus& mb)
 //public
 void ModelRenderer::updateDrawList(Entity cameraEnt)
 {
+    auto& camComponent = cameraEnt.getComponent<Camera>();
+    auto passCount = camComponent.reflectionBuffer.available() ? 2 : 1;
+
+    //if neither the camera nor any model bounds changed since the last
+    //frame then the lists already stored on the camera are still valid
+    if (!m_useTreeQueries
+        && !m_occlusionCulling)
+    {
+        const auto* visibility = getScene()->getVisibilitySystem().getCameraVisibility(cameraEnt);
+        if (visibility
+            && visibility->isUnchanged())
+        {
+            auto i = 0;
+            while (i < passCount && camComponent.getDrawList(i).count(getType()) != 0)
+            {
+                i++;
+            }
+
+            if (i == passCount)
+            {
+                return;
+            }
+        }
+    }
+
+    if (m_occlusionCulling)
+    {
+        updateOcclusionBuffer(cameraEnt);
+    }
+
     if (m_useTreeQueries)
     {
         updateDrawListBalancedTree(cameraEnt);
@@ -74,9 +112,6 @@ void ModelRenderer::updateDrawList(Entity cameraEnt)
         updateDrawListDefault(cameraEnt);
     }
 
-    auto& camComponent = cameraEnt.getComponent<Camera>();
-    auto passCount = camComponent.reflectionBuffer.available() ? 2 : 1;
-
     DPRINT("Visible 3D ents in Scene " + std::to_string(getScene()->getInstanceID()) 
         + ", Camera " + std::to_string(cameraEnt.getIndex()), std::to_string(m_visibleEnts[0].size()));
     //DPRINT("Total ents", std::to_string(entities.size()));
@@ -99,6 +134,13 @@ void ModelRenderer::updateDrawList(Entity cameraEnt)
 
 void ModelRenderer::process(float dt)
 {
+    //render() has been called for every camera since the last update
+    m_lastTriangleCount = m_triangleCount;
+    m_triangleCount = 0;
+    DPRINT("Triangles submitted (3D)", std::to_string(m_lastTriangleCount));
+
+    m_treeComponents.clear();
+
     auto& entities = getEntities();
     for (auto entity : entities)
     {
@@ -109,19 +151,42 @@ void ModelRenderer::process(float dt)
         {
             if (!entity.destroyed())
             {
+                //make sure cached transforms are up to date before
+                //reading them from multiple threads below
                 const auto& tx = entity.getComponent<Transform>();
-                auto worldPosition = tx.getWorldPosition();
-                auto worldBounds = model.getAABB();
-
-                worldBounds += tx.getOrigin();
-                worldBounds = tx.getWorldTransform() * worldBounds;
+                tx.getWorldTransform();
 
-                m_tree.moveNode(model.m_treeID, worldBounds, worldPosition - model.m_lastWorldPosition);
-
-                model.m_lastWorldPosition = worldPosition;
+                m_treeComponents.emplace_back(&model, &tx);
             }
         }
     }
+
+    if (m_useTreeQueries)
+    {
+        m_treeUpdates.resize(m_treeComponents.size());
+        Detail::parallelFor(m_treeComponents.size(), MinTreeUpdatesPerThread,
+            [&](std::size_t begin, std::size_t end)
+            {
+                for (auto i = begin; i < end; ++i)
+                {
+                    auto& model = *m_treeComponents[i].first;
+                    const auto& tx = *m_treeComponents[i].second;
+                    auto worldPosition = tx.getWorldPosition();
+                    auto worldBounds = model.getAABB();
+
+                    worldBounds += tx.getOrigin();
+                    worldBounds = tx.getWorldTransform() * worldBounds;
+
+                    m_treeUpdates[i].treeID = model.m_treeID;
+                    m_treeUpdates[i].worldBounds = worldBounds;
+                    m_treeUpdates[i].displacement = worldPosition - model.m_lastWorldPosition;
+
+                    model.m_lastWorldPosition = worldPosition;
+                }
+            });
+
+        m_tree.moveNodes(m_treeUpdates);
+    }
 }
 
 void ModelRenderer::render(Entity camera, const RenderTarget& rt)
@@ -162,6 +227,7 @@ void ModelRenderer::render(Entity camera, const RenderTarget& rt)
             continue;
         } 
         glCheck(glFrontFace(model.m_facing));
+        model.m_activeLod = sortData.lod;
         
         //calc entity transform
         const auto& tx = entity.getComponent<Transform>();
@@ -169,7 +235,7 @@ void ModelRenderer::render(Entity camera, const RenderTarget& rt)
         glm::mat4 worldView = pass.viewMatrix * worldMat;
 
 #ifndef PLATFORM_DESKTOP
-        glCheck(glBindBuffer(GL_ARRAY_BUFFER, model.m_meshData.vbo));
+        glCheck(glBindBuffer(GL_ARRAY_BUFFER, model.getActiveMeshData().vbo));
 #endif //PLATFORM
         
         for (auto i : sortData.matIDs)
@@ -207,12 +273,12 @@ void ModelRenderer::render(Entity camera, const RenderTarget& rt)
             {
                 glCheck(glEnableVertexAttribArray(attribs[j][Material::Data::Index]));
                 glCheck(glVertexAttribPointer(attribs[j][Material::Data::Index], attribs[j][Material::Data::Size],
-                    GL_FLOAT, GL_FALSE, static_cast<GLsizei>(model.m_meshData.vertexSize),
+                    GL_FLOAT, GL_FALSE, static_cast<GLsizei>(model.getActiveMeshData().vertexSize),
                     reinterpret_cast<void*>(static_cast<intptr_t>(attribs[j][Material::Data::Offset]))));
             }
 
             //bind element/index buffer
-            const auto& indexData = model.m_meshData.indexData[i];
+            const auto& indexData = model.getActiveMeshData().indexData[i];
             glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexData.ibo));
 
             //draw elements
@@ -226,7 +292,9 @@ void ModelRenderer::render(Entity camera, const RenderTarget& rt)
                 glCheck(glDisableVertexAttribArray(attribs[j][Material::Data::Index]));
             }
 #endif //PLATFORM 
+            m_triangleCount += model.getTriangleCount(i);
         }
+        model.m_activeLod = 0;
     }
 
 #ifdef PLATFORM_DESKTOP
@@ -268,6 +336,10 @@ void ModelRenderer::updateDrawListDefault(Entity cameraEnt)
 
     auto& entities = getEntities();
 
+    //use the shared results if the camera was included in this frame's sweep
+    const auto& visibilitySystem = getScene()->getVisibilitySystem();
+    const auto* visibility = visibilitySystem.getCameraVisibility(cameraEnt);
+
     //cull entities by viewable into draw lists by pass
     for (auto& list : m_visibleEnts)
     {
@@ -282,21 +354,31 @@ void ModelRenderer::updateDrawListDefault(Entity cameraEnt)
             continue;
         }
 
-        if (model.m_meshBox != model.m_meshData.boundingBox)
-        {
-            model.updateBounds();
-        }
-
         //render flags are tested when drawing as the flags may have changed
         //between draw calls but without updating the visiblity list.
 
         //use the bounding sphere for depth testing
-        auto sphere = model.getBoundingSphere();
-        const auto& tx = entity.getComponent<Transform>();
+        const auto slot = visibility ? visibilitySystem.getSlot(entity) : VisibilitySystem::NoSlot;
 
-        sphere.centre = glm::vec3(tx.getWorldTransform() * glm::vec4(sphere.centre, 1.f));
-        auto scale = tx.getScale();
-        sphere.radius *= ((scale.x + scale.y + scale.z) / 3.f);
+        Sphere sphere;
+        if (slot != VisibilitySystem::NoSlot)
+        {
+            sphere = visibilitySystem.getWorldSphere(slot);
+        }
+        else
+        {
+            if (model.m_meshBox != model.m_meshData.boundingBox)
+            {
+                model.updateBounds();
+            }
+
+            sphere = model.getBoundingSphere();
+            const auto& tx = entity.getComponent<Transform>();
+
+            sphere.centre = glm::vec3(tx.getWorldTransform() * glm::vec4(sphere.centre, 1.f));
+            auto scale = tx.getScale();
+            sphere.radius *= ((scale.x + scale.y + scale.z) / 3.f);
+        }
 
         //for each pass in the list (different passes may use different projections, eg reflections)
         for (auto p = 0; p < passCount; ++p)
@@ -315,7 +397,11 @@ void ModelRenderer::updateDrawListDefault(Entity cameraEnt)
             }
 
 
-            //if (camComponent.isOrthographic())
+            if (slot != VisibilitySystem::NoSlot)
+            {
+                model.m_visible = visibility->isVisible(slot, p);
+            }
+            else //if (camComponent.isOrthographic())
             {
                 const auto& frustum = camComponent.getPass(p).getFrustum();
 
@@ -332,11 +418,24 @@ void ModelRenderer::updateDrawListDefault(Entity cameraEnt)
                 model.m_visible = cro::Util::Frustum::visible(camComponent.getFrustumData(), camComponent.getPass(p).viewMatrix * tx.getWorldTransform(), model.getAABB());
             }*/
 
+            if (model.m_visible
+                && m_occlusionCulling
+                && p == Camera::Pass::Final)
+            {
+                model.m_visible = !occluded(model, slot != VisibilitySystem::NoSlot ? visibilitySystem.getWorldTransform(slot) : entity.getComponent<Transform>().getWorldTransform());
+            }
+
             if (model.m_visible)
             {
                 auto opaque = std::make_pair(entity, SortData());
                 auto transparent = std::make_pair(entity, SortData());
 
+                if (model.getLodCount() > 1)
+                {
+                    const auto screenSize = Detail::getLodScreenSize(camComponent.getProjectionMatrix(), sphere.radius, glm::length(direction));
+                    opaque.second.lod = transparent.second.lod = model.selectLod(cameraEnt.getIndex(), p, screenSize);
+                }
+
                 //foreach material
                 //add ent/index pair to alpha or opaque list
                 for (auto i = 0u; i < model.m_meshData.submeshCount; ++i)
@@ -382,10 +481,10 @@ void ModelRenderer::updateDrawListBalancedTree(Entity cameraEnt)
 
     for (auto p = 0; p < passCount; ++p)
     {
-        const auto& frustumBounds = camComponent.getPass(p).getAABB();
-        auto entities = queryTree(frustumBounds);
+        m_treeResults.clear();
+        m_tree.query(camComponent.getPass(p).getFrustum(), std::numeric_limits<std::uint64_t>::max(), m_treeResults);
 
-        for (auto entity : entities)
+        for (auto entity : m_treeResults)
         {
             auto& model = entity.getComponent<Model>();
             if (model.isHidden())
@@ -432,12 +531,25 @@ void ModelRenderer::updateDrawListBalancedTree(Entity cameraEnt)
                 model.m_visible = cro::Util::Frustum::visible(camComponent.getFrustumData(), camComponent.getPass(p).viewMatrix * tx.getWorldTransform(), model.getAABB());
             }*/
 
+            if (model.m_visible
+                && m_occlusionCulling
+                && p == Camera::Pass::Final)
+            {
+                model.m_visible = !occluded(model, tx.getWorldTransform());
+            }
+
             //add visible ents to lists for depth sorting
             if (model.m_visible)
             {
                 auto opaque = std::make_pair(entity, SortData());
                 auto transparent = std::make_pair(entity, SortData());
 
+                if (model.getLodCount() > 1)
+                {
+                    const auto screenSize = Detail::getLodScreenSize(camComponent.getProjectionMatrix(), sphere.radius, glm::length(direction));
+                    opaque.second.lod = transparent.second.lod = model.selectLod(cameraEnt.getIndex(), p, screenSize);
+                }
+
                 //foreach material
                 //add ent/index pair to alpha or opaque list
                 for (auto i = 0u; i < model.m_meshData.submeshCount; ++i)
@@ -469,38 +581,50 @@ void ModelRenderer::updateDrawListBalancedTree(Entity cameraEnt)
     }
 }
 
-std::vector<Entity> ModelRenderer::queryTree(Box area) const
+void ModelRenderer::updateOcclusionBuffer(Entity cameraEnt)
 {
-    Detail::FixedStack<std::int32_t, 256> stack;
-    stack.push(m_tree.getRoot());
+    const auto& camComponent = cameraEnt.getComponent<Camera>();
+    m_occlusionBuffer.begin(camComponent.getPass(Camera::Pass::Final).viewProjectionMatrix);
 
-    std::vector<Entity> retVal;
-    retVal.reserve(256);
+    const auto& visibilitySystem = getScene()->getVisibilitySystem();
+    const auto* visibility = visibilitySystem.getCameraVisibility(cameraEnt);
 
-    while (stack.size() > 0)
+    auto& entities = getEntities();
+    for (auto entity : entities)
     {
-        auto treeID = stack.pop();
-        if (treeID == Detail::TreeNode::Null)
+        if (!entity.hasComponent<Occluder>()
+            || entity.getComponent<Model>().isHidden())
         {
             continue;
         }
 
-        const auto& node = m_tree.getNodes()[treeID];
-        if (area.intersects(node.fatBounds))
+        const auto& occluder = entity.getComponent<Occluder>();
+        if (!occluder.active)
         {
-            if (node.isLeaf() && node.entity.isValid())
-            {
-                //we have a candidate, stash
-                retVal.push_back(node.entity);
-            }
-            else
+            continue;
+        }
+
+        //skip occluders which we already know are out of view
+        const auto slot = visibility ? visibilitySystem.getSlot(entity) : VisibilitySystem::NoSlot;
+        if (slot != VisibilitySystem::NoSlot)
+        {
+            if (visibility->isVisible(slot, Camera::Pass::Final))
             {
-                stack.push(node.childA);
-                stack.push(node.childB);
+                m_occlusionBuffer.addOccluder(occluder.vertices, occluder.indices, visibilitySystem.getWorldTransform(slot));
             }
         }
+        else
+        {
+            m_occlusionBuffer.addOccluder(occluder.vertices, occluder.indices, entity.getComponent<Transform>().getWorldTransform());
+        }
     }
-    return retVal;
+
+    m_occlusionBuffer.rasterise();
+}
+
+bool ModelRenderer::occluded(const Model& model, const glm::mat4& worldTransform) const
+{
+    return !m_occlusionBuffer.isVisible(worldTransform * model.getAABB());
 }
 
 void ModelRenderer::applyProperties(const Material::Data& material, const Model& model, const Scene& scene, const Camera& camera)
@@ -613,6 +737,19 @@ void ModelRenderer::applyProperties(const Material::Data& material, const Model&
             glCheck(glUniformMatrix4fv(material.uniforms[Material::ReflectionMatrix], 1, GL_FALSE, &camera.getPass(Camera::Pass::Refraction).viewProjectionMatrix[0][0]));
         }
         break;
+        case Material::LightClusterSampler:
+            glCheck(glActiveTexture(GL_TEXTURE0 + currentTextureUnit));
+#ifdef PLATFORM_DESKTOP
+            glCheck(glBindTexture(GL_TEXTURE_BUFFER, camera.m_lightClusters.texture));
+#endif
+            glCheck(glUniform1i(material.uniforms[Material::LightClusterSampler], currentTextureUnit++));
+            break;
+        case Material::LightClusterParams:
+            glCheck(glUniform4fv(material.uniforms[Material::LightClusterParams], 1, &camera.m_lightClusters.params[0]));
+            break;
+        case Material::LightClusterMatrices:
+            glCheck(glUniformMatrix4fv(material.uniforms[Material::LightClusterMatrices], 2, GL_FALSE, &camera.m_lightClusters.matrices[0][0][0]));
+            break;
         }
     }
 }
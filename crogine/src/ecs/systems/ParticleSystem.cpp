@@ -199,6 +199,12 @@ ParticleSystem::ParticleSystem(MessageBus& mb)
     requireComponent<Transform>();
     requireComponent<ParticleEmitter>();
 
+    if (App::isHeadless())
+    {
+        //particles are purely visual so there's nothing to load
+        return;
+    }
+
     if (!m_shader.loadFromString(vertex, fragment))
     {
         Logger::log("Failed to compile Particle shader", Logger::Type::Error);
@@ -255,7 +261,10 @@ ParticleSystem::~ParticleSystem()
 #ifdef PLATFORM_DESKTOP
     for (auto vao : m_vaoIDs)
     {
-        glCheck(glDeleteVertexArrays(1, &vao));
+        if (vao)
+        {
+            glCheck(glDeleteVertexArrays(1, &vao));
+        }
     }
 
 #endif
@@ -298,6 +307,11 @@ void ParticleSystem::updateDrawList(Entity cameraEnt)
 
 void ParticleSystem::process(float dt)
 {
+    if (getScene()->isHeadless())
+    {
+        return;
+    }
+
     auto& entities = getEntities();
     for (auto& e : entities)
     {
@@ -611,6 +625,11 @@ void ParticleSystem::render(Entity camera, const RenderTarget& rt)
 //private
 void ParticleSystem::onEntityAdded(Entity entity)
 {    
+    if (getScene()->isHeadless())
+    {
+        return;
+    }
+
     //check VBO count and increase if needed
     if (m_nextBuffer == m_bufferCount)
     {
@@ -627,6 +646,11 @@ void ParticleSystem::onEntityAdded(Entity entity)
 
 void ParticleSystem::onEntityRemoved(Entity entity)
 {
+    if (getScene()->isHeadless())
+    {
+        return;
+    }
+
     auto vboID = entity.getComponent<ParticleEmitter>().m_vbo;
     auto vaoID = entity.getComponent<ParticleEmitter>().m_vao;
     
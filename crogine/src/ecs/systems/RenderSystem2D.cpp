@@ -31,6 +31,7 @@ source distribution.
 #include <crogine/ecs/components/Drawable2D.hpp>
 #include <crogine/ecs/components/Transform.hpp>
 #include <crogine/ecs/components/Camera.hpp>
+#include <crogine/ecs/Scene.hpp>
 #include <crogine/graphics/Texture.hpp>
 #include <crogine/graphics/RenderTarget.hpp>
 #include <crogine/util/Rectangle.hpp>
@@ -69,8 +70,11 @@ RenderSystem2D::RenderSystem2D(MessageBus& mb)
     requireComponent<Transform>();
 
     //load default shaders
-    m_colouredShader.loadFromString(Shaders::Sprite::Vertex, Shaders::Sprite::Coloured);
-    m_texturedShader.loadFromString(Shaders::Sprite::Vertex, Shaders::Sprite::Textured, "#define TEXTURED\n");
+    if (!App::isHeadless())
+    {
+        m_colouredShader.loadFromString(Shaders::Sprite::Vertex, Shaders::Sprite::Coloured);
+        m_texturedShader.loadFromString(Shaders::Sprite::Vertex, Shaders::Sprite::Textured, "#define TEXTURED\n");
+    }
 }
 
 RenderSystem2D::~RenderSystem2D()
@@ -142,12 +146,16 @@ void RenderSystem2D::updateDrawList(Entity camEnt)
 
 void RenderSystem2D::process(float)
 {
+    //headless scenes still sort and cull, but skip anything GPU side
+    const bool headless = getScene()->isHeadless();
+
     auto& entities = getEntities();
     for (auto entity : entities)
     {
         auto& drawable = entity.getComponent<Drawable2D>();
         //check shader flag and set correct shader if needed
-        if (drawable.m_applyDefaultShader)
+        if (drawable.m_applyDefaultShader
+            && !headless)
         {
             if (drawable.m_texture)
             {
@@ -164,7 +172,8 @@ void RenderSystem2D::process(float)
         }
 
         //check data flag and update buffer if needed
-        if (drawable.m_updateBufferData)
+        if (drawable.m_updateBufferData
+            && !headless)
         {
             //bind VBO and upload data
             glCheck(glBindBuffer(GL_ARRAY_BUFFER, drawable.m_vbo));
@@ -395,19 +404,20 @@ void RenderSystem2D::onEntityAdded(Entity entity)
 {
     //create the VBO (VAO is applied when shader is set)
     auto& drawable = entity.getComponent<Drawable2D>();
-    if (drawable.m_vbo == 0) //setting a custom shader may have already created this
+    if (drawable.m_vbo == 0 //setting a custom shader may have already created this
+        && !getScene()->isHeadless())
     {
         glCheck(glGenBuffers(1, &drawable.m_vbo));
     }
 
     /*
-    The problem with the quad tree is that it expects fixed
-    size AABBs. If a drawable changes significantly, eg a 
-    text string, then searching for it to remove it based
-    on its current AABB will return a different result to
-    when it was first placed (and therefor an incorrect
-    location). This cascades in errors when trying to remove
-    an entity from a cell in which is doesn't actually reside...
+    The quad tree no longer uses an entity's current AABB to
+    find it, so drawables which change size, eg a text string,
+    can be updated or removed safely. However transforms don't
+    notify their children when they move, so there's no reliable
+    way to know which entities need updating short of updating
+    all of them every frame, which is no cheaper than the culling
+    currently done in updateDrawList()...
     */
 
 
@@ -0,0 +1,243 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include <crogine/ecs/systems/ReplicationClientSystem.hpp>
+#include <crogine/ecs/components/Replicated.hpp>
+#include <crogine/ecs/components/Transform.hpp>
+#include <crogine/network/NetClient.hpp>
+#include <crogine/util/BitStream.hpp>
+
+#include "../../network/Snapshot.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace cro;
+
+namespace
+{
+    //if the render time drifts further than this from the
+    //target it is reset rather than gradually corrected
+    constexpr double MaxTimeError = 500.0;
+    constexpr double TimeCorrectionRate = 0.002;
+    constexpr double MaxTimeCorrection = 0.1;
+}
+
+ReplicationClientSystem::ReplicationClientSystem(MessageBus& mb, NetClient& client, const ReplicationSettings& settings)
+    : System        (mb, typeid(ReplicationClientSystem)),
+    m_client        (client),
+    m_settings      (settings),
+    m_history       (std::make_unique<Detail::SnapshotHistory>()),
+    m_renderTime    (0.0),
+    m_hasRenderTime (false),
+    m_droppedCount  (0),
+    m_activeSequence(-1)
+{
+    requireComponent<Transform>();
+    requireComponent<Replicated>();
+}
+
+ReplicationClientSystem::~ReplicationClientSystem() = default;
+
+//public
+bool ReplicationClientSystem::handlePacket(const NetEvent& evt)
+{
+    if (evt.type != NetEvent::PacketReceived
+        || evt.packet.getID() != m_settings.snapshotPacketID)
+    {
+        return false;
+    }
+
+    //decode into a temporary first so a malformed packet
+    //doesn't overwrite a snapshot used as a baseline
+    Detail::Snapshot snapshot;
+    Util::Net::BitReader reader(evt.packet.getData(), evt.packet.getSize());
+    if (!Detail::decodeSnapshot(reader, *m_history, m_settings, snapshot))
+    {
+        m_droppedCount++;
+        return true;
+    }
+
+    auto& dst = m_history->insert(snapshot.sequence);
+    dst.timestamp = snapshot.timestamp;
+    dst.entities.swap(snapshot.entities);
+
+    m_client.sendPacket(m_settings.ackPacketID, dst.sequence, NetFlag::Unreliable, m_settings.channel);
+
+    //anything older than the newest snapshot arrived out of order and is only useful as a baseline
+    if (m_buffer.empty()
+        || Detail::sequenceGreater(dst.sequence, m_buffer.back()))
+    {
+        m_buffer.push_back(dst.sequence);
+        while (m_buffer.size() > Detail::SnapshotHistory::Size)
+        {
+            m_buffer.pop_front();
+        }
+    }
+    return true;
+}
+
+void ReplicationClientSystem::process(float dt)
+{
+    //drop anything which has been overwritten in the history
+    m_buffer.erase(std::remove_if(m_buffer.begin(), m_buffer.end(),
+        [&](std::uint16_t seq) {return m_history->find(seq) == nullptr; }), m_buffer.end());
+
+    if (m_buffer.empty())
+    {
+        return;
+    }
+
+    //render behind the most recent snapshot, speeding up or slowing
+    //down slightly to stay there as the packet latency varies
+    const auto* latest = m_history->find(m_buffer.back());
+    const double targetTime = static_cast<double>(latest->timestamp) - (m_settings.interpolationDelay * 1000.0);
+    const double error = targetTime - m_renderTime;
+
+    if (!m_hasRenderTime
+        || std::abs(error) > MaxTimeError)
+    {
+        m_renderTime = targetTime;
+        m_hasRenderTime = true;
+    }
+    else
+    {
+        const double correction = std::clamp(error * TimeCorrectionRate, -MaxTimeCorrection, MaxTimeCorrection);
+        m_renderTime += dt * 1000.0 * (1.0 + correction);
+    }
+
+    //find the pair of snapshots either side of the render time
+    while (m_buffer.size() > 1
+        && m_history->find(m_buffer[1])->timestamp <= m_renderTime)
+    {
+        m_buffer.pop_front();
+    }
+
+    const auto* from = m_history->find(m_buffer.front());
+    const auto* to = m_buffer.size() > 1 ? m_history->find(m_buffer[1]) : from;
+
+    float t = 0.f;
+    if (to->timestamp > from->timestamp)
+    {
+        t = static_cast<float>((m_renderTime - from->timestamp) / static_cast<double>(to->timestamp - from->timestamp));
+        t = std::clamp(t, 0.f, 1.f);
+    }
+
+    if (m_activeSequence != from->sequence)
+    {
+        updateActiveIDs(*from);
+    }
+
+    auto& entities = getEntities();
+    for (auto entity : entities)
+    {
+        const auto netID = entity.getComponent<Replicated>().netID;
+        const auto* fromState = Detail::findState(from->entities, netID);
+        const auto* toState = Detail::findState(to->entities, netID);
+
+        if (!fromState && !toState)
+        {
+            continue;
+        }
+
+        glm::vec3 position(0.f);
+        glm::quat rotation(1.f, 0.f, 0.f, 0.f);
+        glm::vec3 scale(1.f);
+
+        if (fromState && toState)
+        {
+            glm::vec3 toPosition(0.f);
+            glm::quat toRotation(1.f, 0.f, 0.f, 0.f);
+            glm::vec3 toScale(1.f);
+
+            Detail::dequantiseState(*fromState, m_settings, position, rotation, scale);
+            Detail::dequantiseState(*toState, m_settings, toPosition, toRotation, toScale);
+
+            position = glm::mix(position, toPosition, t);
+            rotation = glm::slerp(rotation, toRotation, t);
+            scale = glm::mix(scale, toScale, t);
+        }
+        else
+        {
+            Detail::dequantiseState(fromState ? *fromState : *toState, m_settings, position, rotation, scale);
+        }
+
+        auto& tx = entity.getComponent<Transform>();
+        tx.setPosition(position);
+        tx.setRotation(rotation);
+        if (m_settings.replicateScale)
+        {
+            tx.setScale(scale);
+        }
+    }
+}
+
+//private
+void ReplicationClientSystem::updateActiveIDs(const Detail::Snapshot& snapshot)
+{
+    m_activeSequence = snapshot.sequence;
+
+    //both lists are sorted, so walk them together
+    std::vector<std::uint32_t> ids;
+    ids.reserve(snapshot.entities.size());
+
+    auto active = m_activeIDs.begin();
+    for (const auto& state : snapshot.entities)
+    {
+        while (active != m_activeIDs.end() && *active < state.netID)
+        {
+            if (m_removedCallback)
+            {
+                m_removedCallback(*active);
+            }
+            active++;
+        }
+
+        if (active != m_activeIDs.end() && *active == state.netID)
+        {
+            active++;
+        }
+        else if (m_addedCallback)
+        {
+            m_addedCallback(state.netID);
+        }
+        ids.push_back(state.netID);
+    }
+
+    while (active != m_activeIDs.end())
+    {
+        if (m_removedCallback)
+        {
+            m_removedCallback(*active);
+        }
+        active++;
+    }
+    m_activeIDs.swap(ids);
+}
@@ -0,0 +1,415 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include <crogine/ecs/systems/ReplicationServerSystem.hpp>
+#include <crogine/ecs/systems/DynamicTreeSystem.hpp>
+#include <crogine/ecs/components/Replicated.hpp>
+#include <crogine/ecs/components/Transform.hpp>
+#include <crogine/network/NetHost.hpp>
+#include <crogine/util/BitStream.hpp>
+#include <crogine/core/Log.hpp>
+
+#include "../../network/Snapshot.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace cro;
+
+namespace
+{
+    //priority is scaled from 1 at the view position to this at the edge of the view radius
+    constexpr float MinDistancePriority = 0.25f;
+
+    //sequence, timestamp, baseline and entity counts
+    constexpr std::size_t SnapshotHeaderBits = 16 + 32 + 17 + 16;
+
+    bool sameState(const Detail::EntityState& a, const Detail::EntityState& b)
+    {
+        return a.position == b.position
+            && a.rotation == b.rotation
+            && a.scale == b.scale;
+    }
+}
+
+ReplicationServerSystem::ReplicationServerSystem(MessageBus& mb, NetHost& host, const ReplicationSettings& settings)
+    : System        (mb, typeid(ReplicationServerSystem)),
+    m_host          (host),
+    m_settings      (settings),
+    m_outgoing      (std::make_unique<Detail::Snapshot>()),
+    m_writer        (std::make_unique<Util::Net::BitWriter>()),
+    m_tree          (nullptr),
+    m_treeFilter    (std::numeric_limits<std::uint64_t>::max()),
+    m_bandwidthLimit(0),
+    m_sequence      (0),
+    m_accumulator   (0.f),
+    m_serverTime    (0.0),
+    m_bytesSent     (0)
+{
+    CRO_ASSERT(settings.tickRate > 0, "");
+    CRO_ASSERT(settings.positionPrecision > 0 && settings.scalePrecision > 0, "");
+
+    requireComponent<Transform>();
+    requireComponent<Replicated>();
+}
+
+ReplicationServerSystem::~ReplicationServerSystem() = default;
+
+//public
+void ReplicationServerSystem::addClient(const NetPeer& peer)
+{
+    if (!getClient(peer))
+    {
+        auto& client = m_clients.emplace_back();
+        client.peer = peer;
+        client.history = std::make_unique<Detail::SnapshotHistory>();
+    }
+}
+
+void ReplicationServerSystem::removeClient(const NetPeer& peer)
+{
+    m_clients.erase(std::remove_if(m_clients.begin(), m_clients.end(),
+        [&peer](const Client& c) {return c.peer == peer; }), m_clients.end());
+}
+
+bool ReplicationServerSystem::handlePacket(const NetEvent& evt)
+{
+    if (evt.type != NetEvent::PacketReceived
+        || evt.packet.getID() != m_settings.ackPacketID)
+    {
+        return false;
+    }
+
+    if (evt.packet.getSize() == sizeof(std::uint16_t))
+    {
+        if (auto* client = getClient(evt.peer); client != nullptr)
+        {
+            const auto sequence = evt.packet.as<std::uint16_t>();
+            if (!client->hasAck
+                || Detail::sequenceGreater(sequence, client->ackSequence))
+            {
+                client->ackSequence = sequence;
+                client->hasAck = true;
+            }
+        }
+    }
+    return true;
+}
+
+void ReplicationServerSystem::setClientView(const NetPeer& peer, glm::vec3 position, float radius)
+{
+    if (auto* client = getClient(peer); client != nullptr)
+    {
+        client->viewPosition = position;
+        client->viewRadius = std::max(0.f, radius);
+        client->hasView = true;
+    }
+}
+
+void ReplicationServerSystem::clearClientView(const NetPeer& peer)
+{
+    if (auto* client = getClient(peer); client != nullptr)
+    {
+        client->hasView = false;
+    }
+}
+
+void ReplicationServerSystem::setRelevancyTree(const DynamicTreeSystem* tree, std::uint64_t filter)
+{
+    m_tree = tree;
+    m_treeFilter = filter;
+}
+
+void ReplicationServerSystem::process(float dt)
+{
+    m_serverTime += dt;
+    m_accumulator += dt;
+
+    //if we fell behind send a single snapshot rather than
+    //a burst, as only the most recent state is useful
+    const float interval = 1.f / m_settings.tickRate;
+    if (m_accumulator >= interval)
+    {
+        m_accumulator = std::fmod(m_accumulator, interval);
+        sendSnapshot();
+    }
+}
+
+//private
+ReplicationServerSystem::Client* ReplicationServerSystem::getClient(const NetPeer& peer)
+{
+    auto result = std::find_if(m_clients.begin(), m_clients.end(),
+        [&peer](const Client& c) {return c.peer == peer; });
+
+    return result == m_clients.end() ? nullptr : &(*result);
+}
+
+void ReplicationServerSystem::updateStates()
+{
+    m_states.clear();
+    m_entityInfo.clear();
+    m_stateIndices.clear();
+
+    //sort the entities rather than the states so that the
+    //extra info remains in the same order
+    auto entities = getEntities();
+    std::sort(entities.begin(), entities.end(),
+        [](Entity a, Entity b) {return a.getComponent<Replicated>().netID < b.getComponent<Replicated>().netID; });
+
+    std::uint32_t lastID = 0;
+    for (auto entity : entities)
+    {
+        const auto& replicated = entity.getComponent<Replicated>();
+        if (replicated.netID == 0)
+        {
+            continue;
+        }
+
+        if (replicated.netID == lastID)
+        {
+            LogW << "Replicated entities found with duplicate netID " << lastID << ", these will not be replicated correctly" << std::endl;
+            continue;
+        }
+        lastID = replicated.netID;
+
+        const auto& tx = entity.getComponent<Transform>();
+        m_stateIndices.insert(std::make_pair(replicated.netID, m_states.size()));
+        m_states.push_back(Detail::quantiseState(replicated.netID, tx.getPosition(), tx.getRotation(), tx.getScale(), m_settings));
+
+        auto& info = m_entityInfo.emplace_back();
+        info.position = tx.getPosition();
+        info.priority = replicated.priority;
+        info.alwaysRelevant = replicated.alwaysRelevant;
+    }
+}
+
+void ReplicationServerSystem::updateRelevant(const Client& client)
+{
+    m_relevant.clear();
+
+    if (!client.hasView)
+    {
+        for (auto i = 0u; i < m_states.size(); ++i)
+        {
+            m_relevant.push_back(i);
+        }
+        return;
+    }
+
+    const float radiusSqr = client.viewRadius * client.viewRadius;
+    const auto inView = [&](std::size_t index)
+    {
+        const auto diff = m_entityInfo[index].position - client.viewPosition;
+        return glm::dot(diff, diff) <= radiusSqr;
+    };
+
+    if (m_tree)
+    {
+        const glm::vec3 extent(client.viewRadius);
+        const auto results = m_tree->query(Box(client.viewPosition - extent, client.viewPosition + extent), m_treeFilter);
+        for (auto entity : results)
+        {
+            if (entity.hasComponent<Replicated>())
+            {
+                auto result = m_stateIndices.find(entity.getComponent<Replicated>().netID);
+                if (result != m_stateIndices.end()
+                    && inView(result->second))
+                {
+                    m_relevant.push_back(result->second);
+                }
+            }
+        }
+
+        for (auto i = 0u; i < m_entityInfo.size(); ++i)
+        {
+            if (m_entityInfo[i].alwaysRelevant)
+            {
+                m_relevant.push_back(i);
+            }
+        }
+
+        std::sort(m_relevant.begin(), m_relevant.end());
+        m_relevant.erase(std::unique(m_relevant.begin(), m_relevant.end()), m_relevant.end());
+    }
+    else
+    {
+        for (auto i = 0u; i < m_states.size(); ++i)
+        {
+            if (m_entityInfo[i].alwaysRelevant
+                || inView(i))
+            {
+                m_relevant.push_back(i);
+            }
+        }
+    }
+}
+
+void ReplicationServerSystem::updateSnapshot(Client& client)
+{
+    auto& entities = m_outgoing->entities;
+    entities.clear();
+
+    updateRelevant(client);
+
+    if (m_bandwidthLimit == 0)
+    {
+        for (auto i : m_relevant)
+        {
+            entities.push_back(m_states[i]);
+        }
+        return;
+    }
+
+    const auto* lastSent = client.hasSent ? client.history->find(client.lastSequence) : nullptr;
+    const auto* baseline = client.hasAck ? client.history->find(client.ackSequence) : nullptr;
+
+    const auto findState = [](const Detail::Snapshot* snapshot, std::uint32_t netID) -> const Detail::EntityState*
+    {
+        return snapshot ? Detail::findState(snapshot->entities, netID) : nullptr;
+    };
+
+    struct Candidate final
+    {
+        std::size_t index = 0;
+        const Detail::EntityState* lastSent = nullptr;
+        const Detail::EntityState* baseline = nullptr;
+        float priority = 0.f;
+    };
+    std::vector<Candidate> candidates;
+
+    const std::int64_t budget = static_cast<std::int64_t>((m_bandwidthLimit * 8) / m_settings.tickRate);
+    std::int64_t used = SnapshotHeaderBits;
+
+    //anything unchanged since the last snapshot is sent as is. Everything
+    //else is a candidate for updating, and otherwise holds its last state.
+    std::unordered_map<std::uint32_t, float> priorities;
+    for (auto i : m_relevant)
+    {
+        const auto& state = m_states[i];
+        const auto* previous = findState(lastSent, state.netID);
+        const auto* base = findState(baseline, state.netID);
+
+        if (previous && sameState(*previous, state))
+        {
+            entities.push_back(state);
+            used += Detail::getStateBitCount(state, base, m_settings);
+            continue;
+        }
+
+        if (previous)
+        {
+            used += Detail::getStateBitCount(*previous, base, m_settings);
+        }
+
+        float priority = m_entityInfo[i].priority;
+        if (client.hasView
+            && client.viewRadius > 0)
+        {
+            const float distance = glm::length(m_entityInfo[i].position - client.viewPosition) / client.viewRadius;
+            priority *= 1.f - ((1.f - MinDistancePriority) * std::min(distance, 1.f));
+        }
+
+        if (auto result = client.priorities.find(state.netID); result != client.priorities.end())
+        {
+            priority += result->second;
+        }
+
+        auto& candidate = candidates.emplace_back();
+        candidate.index = i;
+        candidate.lastSent = previous;
+        candidate.baseline = base;
+        candidate.priority = priority;
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+        [](const Candidate& a, const Candidate& b) {return a.priority > b.priority; });
+
+    for (auto i = 0u; i < candidates.size(); ++i)
+    {
+        auto& candidate = candidates[i];
+        const auto& state = m_states[candidate.index];
+
+        auto cost = static_cast<std::int64_t>(Detail::getStateBitCount(state, candidate.baseline, m_settings));
+        if (candidate.lastSent)
+        {
+            cost -= static_cast<std::int64_t>(Detail::getStateBitCount(*candidate.lastSent, candidate.baseline, m_settings));
+        }
+
+        if (used + cost <= budget
+            || i == 0)
+        {
+            entities.push_back(state);
+            used += cost;
+            candidate.priority = 0.f;
+        }
+        else if (candidate.lastSent)
+        {
+            entities.push_back(*candidate.lastSent);
+        }
+        //else new to this client so wait until there's space
+
+        priorities.insert(std::make_pair(state.netID, candidate.priority));
+    }
+    client.priorities.swap(priorities);
+
+    std::sort(entities.begin(), entities.end(),
+        [](const Detail::EntityState& a, const Detail::EntityState& b) {return a.netID < b.netID; });
+}
+
+void ReplicationServerSystem::sendSnapshot()
+{
+    m_sequence++;
+    updateStates();
+
+    m_outgoing->sequence = m_sequence;
+    m_outgoing->timestamp = static_cast<std::uint32_t>(m_serverTime * 1000.0);
+
+    for (auto& client : m_clients)
+    {
+        updateSnapshot(client);
+
+        const auto* baseline = client.hasAck ? client.history->find(client.ackSequence) : nullptr;
+
+        m_writer->clear();
+        Detail::encodeSnapshot(*m_outgoing, baseline, m_settings, *m_writer);
+
+        m_host.sendPacket(client.peer, m_settings.snapshotPacketID, m_writer->getData(), m_writer->getSize(), NetFlag::Unreliable, m_settings.channel);
+        m_bytesSent += m_writer->getSize();
+
+        //only store the snapshot once we're done with the baseline, in
+        //case the baseline is the one being replaced in the history
+        auto& stored = client.history->insert(m_sequence);
+        stored.timestamp = m_outgoing->timestamp;
+        stored.entities.swap(m_outgoing->entities);
+
+        client.lastSequence = m_sequence;
+        client.hasSent = true;
+    }
+}
@@ -35,6 +35,7 @@ source distribution.
 #include <crogine/ecs/components/Model.hpp>
 #include <crogine/ecs/components/Skeleton.hpp>
 #include <crogine/ecs/Scene.hpp>
+#include <crogine/ecs/systems/VisibilitySystem.hpp>
 
 #include <crogine/graphics/Spatial.hpp>
 #include <crogine/core/Clock.hpp>
@@ -55,11 +56,16 @@ namespace
     std::uint32_t intervalCounter = 0;
 
     constexpr float CascadeOverlap = 0.5f;
+
+    //cascades are padded by 1/SnapDivisions of their size
+    //and move in steps of this size as the camera moves
+    constexpr float SnapDivisions = 16.f;
 }
 
 ShadowMapRenderer::ShadowMapRenderer(cro::MessageBus& mb)
     : System(mb, typeid(ShadowMapRenderer)),
-    m_interval      (1)
+    m_interval      (1),
+    m_renderCount   (0)
 {
     requireComponent<cro::Model>();
     requireComponent<cro::Transform>();
@@ -78,8 +84,48 @@ void ShadowMapRenderer::setNumCascades(std::int32_t count)
     CRO_ASSERT(false, "Cascade count is set by camera num splits");
 }
 
+void ShadowMapRenderer::setCascadeInterval(std::size_t cascade, std::uint32_t interval)
+{
+    if (m_cascadeIntervals.size() <= cascade)
+    {
+        m_cascadeIntervals.resize(cascade + 1, 1);
+    }
+    m_cascadeIntervals[cascade] = std::max(interval, 1u);
+}
+
+void ShadowMapRenderer::invalidateStaticCasters()
+{
+    for (auto& cache : m_cameraCaches)
+    {
+        for (auto& cascade : cache.cascades)
+        {
+            cascade.staticDirty = true;
+        }
+    }
+}
+
+const std::vector<ShadowMapRenderer::CascadeStats>& ShadowMapRenderer::getCascadeStats(Entity camera) const
+{
+    for (const auto& cache : m_cameraCaches)
+    {
+        if (cache.camera.getIndex() == camera.getIndex()
+            && cache.camera.getGeneration() == camera.getGeneration())
+        {
+            return cache.stats;
+        }
+    }
+
+    static const std::vector<CascadeStats> empty;
+    return empty;
+}
+
 void ShadowMapRenderer::process(float)
 {
+    if (getScene()->isHeadless())
+    {
+        return;
+    }
+
     //render here to ensure this only happens once per update
     //remember we might be rendering the Scene in multiple passes
     //which would call render() multiple times unnecessarily.
@@ -87,11 +133,46 @@ void ShadowMapRenderer::process(float)
     {
         render();
         m_activeCameras.clear();
+        m_renderCount++;
     }
 
     intervalCounter++;
 }
 
+void ShadowMapRenderer::updateVisibility(Entity camEnt, VisibilitySystem& visibility)
+{
+    if (intervalCounter % m_interval)
+    {
+        return;
+    }
+
+    const auto& camera = camEnt.getComponent<Camera>();
+    if (camera.shadowMapBuffer.available())
+    {
+        //the light space box of each cascade is added as 6 world space planes
+        //so that casters are culled in the same sweep as the camera passes
+        auto& cache = m_cameraCaches[prepareCascades(camEnt)];
+        for (auto i = 0u; i < cache.cascades.size(); ++i)
+        {
+            if (cache.cascades[i].updated)
+            {
+                const auto& lightView = camera.m_shadowViewMatrices[i];
+                const auto& minPos = cache.frustums[i][0];
+                const auto& maxPos = cache.frustums[i][1];
+
+                Frustum volume;
+                for (auto j = 0; j < 3; ++j)
+                {
+                    const auto row = glm::row(lightView, j);
+                    volume[j * 2] = row - glm::vec4(0.f, 0.f, 0.f, minPos[j]);
+                    volume[(j * 2) + 1] = -row + glm::vec4(0.f, 0.f, 0.f, maxPos[j]);
+                }
+                cache.volumes[i] = visibility.addVolume(camEnt, volume);
+            }
+        }
+    }
+}
+
 void ShadowMapRenderer::updateDrawList(Entity camEnt)
 {
     if (intervalCounter % m_interval)
@@ -116,106 +197,102 @@ void ShadowMapRenderer::updateDrawList(Entity camEnt)
     auto& camera = camEnt.getComponent<Camera>();
     if (camera.shadowMapBuffer.available())
     {
-        if (m_drawLists.size() <= m_activeCameras.size())
+        //cascades will already be up to date if updateVisibility() was called
+        const auto cameraIndex = prepareCascades(camEnt);
+        const auto cascadeCount = camera.getCascadeCount();
+
+        //clear rather than recreate the lists so their memory is reused
+        auto& drawList = m_drawLists[cameraIndex];
+        for (auto& list : drawList)
         {
-            m_drawLists.emplace_back();
+            list.clear();
         }
 
-        auto& drawList = m_drawLists[m_activeCameras.size()];
-        drawList.clear();
-        drawList.resize(camera.getCascadeCount());
-
-        m_activeCameras.push_back(camEnt);
+        auto& cache = m_cameraCaches[cameraIndex];
+        const glm::vec3 lightDir = -getScene()->getSunlight().getComponent<Sunlight>().getDirection();
 
+        const auto& visibilitySystem = getScene()->getVisibilitySystem();
+        const auto* visibility = visibilitySystem.getCameraVisibility(camEnt);
 
-        //store the results here to use in frustum culling
-        std::vector<glm::vec3> lightPositions;
-        std::vector<Box> frustums;
 #ifdef CRO_DEBUG_
-        camera.lightCorners.clear();
+        std::int32_t visibleCount = 0;
 #endif
 
-        auto worldMat = camEnt.getComponent<cro::Transform>().getWorldTransform();
-        auto corners = camera.getFrustumSplits();
-        glm::vec3 lightDir = -getScene()->getSunlight().getComponent<Sunlight>().getDirection();
-
-        for (auto i = 0u; i < corners.size(); ++i)
+        const auto cull = [&](Entity entity, bool isStatic)
         {
-            glm::vec3 centre = glm::vec3(0.f);
+            //use the bounds calculated by the shared visibility pass where possible
+            const auto slot = visibility ? visibilitySystem.getSlot(entity) : VisibilitySystem::NoSlot;
 
-            for (auto& c : corners[i])
+            Sphere sphere;
+            if (slot != VisibilitySystem::NoSlot)
             {
-                c = worldMat * c;
-                centre += glm::vec3(c);
+                sphere = visibilitySystem.getWorldSphere(slot);
             }
-            centre /= corners[i].size();
+            else
+            {
+                const auto& tx = entity.getComponent<Transform>();
+                sphere = entity.getComponent<Model>().getBoundingSphere();
 
-            //position light source
-            auto lightPos = centre + lightDir;
-            lightPositions.push_back(lightPos);
+                sphere.centre = glm::vec3(tx.getWorldTransform() * glm::vec4(sphere.centre, 1.f));
+                auto scale = tx.getScale();
+                sphere.radius *= ((scale.x + scale.y + scale.z) / 3.f);
+            }
 
-            const auto lightView = glm::lookAt(lightPos, centre, cro::Transform::Y_AXIS);
-            camera.m_shadowViewMatrices[i] = lightView;
+            for (auto i = 0u; i < cascadeCount; ++i)
+            {
+                auto& state = cache.cascades[i];
+                if (!state.updated
+                    || (isStatic && !state.staticDirty))
+                {
+                    continue;
+                }
 
-            //world coords to light space
-            glm::vec3 minPos(std::numeric_limits<float>::max());
-            glm::vec3 maxPos(std::numeric_limits<float>::lowest());
+                float distance = glm::dot(-lightDir, sphere.centre - cache.lightPositions[i]);
 
-            for (const auto& c : corners[i])
-            {
-                const auto p = lightView * c;
-                minPos.x = std::min(minPos.x, p.x);
-                minPos.y = std::min(minPos.y, p.y);
-                minPos.z = std::min(minPos.z, p.z);
-
-                maxPos.x = std::max(maxPos.x, p.x);
-                maxPos.y = std::max(maxPos.y, p.y);
-                maxPos.z = std::max(maxPos.z, p.z);
-            }
-            
-            //padding the X and Y allows some overlap of cascades
-            //even when the light is perfectly parallel
-            minPos.x -= CascadeOverlap;
-            minPos.y -= CascadeOverlap;
-            maxPos.x += CascadeOverlap;
-            maxPos.y += CascadeOverlap;
-
-            //skewing this means we end up with more depth resolution as we're nearer near plane
-            //how much to skew is up for debate.
-            maxPos.z += camera.m_shadowExpansion * 0.1f;
-            minPos.z -= camera.m_shadowExpansion;
-
-            const auto lightProj = glm::ortho(minPos.x, maxPos.x, minPos.y, maxPos.y, minPos.z, maxPos.z);
-            camera.m_shadowProjectionMatrices[i] = lightProj;
-            camera.m_shadowViewProjectionMatrices[i] = lightProj * lightView;
-
-            frustums.emplace_back(minPos, maxPos);
-#ifdef CRO_DEBUG_
-            camera.lightCorners.emplace_back() =
-            {
-                //near
-                glm::vec4(maxPos.x, maxPos.y, minPos.z, 1.f),
-                glm::vec4(minPos.x, maxPos.y, minPos.z, 1.f),
-                glm::vec4(minPos.x, minPos.y, minPos.z, 1.f),
-                glm::vec4(maxPos.x, minPos.y, minPos.z, 1.f),
-                //far
-                glm::vec4(maxPos.x, maxPos.y, maxPos.z, 1.f),
-                glm::vec4(minPos.x, maxPos.y, maxPos.z, 1.f),
-                glm::vec4(minPos.x, minPos.y, maxPos.z, 1.f),
-                glm::vec4(maxPos.x, minPos.y, maxPos.z, 1.f)
-            };
+                bool visible = false;
+                if (slot != VisibilitySystem::NoSlot
+                    && cache.volumes[i] != VisibilitySystem::NoVolume)
+                {
+                    visible = visibility->isVisible(slot, cache.volumes[i]);
+                }
+                else
+                {
+                    //put sphere into lightspace and do an AABB test on the ortho projection
+                    auto lightSphere = sphere;
+                    lightSphere.centre = glm::vec3(camera.m_shadowViewMatrices[i] * glm::vec4(lightSphere.centre, 1.f));
+                    visible = cache.frustums[i].intersects(lightSphere);
+                }
 
+                if (visible)
+                {
+#ifdef PLATFORM_DESKTOP
+                    auto& list = isStatic ? state.staticList : drawList[i];
+                    list.emplace_back(entity, distance);
+#else
+                    //just place them all in the same draw list
+                    drawList[0].emplace_back(entity, distance);
 #endif
-        }
 #ifdef CRO_DEBUG_
-        std::int32_t visibleCount = 0;
+                    visibleCount++;
 #endif
+                }
+                else
+                {
+                    cache.stats[i].culled++;
+                }
+            }
+        };
+
+        //use depth frusta to cull dynamic entities, and gather
+        //static ones to see if the cached depth needs redrawing
+        m_staticCasters.clear();
+        std::uint64_t staticHash = 0xcbf29ce484222325;
 
-        //use depth frusta to cull entities
         auto& entities = getEntities();
         for (auto& entity : entities)
         {
-            if (!entity.getComponent<ShadowCaster>().active)
+            const auto& caster = entity.getComponent<ShadowCaster>();
+            if (!caster.active)
             {
                 continue;
             }
@@ -226,57 +303,246 @@ void ShadowMapRenderer::updateDrawList(Entity camEnt)
                 continue;
             }
 
-            const auto& tx = entity.getComponent<Transform>();
-            auto sphere = model.getBoundingSphere();
+#ifdef PLATFORM_DESKTOP
+            if (caster.isStatic && !caster.skinned)
+            {
+                m_staticCasters.push_back(entity);
+                staticHash = (staticHash ^ entity.getIndex()) * 0x100000001b3;
+                staticHash = (staticHash ^ entity.getGeneration()) * 0x100000001b3;
+                continue;
+            }
+#endif
+            cull(entity, false);
+        }
 
-            sphere.centre = glm::vec3(tx.getWorldTransform() * glm::vec4(sphere.centre, 1.f));
-            auto scale = tx.getScale();
-            sphere.radius *= ((scale.x + scale.y + scale.z) / 3.f);
+        if (staticHash != cache.staticHash
+            || m_staticCasters.size() != cache.staticCount)
+        {
+            cache.staticHash = staticHash;
+            cache.staticCount = static_cast<std::uint32_t>(m_staticCasters.size());
 
-            std::vector<std::pair<std::size_t, std::size_t>> drawListOffsets;
+            for (auto& cascade : cache.cascades)
+            {
+                cascade.staticDirty = true;
+            }
+        }
 
-            for (auto i = 0u; i < camera.getCascadeCount(); ++i)
+        if (cache.staticCount != 0)
+        {
+            bool redraw = false;
+            for (auto& cascade : cache.cascades)
             {
-                float distance = glm::dot(-lightDir, sphere.centre - lightPositions[i]);
+                if (cascade.updated && cascade.staticDirty)
+                {
+                    cascade.staticList.clear();
+                    redraw = true;
+                }
+            }
 
-                //put sphere into lightspace and do an AABB test on the ortho projection
-                auto lightSphere = sphere;
-                lightSphere.centre = glm::vec3(camera.m_shadowViewMatrices[i] * glm::vec4(lightSphere.centre, 1.f));
-                
-                if (frustums[i].intersects(lightSphere))
+            if (redraw)
+            {
+                for (auto entity : m_staticCasters)
                 {
-#ifdef PLATFORM_DESKTOP
-                    drawList[i].emplace_back(entity, distance);
-#else
-                    //just place them all in the same draw list
-                    drawList[0].emplace_back(entity, distance);
-#endif
-#ifdef CRO_DEBUG_
-                    visibleCount++;
-#endif
+                    cull(entity, true);
                 }
             }
         }
 
         //sort back to front
-        for (auto& cascade : drawList)
+        const auto sortList = [](std::vector<Drawable>& list)
         {
-            std::sort(cascade.begin(), cascade.end(),
+            std::sort(list.begin(), list.end(),
                 [](const ShadowMapRenderer::Drawable& a, const ShadowMapRenderer::Drawable& b)
                 {
                     return a.distance > b.distance;
                 });
+        };
+
+        for (auto i = 0u; i < cascadeCount; ++i)
+        {
+            sortList(drawList[i]);
+
+            if (cache.cascades[i].updated
+                && cache.cascades[i].staticDirty)
+            {
+                sortList(cache.cascades[i].staticList);
+            }
         }
 
 #ifdef CRO_DEBUG_
         //some objects might appear in multiple cascades
         DPRINT("Rendered 3D shadow ents", std::to_string(visibleCount));
-        camera.lightPositions.swap(lightPositions);
+        camera.lightPositions = cache.lightPositions;
 #endif
     }
 }
 
 //private
+std::size_t ShadowMapRenderer::prepareCascades(Entity camEnt)
+{
+    for (auto i = 0u; i < m_activeCameras.size(); ++i)
+    {
+        if (m_activeCameras[i] == camEnt
+            && m_activeCameras[i].getGeneration() == camEnt.getGeneration())
+        {
+            return i;
+        }
+    }
+
+    auto& camera = camEnt.getComponent<Camera>();
+    const auto cameraIndex = m_activeCameras.size();
+    if (m_drawLists.size() <= cameraIndex)
+    {
+        m_drawLists.emplace_back();
+        m_cameraCaches.emplace_back();
+    }
+
+    const auto cascadeCount = camera.getCascadeCount();
+    m_drawLists[cameraIndex].resize(cascadeCount);
+
+    auto& cache = m_cameraCaches[cameraIndex];
+    updateCache(cache, camEnt);
+
+    m_activeCameras.push_back(camEnt);
+
+    //store the results here to use in frustum culling
+    cache.lightPositions.resize(cascadeCount);
+    cache.frustums.resize(cascadeCount);
+    cache.volumes.assign(cascadeCount, VisibilitySystem::NoVolume);
+#ifdef CRO_DEBUG_
+    camera.lightCorners.resize(cascadeCount);
+#endif
+
+    auto worldMat = camEnt.getComponent<cro::Transform>().getWorldTransform();
+    const auto& corners = camera.getFrustumSplits();
+    glm::vec3 lightDir = -getScene()->getSunlight().getComponent<Sunlight>().getDirection();
+
+    //light space with a fixed origin, used to snap each cascade to a grid
+    const auto lightRotation = glm::lookAt(lightDir, glm::vec3(0.f), cro::Transform::Y_AXIS);
+    const auto inverseLightRotation = glm::inverse(lightRotation);
+    const float mapSize = static_cast<float>(std::max(1u, camera.shadowMapBuffer.getSize().x));
+
+    for (auto i = 0u; i < corners.size(); ++i)
+    {
+        auto& state = cache.cascades[i];
+        auto& stats = cache.stats[i];
+        stats = {};
+
+        const auto interval = i < m_cascadeIntervals.size() ? m_cascadeIntervals[i] : 1u;
+        state.updated = !state.valid || ((m_renderCount + i) % interval) == 0;
+        stats.updated = state.updated;
+
+        if (!state.updated)
+        {
+            //leave the matrices as they were when the cascade was last rendered
+            continue;
+        }
+
+        //use the bounding sphere of the split, calculated in camera
+        //space, so that the size of the light frustum doesn't change
+        //as the camera rotates
+        glm::vec3 localCentre = glm::vec3(0.f);
+        for (const auto& c : corners[i])
+        {
+            localCentre += glm::vec3(c);
+        }
+        localCentre /= corners[i].size();
+
+        float radius = 0.f;
+        for (const auto& c : corners[i])
+        {
+            radius = std::max(radius, glm::length(glm::vec3(c) - localCentre));
+        }
+
+        //the frustum is extended by one snap step so the sphere stays
+        //inside it wherever it lies in the current grid cell. The step
+        //is a whole number of texels so that shadow edges don't shimmer
+        const float diameter = (radius + CascadeOverlap) * 2.f;
+        const float extent = diameter * (1.f + (1.f / SnapDivisions));
+        const float texelSize = extent / mapSize;
+        const float step = std::max(1.f, std::floor((diameter / SnapDivisions) / texelSize)) * texelSize;
+
+        glm::vec3 centre = glm::vec3(lightRotation * worldMat * glm::vec4(localCentre, 1.f));
+        centre = glm::floor(centre / step) * step;
+        centre = glm::vec3(inverseLightRotation * glm::vec4(centre, 1.f));
+
+        //position light source
+        auto lightPos = centre + lightDir;
+        cache.lightPositions[i] = lightPos;
+
+        const auto lightView = glm::lookAt(lightPos, centre, cro::Transform::Y_AXIS);
+        camera.m_shadowViewMatrices[i] = lightView;
+
+        //the split centre lies between the snapped centre, which is
+        //at (0, 0, -1) in light space, and one step along each axis
+        glm::vec3 minPos(step / 2.f - extent / 2.f);
+        glm::vec3 maxPos(step / 2.f + extent / 2.f);
+        minPos.z = -1.f - radius;
+        maxPos.z = -1.f + radius + step;
+
+        //skewing this means we end up with more depth resolution as we're nearer near plane
+        //how much to skew is up for debate.
+        maxPos.z += camera.m_shadowExpansion * 0.1f;
+        minPos.z -= camera.m_shadowExpansion;
+
+        const auto lightProj = glm::ortho(minPos.x, maxPos.x, minPos.y, maxPos.y, minPos.z, maxPos.z);
+        camera.m_shadowProjectionMatrices[i] = lightProj;
+        camera.m_shadowViewProjectionMatrices[i] = lightProj * lightView;
+
+        //only redraw static casters if the frustum actually moved
+        if (state.staticViewProjection != camera.m_shadowViewProjectionMatrices[i])
+        {
+            state.staticDirty = true;
+        }
+
+        cache.frustums[i] = Box(minPos, maxPos);
+#ifdef CRO_DEBUG_
+        camera.lightCorners[i] =
+        {
+            //near
+            glm::vec4(maxPos.x, maxPos.y, minPos.z, 1.f),
+            glm::vec4(minPos.x, maxPos.y, minPos.z, 1.f),
+            glm::vec4(minPos.x, minPos.y, minPos.z, 1.f),
+            glm::vec4(maxPos.x, minPos.y, minPos.z, 1.f),
+            //far
+            glm::vec4(maxPos.x, maxPos.y, maxPos.z, 1.f),
+            glm::vec4(minPos.x, maxPos.y, maxPos.z, 1.f),
+            glm::vec4(minPos.x, minPos.y, maxPos.z, 1.f),
+            glm::vec4(maxPos.x, minPos.y, maxPos.z, 1.f)
+        };
+
+#endif
+    }
+
+    return cameraIndex;
+}
+
+void ShadowMapRenderer::updateCache(CameraCache& cache, Entity camEnt)
+{
+    const auto& camera = camEnt.getComponent<Camera>();
+    const auto cascadeCount = camera.getCascadeCount();
+
+    //reset everything if this is a different camera or the
+    //buffer was recreated, as the contents will be invalid
+    if (cache.camera.getIndex() != camEnt.getIndex()
+        || cache.camera.getGeneration() != camEnt.getGeneration()
+        || cache.bufferSize != camera.shadowMapBuffer.getSize()
+        || cache.renderFlags != camera.renderFlags
+        || cache.cascades.size() != cascadeCount)
+    {
+        cache.camera = camEnt;
+        cache.bufferSize = camera.shadowMapBuffer.getSize();
+        cache.renderFlags = camera.renderFlags;
+        cache.staticHash = 0;
+        cache.staticCount = 0;
+
+        cache.cascades.clear();
+        cache.cascades.resize(cascadeCount);
+        cache.stats.clear();
+        cache.stats.resize(cascadeCount);
+    }
+}
+
 void ShadowMapRenderer::render()
 {
     for (auto c = 0u; c < m_activeCameras.size(); c++)
@@ -284,6 +550,7 @@ void ShadowMapRenderer::render()
         auto& camera = m_activeCameras[c].getComponent<Camera>();
         auto cameraPosition = m_activeCameras[c].getComponent<cro::Transform>().getWorldPosition();
         const auto& camView = camera.getPass(Camera::Pass::Final).viewMatrix;
+        auto& cache = m_cameraCaches[c];
 
         //enable face culling and render rear faces
         //glCheck(glEnable(GL_CULL_FACE)); //this is now done per-material as some may be double sided
@@ -291,119 +558,56 @@ void ShadowMapRenderer::render()
         //glCheck(glCullFace(GL_FRONT));
         glCheck(glEnable(GL_DEPTH_TEST));
 
+#ifdef PLATFORM_DESKTOP
+        if (cache.staticCount != 0)
+        {
+            //does nothing if the size is unchanged
+            cache.staticDepth.create(cache.bufferSize.x, cache.bufferSize.y, camera.shadowMapBuffer.getLayerCount());
+        }
+#endif
+
         for (auto d = 0u; d < m_drawLists[c].size(); ++d)
         {
+            auto& state = cache.cascades[d];
+            auto& stats = cache.stats[d];
+            if (!state.updated)
+            {
+                //keep the existing contents of this layer
+                continue;
+            }
+
 #ifdef PLATFORM_DESKTOP
-            camera.shadowMapBuffer.clear(d);
-#else
-            //this should only ever have one draw list so
-            //clearing in this loop only happens once.
-            camera.shadowMapBuffer.clear(cro::Colour::White());
-#endif
-            const auto& list = m_drawLists[c][d];
-            for (const auto& [e, _] : list)
+            if (cache.staticCount != 0)
             {
-                const auto& model = e.getComponent<Model>();
-                //skip this model if its flags don't pass
-                if ((model.m_renderFlags & camera.renderFlags) == 0)
+                if (state.staticDirty)
                 {
-                    continue;
-                }
+                    cache.staticDepth.clear(d);
+                    stats.drawn += drawCasters(state.staticList, camera, m_activeCameras[c].getIndex(), d, cameraPosition, camView);
+                    cache.staticDepth.display();
 
-                glCheck(glFrontFace(model.m_facing));
-
-                //calc entity transform
-                const auto& tx = e.getComponent<Transform>();
-                glm::mat4 worldMat = tx.getWorldTransform();
-                glm::mat4 worldView = camera.m_shadowViewMatrices[d] * worldMat;
-
-                //foreach submesh / material:
-
-#ifndef PLATFORM_DESKTOP
-                glCheck(glBindBuffer(GL_ARRAY_BUFFER, model.m_meshData.vbo));
-#endif
-
-                for (auto i = 0u; i < model.m_meshData.submeshCount; ++i)
+                    state.staticViewProjection = camera.m_shadowViewProjectionMatrices[d];
+                    state.staticDirty = false;
+                    stats.staticRedrawn = true;
+                }
+                else
                 {
-                    const auto& mat = model.m_materials[Mesh::IndexData::Shadow][i];
-                    CRO_ASSERT(mat.shader, "Missing Shadow Cast material.");
-
-                    //bind shader
-                    glCheck(glUseProgram(mat.shader));
-
-                    //apply shader uniforms from material
-                    for (auto j = 0u; j < mat.optionalUniformCount; ++j)
-                    {
-                        switch (mat.optionalUniforms[j])
-                        {
-                        default: break;
-                        case Material::Skinning:
-                            glCheck(glUniformMatrix4fv(mat.uniforms[Material::Skinning], static_cast<GLsizei>(model.m_jointCount), GL_FALSE, &model.m_skeleton[0][0].r));
-                            break;
-                        }
-                    }
-
-                    //check material properties for alpha clipping
-                    std::uint32_t currentTextureUnit = 0;
-                    for (const auto& prop : mat.properties)
-                    {
-                        switch (prop.second.second.type)
-                        {
-                        default: break;
-                        case Material::Property::Texture:
-                            glCheck(glActiveTexture(GL_TEXTURE0 + currentTextureUnit));
-                            glCheck(glBindTexture(GL_TEXTURE_2D, prop.second.second.textureID));
-                            glCheck(glUniform1i(prop.second.first, currentTextureUnit++));
-                            break;
-                        case Material::Property::Number:
-                            glCheck(glUniform1f(prop.second.first, prop.second.second.numberValue));
-                            break;
-                        }
-                    }
-
-                    glCheck(glUniformMatrix4fv(mat.uniforms[Material::World], 1, GL_FALSE, glm::value_ptr(worldMat)));
-                    glCheck(glUniformMatrix4fv(mat.uniforms[Material::View], 1, GL_FALSE, glm::value_ptr(camera.m_shadowViewMatrices[d])));
-                    glCheck(glUniformMatrix4fv(mat.uniforms[Material::WorldView], 1, GL_FALSE, glm::value_ptr(worldView)));
-                    glCheck(glUniformMatrix4fv(mat.uniforms[Material::CameraView], 1, GL_FALSE, glm::value_ptr(camView)));
-                    glCheck(glUniformMatrix4fv(mat.uniforms[Material::Projection], 1, GL_FALSE, glm::value_ptr(camera.m_shadowProjectionMatrices[d])));
-                    glCheck(glUniform3f(mat.uniforms[Material::Camera], cameraPosition.x, cameraPosition.y, cameraPosition.z));
-                    //glCheck(glUniformMatrix4fv(mat.uniforms[Material::ViewProjection], 1, GL_FALSE, glm::value_ptr(camera.depthViewProjectionMatrix)));
-
-                    glCheck((/*model.m_materials[Mesh::IndexData::Final][i].doubleSided ||*/ mat.doubleSided) ? glDisable(GL_CULL_FACE) : glEnable(GL_CULL_FACE));
-
-#ifdef PLATFORM_DESKTOP
-                    model.draw(i, Mesh::IndexData::Shadow);
-#else
-                    //bind attribs
-                    const auto& attribs = mat.attribs;
-                    for (auto j = 0u; j < mat.attribCount; ++j)
-                    {
-                        glCheck(glEnableVertexAttribArray(attribs[j][Material::Data::Index]));
-                        glCheck(glVertexAttribPointer(attribs[j][Material::Data::Index], attribs[j][Material::Data::Size],
-                            GL_FLOAT, GL_FALSE, static_cast<GLsizei>(model.m_meshData.vertexSize),
-                            reinterpret_cast<void*>(static_cast<intptr_t>(attribs[j][Material::Data::Offset]))));
-                    }
-
-                    //bind element/index buffer
-                    const auto& indexData = model.m_meshData.indexData[i];
-                    glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexData.ibo));
-
-                    //draw elements
-                    glCheck(glDrawElements(static_cast<GLenum>(indexData.primitiveType), indexData.indexCount, static_cast<GLenum>(indexData.format), 0));
-
-                    glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
-
-                    //unbind attribs
-                    for (auto j = 0u; j < mat.attribCount; ++j)
-                    {
-                        glCheck(glDisableVertexAttribArray(attribs[j][Material::Data::Index]));
-                    }
-#endif //PLATFORM
+                    stats.cachedStatic = static_cast<std::uint32_t>(state.staticList.size());
                 }
-
+                camera.shadowMapBuffer.clear(d, cache.staticDepth, d);
+            }
+            else
+            {
+                camera.shadowMapBuffer.clear(d);
             }
+#else
+            //this should only ever have one draw list so
+            //clearing in this loop only happens once.
+            camera.shadowMapBuffer.clear(cro::Colour::White());
+#endif
+            stats.drawn += drawCasters(m_drawLists[c][d], camera, m_activeCameras[c].getIndex(), d, cameraPosition, camView);
 
             camera.shadowMapBuffer.display();
+            state.valid = true;
         }
 #ifdef PLATFORM_DESKTOP
         glCheck(glBindVertexArray(0));
@@ -420,6 +624,119 @@ void ShadowMapRenderer::render()
     }
 }
 
+std::uint32_t ShadowMapRenderer::drawCasters(const std::vector<Drawable>& list, const Camera& camera, std::uint32_t cameraIndex, std::size_t d, glm::vec3 cameraPosition, const glm::mat4& camView)
+{
+    std::uint32_t drawCount = 0;
+
+    for (const auto& [e, _] : list)
+    {
+        const auto& model = e.getComponent<Model>();
+        //skip this model if its flags don't pass
+        if ((model.m_renderFlags & camera.renderFlags) == 0)
+        {
+            continue;
+        }
+        drawCount++;
+
+        glCheck(glFrontFace(model.m_facing));
+
+        //calc entity transform
+        const auto& tx = e.getComponent<Transform>();
+        glm::mat4 worldMat = tx.getWorldTransform();
+        glm::mat4 worldView = camera.m_shadowViewMatrices[d] * worldMat;
+
+        //foreach submesh / material:
+
+        //casters use the level selected for the final pass of the camera which owns the cascade
+        model.m_activeLod = model.getLodLevel(cameraIndex, Camera::Pass::Final);
+
+#ifndef PLATFORM_DESKTOP
+        glCheck(glBindBuffer(GL_ARRAY_BUFFER, model.getActiveMeshData().vbo));
+#endif
+
+        for (auto i = 0u; i < model.m_meshData.submeshCount; ++i)
+        {
+            const auto& mat = model.m_materials[Mesh::IndexData::Shadow][i];
+            CRO_ASSERT(mat.shader, "Missing Shadow Cast material.");
+
+            //bind shader
+            glCheck(glUseProgram(mat.shader));
+
+            //apply shader uniforms from material
+            for (auto j = 0u; j < mat.optionalUniformCount; ++j)
+            {
+                switch (mat.optionalUniforms[j])
+                {
+                default: break;
+                case Material::Skinning:
+                    glCheck(glUniformMatrix4fv(mat.uniforms[Material::Skinning], static_cast<GLsizei>(model.m_jointCount), GL_FALSE, &model.m_skeleton[0][0].r));
+                    break;
+                }
+            }
+
+            //check material properties for alpha clipping
+            std::uint32_t currentTextureUnit = 0;
+            for (const auto& prop : mat.properties)
+            {
+                switch (prop.second.second.type)
+                {
+                default: break;
+                case Material::Property::Texture:
+                    glCheck(glActiveTexture(GL_TEXTURE0 + currentTextureUnit));
+                    glCheck(glBindTexture(GL_TEXTURE_2D, prop.second.second.textureID));
+                    glCheck(glUniform1i(prop.second.first, currentTextureUnit++));
+                    break;
+                case Material::Property::Number:
+                    glCheck(glUniform1f(prop.second.first, prop.second.second.numberValue));
+                    break;
+                }
+            }
+
+            glCheck(glUniformMatrix4fv(mat.uniforms[Material::World], 1, GL_FALSE, glm::value_ptr(worldMat)));
+            glCheck(glUniformMatrix4fv(mat.uniforms[Material::View], 1, GL_FALSE, glm::value_ptr(camera.m_shadowViewMatrices[d])));
+            glCheck(glUniformMatrix4fv(mat.uniforms[Material::WorldView], 1, GL_FALSE, glm::value_ptr(worldView)));
+            glCheck(glUniformMatrix4fv(mat.uniforms[Material::CameraView], 1, GL_FALSE, glm::value_ptr(camView)));
+            glCheck(glUniformMatrix4fv(mat.uniforms[Material::Projection], 1, GL_FALSE, glm::value_ptr(camera.m_shadowProjectionMatrices[d])));
+            glCheck(glUniform3f(mat.uniforms[Material::Camera], cameraPosition.x, cameraPosition.y, cameraPosition.z));
+            //glCheck(glUniformMatrix4fv(mat.uniforms[Material::ViewProjection], 1, GL_FALSE, glm::value_ptr(camera.depthViewProjectionMatrix)));
+
+            glCheck((/*model.m_materials[Mesh::IndexData::Final][i].doubleSided ||*/ mat.doubleSided) ? glDisable(GL_CULL_FACE) : glEnable(GL_CULL_FACE));
+
+#ifdef PLATFORM_DESKTOP
+            model.draw(i, Mesh::IndexData::Shadow);
+#else
+            //bind attribs
+            const auto& attribs = mat.attribs;
+            for (auto j = 0u; j < mat.attribCount; ++j)
+            {
+                glCheck(glEnableVertexAttribArray(attribs[j][Material::Data::Index]));
+                glCheck(glVertexAttribPointer(attribs[j][Material::Data::Index], attribs[j][Material::Data::Size],
+                    GL_FLOAT, GL_FALSE, static_cast<GLsizei>(model.getActiveMeshData().vertexSize),
+                    reinterpret_cast<void*>(static_cast<intptr_t>(attribs[j][Material::Data::Offset]))));
+            }
+
+            //bind element/index buffer
+            const auto& indexData = model.getActiveMeshData().indexData[i];
+            glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexData.ibo));
+
+            //draw elements
+            glCheck(glDrawElements(static_cast<GLenum>(indexData.primitiveType), indexData.indexCount, static_cast<GLenum>(indexData.format), 0));
+
+            glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+
+            //unbind attribs
+            for (auto j = 0u; j < mat.attribCount; ++j)
+            {
+                glCheck(glDisableVertexAttribArray(attribs[j][Material::Data::Index]));
+            }
+#endif //PLATFORM
+        }
+        model.m_activeLod = 0;
+    }
+
+    return drawCount;
+}
+
 void ShadowMapRenderer::onEntityAdded(cro::Entity entity)
 {
     if (entity.getComponent<cro::Model>().m_materials[Mesh::IndexData::Shadow][0].shader == 0)
@@ -33,6 +33,8 @@ source distribution.
 #include <crogine/ecs/components/Sprite.hpp>
 #include <crogine/ecs/components/Model.hpp>
 #include <crogine/graphics/Texture.hpp>
+#include <crogine/ecs/Scene.hpp>
+#include <crogine/core/App.hpp>
 
 #include <crogine/detail/OpenGL.hpp>
 
@@ -49,16 +51,25 @@ SpriteSystem3D::SpriteSystem3D(MessageBus& mb, float pixelsPerUnit)
     requireComponent<Sprite>();
     requireComponent<Model>();
 
-    m_colouredShader.loadFromString(Shaders::Sprite::Vertex, Shaders::Sprite::Coloured);
-    m_texturedShader.loadFromString(Shaders::Sprite::Vertex, Shaders::Sprite::Textured, "#define TEXTURED\n");
+    if (!App::isHeadless())
+    {
+        m_colouredShader.loadFromString(Shaders::Sprite::Vertex, Shaders::Sprite::Coloured);
+        m_texturedShader.loadFromString(Shaders::Sprite::Vertex, Shaders::Sprite::Textured, "#define TEXTURED\n");
 
-    m_colouredMaterial = createMaterial(m_colouredShader);
-    m_texturedMaterial = createMaterial(m_texturedShader);
+        m_colouredMaterial = createMaterial(m_colouredShader);
+        m_texturedMaterial = createMaterial(m_texturedShader);
+    }
 }
 
 //public
 void SpriteSystem3D::process(float)
 {
+    //sprite geometry only exists on the GPU
+    if (getScene()->isHeadless())
+    {
+        return;
+    }
+
     //check sprites for dirty flags and update geom as necessary.
     //remember to switch shaders if a texture is added or removed.
     auto& entities = getEntities();
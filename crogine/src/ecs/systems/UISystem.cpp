@@ -61,7 +61,7 @@ UISystem::UISystem(MessageBus& mb)
     m_movementCallbacks.push_back([](Entity, glm::vec2, MotionEvent) {});
     m_selectionCallbacks.push_back([](Entity) {});
 
-    m_windowSize = App::getWindow().getSize();
+    m_windowSize = App::isHeadless() ? glm::uvec2(1) : App::getWindow().getSize();
 }
 
 void UISystem::handleEvent(const Event& evt)
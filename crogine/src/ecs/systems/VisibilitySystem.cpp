@@ -0,0 +1,252 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include <crogine/ecs/systems/VisibilitySystem.hpp>
+#include <crogine/ecs/components/Model.hpp>
+#include <crogine/ecs/components/Transform.hpp>
+#include <crogine/ecs/components/Camera.hpp>
+#include <crogine/ecs/Renderable.hpp>
+
+#include "../../detail/ParallelFor.hpp"
+
+using namespace cro;
+
+namespace
+{
+    //each job handles whole 64 bit words of the results
+    constexpr std::size_t MinWordsPerThread = 8;
+
+    bool intersects(const Frustum& frustum, const Sphere& sphere)
+    {
+        for (const auto& plane : frustum)
+        {
+            if (Spatial::distance(plane, sphere.centre) < -sphere.radius)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+VisibilitySystem::VisibilitySystem(MessageBus& mb)
+    : System        (mb, typeid(VisibilitySystem)),
+    m_sceneChanged  (true),
+    m_cameraCount   (0)
+{
+    requireComponent<Model>();
+    requireComponent<Transform>();
+}
+
+//public
+void VisibilitySystem::update(const std::vector<Entity>& cameras, const std::vector<Renderable*>& renderables)
+{
+    //world transforms are read on this thread as evaluating them
+    //may update cached values which are shared with parent transforms
+    m_previousEntities.swap(m_slotEntities);
+    m_previousTransforms.swap(m_worldTransforms);
+    m_previousSpheres.swap(m_localSpheres);
+
+    m_slotEntities.clear();
+    m_worldTransforms.clear();
+    m_worldSpheres.clear();
+    m_localSpheres.clear();
+    m_scales.clear();
+    std::fill(m_slots.begin(), m_slots.end(), NoSlot);
+
+    m_sceneChanged = false;
+
+    const auto& entities = getEntities();
+    for (auto entity : entities)
+    {
+        auto& model = entity.getComponent<Model>();
+        if (model.isHidden())
+        {
+            continue;
+        }
+
+        if (model.m_meshBox != model.m_meshData.boundingBox)
+        {
+            model.updateBounds();
+        }
+
+        if (model.m_drawListDirty)
+        {
+            m_sceneChanged = true;
+            model.m_drawListDirty = false;
+        }
+
+        const auto index = entity.getIndex();
+        if (index >= m_slots.size())
+        {
+            m_slots.resize(index + 1, NoSlot);
+        }
+
+        const auto slot = m_slotEntities.size();
+        m_slots[index] = static_cast<std::uint32_t>(slot);
+
+        const auto& tx = entity.getComponent<Transform>();
+        m_slotEntities.push_back(entity);
+        m_worldTransforms.push_back(tx.getWorldTransform());
+        m_worldSpheres.push_back(model.getBoundingSphere());
+        m_localSpheres.push_back(m_worldSpheres.back());
+        m_scales.push_back(tx.getScale());
+
+        if (!m_sceneChanged)
+        {
+            m_sceneChanged = slot >= m_previousEntities.size()
+                || m_previousEntities[slot] != entity
+                || m_previousEntities[slot].getGeneration() != entity.getGeneration()
+                || m_previousTransforms[slot] != m_worldTransforms.back()
+                || m_previousSpheres[slot].centre != m_localSpheres.back().centre
+                || m_previousSpheres[slot].radius != m_localSpheres.back().radius;
+        }
+    }
+    m_sceneChanged = m_sceneChanged || (m_slotEntities.size() != m_previousEntities.size());
+
+    //each camera starts with its own passes, then
+    //renderables may add any volumes they require
+    m_cameraCount = 0;
+    for (auto camera : cameras)
+    {
+        if (m_cameras.size() == m_cameraCount)
+        {
+            m_cameras.emplace_back();
+        }
+        auto& result = m_cameras[m_cameraCount++];
+
+        //results can only be kept if they belong to the same camera
+        result.m_unchanged = (result.m_camera == camera
+            && result.m_camera.getGeneration() == camera.getGeneration()
+            && !result.m_bits.empty());
+
+        result.m_camera = camera;
+        result.m_previousVolumes.swap(result.m_volumes);
+        result.m_volumes.clear();
+
+        const auto& cam = camera.getComponent<Camera>();
+        result.m_volumes.push_back(cam.getPass(Camera::Pass::Final).getFrustum());
+        if (cam.reflectionBuffer.available())
+        {
+            result.m_volumes.push_back(cam.getPass(Camera::Pass::Reflection).getFrustum());
+        }
+    }
+
+    for (auto* renderable : renderables)
+    {
+        for (auto camera : cameras)
+        {
+            renderable->updateVisibility(camera, *this);
+        }
+    }
+
+    const auto slotCount = m_slotEntities.size();
+    const auto wordCount = (slotCount + 63) / 64;
+
+    //only cameras whose inputs changed are re-tested
+    m_dirtyCameras.clear();
+    for (auto i = 0u; i < m_cameraCount; ++i)
+    {
+        auto& result = m_cameras[i];
+        result.m_unchanged = result.m_unchanged
+            && !m_sceneChanged
+            && !result.m_camera.getComponent<Camera>().hasChanged()
+            && result.m_volumes == result.m_previousVolumes;
+
+        if (!result.m_unchanged)
+        {
+            result.m_wordCount = wordCount;
+            result.m_bits.assign(result.m_volumes.size() * wordCount, 0);
+            m_dirtyCameras.push_back(i);
+        }
+    }
+
+    //ranges are split on word boundaries so no two threads write to the same word
+    Detail::parallelFor(wordCount, MinWordsPerThread,
+        [&](std::size_t begin, std::size_t end)
+        {
+            for (auto word = begin; word < end; ++word)
+            {
+                const auto last = std::min((word + 1) * 64, slotCount);
+                for (auto slot = word * 64; slot < last; ++slot)
+                {
+                    auto& sphere = m_worldSpheres[slot];
+                    sphere.centre = glm::vec3(m_worldTransforms[slot] * glm::vec4(sphere.centre, 1.f));
+                    const auto& scale = m_scales[slot];
+                    sphere.radius *= ((scale.x + scale.y + scale.z) / 3.f);
+
+                    const auto bit = std::uint64_t(1) << (slot % 64);
+                    for (auto i : m_dirtyCameras)
+                    {
+                        auto& result = m_cameras[i];
+                        for (auto v = 0u; v < result.m_volumes.size(); ++v)
+                        {
+                            if (intersects(result.m_volumes[v], sphere))
+                            {
+                                result.m_bits[(v * wordCount) + word] |= bit;
+                            }
+                        }
+                    }
+                }
+            }
+        });
+}
+
+std::size_t VisibilitySystem::addVolume(Entity camera, const Frustum& volume)
+{
+    auto* result = findCamera(camera);
+    CRO_ASSERT(result, "Camera is not part of the current update");
+    if (!result)
+    {
+        return NoVolume;
+    }
+
+    result->m_volumes.push_back(volume);
+    return result->m_volumes.size() - 1;
+}
+
+const VisibilitySystem::CameraVisibility* VisibilitySystem::getCameraVisibility(Entity camera) const
+{
+    return const_cast<VisibilitySystem*>(this)->findCamera(camera);
+}
+
+//private
+VisibilitySystem::CameraVisibility* VisibilitySystem::findCamera(Entity camera)
+{
+    for (auto i = 0u; i < m_cameraCount; ++i)
+    {
+        if (m_cameras[i].m_camera == camera
+            && m_cameras[i].m_camera.getGeneration() == camera.getGeneration())
+        {
+            return &m_cameras[i];
+        }
+    }
+    return nullptr;
+}
@@ -28,11 +28,13 @@ source distribution.
 -----------------------------------------------------------------------*/
 
 #include <crogine/graphics/BinaryMeshBuilder.hpp>
+#include <crogine/graphics/MeshResource.hpp>
 #include <crogine/detail/ModelBinary.hpp>
 #include <crogine/detail/glm/gtc/type_ptr.hpp>
 #include <crogine/core/FileSystem.hpp>
 
 #include "../detail/GLCheck.hpp"
+#include "../detail/MappedFile.hpp"
 
 using namespace cro;
 
@@ -63,106 +65,218 @@ Skeleton BinaryMeshBuilder::getSkeleton() const
     return m_skeleton;
 }
 
+std::vector<std::size_t> BinaryMeshBuilder::loadBatch(MeshResource& resources, const std::vector<std::string>& paths)
+{
+    //map every file first and let the OS start reading them
+    //all in the background while the first meshes are built
+    std::vector<BinaryMeshBuilder> builders;
+    builders.reserve(paths.size());
+    for (const auto& path : paths)
+    {
+        auto& builder = builders.emplace_back(path);
+        if (!builder.m_path.empty())
+        {
+            builder.m_file = std::make_shared<Detail::MappedFile>();
+            if (builder.m_file->open(builder.m_path))
+            {
+                builder.m_file->prefetch();
+            }
+            else
+            {
+                builder.m_file.reset();
+            }
+        }
+    }
+
+    std::vector<std::size_t> retVal;
+    retVal.reserve(builders.size());
+    for (auto& builder : builders)
+    {
+        if (builder.m_file)
+        {
+            retVal.push_back(resources.loadMesh(builder));
+        }
+        else
+        {
+            LogE << "Failed loading " << builder.m_path << std::endl;
+            retVal.push_back(0);
+        }
+
+        //release the mapping as soon as we're done with it
+        builder.m_file.reset();
+    }
+
+    return retVal;
+}
+
 Mesh::Data BinaryMeshBuilder::build() const
+{
+    if (m_path.empty())
+    {
+        LogE << "Unable to build mesh: file not found" << std::endl;
+        return {};
+    }
+
+    auto file = m_file;
+    if (!file)
+    {
+        file = std::make_shared<Detail::MappedFile>();
+        if (!file->open(m_path))
+        {
+            return {};
+        }
+    }
+
+    auto meshData = build(file->getData(), file->getSize());
+
+    //the mapping is only needed until the mesh is uploaded
+    m_file.reset();
+
+    return meshData;
+}
+
+//private
+Mesh::Data BinaryMeshBuilder::build(const std::uint8_t* fileData, std::size_t fileSize) const
 {
     Mesh::Data meshData;
 
-    RaiiRWops file;
-    file.file = SDL_RWFromFile(m_path.c_str(), "rb");
-    if (file.file)    
+    Detail::ModelBinary::Header header;
+    if (fileSize < sizeof(header))
+    {
+        LogE << "Unable to open " << m_path << ": invalid file size" << std::endl;
+        return {};
+    }
+    std::memcpy(&header, fileData, sizeof(header));
+
+    if (header.magic != Detail::ModelBinary::MAGIC
+        && header.magic != Detail::ModelBinary::MAGIC_V1)
+    {
+        LogE << "Invalid header found" << std::endl;
+        return {};
+    }
+
+    if (header.meshOffset)
     {
-        Detail::ModelBinary::Header header;
-        auto len = SDL_RWseek(file.file, 0, RW_SEEK_END);
-        if (len < sizeof(header))
+        Detail::ModelBinary::MeshHeader meshHeader;
+        if (std::size_t(header.meshOffset) + sizeof(meshHeader) > fileSize)
         {
-            LogE << "Unable to open " << m_path << ": invalid file size" << std::endl;
+            LogE << m_path << ": mesh offset is out of range" << std::endl;
             return {};
         }
+        std::memcpy(&meshHeader, fileData + header.meshOffset, sizeof(meshHeader));
 
-        SDL_RWseek(file.file, 0, RW_SEEK_SET);
-        SDL_RWread(file.file, &header, sizeof(header), 1);
+        if ((meshHeader.flags & VertexProperty::Position) == 0)
+        {
+            LogE << "No position data in mesh" << std::endl;
+            return {};
+        }
 
-        if (header.magic != Detail::ModelBinary::MAGIC
-            && header.magic != Detail::ModelBinary::MAGIC_V1)
+        if (meshHeader.indexArrayCount == 0
+            || meshHeader.indexArrayCount > Mesh::IndexData::MaxBuffers)
         {
-            LogE << "Invalid header found" << std::endl;
+            LogE << m_path << ": invalid index array count " << meshHeader.indexArrayCount << std::endl;
             return {};
         }
 
-        if (header.meshOffset)
+        const std::size_t sizesOffset = header.meshOffset + sizeof(meshHeader);
+        const std::size_t vertOffset = sizesOffset + (meshHeader.indexArrayCount * sizeof(std::uint32_t));
+        if (vertOffset > meshHeader.indexArrayOffset
+            || meshHeader.indexArrayOffset > fileSize)
         {
-            Detail::ModelBinary::MeshHeader meshHeader;
-            SDL_RWread(file.file, &meshHeader, sizeof(meshHeader), 1);
+            LogE << m_path << ": invalid index array offset" << std::endl;
+            return {};
+        }
 
-            if ((meshHeader.flags & VertexProperty::Position) == 0)
-            {
-                LogE << "No position data in mesh" << std::endl;
-                return {};
-            }
+        std::vector<std::uint32_t> sizes(meshHeader.indexArrayCount);
+        std::memcpy(sizes.data(), fileData + sizesOffset, meshHeader.indexArrayCount * sizeof(std::uint32_t));
 
-            std::vector<float> tempVerts;
-            std::vector<std::uint32_t> sizes(meshHeader.indexArrayCount);
-            std::vector<std::vector<std::uint32_t>> indexData(meshHeader.indexArrayCount);
+        std::size_t indexBytes = 0;
+        for (auto size : sizes)
+        {
+            indexBytes += size * sizeof(std::uint32_t);
+        }
 
-            SDL_RWread(file.file, sizes.data(), meshHeader.indexArrayCount * sizeof(std::uint32_t), 1);
+        if (indexBytes > fileSize - meshHeader.indexArrayOffset)
+        {
+            LogE << m_path << ": index data is out of range" << std::endl;
+            return {};
+        }
 
-            std::uint32_t vertStride = 0;
-            for (auto i = 0u; i < Mesh::Attribute::Total; ++i)
+        std::uint32_t vertStride = 0;
+        for (auto i = 0u; i < Mesh::Attribute::Total; ++i)
+        {
+            if (meshHeader.flags & (1 << i))
             {
-                if (meshHeader.flags & (1 << i))
+                switch (i)
                 {
-                    switch (i)
-                    {
-                    default:
-                    case Mesh::Attribute::Bitangent:
-                        break;
-                    case Mesh::Attribute::Position:
-                        vertStride += 3;
-                        meshData.attributes[i] = 3;
-                        break;
-                    case Mesh::Attribute::Colour:
-                        vertStride += 4;
-                        meshData.attributes[i] = 4;
-                        break;
-                    case Mesh::Attribute::Normal:
-                        vertStride += 3;
-                        meshData.attributes[i] = 3;
-                        break;
-                    case Mesh::Attribute::Tangent:
-                        meshData.attributes[i] = 3;
-                        meshData.attributes[Mesh::Attribute::Bitangent] = 3;
-                        vertStride += 4; //we'll be decoding tangents
-                        break;
-                    case Mesh::Attribute::UV0:
-                    case Mesh::Attribute::UV1:
-                        vertStride += 2;
-                        meshData.attributes[i] = 2;
-                        break;
-                    case Mesh::Attribute::BlendIndices:
-                    case Mesh::Attribute::BlendWeights:
-                        vertStride += 4;
-                        meshData.attributes[i] = 4;
-                        break;
-                    }
+                default:
+                case Mesh::Attribute::Bitangent:
+                    break;
+                case Mesh::Attribute::Position:
+                    vertStride += 3;
+                    meshData.attributes[i] = 3;
+                    break;
+                case Mesh::Attribute::Colour:
+                    vertStride += 4;
+                    meshData.attributes[i] = 4;
+                    break;
+                case Mesh::Attribute::Normal:
+                    vertStride += 3;
+                    meshData.attributes[i] = 3;
+                    break;
+                case Mesh::Attribute::Tangent:
+                    meshData.attributes[i] = 3;
+                    meshData.attributes[Mesh::Attribute::Bitangent] = 3;
+                    vertStride += 4; //we'll be decoding tangents
+                    break;
+                case Mesh::Attribute::UV0:
+                case Mesh::Attribute::UV1:
+                    vertStride += 2;
+                    meshData.attributes[i] = 2;
+                    break;
+                case Mesh::Attribute::BlendIndices:
+                case Mesh::Attribute::BlendWeights:
+                    vertStride += 4;
+                    meshData.attributes[i] = 4;
+                    break;
                 }
             }
+        }
 
-            auto pos = SDL_RWtell(file.file);
-            auto vertSize = meshHeader.indexArrayOffset - pos;
-            tempVerts.resize(vertSize / sizeof(float));
-            SDL_RWread(file.file, tempVerts.data(), vertSize, 1);
-            CRO_ASSERT(tempVerts.size() % vertStride == 0, "");
-            
-            for (auto i = 0u; i < meshHeader.indexArrayCount; ++i)
-            {
-                indexData[i].resize(sizes[i]);
-                SDL_RWread(file.file, indexData[i].data(), sizes[i] * sizeof(std::uint32_t), 1);
-            }
+        const auto vertBytes = meshHeader.indexArrayOffset - vertOffset;
+        if (vertBytes % (vertStride * sizeof(float)) != 0)
+        {
+            LogE << m_path << ": vertex data size doesn't match vertex attributes" << std::endl;
+            return {};
+        }
 
-            //process vertex data
-            std::vector<float> vertData;
-            for (auto i = 0u; i < tempVerts.size(); i += vertStride)
+        meshData.attributeFlags = meshHeader.flags;
+        meshData.primitiveType = GL_TRIANGLES;
+        meshData.vertexSize = getVertexSize(meshData.attributes);
+        meshData.vertexCount = vertBytes / (vertStride * sizeof(float));
+
+        const auto outStride = meshData.vertexSize / sizeof(float);
+        const auto* vertSrc = fileData + vertOffset;
+
+        //if the layout in the file matches the vertex layout and is
+        //correctly aligned upload straight from the mapped file, else
+        //the tangents need decoding into a single processed copy
+        std::vector<float> vertData;
+        const float* vertices = nullptr;
+        if (outStride == vertStride
+            && (reinterpret_cast<std::uintptr_t>(vertSrc) % alignof(float)) == 0)
+        {
+            vertices = reinterpret_cast<const float*>(vertSrc);
+        }
+        else
+        {
+            vertData.reserve(meshData.vertexCount * outStride);
+
+            std::vector<float> tempVert(vertStride);
+            for (auto v = 0u; v < meshData.vertexCount; ++v)
             {
+                std::memcpy(tempVert.data(), vertSrc + (v * vertStride * sizeof(float)), vertStride * sizeof(float));
+
                 std::uint32_t offset = 0;
                 glm::vec3 normal = glm::vec3(0.f);
                 for (auto j = 0u; j < Mesh::Attribute::Total; ++j)
@@ -175,30 +289,21 @@ Mesh::Data BinaryMeshBuilder::build() const
                         case Mesh::Attribute::Bitangent:
                             break;
                         case Mesh::Attribute::Position:
-                            vertData.push_back(tempVerts[i + offset]);
-                            vertData.push_back(tempVerts[i + offset + 1]);
-                            vertData.push_back(tempVerts[i + offset + 2]);
-
+                            vertData.insert(vertData.end(), tempVert.begin() + offset, tempVert.begin() + offset + 3);
                             offset += 3;
                             break;
                         case Mesh::Attribute::Colour:
-                            vertData.push_back(tempVerts[i + offset]);
-                            vertData.push_back(tempVerts[i + offset + 1]);
-                            vertData.push_back(tempVerts[i + offset + 2]);
-                            vertData.push_back(tempVerts[i + offset + 3]);
-
+                            vertData.insert(vertData.end(), tempVert.begin() + offset, tempVert.begin() + offset + 4);
                             offset += 4;
                             break;
                         case Mesh::Attribute::Normal:
-                            vertData.push_back(tempVerts[i + offset]);
-                            vertData.push_back(tempVerts[i + offset + 1]);
-                            vertData.push_back(tempVerts[i + offset + 2]);
+                            vertData.insert(vertData.end(), tempVert.begin() + offset, tempVert.begin() + offset + 3);
 
                             normal =
                             {
-                                tempVerts[i + offset],
-                                tempVerts[i + offset + 1],
-                                tempVerts[i + offset + 2],
+                                tempVert[offset],
+                                tempVert[offset + 1],
+                                tempVert[offset + 2],
                             };
 
                             offset += 3;
@@ -207,12 +312,12 @@ Mesh::Data BinaryMeshBuilder::build() const
                         {
                             glm::vec3 tan =
                             {
-                                (tempVerts[i + offset]),
-                                (tempVerts[i + offset + 1]),
-                                (tempVerts[i + offset + 2])
+                                (tempVert[offset]),
+                                (tempVert[offset + 1]),
+                                (tempVert[offset + 2])
                             };
 
-                            auto sign = (tempVerts[i + offset + 3]);
+                            auto sign = (tempVert[offset + 3]);
                             CRO_ASSERT(glm::length2(normal) != 0, "");
 
                             auto bitan = glm::cross(normal, tan) * sign;
@@ -220,7 +325,7 @@ Mesh::Data BinaryMeshBuilder::build() const
                             vertData.push_back(tan.x);
                             vertData.push_back(tan.y);
                             vertData.push_back(tan.z);
-                            
+
                             vertData.push_back(bitan.x);
                             vertData.push_back(bitan.y);
                             vertData.push_back(bitan.z);
@@ -229,163 +334,139 @@ Mesh::Data BinaryMeshBuilder::build() const
                             break;
                         case Mesh::Attribute::UV0:
                         case Mesh::Attribute::UV1:
-                            vertData.push_back(tempVerts[i + offset]);
-                            vertData.push_back(tempVerts[i + offset + 1]);
-
+                            vertData.insert(vertData.end(), tempVert.begin() + offset, tempVert.begin() + offset + 2);
                             offset += 2;
                             break;
                         case Mesh::Attribute::BlendIndices:
                         case Mesh::Attribute::BlendWeights:
-                            vertData.push_back(tempVerts[i + offset]);
-                            vertData.push_back(tempVerts[i + offset + 1]);
-                            vertData.push_back(tempVerts[i + offset + 2]);
-                            vertData.push_back(tempVerts[i + offset + 3]);
-
+                            vertData.insert(vertData.end(), tempVert.begin() + offset, tempVert.begin() + offset + 4);
                             offset += 4;
                             break;
                         }
                     }
                 }
             }
+            vertices = vertData.data();
+        }
 
-            meshData.attributeFlags = meshHeader.flags;
-            meshData.primitiveType = GL_TRIANGLES;
-            meshData.vertexSize = getVertexSize(meshData.attributes);
-            meshData.vertexCount = vertData.size() / (meshData.vertexSize / sizeof(float));
-            createVBO(meshData, vertData);
-
-            meshData.submeshCount = meshHeader.indexArrayCount;
-            for (auto i = 0u; i < meshData.submeshCount; ++i)
-            {
-                meshData.indexData[i].format = GL_UNSIGNED_INT;
-                meshData.indexData[i].primitiveType = meshData.primitiveType;
-                meshData.indexData[i].indexCount = static_cast<std::uint32_t>(indexData[i].size());
-
-                createIBO(meshData, indexData[i].data(), i, sizeof(std::uint32_t));
-            }
+        createVBO(meshData, vertices);
 
-            //boundingbox / sphere
-            meshData.boundingBox[0] = glm::vec3(std::numeric_limits<float>::max());
-            meshData.boundingBox[1] = glm::vec3(std::numeric_limits<float>::lowest());
-            for (std::size_t i = 0; i < vertData.size(); i += (meshData.vertexSize / sizeof(float)))
-            {
-                //min point
-                if (meshData.boundingBox[0].x > vertData[i])
-                {
-                    meshData.boundingBox[0].x = vertData[i];
-                }
-                if (meshData.boundingBox[0].y > vertData[i + 1])
-                {
-                    meshData.boundingBox[0].y = vertData[i + 1];
-                }
-                if (meshData.boundingBox[0].z > vertData[i + 2])
-                {
-                    meshData.boundingBox[0].z = vertData[i + 2];
-                }
+        //index arrays are always uploaded directly from the file
+        meshData.submeshCount = meshHeader.indexArrayCount;
+        std::size_t indexOffset = meshHeader.indexArrayOffset;
+        for (auto i = 0u; i < meshData.submeshCount; ++i)
+        {
+            meshData.indexData[i].format = GL_UNSIGNED_INT;
+            meshData.indexData[i].primitiveType = meshData.primitiveType;
+            meshData.indexData[i].indexCount = sizes[i];
 
-                //maxpoint
-                if (meshData.boundingBox[1].x < vertData[i])
-                {
-                    meshData.boundingBox[1].x = vertData[i];
-                }
-                if (meshData.boundingBox[1].y < vertData[i + 1])
-                {
-                    meshData.boundingBox[1].y = vertData[i + 1];
-                }
-                if (meshData.boundingBox[1].z < vertData[i + 2])
-                {
-                    meshData.boundingBox[1].z = vertData[i + 2];
-                }
-            }
-            auto rad = (meshData.boundingBox[1] - meshData.boundingBox[0]) / 2.f;
-            meshData.boundingSphere.centre = meshData.boundingBox[0] + rad;
-            meshData.boundingSphere.radius = glm::length(rad);
+            createIBO(meshData, fileData + indexOffset, i, sizeof(std::uint32_t));
+            indexOffset += sizes[i] * sizeof(std::uint32_t);
         }
 
-        m_skeleton = {};
-        if (header.skeletonOffset)
+        //boundingbox / sphere
+        meshData.boundingBox[0] = glm::vec3(std::numeric_limits<float>::max());
+        meshData.boundingBox[1] = glm::vec3(std::numeric_limits<float>::lowest());
+        for (std::size_t i = 0; i < meshData.vertexCount * outStride; i += outStride)
         {
-            if (header.version < 2)
-            {
-                LogW << m_path <<  "\nSkeletal animation requires version 2 or greater. Please re-export the model" << std::endl;
-            }
+            const glm::vec3 position(vertices[i], vertices[i + 1], vertices[i + 2]);
+            meshData.boundingBox[0] = glm::min(meshData.boundingBox[0], position);
+            meshData.boundingBox[1] = glm::max(meshData.boundingBox[1], position);
+        }
+        auto rad = (meshData.boundingBox[1] - meshData.boundingBox[0]) / 2.f;
+        meshData.boundingSphere.centre = meshData.boundingBox[0] + rad;
+        meshData.boundingSphere.radius = glm::length(rad);
+    }
 
-            else if (SDL_RWseek(file.file, header.skeletonOffset, RW_SEEK_SET) > -1)
-            {
-                Detail::ModelBinary::SkeletonHeaderV2 skelHeader;
-                SDL_RWread(file.file, &skelHeader, sizeof(skelHeader), 1);
-                m_skeleton.setRootTransform(glm::make_mat4(skelHeader.rootTransform));
+    m_skeleton = {};
+    if (header.skeletonOffset)
+    {
+        Detail::ModelBinary::SkeletonHeaderV2 skelHeader;
 
-                std::vector<Joint> inFrames(skelHeader.frameCount * skelHeader.frameSize);
-                std::vector<Detail::ModelBinary::SerialAnimation> inAnims(skelHeader.animationCount);
-                std::vector<Detail::ModelBinary::SerialNotification> inNotifications(skelHeader.notificationCount);
-                std::vector<Detail::ModelBinary::SerialAttachment> inAttachments(skelHeader.attachmentCount);
-                std::vector<float> inverseBindPose(skelHeader.frameSize * 16);
+        if (header.version < 2)
+        {
+            LogW << m_path <<  "\nSkeletal animation requires version 2 or greater. Please re-export the model" << std::endl;
+        }
 
-                SDL_RWread(file.file, inFrames.data(), sizeof(Joint), inFrames.size());
-                SDL_RWread(file.file, inAnims.data(), sizeof(Detail::ModelBinary::SerialAnimation), inAnims.size());
-                SDL_RWread(file.file, inNotifications.data(), sizeof(Detail::ModelBinary::SerialNotification), inNotifications.size());
-                SDL_RWread(file.file, inAttachments.data(), sizeof(Detail::ModelBinary::SerialAttachment), inAttachments.size());
-                SDL_RWread(file.file, inverseBindPose.data(), sizeof(float), inverseBindPose.size());
+        else if (std::size_t(header.skeletonOffset) + sizeof(skelHeader) <= fileSize)
+        {
+            std::memcpy(&skelHeader, fileData + header.skeletonOffset, sizeof(skelHeader));
+            m_skeleton.setRootTransform(glm::make_mat4(skelHeader.rootTransform));
 
+            const std::size_t frameBytes = skelHeader.frameCount * skelHeader.frameSize * sizeof(Joint);
+            const std::size_t animBytes = skelHeader.animationCount * sizeof(Detail::ModelBinary::SerialAnimation);
+            const std::size_t notificationBytes = skelHeader.notificationCount * sizeof(Detail::ModelBinary::SerialNotification);
+            const std::size_t attachmentBytes = skelHeader.attachmentCount * sizeof(Detail::ModelBinary::SerialAttachment);
+            const std::size_t bindPoseBytes = skelHeader.frameSize * sizeof(glm::mat4);
 
-                CRO_ASSERT(inFrames.size() % skelHeader.frameSize == 0, "");
-                for (auto i = 0u; i < skelHeader.frameCount; ++i)
-                {
-                    std::vector<Joint> frame;
-                    for (auto j = i * skelHeader.frameSize; j < (i * skelHeader.frameSize) + skelHeader.frameSize; ++j)
-                    {
-                        frame.push_back(inFrames[j]);
-                    }
+            std::size_t readPos = header.skeletonOffset + sizeof(skelHeader);
+            if (readPos + frameBytes + animBytes + notificationBytes + attachmentBytes + bindPoseBytes > fileSize)
+            {
+                LogE << m_path << ": skeleton data is out of range" << std::endl;
+                return meshData;
+            }
 
-                    m_skeleton.addFrame(frame);
-                }
+            //read each array straight from the file
+            std::vector<Joint> frame(skelHeader.frameSize);
+            for (auto i = 0u; i < skelHeader.frameCount; ++i)
+            {
+                std::memcpy(frame.data(), fileData + readPos, skelHeader.frameSize * sizeof(Joint));
+                readPos += skelHeader.frameSize * sizeof(Joint);
 
-                for (const auto& inAnim : inAnims)
-                {
-                    SkeletalAnim anim;
-                    anim.frameCount = inAnim.frameCount;
-                    anim.frameRate = inAnim.frameRate;
-                    anim.startFrame = inAnim.startFrame;
-                    anim.name = inAnim.name;
-                    anim.looped = inAnim.looped != 0;
-
-                    m_skeleton.addAnimation(anim);
-                }
+                m_skeleton.addFrame(frame);
+            }
 
-                for (auto [frameID, jointID, userID, name] : inNotifications)
-                {
-                    m_skeleton.addNotification(frameID, { jointID, userID, name });
-                }
+            for (auto i = 0u; i < skelHeader.animationCount; ++i)
+            {
+                Detail::ModelBinary::SerialAnimation inAnim;
+                std::memcpy(&inAnim, fileData + readPos, sizeof(inAnim));
+                readPos += sizeof(inAnim);
+
+                SkeletalAnim anim;
+                anim.frameCount = inAnim.frameCount;
+                anim.frameRate = inAnim.frameRate;
+                anim.startFrame = inAnim.startFrame;
+                anim.name = inAnim.name;
+                anim.looped = inAnim.looped != 0;
+
+                m_skeleton.addAnimation(anim);
+            }
 
-                for (const auto& [rotation, translation, scale, parent, name] : inAttachments)
-                {
-                    Attachment ap;
-                    ap.setParent(parent);
-                    ap.setPosition(translation);
-                    ap.setRotation(rotation);
-                    ap.setScale(scale);
-                    ap.setName(name);
-
-                    m_skeleton.addAttachment(ap);
-                }
+            for (auto i = 0u; i < skelHeader.notificationCount; ++i)
+            {
+                Detail::ModelBinary::SerialNotification inNotification;
+                std::memcpy(&inNotification, fileData + readPos, sizeof(inNotification));
+                readPos += sizeof(inNotification);
 
-                std::vector<glm::mat4> invBindMatrices(skelHeader.frameSize);
-                for (auto i = 0u; i < inverseBindPose.size(); i += 16)
-                {
-                    std::memcpy(&invBindMatrices[i / 16][0][0], inverseBindPose.data() + i, sizeof(glm::mat4));
-                }
-                m_skeleton.setInverseBindPose(invBindMatrices);
+                auto [frameID, jointID, userID, name] = inNotification;
+                m_skeleton.addNotification(frameID, { jointID, userID, name });
             }
-            else
+
+            for (auto i = 0u; i < skelHeader.attachmentCount; ++i)
             {
-                LogE << "Failed to seek to skeleton offset, incorrect value provided" << std::endl;
+                Detail::ModelBinary::SerialAttachment inAttachment;
+                std::memcpy(&inAttachment, fileData + readPos, sizeof(inAttachment));
+                readPos += sizeof(inAttachment);
+
+                const auto& [rotation, translation, scale, parent, name] = inAttachment;
+                Attachment ap;
+                ap.setParent(parent);
+                ap.setPosition(translation);
+                ap.setRotation(rotation);
+                ap.setScale(scale);
+                ap.setName(name);
+
+                m_skeleton.addAttachment(ap);
             }
+
+            std::vector<glm::mat4> invBindMatrices(skelHeader.frameSize);
+            std::memcpy(invBindMatrices.data(), fileData + readPos, bindPoseBytes);
+            m_skeleton.setInverseBindPose(invBindMatrices);
+        }
+        else
+        {
+            LogE << "Failed to seek to skeleton offset, incorrect value provided" << std::endl;
         }
-    }
-    else
-    {
-        LogE << m_path << ": " << SDL_GetError() << std::endl;
     }
 
     return meshData;
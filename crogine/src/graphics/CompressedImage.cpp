@@ -0,0 +1,551 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include <crogine/graphics/CompressedImage.hpp>
+#include <crogine/core/FileSystem.hpp>
+#include <crogine/core/Log.hpp>
+#include <crogine/detail/Types.hpp>
+
+#include <SDL_rwops.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+using namespace cro;
+
+namespace
+{
+    template <typename T>
+    T readValue(const std::uint8_t* data, std::size_t offset)
+    {
+        T retVal = 0;
+        std::memcpy(&retVal, data + offset, sizeof(T));
+        return retVal;
+    }
+
+    constexpr std::uint32_t makeFourCC(char a, char b, char c, char d)
+    {
+        return static_cast<std::uint32_t>(a)
+            | (static_cast<std::uint32_t>(b) << 8)
+            | (static_cast<std::uint32_t>(c) << 16)
+            | (static_cast<std::uint32_t>(d) << 24);
+    }
+
+    namespace DDS
+    {
+        constexpr std::uint32_t Magic = makeFourCC('D', 'D', 'S', ' ');
+        constexpr std::uint32_t DX10 = makeFourCC('D', 'X', '1', '0');
+        constexpr std::size_t HeaderSize = 128; //includes magic
+        constexpr std::size_t DX10HeaderSize = 20;
+
+        constexpr std::size_t HeightOffset = 12;
+        constexpr std::size_t WidthOffset = 16;
+        constexpr std::size_t MipCountOffset = 28;
+        constexpr std::size_t PixelFlagsOffset = 80;
+        constexpr std::size_t FourCCOffset = 84;
+        constexpr std::size_t Caps2Offset = 112;
+        constexpr std::size_t DXGIOffset = 128;
+        constexpr std::size_t MiscFlagOffset = 136;
+
+        constexpr std::uint32_t FlagFourCC = 0x4;
+        constexpr std::uint32_t FlagAlphaPixels = 0x1;
+        constexpr std::uint32_t Caps2Cubemap = 0x200;
+        constexpr std::uint32_t Caps2AllFaces = 0xFC00;
+        constexpr std::uint32_t MiscTextureCube = 0x4;
+
+        CompressedFormat::Type fromFourCC(std::uint32_t fourCC, bool alpha)
+        {
+            switch (fourCC)
+            {
+            default: return CompressedFormat::None;
+            case makeFourCC('D', 'X', 'T', '1'): return alpha ? CompressedFormat::BC1A : CompressedFormat::BC1;
+            case makeFourCC('D', 'X', 'T', '2'):
+            case makeFourCC('D', 'X', 'T', '3'): return CompressedFormat::BC2;
+            case makeFourCC('D', 'X', 'T', '4'):
+            case makeFourCC('D', 'X', 'T', '5'): return CompressedFormat::BC3;
+            case makeFourCC('A', 'T', 'I', '1'):
+            case makeFourCC('B', 'C', '4', 'U'): return CompressedFormat::BC4;
+            case makeFourCC('A', 'T', 'I', '2'):
+            case makeFourCC('B', 'C', '5', 'U'): return CompressedFormat::BC5;
+            }
+        }
+
+        CompressedFormat::Type fromDXGI(std::uint32_t format)
+        {
+            switch (format)
+            {
+            default: return CompressedFormat::None;
+            case 71:
+            case 72: return CompressedFormat::BC1A;
+            case 74:
+            case 75: return CompressedFormat::BC2;
+            case 77:
+            case 78: return CompressedFormat::BC3;
+            case 80: return CompressedFormat::BC4;
+            case 83: return CompressedFormat::BC5;
+            case 95: return CompressedFormat::BC6H;
+            case 98:
+            case 99: return CompressedFormat::BC7;
+            }
+        }
+    }
+
+    namespace KTX2
+    {
+        constexpr std::array<std::uint8_t, 12u> Identifier =
+        {
+            0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+        };
+
+        constexpr std::size_t FormatOffset = 12;
+        constexpr std::size_t WidthOffset = 20;
+        constexpr std::size_t HeightOffset = 24;
+        constexpr std::size_t DepthOffset = 28;
+        constexpr std::size_t LayerCountOffset = 32;
+        constexpr std::size_t FaceCountOffset = 36;
+        constexpr std::size_t LevelCountOffset = 40;
+        constexpr std::size_t SuperCompressionOffset = 44;
+        constexpr std::size_t LevelIndexOffset = 80;
+        constexpr std::size_t LevelIndexStride = 24;
+
+        //sRGB variants are loaded as their UNORM equivalent
+        //signed formats are not supported
+        CompressedFormat::Type fromVkFormat(std::uint32_t format)
+        {
+            switch (format)
+            {
+            default: return CompressedFormat::None;
+            case 131:
+            case 132: return CompressedFormat::BC1;
+            case 133:
+            case 134: return CompressedFormat::BC1A;
+            case 135:
+            case 136: return CompressedFormat::BC2;
+            case 137:
+            case 138: return CompressedFormat::BC3;
+            case 139: return CompressedFormat::BC4;
+            case 141: return CompressedFormat::BC5;
+            case 143: return CompressedFormat::BC6H;
+            case 145:
+            case 146: return CompressedFormat::BC7;
+            case 147:
+            case 148: return CompressedFormat::ETC2_RGB;
+            case 149:
+            case 150: return CompressedFormat::ETC2_RGBA1;
+            case 151:
+            case 152: return CompressedFormat::ETC2_RGBA;
+            }
+        }
+    }
+
+    std::uint32_t maxLevelCount(glm::uvec2 size)
+    {
+        std::uint32_t count = 1;
+        auto dim = std::max(size.x, size.y);
+        while (dim > 1)
+        {
+            dim /= 2;
+            count++;
+        }
+        return count;
+    }
+
+    //header dimensions are untrusted, so cap them before
+    //they're used to calculate level sizes and offsets
+    constexpr std::uint32_t MaxDimension = 16384;
+    bool validDimensions(glm::uvec2 size)
+    {
+        return size.x != 0 && size.y != 0
+            && size.x <= MaxDimension && size.y <= MaxDimension;
+    }
+}
+
+CompressedImage::CompressedImage()
+    : m_format      (CompressedFormat::None),
+    m_size          (0),
+    m_levelCount    (0),
+    m_faceCount     (0)
+{
+
+}
+
+//public
+bool CompressedImage::loadFromFile(const std::string& filePath)
+{
+    auto path = FileSystem::getResourcePath() + filePath;
+
+    RaiiRWops file;
+    file.file = SDL_RWFromFile(path.c_str(), "rb");
+    if (!file.file)
+    {
+        Logger::log("Failed opening " + path, Logger::Type::Error);
+        return false;
+    }
+
+    auto size = SDL_RWsize(file.file);
+    if (size < 1)
+    {
+        LogE << path << ": file is empty" << std::endl;
+        return false;
+    }
+
+    std::vector<std::uint8_t> buffer(static_cast<std::size_t>(size));
+    if (SDL_RWread(file.file, buffer.data(), buffer.size(), 1) != 1)
+    {
+        LogE << path << ": failed reading file" << std::endl;
+        return false;
+    }
+
+    if (!loadFromMemory(buffer.data(), buffer.size()))
+    {
+        LogE << "Failed loading compressed image " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool CompressedImage::loadFromMemory(const std::uint8_t* data, std::size_t size)
+{
+    reset();
+
+    if (!data || size < KTX2::Identifier.size())
+    {
+        LogE << "Invalid compressed image data" << std::endl;
+        return false;
+    }
+
+    bool result = false;
+    if (std::memcmp(data, KTX2::Identifier.data(), KTX2::Identifier.size()) == 0)
+    {
+        result = parseKTX2(data, size);
+    }
+    else if (readValue<std::uint32_t>(data, 0) == DDS::Magic)
+    {
+        result = parseDDS(data, size);
+    }
+    else
+    {
+        LogE << "Compressed image data is not DDS or KTX2" << std::endl;
+    }
+
+    if (result)
+    {
+        result = validate(size);
+    }
+
+    if (result)
+    {
+        m_data.assign(data, data + size);
+    }
+    else
+    {
+        reset();
+    }
+    return result;
+}
+
+bool CompressedImage::hasAlpha() const
+{
+    switch (m_format)
+    {
+    default: return false;
+    case CompressedFormat::BC1A:
+    case CompressedFormat::BC2:
+    case CompressedFormat::BC3:
+    case CompressedFormat::BC7:
+    case CompressedFormat::ETC2_RGBA1:
+    case CompressedFormat::ETC2_RGBA:
+        return true;
+    }
+}
+
+const std::uint8_t* CompressedImage::getLevelData(std::uint32_t level, std::uint32_t face) const
+{
+    if (level >= m_levelCount || face >= m_faceCount)
+    {
+        return nullptr;
+    }
+    return m_data.data() + m_offsets[level * m_faceCount + face];
+}
+
+std::size_t CompressedImage::getLevelByteSize(std::uint32_t level) const
+{
+    if (level >= m_levelCount)
+    {
+        return 0;
+    }
+    auto size = getLevelSize(level);
+    return calcByteSize(m_format, size.x, size.y);
+}
+
+glm::uvec2 CompressedImage::getLevelSize(std::uint32_t level) const
+{
+    return { std::max(1u, m_size.x >> level), std::max(1u, m_size.y >> level) };
+}
+
+std::size_t CompressedImage::getBlockByteSize(CompressedFormat::Type format)
+{
+    switch (format)
+    {
+    default: return 0;
+    case CompressedFormat::BC1:
+    case CompressedFormat::BC1A:
+    case CompressedFormat::BC4:
+    case CompressedFormat::ETC2_RGB:
+    case CompressedFormat::ETC2_RGBA1:
+        return 8;
+    case CompressedFormat::BC2:
+    case CompressedFormat::BC3:
+    case CompressedFormat::BC5:
+    case CompressedFormat::BC6H:
+    case CompressedFormat::BC7:
+    case CompressedFormat::ETC2_RGBA:
+        return 16;
+    }
+}
+
+std::size_t CompressedImage::calcByteSize(CompressedFormat::Type format, std::uint32_t width, std::uint32_t height)
+{
+    std::size_t blocksX = (static_cast<std::size_t>(width) + 3) / 4;
+    std::size_t blocksY = (static_cast<std::size_t>(height) + 3) / 4;
+    return blocksX * blocksY * getBlockByteSize(format);
+}
+
+//private
+bool CompressedImage::parseDDS(const std::uint8_t* data, std::size_t size)
+{
+    if (size < DDS::HeaderSize)
+    {
+        LogE << "DDS file too small" << std::endl;
+        return false;
+    }
+
+    m_size.x = readValue<std::uint32_t>(data, DDS::WidthOffset);
+    m_size.y = readValue<std::uint32_t>(data, DDS::HeightOffset);
+    m_levelCount = std::max(1u, readValue<std::uint32_t>(data, DDS::MipCountOffset));
+
+    if (!validDimensions(m_size))
+    {
+        LogE << "Invalid DDS dimensions " << m_size.x << "x" << m_size.y << std::endl;
+        return false;
+    }
+
+    auto pixelFlags = readValue<std::uint32_t>(data, DDS::PixelFlagsOffset);
+    if ((pixelFlags & DDS::FlagFourCC) == 0)
+    {
+        LogE << "Uncompressed DDS files are not supported" << std::endl;
+        return false;
+    }
+
+    std::size_t dataOffset = DDS::HeaderSize;
+    auto fourCC = readValue<std::uint32_t>(data, DDS::FourCCOffset);
+    auto caps2 = readValue<std::uint32_t>(data, DDS::Caps2Offset);
+    bool cubemap = false;
+
+    if (fourCC == DDS::DX10)
+    {
+        if (size < DDS::HeaderSize + DDS::DX10HeaderSize)
+        {
+            LogE << "DDS file too small for DX10 header" << std::endl;
+            return false;
+        }
+        dataOffset += DDS::DX10HeaderSize;
+
+        m_format = DDS::fromDXGI(readValue<std::uint32_t>(data, DDS::DXGIOffset));
+        cubemap = (readValue<std::uint32_t>(data, DDS::MiscFlagOffset) & DDS::MiscTextureCube) != 0;
+    }
+    else
+    {
+        m_format = DDS::fromFourCC(fourCC, (pixelFlags & DDS::FlagAlphaPixels) != 0);
+        if (caps2 & DDS::Caps2Cubemap)
+        {
+            if ((caps2 & DDS::Caps2AllFaces) != DDS::Caps2AllFaces)
+            {
+                LogE << "Partial DDS cubemaps are not supported" << std::endl;
+                return false;
+            }
+            cubemap = true;
+        }
+    }
+
+    if (m_format == CompressedFormat::None)
+    {
+        LogE << "Unsupported DDS pixel format" << std::endl;
+        return false;
+    }
+
+    m_faceCount = cubemap ? 6 : 1;
+
+    if (m_levelCount > maxLevelCount(m_size))
+    {
+        LogE << "Invalid DDS mip count " << m_levelCount << std::endl;
+        return false;
+    }
+
+    //DDS stores each face's complete mip chain in turn
+    m_offsets.resize(m_levelCount * m_faceCount);
+    for (auto face = 0u; face < m_faceCount; ++face)
+    {
+        for (auto level = 0u; level < m_levelCount; ++level)
+        {
+            m_offsets[level * m_faceCount + face] = dataOffset;
+            auto levelSize = getLevelSize(level);
+            dataOffset += calcByteSize(m_format, levelSize.x, levelSize.y);
+        }
+    }
+
+    return true;
+}
+
+bool CompressedImage::parseKTX2(const std::uint8_t* data, std::size_t size)
+{
+    if (size < KTX2::LevelIndexOffset)
+    {
+        LogE << "KTX2 file too small" << std::endl;
+        return false;
+    }
+
+    m_format = KTX2::fromVkFormat(readValue<std::uint32_t>(data, KTX2::FormatOffset));
+    if (m_format == CompressedFormat::None)
+    {
+        LogE << "Unsupported KTX2 vkFormat " << readValue<std::uint32_t>(data, KTX2::FormatOffset) << std::endl;
+        return false;
+    }
+
+    if (readValue<std::uint32_t>(data, KTX2::SuperCompressionOffset) != 0)
+    {
+        LogE << "Supercompressed KTX2 files are not supported" << std::endl;
+        return false;
+    }
+
+    if (readValue<std::uint32_t>(data, KTX2::DepthOffset) > 1
+        || readValue<std::uint32_t>(data, KTX2::LayerCountOffset) > 1)
+    {
+        LogE << "KTX2 3D textures and texture arrays are not supported" << std::endl;
+        return false;
+    }
+
+    m_size.x = readValue<std::uint32_t>(data, KTX2::WidthOffset);
+    m_size.y = readValue<std::uint32_t>(data, KTX2::HeightOffset);
+    m_faceCount = readValue<std::uint32_t>(data, KTX2::FaceCountOffset);
+    m_levelCount = std::max(1u, readValue<std::uint32_t>(data, KTX2::LevelCountOffset));
+
+    if (!validDimensions(m_size))
+    {
+        LogE << "Invalid KTX2 dimensions " << m_size.x << "x" << m_size.y << std::endl;
+        return false;
+    }
+
+    if (m_faceCount != 1 && m_faceCount != 6)
+    {
+        LogE << "Invalid KTX2 face count " << m_faceCount << std::endl;
+        return false;
+    }
+
+    if (m_levelCount > maxLevelCount(m_size)
+        || size < KTX2::LevelIndexOffset + (m_levelCount * KTX2::LevelIndexStride))
+    {
+        LogE << "Invalid KTX2 level index" << std::endl;
+        return false;
+    }
+
+    //KTX2 stores all faces of a level together
+    m_offsets.resize(m_levelCount * m_faceCount);
+    for (auto level = 0u; level < m_levelCount; ++level)
+    {
+        auto indexOffset = KTX2::LevelIndexOffset + (level * KTX2::LevelIndexStride);
+        auto byteOffset = readValue<std::uint64_t>(data, indexOffset);
+        auto byteLength = readValue<std::uint64_t>(data, indexOffset + sizeof(std::uint64_t));
+
+        auto levelSize = getLevelSize(level);
+        auto faceSize = calcByteSize(m_format, levelSize.x, levelSize.y);
+        if (byteLength != faceSize * m_faceCount
+            || byteOffset > size)
+        {
+            LogE << "Invalid KTX2 data for level " << level << std::endl;
+            return false;
+        }
+
+        for (auto face = 0u; face < m_faceCount; ++face)
+        {
+            m_offsets[level * m_faceCount + face] = static_cast<std::size_t>(byteOffset) + (face * faceSize);
+        }
+    }
+
+    return true;
+}
+
+bool CompressedImage::validate(std::size_t dataSize) const
+{
+    if (m_size.x == 0 || m_size.y == 0)
+    {
+        LogE << "Compressed image has zero size" << std::endl;
+        return false;
+    }
+
+    if (m_faceCount == 6 && m_size.x != m_size.y)
+    {
+        LogE << "Cubemap faces must be square" << std::endl;
+        return false;
+    }
+
+    if (m_levelCount > maxLevelCount(m_size))
+    {
+        LogE << "Compressed image has " << m_levelCount << " levels, expected at most " << maxLevelCount(m_size) << std::endl;
+        return false;
+    }
+
+    for (auto level = 0u; level < m_levelCount; ++level)
+    {
+        auto levelBytes = getLevelByteSize(level);
+        for (auto face = 0u; face < m_faceCount; ++face)
+        {
+            auto offset = m_offsets[level * m_faceCount + face];
+            if (offset > dataSize
+                || levelBytes > dataSize - offset)
+            {
+                LogE << "Compressed image data for level " << level << ", face " << face << " is out of bounds" << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void CompressedImage::reset()
+{
+    m_format = CompressedFormat::None;
+    m_size = glm::uvec2(0);
+    m_levelCount = 0;
+    m_faceCount = 0;
+    m_data.clear();
+    m_offsets.clear();
+}
@@ -0,0 +1,185 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include "CompressedUpload.hpp"
+#include "../detail/GLCheck.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+//not all of these are defined by our GL loader
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RED_RGTC1
+#define GL_COMPRESSED_RED_RGTC1 0x8DBB
+#endif
+#ifndef GL_COMPRESSED_RG_RGTC2
+#define GL_COMPRESSED_RG_RGTC2 0x8DBD
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+#ifndef GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT
+#define GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT 0x8E8F
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+#ifndef GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2
+#define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 0x9276
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+
+namespace
+{
+    bool hasExtension(const char* name)
+    {
+        GLint count = 0;
+        glCheck(glGetIntegerv(GL_NUM_EXTENSIONS, &count));
+        for (auto i = 0; i < count; ++i)
+        {
+            const auto* ext = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            if (ext && std::strcmp(ext, name) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<GLint> getSupportedFormats()
+    {
+        GLint count = 0;
+        glCheck(glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count));
+
+        std::vector<GLint> formats(count);
+        if (count)
+        {
+            glCheck(glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data()));
+        }
+
+        //drivers are only required to list 'general purpose' formats
+        //so also check for the extensions which provide the rest
+#ifdef PLATFORM_DESKTOP
+        if (hasExtension("GL_EXT_texture_compression_s3tc"))
+        {
+            formats.push_back(GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+            formats.push_back(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT);
+            formats.push_back(GL_COMPRESSED_RGBA_S3TC_DXT3_EXT);
+            formats.push_back(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+        }
+
+        //core in 3.0
+        formats.push_back(GL_COMPRESSED_RED_RGTC1);
+        formats.push_back(GL_COMPRESSED_RG_RGTC2);
+
+        if (hasExtension("GL_ARB_texture_compression_bptc"))
+        {
+            formats.push_back(GL_COMPRESSED_RGBA_BPTC_UNORM);
+            formats.push_back(GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT);
+        }
+
+        if (hasExtension("GL_ARB_ES3_compatibility"))
+        {
+            formats.push_back(GL_COMPRESSED_RGB8_ETC2);
+            formats.push_back(GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2);
+            formats.push_back(GL_COMPRESSED_RGBA8_ETC2_EAC);
+        }
+#else
+        //ETC2 is core in GLES3
+        formats.push_back(GL_COMPRESSED_RGB8_ETC2);
+        formats.push_back(GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2);
+        formats.push_back(GL_COMPRESSED_RGBA8_ETC2_EAC);
+#endif
+        return formats;
+    }
+}
+
+std::uint32_t cro::Detail::getGLCompressedFormat(CompressedFormat::Type format)
+{
+    switch (format)
+    {
+    default: return 0;
+    case CompressedFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    case CompressedFormat::BC1A: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    case CompressedFormat::BC2: return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+    case CompressedFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case CompressedFormat::BC4: return GL_COMPRESSED_RED_RGTC1;
+    case CompressedFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+    case CompressedFormat::BC6H: return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+    case CompressedFormat::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    case CompressedFormat::ETC2_RGB: return GL_COMPRESSED_RGB8_ETC2;
+    case CompressedFormat::ETC2_RGBA1: return GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2;
+    case CompressedFormat::ETC2_RGBA: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+    }
+}
+
+bool cro::Detail::isCompressedFormatSupported(CompressedFormat::Type format)
+{
+    //the context is created once by the App, so it's safe to cache this
+    static const std::vector<GLint> supportedFormats = getSupportedFormats();
+
+    auto glFormat = static_cast<GLint>(getGLCompressedFormat(format));
+    return glFormat != 0
+        && std::find(supportedFormats.begin(), supportedFormats.end(), glFormat) != supportedFormats.end();
+}
+
+bool cro::Detail::uploadCompressedImage(const CompressedImage& image, std::uint32_t target, std::uint32_t bindTarget, std::uint32_t face)
+{
+    if (!isCompressedFormatSupported(image.getFormat()))
+    {
+        LogE << "Compressed texture format is not supported by this device" << std::endl;
+        return false;
+    }
+
+    const auto glFormat = getGLCompressedFormat(image.getFormat());
+    for (auto level = 0u; level < image.getLevelCount(); ++level)
+    {
+        auto size = image.getLevelSize(level);
+        glCheck(glCompressedTexImage2D(target, level, glFormat, size.x, size.y, 0,
+            static_cast<GLsizei>(image.getLevelByteSize(level)), image.getLevelData(level, face)));
+    }
+    glCheck(glTexParameteri(bindTarget, GL_TEXTURE_MAX_LEVEL, image.getLevelCount() - 1));
+
+    return true;
+}
@@ -0,0 +1,63 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <crogine/graphics/CompressedImage.hpp>
+
+#include <cstdint>
+
+namespace cro::Detail
+{
+    /*!
+    \brief Returns the OpenGL internal format for the given compressed
+    format, or 0 if there is no equivalent.
+    */
+    std::uint32_t getGLCompressedFormat(CompressedFormat::Type);
+
+    /*!
+    \brief Returns true if the current context is able to sample
+    textures of the given compressed format. Requires a valid
+    OpenGL context.
+    */
+    bool isCompressedFormatSupported(CompressedFormat::Type);
+
+    /*!
+    \brief Uploads every level of the given face of a CompressedImage
+    to the currently bound texture target with glCompressedTexImage2D
+    and sets GL_TEXTURE_MAX_LEVEL accordingly.
+    \param target The target to upload to, eg GL_TEXTURE_2D or
+    GL_TEXTURE_CUBE_MAP_POSITIVE_X + face
+    \param bindTarget The target to which the texture is bound, eg
+    GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP
+    \returns false if the format is unsupported
+    */
+    bool uploadCompressedImage(const CompressedImage&, std::uint32_t target, std::uint32_t bindTarget, std::uint32_t face = 0);
+}
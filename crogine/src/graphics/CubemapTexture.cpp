@@ -29,9 +29,11 @@ source distribution.
 
 #include <crogine/graphics/CubemapTexture.hpp>
 #include <crogine/graphics/Image.hpp>
+#include <crogine/graphics/CompressedImage.hpp>
 #include <crogine/core/ConfigFile.hpp>
 
 #include "../detail/GLCheck.hpp"
+#include "CompressedUpload.hpp"
 
 using namespace cro;
 
@@ -71,9 +73,16 @@ std::uint32_t CubemapTexture::getGLHandle() const
 
 bool CubemapTexture::loadFromFile(const std::string& path)
 {
-    if (FileSystem::getFileExtension(path) != ".ccm")
+    const auto ext = FileSystem::getFileExtension(path);
+    if (ext == ".dds" || ext == ".ktx2")
     {
-        LogE << path << ": not a *.ccm file" << std::endl;
+        CompressedImage image;
+        return image.loadFromFile(path) && loadFromImage(image);
+    }
+
+    if (ext != ".ccm")
+    {
+        LogE << path << ": not a *.ccm, *.dds or *.ktx2 file" << std::endl;
         return false;
     }
 
@@ -165,6 +174,45 @@ bool CubemapTexture::loadFromFile(const std::string& path)
         return true;
     }
 
+    LogE << "Failed creating texture handle" << std::endl;
+    return false;
+}
+
+bool CubemapTexture::loadFromImage(const CompressedImage& image)
+{
+    if (image.getFaceCount() != 6)
+    {
+        LogE << "Failed creating cubemap: compressed image does not contain 6 faces" << std::endl;
+        return false;
+    }
+
+    if (m_handle == 0)
+    {
+        glCheck(glGenTextures(1, &m_handle));
+    }
+
+    if (m_handle)
+    {
+        glCheck(glBindTexture(GL_TEXTURE_CUBE_MAP, m_handle));
+        for (auto i = 0u; i < 6u; ++i)
+        {
+            if (!Detail::uploadCompressedImage(image, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, GL_TEXTURE_CUBE_MAP, i))
+            {
+                glCheck(glBindTexture(GL_TEXTURE_CUBE_MAP, 0));
+                return false;
+            }
+        }
+
+        glCheck(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        glCheck(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, image.getLevelCount() > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+        glCheck(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+        glCheck(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+        glCheck(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE));
+        glCheck(glBindTexture(GL_TEXTURE_CUBE_MAP, 0));
+
+        return true;
+    }
+
     LogE << "Failed creating texture handle" << std::endl;
     return false;
 }
\ No newline at end of file
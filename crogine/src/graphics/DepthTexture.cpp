@@ -229,6 +229,32 @@ void DepthTexture::clear(std::uint32_t layer)
 #endif
 }
 
+void DepthTexture::clear(std::uint32_t layer, const DepthTexture& source, std::uint32_t sourceLayer)
+{
+#ifdef PLATFORM_DESKTOP
+    CRO_ASSERT(m_fboID, "No FBO created!");
+    CRO_ASSERT(m_layerCount > layer, "");
+    CRO_ASSERT(source.m_fboID, "Source has no FBO");
+    CRO_ASSERT(source.m_layerCount > sourceLayer, "");
+    CRO_ASSERT(source.m_size == m_size, "Source size doesn't match");
+
+    setActive(true);
+    glCheck(glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_textureID, 0, layer));
+    glCheck(glColorMask(false, false, false, false));
+
+    //setActive() bound our FBO to both read and draw, so
+    //temporarily read from the source and restore it after
+    glCheck(glBindFramebuffer(GL_READ_FRAMEBUFFER, source.m_fboID));
+    glCheck(glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, source.m_textureID, 0, sourceLayer));
+
+    const auto width = static_cast<GLint>(m_size.x);
+    const auto height = static_cast<GLint>(m_size.y);
+    glCheck(glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST));
+
+    glCheck(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_fboID));
+#endif
+}
+
 void DepthTexture::display()
 {
 #ifdef PLATFORM_DESKTOP
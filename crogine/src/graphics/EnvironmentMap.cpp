@@ -30,6 +30,7 @@ source distribution.
 #include "../detail/stb_image.h"
 #include "../detail/SDLImageRead.hpp"
 #include "../detail/GLCheck.hpp"
+#include "CompressedUpload.hpp"
 
 #include <crogine/core/FileSystem.hpp>
 #include <crogine/core/Log.hpp>
@@ -40,6 +41,7 @@ source distribution.
 #include <crogine/util/Constants.hpp>
 
 #include <crogine/graphics/EnvironmentMap.hpp>
+#include <crogine/graphics/CompressedImage.hpp>
 #include <crogine/graphics/Shader.hpp>
 
 #include <array>
@@ -137,6 +139,13 @@ bool EnvironmentMap::loadFromFile(const std::string& filePath)
     return false;
 #else
 
+    const auto ext = FileSystem::getFileExtension(filePath);
+    if (ext == ".dds" || ext == ".ktx2")
+    {
+        CompressedImage image;
+        return image.loadFromFile(filePath) && loadFromImage(image);
+    }
+
     auto path = FileSystem::getResourcePath() + filePath;
 
     if (!cro::FileSystem::fileExists(path))
@@ -263,13 +272,80 @@ bool EnvironmentMap::loadFromFile(const std::string& filePath)
     glCheck(glBindTexture(GL_TEXTURE_CUBE_MAP, m_textures[Skybox]));
     glCheck(glGenerateMipmap(GL_TEXTURE_CUBE_MAP));
 
+    return renderMaps(tempFBO.handle, tempRBO.handle);
+
+#endif //PLATFORM_MOBILE
+}
+
+bool EnvironmentMap::loadFromImage(const CompressedImage& image)
+{
+#ifdef PLATFORM_MOBILE
+    LogE << "Environment mapping is not available on mobile platforms. Use a cubemap instead." << std::endl;
+    return false;
+#else
+
+    if (image.getFaceCount() != 6)
+    {
+        LogE << "Failed creating environment map: compressed image does not contain 6 faces" << std::endl;
+        return false;
+    }
+
+    for (auto t : m_textures)
+    {
+        if (t == 0)
+        {
+            LogE << "Failed creating one or more textures" << std::endl;
+            return false;
+        }
+    }
+
+    //the skybox is used as-is, so the equirectangular
+    //projection pass and mip generation are skipped
+    glCheck(glBindTexture(GL_TEXTURE_CUBE_MAP, m_textures[Skybox]));
+    for (auto i = 0u; i < 6u; ++i)
+    {
+        if (!Detail::uploadCompressedImage(image, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, GL_TEXTURE_CUBE_MAP, i))
+        {
+            glCheck(glBindTexture(GL_TEXTURE_CUBE_MAP, 0));
+            return false;
+        }
+    }
+
+    glCheck(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    glCheck(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    glCheck(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE));
+    glCheck(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, image.getLevelCount() > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+    glCheck(glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+
+    TempFrameBuffer tempFBO;
+    TempRenderBuffer tempRBO;
+
+    glCheck(glGenFramebuffers(1, &tempFBO.handle));
+    glCheck(glGenRenderbuffers(1, &tempRBO.handle));
+
+    glCheck(glBindFramebuffer(GL_FRAMEBUFFER, tempFBO.handle));
+    glCheck(glBindRenderbuffer(GL_RENDERBUFFER, tempRBO.handle));
+    glCheck(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, CubemapSize, CubemapSize));
+    glCheck(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, tempRBO.handle));
+
+    createCube();
+
+    return renderMaps(tempFBO.handle, tempRBO.handle);
+
+#endif //PLATFORM_MOBILE
+}
+
+//private
+bool EnvironmentMap::renderMaps(std::uint32_t fbo, std::uint32_t rbo)
+{
+    cro::Shader shader;
     if (!shader.loadFromString(PBRCubeVertex, IrradianceFrag))
     {
         LogE << "Failed creating irradiance convolution shader" << std::endl;
         return false;
     }
 
-    renderIrradianceMap(tempFBO.handle, tempRBO.handle, shader);
+    renderIrradianceMap(fbo, rbo, shader);
 
 
     if (!shader.loadFromString(PBRCubeVertex, PrefilterFrag))
@@ -277,7 +353,7 @@ bool EnvironmentMap::loadFromFile(const std::string& filePath)
         LogE << "Failed creating prefilter convolution shader" << std::endl;
         return false;
     }
-    renderPrefilterMap(tempFBO.handle, tempRBO.handle, shader);
+    renderPrefilterMap(fbo, rbo, shader);
 
 
     if (!shader.loadFromString(BRDFVert, BRDFFrag))
@@ -285,7 +361,7 @@ bool EnvironmentMap::loadFromFile(const std::string& filePath)
         LogE << "Failed creating BRDF shader" << std::endl;
         return false;
     }
-    renderBRDFMap(tempFBO.handle, tempRBO.handle, shader);
+    renderBRDFMap(fbo, rbo, shader);
 
     //make sure everything is put back neat :)
     glCheck(glBindVertexArray(0));
@@ -294,8 +370,6 @@ bool EnvironmentMap::loadFromFile(const std::string& filePath)
 
     deleteCube();
     return true;
-
-#endif //PLATFORM_MOBILE
 }
 
 void EnvironmentMap::renderIrradianceMap(std::uint32_t fbo, std::uint32_t rbo, Shader& shader)
@@ -97,7 +97,7 @@ bool Image::loadFromFile(const std::string& filePath)
         return false;
     }
 
-    stbi_set_flip_vertically_on_load(m_flipOnLoad ? 1 : 0);
+    stbi_set_flip_vertically_on_load_thread(m_flipOnLoad ? 1 : 0);
 
     STBIMG_stbio_RWops io;
     stbi_callback_from_RW(file, &io);
@@ -126,7 +126,7 @@ bool Image::loadFromFile(const std::string& filePath)
         stbi_image_free(img);
         SDL_RWclose(file);
 
-        stbi_set_flip_vertically_on_load(0);
+        stbi_set_flip_vertically_on_load_thread(0);
 
         return result;
     }
@@ -135,7 +135,7 @@ bool Image::loadFromFile(const std::string& filePath)
         Logger::log("failed to open image: " + path, Logger::Type::Error);
         SDL_RWclose(file);
 
-        stbi_set_flip_vertically_on_load(0);
+        stbi_set_flip_vertically_on_load_thread(0);
 
         return false;
     }
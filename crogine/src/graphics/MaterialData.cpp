@@ -336,6 +336,21 @@ void Data::setShader(const Shader& s)
             uniforms[Material::SkyBox] = handle;
             optionalUniforms[optionalUniformCount++] = Material::SkyBox;
         }
+        else if (uniform == "u_lightClusters")
+        {
+            uniforms[Material::LightClusterSampler] = handle;
+            optionalUniforms[optionalUniformCount++] = Material::LightClusterSampler;
+        }
+        else if (uniform == "u_lightClusterParams")
+        {
+            uniforms[Material::LightClusterParams] = handle;
+            optionalUniforms[optionalUniformCount++] = Material::LightClusterParams;
+        }
+        else if (uniform == "u_lightClusterMatrices[0]")
+        {
+            uniforms[Material::LightClusterMatrices] = handle;
+            optionalUniforms[optionalUniformCount++] = Material::LightClusterMatrices;
+        }
         //else these are user settable uniforms - ie optional, but set by user such as textures
         else
         {
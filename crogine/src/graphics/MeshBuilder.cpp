@@ -49,10 +49,15 @@ std::size_t MeshBuilder::getVertexSize(const std::array<std::size_t, Mesh::Attri
 }
 
 void MeshBuilder::createVBO(Mesh::Data& meshData, const std::vector<float>& vertexData)
+{
+    createVBO(meshData, vertexData.data());
+}
+
+void MeshBuilder::createVBO(Mesh::Data& meshData, const float* vertexData)
 {
     glCheck(glGenBuffers(1, &meshData.vbo));
     glCheck(glBindBuffer(GL_ARRAY_BUFFER, meshData.vbo));
-    glCheck(glBufferData(GL_ARRAY_BUFFER, meshData.vertexSize * meshData.vertexCount, vertexData.data(), GL_STATIC_DRAW));
+    glCheck(glBufferData(GL_ARRAY_BUFFER, meshData.vertexSize * meshData.vertexCount, vertexData, GL_STATIC_DRAW));
     glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
 }
 
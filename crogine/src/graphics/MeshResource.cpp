@@ -73,6 +73,19 @@ bool MeshResource::loadMesh(std::size_t ID, const MeshBuilder& mb)
             m_skeletalData.insert(std::make_pair(ID, skeleton));
         }
 
+        std::size_t byteSize = meshData.vertexCount * meshData.vertexSize;
+        for (auto i = 0u; i < meshData.submeshCount; ++i)
+        {
+            const auto& indexData = meshData.indexData[i];
+            byteSize += indexData.indexCount * (indexData.format == GL_UNSIGNED_SHORT ? sizeof(std::uint16_t) : sizeof(std::uint32_t));
+        }
+        m_tracker.add(ID, byteSize);
+
+        //never evict the mesh we just loaded
+        m_tracker.acquire(ID);
+        evict();
+        m_tracker.release(ID);
+
         return true;
     }
     LOG("Invalid mesh data was returned from MeshBuilder", Logger::Type::Error);
@@ -94,6 +107,7 @@ std::size_t MeshResource::loadMesh(const MeshBuilder& mb, bool forceReload)
             deleteMesh(m_meshData.at(nextID));
             m_meshData.erase(nextID);
             m_skeletalData.erase(nextID);
+            m_tracker.remove(nextID);
 
             if (!loadMesh(nextID, mb))
             {
@@ -101,6 +115,7 @@ std::size_t MeshResource::loadMesh(const MeshBuilder& mb, bool forceReload)
             }
         }
 
+        m_tracker.touch(nextID);
         return nextID;
     }
 
@@ -121,6 +136,7 @@ const Mesh::Data& MeshResource::getMesh(std::size_t id) const
 Mesh::Data& MeshResource::getMesh(std::size_t id)
 {
     CRO_ASSERT(m_meshData.count(id) != 0, "Mesh not found");
+    m_tracker.touch(id);
     return m_meshData.at(id);
 }
 
@@ -133,6 +149,37 @@ Skeleton MeshResource::getSkeltalAnimation(std::size_t ID) const
     return {};
 }
 
+bool MeshResource::hasMesh(std::size_t ID) const
+{
+    return m_meshData.count(ID) != 0;
+}
+
+bool MeshResource::acquire(std::size_t ID)
+{
+    return m_tracker.acquire(ID);
+}
+
+bool MeshResource::release(std::size_t ID)
+{
+    if (m_tracker.release(ID))
+    {
+        evict();
+        return true;
+    }
+    return false;
+}
+
+void MeshResource::setMemoryBudget(std::size_t bytes)
+{
+    m_tracker.setBudget(bytes);
+    evict();
+}
+
+ResourceStats MeshResource::getMemoryStats() const
+{
+    return m_tracker.getStats();
+}
+
 void MeshResource::flush()
 {
     //make sure all the meshes are deaded
@@ -142,6 +189,7 @@ void MeshResource::flush()
     }
     m_meshData.clear();
     m_skeletalData.clear();
+    m_tracker.clear();
     autoID = std::numeric_limits<std::size_t>::max();
 }
 
@@ -171,4 +219,15 @@ void MeshResource::deleteMesh(Mesh::Data md)
     {
         glCheck(glDeleteBuffers(1, &md.vbo));
     }
+}
+
+void MeshResource::evict()
+{
+    const auto ids = m_tracker.collect();
+    for (auto id : ids)
+    {
+        deleteMesh(m_meshData.at(id));
+        m_meshData.erase(id);
+        m_skeletalData.erase(id);
+    }
 }
\ No newline at end of file
@@ -60,6 +60,25 @@ namespace
 #ifdef CRO_DEBUG_
     bool billboardsWarned = false;
 #endif
+
+    //only meshes loaded from file may be used as LOD levels
+    std::unique_ptr<MeshBuilder> createFileBuilder(const std::string& path)
+    {
+        auto ext = FileSystem::getFileExtension(path);
+        if (ext == ".cmf")
+        {
+            return std::make_unique<StaticMeshBuilder>(path);
+        }
+        else if (ext == ".cmb")
+        {
+            return std::make_unique<BinaryMeshBuilder>(path);
+        }
+        else if (ext == ".iqm")
+        {
+            return std::make_unique<IqmBuilder>(path);
+        }
+        return nullptr;
+    }
 }
 
 ModelDefinition::ModelDefinition(ResourceCollection& rc, EnvironmentMap* envMap, const std::string& workingDir)
@@ -128,20 +147,11 @@ bool ModelDefinition::loadFromFile(const std::string& path, bool instanced, bool
     bool lockRotation = false;
     bool lockScale = false;
 
-    if (ext == ".cmf")
-    {
-        //we have a static mesh
-        meshBuilder = std::make_unique<StaticMeshBuilder>(m_workingDir + meshValue);
-    }
-    else if (ext == ".cmb")
+    const bool fileMesh = (ext == ".cmf" || ext == ".cmb" || ext == ".iqm");
+    if (fileMesh)
     {
-        //binary model
-        meshBuilder = std::make_unique<BinaryMeshBuilder>(m_workingDir + meshValue);
-    }
-    else if (ext == ".iqm")
-    {
-        //use iqm loader
-        meshBuilder = std::make_unique<IqmBuilder>(m_workingDir + meshValue);
+        //static, binary or iqm mesh
+        meshBuilder = createFileBuilder(m_workingDir + meshValue);
     }
     else if (Util::String::toLower(meshValue) == "sphere")
     {
@@ -238,15 +248,32 @@ bool ModelDefinition::loadFromFile(const std::string& path, bool instanced, bool
     //check we have at least one material with a valid shader type
     const auto& objs = cfg.getObjects();
     std::vector<ConfigObject> materials;
+    std::vector<std::pair<std::string, float>> lods;
     for (const auto& obj : objs)
     {
         auto type = std::find(std::begin(materialTypes), std::end(materialTypes), obj.getId());
+        const auto objName = Util::String::toLower(obj.getName());
 
-        if (Util::String::toLower(obj.getName()) == "material"
+        if (objName == "material"
             && type != materialTypes.end())
         {
             materials.push_back(obj);
         }
+        else if (objName == "lod")
+        {
+            //lod levels are listed finest to coarsest, each with the
+            //projected size below which the level becomes active
+            const auto* lodMesh = obj.findProperty("mesh");
+            const auto* lodSize = obj.findProperty("screen_size");
+            if (lodMesh && lodSize)
+            {
+                lods.emplace_back(lodMesh->getValue<std::string>(), lodSize->getValue<float>());
+            }
+            else
+            {
+                LogW << path << ": lod object requires both mesh and screen_size properties, skipping..." << std::endl;
+            }
+        }
     }
 
     if (materials.empty())
@@ -278,6 +305,47 @@ bool ModelDefinition::loadFromFile(const std::string& path, bool instanced, bool
         m_skeleton = skel;
     }
 
+    if (!lods.empty())
+    {
+        if (!fileMesh)
+        {
+            LogW << path << ": LOD levels are only supported on meshes loaded from file." << std::endl;
+        }
+        else
+        {
+            const auto& baseMesh = m_resources.meshes.getMesh(m_meshID);
+            for (const auto& [lodPath, screenSize] : lods)
+            {
+                auto lodBuilder = createFileBuilder(m_workingDir + lodPath);
+                if (!lodBuilder)
+                {
+                    LogW << lodPath << ": invalid LOD file type, skipping..." << std::endl;
+                    continue;
+                }
+
+                auto lodID = m_resources.meshes.loadMesh(*lodBuilder, forceReload);
+                if (lodID == 0)
+                {
+                    LogW << lodPath << ": failed loading LOD mesh, skipping..." << std::endl;
+                    continue;
+                }
+
+                //levels must be interchangeable with the base mesh
+                //so that they can share its materials
+                const auto& lodMesh = m_resources.meshes.getMesh(lodID);
+                if (lodMesh.submeshCount != baseMesh.submeshCount
+                    || lodMesh.vertexSize != baseMesh.vertexSize
+                    || lodMesh.attributes != baseMesh.attributes)
+                {
+                    LogW << lodPath << ": LOD vertex layout or sub-mesh count does not match " << meshValue << ", skipping..." << std::endl;
+                    continue;
+                }
+
+                m_lodIDs.emplace_back(lodID, screenSize);
+            }
+        }
+    }
+
     for (auto& mat : materials)
     {
         ShaderResource::BuiltIn shaderType = useDeferredShaders ? ShaderResource::UnlitDeferred : ShaderResource::Unlit;
@@ -698,6 +766,11 @@ bool ModelDefinition::createModel(Entity entity)
             model.setMaterial(i, m_resources.materials.get(m_materialIDs[i]));
         }
 
+        for (const auto& [lodID, screenSize] : m_lodIDs)
+        {
+            model.addLod(m_resources.meshes.getMesh(lodID), screenSize);
+        }
+
         if (m_castShadows)
         {
             for (auto i = 0u; i < m_materialCount; ++i)
@@ -752,6 +825,7 @@ const Material::Data* ModelDefinition::getMaterial(std::size_t index) const
 void ModelDefinition::reset()
 {
     m_meshID = 0;
+    m_lodIDs.clear();
     m_materialIDs = {};
     m_shadowIDs = {};
     m_materialCount = 0;
@@ -77,6 +77,7 @@ namespace
 
 Shader::Shader()
     : m_handle  (0),
+    m_stages    ({}),
     m_attribMap ({})
 {
     resetAttribMap();
@@ -85,10 +86,12 @@ Shader::Shader()
 Shader::Shader(Shader&& other) noexcept
 {
     m_handle = other.m_handle;
+    m_stages = other.m_stages;
     m_attribMap = other.m_attribMap;
     m_uniformMap = other.m_uniformMap;
 
     other.m_handle = 0;
+    other.m_stages = {};
     other.m_attribMap = {};
     other.m_uniformMap.clear();
 }
@@ -99,14 +102,17 @@ Shader& Shader::operator=(Shader&& other) noexcept
     {
         Shader temp;
         std::swap(m_handle, temp.m_handle);
+        std::swap(m_stages, temp.m_stages);
         std::swap(m_attribMap, temp.m_attribMap);
         std::swap(m_uniformMap, temp.m_uniformMap);
 
         m_handle = other.m_handle;
+        m_stages = other.m_stages;
         m_attribMap = other.m_attribMap;
         m_uniformMap = other.m_uniformMap;
 
         other.m_handle = 0;
+        other.m_stages = {};
         other.m_attribMap = {};
         other.m_uniformMap.clear();
     }
@@ -116,10 +122,7 @@ Shader& Shader::operator=(Shader&& other) noexcept
 
 Shader::~Shader()
 {
-    if (m_handle)
-    {
-        glCheck(glDeleteProgram(m_handle));
-    }
+    reset();
 }
 
 //public
@@ -207,174 +210,229 @@ std::int32_t Shader::getUniformID(const std::string& name) const
 //private
 bool Shader::loadFromSource(const char* vertex, const char* geometry, const char* fragment, const char* defines)
 {
-    if (m_handle)
-    {
-        //remove existing program
-        glCheck(glDeleteProgram(m_handle));
-        m_handle = 0;
-        resetAttribMap();
-        resetUniformMap();
-    }
+    return beginCompile(vertex, geometry, fragment, defines, false)
+        && endCompile();
+}
 
-    //compile vert shader
-    GLuint vertID = glCreateShader(GL_VERTEX_SHADER);
+bool Shader::beginCompile(const char* vertex, const char* geometry, const char* fragment, const char* defines, bool retrievable)
+{
+    reset();
 
 #ifdef __ANDROID__
-    const char* src[] = { "#version 100\n#define MOBILE\n", precision.c_str(), defines, vertex };
+    const char* src[] = { "#version 100\n#define MOBILE\n", precision.c_str(), defines ? defines : "", vertex };
 #else
-    const char* src[] = { "#version 410 core\n", precision.c_str(), defines, vertex };
+    const char* src[] = { "#version 410 core\n", precision.c_str(), defines ? defines : "", vertex };
 #endif //__ANDROID__
 
-    glCheck(glShaderSource(vertID, 4, src, nullptr));
-    glCheck(glCompileShader(vertID));
+    //compile status isn't queried until endCompile() so that
+    //drivers which compile in the background aren't stalled
+    m_stages[0] = glCreateShader(GL_VERTEX_SHADER);
+    glCheck(glShaderSource(m_stages[0], 4, src, nullptr));
+    glCheck(glCompileShader(m_stages[0]));
 
-    GLint result = GL_FALSE;
-    int resultLength = 0;
-
-    glCheck(glGetShaderiv(vertID, GL_COMPILE_STATUS, &result));
-    glCheck(glGetShaderiv(vertID, GL_INFO_LOG_LENGTH, &resultLength));
-    if (result == GL_FALSE)
+#ifdef PLATFORM_DESKTOP
+    //compile geom shader if not nullptr
+    if (geometry != nullptr)
     {
-        //failed compilation
-        std::string str;
-        str.resize(resultLength + 1);
-        glCheck(glGetShaderInfoLog(vertID, resultLength, nullptr, &str[0]));
-        Logger::log("Failed compiling vertex shader: " + std::to_string(result) + ", " + str, Logger::Type::Error);
+        m_stages[1] = glCreateShader(GL_GEOMETRY_SHADER);
+        src[3] = geometry;
+        glCheck(glShaderSource(m_stages[1], 4, src, nullptr));
+        glCheck(glCompileShader(m_stages[1]));
+    }
+#endif
 
-        glCheck(glDeleteShader(vertID));
+    m_stages[2] = glCreateShader(GL_FRAGMENT_SHADER);
+    src[3] = fragment;
+    glCheck(glShaderSource(m_stages[2], 4, src, nullptr));
+    glCheck(glCompileShader(m_stages[2]));
+
+    m_handle = glCreateProgram();
+    if (m_handle == 0)
+    {
+        deleteStages();
         return false;
     }
 
-    GLuint geomID = 0;
 #ifdef PLATFORM_DESKTOP
-    //compile geom shader if not nullptr
-    if (geometry != nullptr)
+    if (retrievable)
     {
-        geomID = glCreateShader(GL_GEOMETRY_SHADER);
-        src[3] = geometry;
-        glCheck(glShaderSource(geomID, 4, src, nullptr));
-        glCheck(glCompileShader(geomID));
+        glCheck(glProgramParameteri(m_handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
+#endif
 
-        result = GL_FALSE;
-        resultLength = 0;
+    for (auto stage : m_stages)
+    {
+        if (stage)
+        {
+            glCheck(glAttachShader(m_handle, stage));
+        }
+    }
+    glCheck(glLinkProgram(m_handle));
 
-        glCheck(glGetShaderiv(geomID, GL_COMPILE_STATUS, &result));
-        glCheck(glGetShaderiv(geomID, GL_INFO_LOG_LENGTH, &resultLength));
-        if (result == GL_FALSE)
+    return true;
+}
+
+bool Shader::endCompile()
+{
+    if (m_handle == 0)
+    {
+        return false;
+    }
+
+    static const std::array<std::string, 3> StageNames = { "vertex", "geometry", "fragment" };
+
+    GLint result = GL_FALSE;
+    int resultLength = 0;
+
+    for (auto i = 0u; i < m_stages.size(); ++i)
+    {
+        if (m_stages[i])
         {
-            std::string str;
-            str.resize(resultLength + 1);
-            glCheck(glGetShaderInfoLog(geomID, resultLength, nullptr, &str[0]));
-            Logger::log("Failed compiling geometry shader: " + std::to_string(result) + ", " + str, Logger::Type::Error);
+            result = GL_FALSE;
+            resultLength = 0;
 
-            glCheck(glDeleteShader(vertID));
-            glCheck(glDeleteShader(geomID));
+            glCheck(glGetShaderiv(m_stages[i], GL_COMPILE_STATUS, &result));
+            glCheck(glGetShaderiv(m_stages[i], GL_INFO_LOG_LENGTH, &resultLength));
+            if (result == GL_FALSE)
+            {
+                //failed compilation
+                std::string str;
+                str.resize(resultLength + 1);
+                glCheck(glGetShaderInfoLog(m_stages[i], resultLength, nullptr, &str[0]));
+                Logger::log("Failed compiling " + StageNames[i] + " shader: " + std::to_string(result) + ", " + str, Logger::Type::Error);
 
-            return false;
+                reset();
+                return false;
+            }
         }
     }
-#endif
-
-    //compile frag shader
-    GLuint fragID = glCreateShader(GL_FRAGMENT_SHADER);
-    src[3] = fragment;
-    glCheck(glShaderSource(fragID, 4, src, nullptr));
-    glCheck(glCompileShader(fragID));
 
     result = GL_FALSE;
     resultLength = 0;
-
-    glCheck(glGetShaderiv(fragID, GL_COMPILE_STATUS, &result));
-    glCheck(glGetShaderiv(fragID, GL_INFO_LOG_LENGTH, &resultLength));
+    glCheck(glGetProgramiv(m_handle, GL_LINK_STATUS, &result));
+    glCheck(glGetProgramiv(m_handle, GL_INFO_LOG_LENGTH, &resultLength));
     if (result == GL_FALSE)
     {
         std::string str;
         str.resize(resultLength + 1);
-        glCheck(glGetShaderInfoLog(fragID, resultLength, nullptr, &str[0]));
-        Logger::log("Failed compiling fragment shader: " + std::to_string(result) + ", " + str, Logger::Type::Error);
+        glCheck(glGetProgramInfoLog(m_handle, resultLength, nullptr, &str[0]));
+        Logger::log("Failed to link shader program: " + std::to_string(result) + ", " + str, Logger::Type::Error);
 
-        glCheck(glDeleteShader(vertID));
-        glCheck(glDeleteShader(fragID));
+        reset();
+        return false;
+    }
 
-        if (geomID)
-        {
-            glCheck(glDeleteShader(geomID));
-        }
+    //tidy
+    deleteStages();
+
+    //grab attributes
+    if (!fillAttribMap())
+    {
+        reset();
         return false;
     }
 
-    //link shaders to program
+    fillUniformMap();
+
+    return true;
+}
+
+bool Shader::loadFromBinary(std::uint32_t format, const std::vector<std::uint8_t>& data)
+{
+#ifdef PLATFORM_DESKTOP
+    reset();
+
     m_handle = glCreateProgram();
-    if (m_handle)
+    if (m_handle == 0)
     {
-        glCheck(glAttachShader(m_handle, vertID));
-        if (geomID)
-        {
-            glCheck(glAttachShader(m_handle, geomID));
-        }
-        glCheck(glAttachShader(m_handle, fragID));
-        glCheck(glLinkProgram(m_handle));
-
-        result = GL_FALSE;
-        resultLength = 0;
-        glCheck(glGetProgramiv(m_handle, GL_LINK_STATUS, &result));
-        glCheck(glGetProgramiv(m_handle, GL_INFO_LOG_LENGTH, &resultLength));
-        if (result == GL_FALSE)
-        {
-            std::string str;
-            str.resize(resultLength + 1);
-            glCheck(glGetProgramInfoLog(m_handle, resultLength, nullptr, &str[0]));
-            Logger::log("Failed to link shader program: " + std::to_string(result) + ", " + str, Logger::Type::Error);
-
-            glCheck(glDetachShader(m_handle, vertID));
-            if (geomID)
-            {
-                glCheck(glDetachShader(m_handle, geomID));
-            }
-            glCheck(glDetachShader(m_handle, fragID));
+        return false;
+    }
 
-            glCheck(glDeleteShader(vertID));
-            if (geomID)
-            {
-                glCheck(glDeleteShader(geomID));
-            }
-            glCheck(glDeleteShader(fragID));
-            glCheck(glDeleteProgram(m_handle));
-            m_handle = 0;
-            return false;
-        }
-        else
-        {
-            //tidy
-            glCheck(glDetachShader(m_handle, vertID));
-            if (geomID)
-            {
-                glCheck(glDetachShader(m_handle, geomID));
-            }
-            glCheck(glDetachShader(m_handle, fragID));
+    glCheck(glProgramBinary(m_handle, format, data.data(), static_cast<GLsizei>(data.size())));
 
-            glCheck(glDeleteShader(vertID));
-            if (geomID)
-            {
-                glCheck(glDeleteShader(geomID));
-            }
-            glCheck(glDeleteShader(fragID));
+    //this is expected to fail if the driver was updated since
+    //the binary was stored, so don't log an error
+    GLint result = GL_FALSE;
+    glCheck(glGetProgramiv(m_handle, GL_LINK_STATUS, &result));
+    if (result == GL_FALSE
+        || !fillAttribMap())
+    {
+        reset();
+        return false;
+    }
 
-            //grab attributes
-            if (!fillAttribMap())
-            {
-                glCheck(glDeleteProgram(m_handle));
-                m_handle = 0;
-                return false;
-            }
+    fillUniformMap();
+    return true;
+#else
+    return false;
+#endif
+}
 
-            fillUniformMap();
+bool Shader::getBinary(std::uint32_t& format, std::vector<std::uint8_t>& dst) const
+{
+#ifdef PLATFORM_DESKTOP
+    if (m_handle == 0)
+    {
+        return false;
+    }
 
-            return true;
-        }
+    GLint length = 0;
+    glCheck(glGetProgramiv(m_handle, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0)
+    {
+        return false;
     }
 
+    dst.resize(length);
+
+    GLenum binaryFormat = 0;
+    glCheck(glGetProgramBinary(m_handle, length, &length, &binaryFormat, dst.data()));
+    dst.resize(length);
+
+    format = binaryFormat;
+    return length > 0;
+#else
     return false;
+#endif
+}
+
+std::string Shader::getPreamble()
+{
+#ifdef __ANDROID__
+    return "#version 100\n#define MOBILE\n" + precision;
+#else
+    return "#version 410 core\n" + precision;
+#endif
+}
+
+void Shader::reset()
+{
+    deleteStages();
+
+    if (m_handle)
+    {
+        //remove existing program
+        glCheck(glDeleteProgram(m_handle));
+        m_handle = 0;
+        resetAttribMap();
+        resetUniformMap();
+    }
+}
+
+void Shader::deleteStages()
+{
+    for (auto& stage : m_stages)
+    {
+        if (stage)
+        {
+            if (m_handle)
+            {
+                glCheck(glDetachShader(m_handle, stage));
+            }
+            glCheck(glDeleteShader(stage));
+            stage = 0;
+        }
+    }
 }
 
 bool Shader::fillAttribMap()
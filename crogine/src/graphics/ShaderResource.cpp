@@ -40,11 +40,56 @@ source distribution.
 #endif
 #include "../detail/GLCheck.hpp"
 
+#include <crogine/core/App.hpp>
+
+#include <SDL_video.h>
+
 using namespace cro;
 
 namespace
 {
     std::int32_t MAX_BONES = 0;
+
+    constexpr std::int32_t BuiltInTypeMask = 0xFF000000;
+
+    std::string getGLString(GLenum name)
+    {
+        const auto* str = reinterpret_cast<const char*>(glGetString(name));
+        return str ? str : "";
+    }
+
+    //asks the driver to compile on as many threads as it likes
+    //when KHR_parallel_shader_compile is available. Without it
+    //beginCompile()/endCompile() still allow drivers which
+    //compile in the background to do so.
+    void enableParallelCompile()
+    {
+#ifdef PLATFORM_DESKTOP
+        static bool enabled = false;
+        if (!enabled)
+        {
+            enabled = true;
+
+            using MaxThreadsFunc = void(APIENTRYP)(GLuint);
+            MaxThreadsFunc func = nullptr;
+
+            if (SDL_GL_ExtensionSupported("GL_KHR_parallel_shader_compile"))
+            {
+                func = reinterpret_cast<MaxThreadsFunc>(SDL_GL_GetProcAddress("glMaxShaderCompilerThreadsKHR"));
+            }
+            else if (SDL_GL_ExtensionSupported("GL_ARB_parallel_shader_compile"))
+            {
+                func = reinterpret_cast<MaxThreadsFunc>(SDL_GL_GetProcAddress("glMaxShaderCompilerThreadsARB"));
+            }
+
+            if (func)
+            {
+                func(0xFFFFFFFF);
+                LOG("Enabled parallel shader compilation", Logger::Type::Info);
+            }
+        }
+#endif
+    }
 }
 
 ShaderResource::ShaderResource()
@@ -53,6 +98,16 @@ ShaderResource::ShaderResource()
     {
         Logger::log("FAILED LOADING DEFAULT SHADER, SHADER RESOURCE INVALID STATE", Logger::Type::Error);
     }
+
+#ifdef PLATFORM_DESKTOP
+    m_cache.setDriverString(getGLString(GL_VENDOR) + getGLString(GL_RENDERER) + getGLString(GL_VERSION));
+
+    if (App::isValid() && !App::isHeadless()
+        && !App::getPreferencePath().empty())
+    {
+        setCacheDirectory(App::getPreferencePath() + "shader_cache/");
+    }
+#endif
 }
 
 //public
@@ -70,6 +125,7 @@ bool ShaderResource::loadFromFile(std::int32_t ID, const std::string& vertex, co
         return false;
     }
     m_shaders.insert(std::move(pair));
+    track(ID);
     return true;
 }
 
@@ -81,13 +137,7 @@ bool ShaderResource::loadFromString(std::int32_t ID, const std::string& vertex,
         return false;
     }
 
-    auto pair = std::make_pair(ID, Shader());
-    if (!pair.second.loadFromString(vertex, fragment, defines))
-    {
-        return false;
-    }
-    m_shaders.insert(std::move(pair));
-    return true;
+    return loadCached(ID, vertex.c_str(), nullptr, fragment.c_str(), defines);
 }
 
 bool ShaderResource::loadFromString(std::int32_t ID, const std::string& vertex, const std::string& geom, const std::string& fragment, const std::string& defines)
@@ -98,13 +148,7 @@ bool ShaderResource::loadFromString(std::int32_t ID, const std::string& vertex,
         return false;
     }
 
-    auto pair = std::make_pair(ID, Shader());
-    if (!pair.second.loadFromString(vertex, geom, fragment, defines))
-    {
-        return false;
-    }
-    m_shaders.insert(std::move(pair));
-    return true;
+    return loadCached(ID, vertex.c_str(), geom.c_str(), fragment.c_str(), defines);
 }
 
 std::int32_t ShaderResource::loadBuiltIn(BuiltIn type, std::int32_t flags)
@@ -120,9 +164,198 @@ std::int32_t ShaderResource::loadBuiltIn(BuiltIn type, std::int32_t flags)
     //check not already loaded
     if (m_shaders.count(id) > 0)
     {
+        m_tracker.touch(id);
         return id;
     }
 
+    const auto source = getBuiltInSource(id);
+    if (loadFromString(id, *source.vertex, *source.fragment, source.defines))
+    {
+        m_manifest.add(id);
+        return id;
+    }
+    return -1;
+}
+
+Shader& ShaderResource::get(std::int32_t ID)
+{
+    if (m_shaders.count(ID) == 0)
+    {
+        Logger::log("Could not find shader with ID " + std::to_string(ID) + ", returning default shader", Logger::Type::Warning);
+        return m_defaultShader;
+    }
+    m_tracker.touch(ID);
+    return m_shaders.at(ID);// .second;
+}
+
+bool ShaderResource::hasShader(std::int32_t shaderID) const
+{
+    return m_shaders.count(shaderID) != 0;
+}
+
+bool ShaderResource::acquire(std::int32_t shaderID)
+{
+    return m_tracker.acquire(shaderID);
+}
+
+bool ShaderResource::release(std::int32_t shaderID)
+{
+    if (m_tracker.release(shaderID))
+    {
+        evict();
+        return true;
+    }
+    return false;
+}
+
+void ShaderResource::setMemoryBudget(std::size_t bytes)
+{
+    m_tracker.setBudget(bytes);
+    evict();
+}
+
+ResourceStats ShaderResource::getMemoryStats() const
+{
+    return m_tracker.getStats();
+}
+
+bool ShaderResource::setCacheDirectory(const std::string& path)
+{
+#ifdef PLATFORM_DESKTOP
+    if (!path.empty())
+    {
+        GLint formatCount = 0;
+        glCheck(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount));
+        if (formatCount < 1)
+        {
+            LogW << "Driver doesn't support program binaries, shader cache is disabled" << std::endl;
+            m_cache.setDirectory("");
+            return false;
+        }
+    }
+    return m_cache.setDirectory(path);
+#else
+    return path.empty();
+#endif
+}
+
+std::size_t ShaderResource::precompile(const std::vector<std::int32_t>& ids)
+{
+    enableParallelCompile();
+
+    struct PendingShader final
+    {
+        std::int32_t id = 0;
+        std::uint64_t key = 0;
+    };
+    std::vector<PendingShader> pending;
+
+    std::size_t count = 0;
+
+    //submit everything first so the driver can work on
+    //the whole batch before we ask for any results
+    for (auto id : ids)
+    {
+        const auto type = id & BuiltInTypeMask;
+#ifdef PLATFORM_DESKTOP
+        if (type < BuiltIn::PBRDeferred || type > BuiltIn::PBR
+#else
+        if (type < BuiltIn::Unlit || type > BuiltIn::PBR
+#endif
+            || (id & ~BuiltInTypeMask) == 0)
+        {
+            LogW << "Skipping precompilation of " << id << ": not a valid built in shader ID" << std::endl;
+            continue;
+        }
+
+        if (m_shaders.count(id) != 0)
+        {
+            continue;
+        }
+
+        const auto source = getBuiltInSource(id);
+        const auto key = getCacheKey(source.vertex->c_str(), nullptr, source.fragment->c_str(), source.defines);
+
+        Shader shader;
+        if (loadBinary(key, shader))
+        {
+            m_shaders.insert(std::make_pair(id, std::move(shader)));
+            track(id);
+            m_manifest.add(id);
+            count++;
+        }
+        else if (shader.beginCompile(source.vertex->c_str(), nullptr, source.fragment->c_str(), source.defines.c_str(), m_cache.isEnabled()))
+        {
+            //not tracked until complete so it won't be evicted
+            m_shaders.insert(std::make_pair(id, std::move(shader)));
+            pending.push_back({ id, key });
+        }
+    }
+
+    for (const auto& [id, key] : pending)
+    {
+        auto& shader = m_shaders.at(id);
+        if (!shader.endCompile())
+        {
+            m_shaders.erase(id);
+            continue;
+        }
+
+        storeBinary(key, shader);
+        track(id);
+        m_manifest.add(id);
+        count++;
+    }
+
+    return count;
+}
+
+std::size_t ShaderResource::precompile(const std::string& path)
+{
+    Detail::ShaderManifest manifest;
+    if (!manifest.loadFromFile(path))
+    {
+        return 0;
+    }
+    return precompile(manifest.getIDs());
+}
+
+bool ShaderResource::saveManifest(const std::string& path) const
+{
+    return m_manifest.saveToFile(path);
+}
+
+//private
+void ShaderResource::track(std::int32_t shaderID)
+{
+    GLint byteSize = 0;
+#ifdef GL_PROGRAM_BINARY_LENGTH
+    glCheck(glGetProgramiv(m_shaders.at(shaderID).getGLHandle(), GL_PROGRAM_BINARY_LENGTH, &byteSize));
+#endif
+    m_tracker.add(shaderID, static_cast<std::size_t>(std::max(0, byteSize)));
+
+    //never evict the shader we just loaded
+    m_tracker.acquire(shaderID);
+    evict();
+    m_tracker.release(shaderID);
+}
+
+void ShaderResource::evict()
+{
+    const auto ids = m_tracker.collect();
+    for (auto id : ids)
+    {
+        m_shaders.erase(static_cast<std::int32_t>(id));
+    }
+}
+
+ShaderResource::BuiltInSource ShaderResource::getBuiltInSource(std::int32_t id) const
+{
+    const auto type = id & BuiltInTypeMask;
+    const auto flags = id & ~BuiltInTypeMask;
+
+    BuiltInSource source;
+
     //create shader defines based on flags
     std::string defines;
     bool needUVs = false;
@@ -210,7 +443,6 @@ std::int32_t ShaderResource::loadBuiltIn(BuiltIn type, std::int32_t flags)
     }
     defines += "\n";
 
-    bool success = false;
     switch (type)
     {
     default:
@@ -218,61 +450,106 @@ std::int32_t ShaderResource::loadBuiltIn(BuiltIn type, std::int32_t flags)
         defines += "#define VERTEX_LIT\n";
         [[fallthrough]];
     case BuiltIn::BillboardUnlit:
-        success = loadFromString(id, Shaders::Billboard::Vertex, Shaders::Billboard::Fragment, defines);
+        source.vertex = &Shaders::Billboard::Vertex;
+        source.fragment = &Shaders::Billboard::Fragment;
         break;
     case BuiltIn::Unlit:
-        success = loadFromString(id, Shaders::Unlit::Vertex, Shaders::Unlit::Fragment, defines);
+        source.vertex = &Shaders::Unlit::Vertex;
+        source.fragment = &Shaders::Unlit::Fragment;
         break;
     case BuiltIn::UnlitDeferred:
-        success = loadFromString(id, Shaders::Unlit::Vertex, Shaders::Deferred::OITUnlitFragment, defines);
+        source.vertex = &Shaders::Unlit::Vertex;
+        source.fragment = &Shaders::Deferred::OITUnlitFragment;
         break;
     case BuiltIn::VertexLit:
-        success = loadFromString(id, Shaders::VertexLit::Vertex, Shaders::VertexLit::Fragment, defines);
+        source.vertex = &Shaders::VertexLit::Vertex;
+        source.fragment = &Shaders::VertexLit::Fragment;
         break;
     case BuiltIn::VertexLitDeferred:
-        success = loadFromString(id, Shaders::VertexLit::Vertex, Shaders::Deferred::OITShadedFragment, defines);
+        source.vertex = &Shaders::VertexLit::Vertex;
+        source.fragment = &Shaders::Deferred::OITShadedFragment;
         break;
     case BuiltIn::ShadowMap:
 #ifdef PLATFORM_DESKTOP
-        success = loadFromString(id, Shaders::ShadowMap::Vertex, Shaders::ShadowMap::FragmentDesktop, defines);
+        source.vertex = &Shaders::ShadowMap::Vertex;
+        source.fragment = &Shaders::ShadowMap::FragmentDesktop;
 #else
-        success = loadFromString(id, Shaders::ShadowMap::Vertex, Shaders::ShadowMap::FragmentMobile, defines);
+        source.vertex = &Shaders::ShadowMap::Vertex;
+        source.fragment = &Shaders::ShadowMap::FragmentMobile;
 #endif
         break;
     case BillboardShadowMap:
         defines += "#define SHADOW_MAPPING\n";
 #ifdef PLATFORM_DESKTOP
-        success = loadFromString(id, Shaders::Billboard::Vertex, Shaders::ShadowMap::FragmentDesktop, defines);
+        source.vertex = &Shaders::Billboard::Vertex;
+        source.fragment = &Shaders::ShadowMap::FragmentDesktop;
 #else
-        success = loadFromString(id, Shaders::Billboard::Vertex, Shaders::ShadowMap::FragmentMobile, defines);
+        source.vertex = &Shaders::Billboard::Vertex;
+        source.fragment = &Shaders::ShadowMap::FragmentMobile;
 #endif
         break;
     case BuiltIn::PBRDeferred:
-        success = loadFromString(id, Shaders::Deferred::GBufferVertex, Shaders::Deferred::GBufferFragment, defines);
+        source.vertex = &Shaders::Deferred::GBufferVertex;
+        source.fragment = &Shaders::Deferred::GBufferFragment;
         break;
     case BuiltIn::PBR:
-        success = loadFromString(id, Shaders::VertexLit::Vertex, Shaders::PBR::Fragment, defines);
+        source.vertex = &Shaders::VertexLit::Vertex;
+        source.fragment = &Shaders::PBR::Fragment;
         break;
     }
 
-    if (success)
+    source.defines = std::move(defines);
+    return source;
+}
+
+std::uint64_t ShaderResource::getCacheKey(const char* vertex, const char* geom, const char* fragment, const std::string& defines) const
+{
+    const auto preamble = Shader::getPreamble();
+    return m_cache.getKey({ preamble.c_str(), defines.c_str(), vertex, geom, fragment });
+}
+
+bool ShaderResource::loadCached(std::int32_t id, const char* vertex, const char* geom, const char* fragment, const std::string& defines)
+{
+    Shader shader;
+    const auto key = getCacheKey(vertex, geom, fragment, defines);
+
+    if (!loadBinary(key, shader))
     {
-        return id;
+        if (!shader.beginCompile(vertex, geom, fragment, defines.c_str(), m_cache.isEnabled())
+            || !shader.endCompile())
+        {
+            return false;
+        }
+        storeBinary(key, shader);
     }
-    return -1;
+
+    m_shaders.insert(std::make_pair(id, std::move(shader)));
+    track(id);
+    return true;
 }
 
-Shader& ShaderResource::get(std::int32_t ID)
+bool ShaderResource::loadBinary(std::uint64_t key, Shader& shader) const
 {
-    if (m_shaders.count(ID) == 0)
+    if (!m_cache.isEnabled())
     {
-        Logger::log("Could not find shader with ID " + std::to_string(ID) + ", returning default shader", Logger::Type::Warning);
-        return m_defaultShader;
+        return false;
     }
-    return m_shaders.at(ID);// .second;
+
+    std::uint32_t format = 0;
+    std::vector<std::uint8_t> data;
+    return m_cache.read(key, format, data)
+        && shader.loadFromBinary(format, data);
 }
 
-bool ShaderResource::hasShader(std::int32_t shaderID) const
+void ShaderResource::storeBinary(std::uint64_t key, const Shader& shader) const
 {
-    return m_shaders.count(shaderID) != 0;
+    if (m_cache.isEnabled())
+    {
+        std::uint32_t format = 0;
+        std::vector<std::uint8_t> data;
+        if (shader.getBinary(format, data))
+        {
+            m_cache.write(key, format, data);
+        }
+    }
 }
\ No newline at end of file
@@ -29,12 +29,15 @@ source distribution.
 
 #include <crogine/graphics/Texture.hpp>
 #include <crogine/graphics/Image.hpp>
+#include <crogine/graphics/CompressedImage.hpp>
+#include <crogine/core/FileSystem.hpp>
 #include <crogine/detail/Assert.hpp>
 
 #include "../detail/GLCheck.hpp"
 #include "../detail/stb_image.h"
 #include "../detail/stb_image_write.h"
 #include "../detail/SDLImageRead.hpp"
+#include "CompressedUpload.hpp"
 #include <SDL_rwops.h>
 
 #include <algorithm>
@@ -61,7 +64,8 @@ Texture::Texture()
     m_handle        (0),
     m_smooth        (false),
     m_repeated      (false),
-    m_hasMipMaps    (false)
+    m_hasMipMaps    (false),
+    m_compressed    (false)
 {
 
 }
@@ -72,7 +76,8 @@ Texture::Texture(Texture&& other) noexcept
     m_handle    (other.m_handle),
     m_smooth    (other.m_smooth),
     m_repeated  (other.m_repeated),
-    m_hasMipMaps(other.m_hasMipMaps)
+    m_hasMipMaps(other.m_hasMipMaps),
+    m_compressed(other.m_compressed)
 {
     other.m_size = glm::uvec2(0);
     other.m_format = ImageFormat::None;
@@ -80,6 +85,7 @@ Texture::Texture(Texture&& other) noexcept
     other.m_smooth = false;
     other.m_repeated = false;
     other.m_hasMipMaps = false;
+    other.m_compressed = false;
 }
 
 Texture& Texture::operator=(Texture&& other) noexcept
@@ -95,6 +101,7 @@ Texture& Texture::operator=(Texture&& other) noexcept
         m_smooth = other.m_smooth;
         m_repeated = other.m_repeated;
         m_hasMipMaps = other.m_hasMipMaps;
+        m_compressed = other.m_compressed;
 
         other.m_size = glm::uvec2(0);
         other.m_format = ImageFormat::None;
@@ -102,6 +109,7 @@ Texture& Texture::operator=(Texture&& other) noexcept
         other.m_smooth = false;
         other.m_repeated = false;
         other.m_hasMipMaps = false;
+        other.m_compressed = false;
     }
     return *this;
 }
@@ -159,6 +167,12 @@ void Texture::create(std::uint32_t width, std::uint32_t height, ImageFormat::Typ
     std::fill(buffer.begin(), buffer.end(), 0);
 
     glCheck(glBindTexture(GL_TEXTURE_2D, m_handle));
+    if (m_compressed)
+    {
+        //restore the default level range set by loading a compressed image
+        glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000));
+        m_compressed = false;
+    }
 //#ifdef GL41
     glCheck(glTexImage2D(GL_TEXTURE_2D, 0, uploadFormat, width, height, 0, uploadFormat, GL_UNSIGNED_BYTE, buffer.data()));
 //#else
@@ -196,6 +210,17 @@ bool Texture::loadFromFile(const std::string& filePath, bool createMipMaps)
     //    return loadAsByte(file, createMipMaps);
     //}
 
+    const auto ext = FileSystem::getFileExtension(filePath);
+    if (ext == ".dds" || ext == ".ktx2")
+    {
+        CompressedImage image;
+        if (image.loadFromFile(filePath))
+        {
+            return loadFromImage(image);
+        }
+        return false;
+    }
+
     Image image;
     if (image.loadFromFile(filePath))
     {
@@ -219,8 +244,66 @@ bool Texture::loadFromImage(const Image& image, bool createMipMaps)
     return update(image.getPixelData(), createMipMaps);
 }
 
+bool Texture::loadFromImage(const CompressedImage& image)
+{
+    if (image.getLevelCount() == 0
+        || image.getFaceCount() != 1)
+    {
+        LogE << "Failed creating texture from compressed image: Image is empty or is a cubemap." << std::endl;
+        return false;
+    }
+
+    auto size = image.getSize();
+    if (size.x > getMaxTextureSize() || size.y > getMaxTextureSize())
+    {
+        LogE << "Failed creating texture from compressed image: Image is larger than the maximum texture size." << std::endl;
+        return false;
+    }
+
+    if (!m_handle)
+    {
+        GLuint handle;
+        glCheck(glGenTextures(1, &handle));
+        m_handle = handle;
+    }
+
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_handle));
+    if (!Detail::uploadCompressedImage(image, GL_TEXTURE_2D, GL_TEXTURE_2D))
+    {
+        glCheck(glBindTexture(GL_TEXTURE_2D, 0));
+        return false;
+    }
+
+    m_size = size;
+    m_format = image.hasAlpha() ? ImageFormat::RGBA : ImageFormat::RGB;
+    m_hasMipMaps = image.getLevelCount() > 1;
+    m_compressed = true;
+
+    auto wrap = m_repeated ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap));
+    glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_smooth ? GL_LINEAR : GL_NEAREST));
+    if (m_hasMipMaps)
+    {
+        glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_smooth ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR_MIPMAP_NEAREST));
+    }
+    else
+    {
+        glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_smooth ? GL_LINEAR : GL_NEAREST));
+    }
+    glCheck(glBindTexture(GL_TEXTURE_2D, 0));
+
+    return true;
+}
+
 bool Texture::update(const std::uint8_t* pixels, bool createMipMaps, URect area)
 {
+    if (m_compressed)
+    {
+        Logger::log("Failed updating image, compressed textures cannot be updated", Logger::Type::Error);
+        return false;
+    }
+
     if (area.left + area.width > m_size.x)
     {
         Logger::log("Failed updating image, source pixels too wide", Logger::Type::Error);
@@ -388,6 +471,11 @@ bool Texture::isRepeated() const
     return m_repeated;
 }
 
+bool Texture::isCompressed() const
+{
+    return m_compressed;
+}
+
 std::uint32_t Texture::getMaxTextureSize()
 {
     if (Detail::SDLResource::valid())
@@ -409,6 +497,7 @@ void Texture::swap(Texture& other)
     std::swap(m_smooth, other.m_smooth);
     std::swap(m_repeated, other.m_repeated);
     std::swap(m_hasMipMaps, other.m_hasMipMaps);
+    std::swap(m_compressed, other.m_compressed);
 }
 
 FloatRect Texture::getNormalisedSubrect(FloatRect rect) const
@@ -0,0 +1,200 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "TextureLoader.hpp"
+
+#include <crogine/core/HiResTimer.hpp>
+
+#include <algorithm>
+
+using namespace cro;
+using namespace cro::Detail;
+
+namespace
+{
+    constexpr std::size_t MaxDecodeThreads = 4;
+    constexpr std::size_t DefaultByteBudget = 8 * 1024 * 1024;
+    constexpr float DefaultTimeBudget = 0.004f;
+}
+
+std::size_t DecodedImage::getByteSize() const
+{
+    if (!success)
+    {
+        return 0;
+    }
+
+    auto size = image.getSize();
+    std::size_t pixelSize = 4;
+    switch (image.getFormat())
+    {
+    default: break;
+    case ImageFormat::RGB:
+        pixelSize = 3;
+        break;
+    case ImageFormat::A:
+        pixelSize = 1;
+        break;
+    }
+    return size.x * size.y * pixelSize;
+}
+
+//-----------------------------//
+ImageDecoder::ImageDecoder(std::size_t threadCount)
+    : m_pendingCount(0),
+    m_running       (true)
+{
+    if (threadCount == 0)
+    {
+        //leave a thread for the main loop
+        auto hwCount = std::thread::hardware_concurrency();
+        threadCount = std::clamp(hwCount > 1 ? std::size_t(hwCount - 1) : std::size_t(1), std::size_t(1), MaxDecodeThreads);
+    }
+
+    for (auto i = 0u; i < threadCount; ++i)
+    {
+        m_threads.emplace_back(&ImageDecoder::threadFunc, this);
+    }
+}
+
+ImageDecoder::~ImageDecoder()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_running = false;
+        m_jobs.clear();
+    }
+    m_condition.notify_all();
+
+    for (auto& t : m_threads)
+    {
+        if (t.joinable())
+        {
+            t.join();
+        }
+    }
+}
+
+//public
+void ImageDecoder::queue(std::uint32_t id, const std::string& path, bool createMipMaps)
+{
+    DecodedImage job;
+    job.id = id;
+    job.path = path;
+    job.createMipMaps = createMipMaps;
+
+    {
+        std::scoped_lock lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_pendingCount++;
+    m_condition.notify_one();
+}
+
+std::size_t ImageDecoder::poll(std::deque<DecodedImage>& dst)
+{
+    std::scoped_lock lock(m_mutex);
+    auto count = m_completed.size();
+    std::move(m_completed.begin(), m_completed.end(), std::back_inserter(dst));
+    m_completed.clear();
+    m_pendingCount -= count;
+    return count;
+}
+
+std::size_t ImageDecoder::getPendingCount() const
+{
+    return m_pendingCount;
+}
+
+//private
+void ImageDecoder::threadFunc()
+{
+    while (true)
+    {
+        DecodedImage job;
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [&]() {return !m_running || !m_jobs.empty(); });
+
+            if (!m_running)
+            {
+                return;
+            }
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        //this is the expensive part, so make sure
+        //we're not holding the lock while decoding
+        job.success = job.image.loadFromFile(job.path);
+
+        std::scoped_lock lock(m_mutex);
+        m_completed.push_back(std::move(job));
+    }
+}
+
+//-----------------------------//
+UploadQueue::UploadQueue()
+    : m_byteBudget  (DefaultByteBudget),
+    m_timeBudget    (DefaultTimeBudget)
+{
+
+}
+
+//public
+std::size_t UploadQueue::process(ImageDecoder& decoder, TextureUploader& uploader)
+{
+    decoder.poll(m_pending);
+
+    HiResTimer timer;
+    float elapsed = 0.f;
+    std::size_t byteCount = 0;
+
+    while (!m_pending.empty())
+    {
+        //always upload at least one image so large
+        //images don't stall the queue indefinitely
+        if (byteCount != 0)
+        {
+            if (byteCount + m_pending.front().getByteSize() > m_byteBudget
+                || elapsed > m_timeBudget)
+            {
+                break;
+            }
+        }
+
+        byteCount += uploader.upload(m_pending.front());
+        m_pending.pop_front();
+
+        elapsed += timer.restart();
+    }
+
+    return byteCount;
+}
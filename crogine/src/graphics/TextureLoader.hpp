@@ -0,0 +1,168 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#pragma once
+
+#include <crogine/graphics/Image.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cro::Detail
+{
+    /*!
+    \brief The result of decoding an image file on a worker thread.
+    */
+    struct DecodedImage final
+    {
+        std::uint32_t id = 0;
+        std::string path;
+        Image image;
+        bool createMipMaps = false;
+        bool success = false;
+
+        std::size_t getByteSize() const;
+    };
+
+    /*!
+    \brief Decodes image files on a pool of worker threads.
+    This requires neither a window nor an OpenGL context, so
+    the completed images must be uploaded separately from the
+    main thread.
+    */
+    class ImageDecoder final
+    {
+    public:
+        /*!
+        \brief Constructor.
+        \param threadCount Number of worker threads to decode with.
+        If this is zero the count is based on the number of available
+        hardware threads.
+        */
+        explicit ImageDecoder(std::size_t threadCount = 0);
+        ~ImageDecoder();
+
+        ImageDecoder(const ImageDecoder&) = delete;
+        ImageDecoder(ImageDecoder&&) = delete;
+        ImageDecoder& operator = (const ImageDecoder&) = delete;
+        ImageDecoder& operator = (ImageDecoder&&) = delete;
+
+        /*!
+        \brief Queues the file at the given path to be decoded.
+        */
+        void queue(std::uint32_t id, const std::string& path, bool createMipMaps);
+
+        /*!
+        \brief Moves any images which have finished decoding into dst.
+        This never blocks.
+        \returns The number of images appended to dst
+        */
+        std::size_t poll(std::deque<DecodedImage>& dst);
+
+        /*!
+        \brief Returns the number of images queued or being decoded
+        which have not yet been returned by poll()
+        */
+        std::size_t getPendingCount() const;
+
+    private:
+        std::vector<std::thread> m_threads;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::deque<DecodedImage> m_jobs;
+        std::deque<DecodedImage> m_completed;
+        std::atomic<std::size_t> m_pendingCount;
+        bool m_running;
+
+        void threadFunc();
+    };
+
+    /*!
+    \brief Interface for uploading decoded images.
+    UploadQueue uses this to upload images to the GPU so
+    that it can be swapped for a mock when there's no
+    OpenGL context available.
+    */
+    class TextureUploader
+    {
+    public:
+        virtual ~TextureUploader() = default;
+
+        /*!
+        \brief Uploads the given image
+        \returns The number of bytes uploaded
+        */
+        virtual std::size_t upload(const DecodedImage&) = 0;
+    };
+
+    /*!
+    \brief Collects images from an ImageDecoder and passes them
+    to a TextureUploader, limiting the amount uploaded each time
+    process() is called.
+    */
+    class UploadQueue final
+    {
+    public:
+        UploadQueue();
+
+        /*!
+        \brief Sets the maximum number of bytes uploaded with each call to process()
+        */
+        void setByteBudget(std::size_t bytes) { m_byteBudget = bytes; }
+
+        /*!
+        \brief Sets the maximum time in seconds spent uploading with each call to process()
+        */
+        void setTimeBudget(float seconds) { m_timeBudget = seconds; }
+
+        /*!
+        \brief Collects completed images from the given decoder and
+        uploads as many as the budget allows with the given uploader.
+        At least one image is always uploaded if one is available so
+        that images larger than the budget are still processed.
+        \returns The number of bytes uploaded
+        */
+        std::size_t process(ImageDecoder&, TextureUploader&);
+
+        /*!
+        \brief Returns the number of decoded images waiting to be uploaded
+        */
+        std::size_t getPendingCount() const { return m_pending.size(); }
+
+    private:
+        std::size_t m_byteBudget;
+        float m_timeBudget;
+        std::deque<DecodedImage> m_pending;
+    };
+}
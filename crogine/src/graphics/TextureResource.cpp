@@ -1,6 +1,6 @@
 /*-----------------------------------------------------------------------
 
-Matt Marchant 2017 - 2020
+Matt Marchant 2017 - 2022
 http://trederia.blogspot.com
 
 crogine - Zlib license.
@@ -29,6 +29,12 @@ source distribution.
 
 #include <crogine/graphics/TextureResource.hpp>
 #include <crogine/graphics/Image.hpp>
+#include <crogine/core/FileSystem.hpp>
+
+#include "TextureLoader.hpp"
+#include "../detail/GLCheck.hpp"
+
+#include <cstring>
 
 using namespace cro;
 
@@ -37,12 +43,90 @@ namespace
     std::uint32_t fallbackID = std::numeric_limits<std::uint32_t>::max();
 }
 
+class TextureResource::GLUploader final : public Detail::TextureUploader
+{
+public:
+    explicit GLUploader(TextureResource& tr) : m_textureResource(&tr) {}
+
+    ~GLUploader()
+    {
+        if (m_pixelBuffer)
+        {
+            glCheck(glDeleteBuffers(1, &m_pixelBuffer));
+        }
+    }
+
+    GLUploader(const GLUploader&) = delete;
+    GLUploader& operator = (const GLUploader&) = delete;
+
+    void setTextureResource(TextureResource& tr) { m_textureResource = &tr; }
+
+    std::size_t upload(const Detail::DecodedImage& img) override
+    {
+        auto& textures = m_textureResource->m_textures;
+        if (!img.success || textures.count(img.id) == 0)
+        {
+            //leave the fallback texture in place
+            return 0;
+        }
+
+        auto& texture = *textures.at(img.id).second;
+        auto byteSize = TextureResource::uploadImage(texture, img.image, img.createMipMaps, m_pixelBuffer);
+        m_textureResource->m_tracker.setByteSize(img.id, TextureResource::getByteSize(texture));
+
+        return byteSize;
+    }
+
+private:
+    TextureResource* m_textureResource;
+    std::uint32_t m_pixelBuffer = 0;
+};
+
 TextureResource::TextureResource()
     : m_fallbackColour(Colour::Magenta)
 {
 
 }
 
+TextureResource::~TextureResource() = default;
+
+TextureResource::TextureResource(TextureResource&& other) noexcept
+    : m_textures        (std::move(other.m_textures)),
+    m_pathIDs           (std::move(other.m_pathIDs)),
+    m_fallbackTextures  (std::move(other.m_fallbackTextures)),
+    m_fallbackColour    (other.m_fallbackColour),
+    m_tracker           (std::move(other.m_tracker)),
+    m_decoder           (std::move(other.m_decoder)),
+    m_uploadQueue       (std::move(other.m_uploadQueue)),
+    m_uploader          (std::move(other.m_uploader))
+{
+    if (m_uploader)
+    {
+        m_uploader->setTextureResource(*this);
+    }
+}
+
+TextureResource& TextureResource::operator=(TextureResource&& other) noexcept
+{
+    if (this != &other)
+    {
+        m_textures = std::move(other.m_textures);
+        m_pathIDs = std::move(other.m_pathIDs);
+        m_fallbackTextures = std::move(other.m_fallbackTextures);
+        m_fallbackColour = other.m_fallbackColour;
+        m_tracker = std::move(other.m_tracker);
+        m_decoder = std::move(other.m_decoder);
+        m_uploadQueue = std::move(other.m_uploadQueue);
+        m_uploader = std::move(other.m_uploader);
+
+        if (m_uploader)
+        {
+            m_uploader->setTextureResource(*this);
+        }
+    }
+    return *this;
+}
+
 //public
 bool TextureResource::load(std::uint32_t id, const std::string& path, bool createMipMaps)
 {
@@ -54,7 +138,11 @@ bool TextureResource::load(std::uint32_t id, const std::string& path, bool creat
             //loadFromFile() should print error message
             return false;
         }
+        m_tracker.add(id, getByteSize(*tex));
         m_textures.insert(std::make_pair(id, std::make_pair(path, std::move(tex))));
+        m_pathIDs.insert(std::make_pair(path, id));
+
+        evict();
         return true;
     }
     else
@@ -68,57 +156,144 @@ bool TextureResource::load(std::uint32_t id, const std::string& path, bool creat
     return false;
 }
 
+bool TextureResource::loadAsync(std::uint32_t id, const std::string& path, bool createMipMaps)
+{
+    if (m_textures.count(id) != 0)
+    {
+        const auto& currentPath = m_textures.at(id).first;
+        LogI << "Texture ID " << id << " already assigned to " << currentPath << std::endl;
+        return path == currentPath;
+    }
+
+    //compressed images need no decoding so are loaded immediately
+    const auto ext = FileSystem::getFileExtension(path);
+    if (ext == ".dds" || ext == ".ktx2")
+    {
+        return load(id, path, createMipMaps);
+    }
+
+    if (!m_decoder)
+    {
+        m_decoder = std::make_unique<Detail::ImageDecoder>();
+        m_uploader = std::make_unique<GLUploader>(*this);
+    }
+
+    if (!m_uploadQueue)
+    {
+        m_uploadQueue = std::make_unique<Detail::UploadQueue>();
+    }
+
+    //the placeholder shares the GL handle with the final texture
+    Image img;
+    img.create(32, 32, m_fallbackColour);
+    std::unique_ptr<Texture> tex = std::make_unique<Texture>();
+    tex->loadFromImage(img);
+    m_tracker.add(id, getByteSize(*tex));
+    m_textures.insert(std::make_pair(id, std::make_pair(path, std::move(tex))));
+    m_pathIDs.insert(std::make_pair(path, id));
+
+    m_decoder->queue(id, path, createMipMaps);
+    return true;
+}
+
+std::size_t TextureResource::update()
+{
+    if (!m_decoder)
+    {
+        return 0;
+    }
+    auto byteSize = m_uploadQueue->process(*m_decoder, *m_uploader);
+    if (byteSize != 0)
+    {
+        evict();
+    }
+    return byteSize;
+}
+
+void TextureResource::setUploadBudget(std::size_t bytes, float seconds)
+{
+    if (!m_uploadQueue)
+    {
+        m_uploadQueue = std::make_unique<Detail::UploadQueue>();
+    }
+    m_uploadQueue->setByteBudget(bytes);
+    m_uploadQueue->setTimeBudget(seconds);
+}
+
+std::size_t TextureResource::getPendingCount() const
+{
+    std::size_t count = 0;
+    if (m_decoder)
+    {
+        count += m_decoder->getPendingCount();
+    }
+
+    if (m_uploadQueue)
+    {
+        count += m_uploadQueue->getPendingCount();
+    }
+    return count;
+}
+
 Texture& TextureResource::get(std::uint32_t id)
 {
     if (m_textures.count(id) == 0)
     {
-        //find the fallback
-        if (m_fallbackTextures.count(m_fallbackColour) == 0)
-        {
-            Image img;
-            img.create(32, 32, m_fallbackColour);
-            std::unique_ptr<Texture> fbTex = std::make_unique<Texture>();
-            fbTex->create(32, 32);
-            fbTex->update(img.getPixelData());
-
-            m_fallbackTextures.insert(std::make_pair(m_fallbackColour, std::move(fbTex)));
-        }
-        return *m_fallbackTextures.at(m_fallbackColour);
+        return getFallbackTexture();
     }
+    m_tracker.touch(id);
     return *m_textures.at(id).second;
 }
 
 Texture& TextureResource::get(const std::string& path, bool useMipMaps)
 {
-    auto result = std::find_if(m_textures.begin(), m_textures.end(), 
-        [&path](const auto& pair)
-        {
-            return pair.second.first == path;
-        });
+    if (auto result = m_pathIDs.find(path); result != m_pathIDs.end())
+    {
+        m_tracker.touch(result->second);
+        return *m_textures.at(result->second).second;
+    }
 
-    if (result == m_textures.end())
+    auto tex = std::make_unique<Texture>();
+    if (!tex->loadFromFile(path, useMipMaps))
     {
-        auto tex = std::make_unique<Texture>();
-        if (!tex->loadFromFile(path, useMipMaps))
-        {
-            if (m_fallbackTextures.count(m_fallbackColour) == 0)
-            {
-                Image img;
-                img.create(32, 32, m_fallbackColour);
-                std::unique_ptr<Texture> fbTex = std::make_unique<Texture>();
-                fbTex->create(32, 32);
-                fbTex->update(img.getPixelData());
-
-                m_fallbackTextures.insert(std::make_pair(m_fallbackColour, std::move(fbTex)));
-            }
-            return *m_fallbackTextures.at(m_fallbackColour);
-        }
+        return getFallbackTexture();
+    }
 
-        auto id = fallbackID--;
-        m_textures.insert(std::make_pair(id, std::make_pair(path, std::move(tex))));
-        return *m_textures.at(id).second;
+    auto id = fallbackID--;
+    m_tracker.add(id, getByteSize(*tex));
+    m_textures.insert(std::make_pair(id, std::make_pair(path, std::move(tex))));
+    m_pathIDs.insert(std::make_pair(path, id));
+
+    //don't evict until we've taken a reference to the new texture
+    auto& retVal = *m_textures.at(id).second;
+    evict();
+    return retVal;
+}
+
+bool TextureResource::acquire(std::uint32_t id)
+{
+    return m_tracker.acquire(id);
+}
+
+bool TextureResource::release(std::uint32_t id)
+{
+    if (m_tracker.release(id))
+    {
+        evict();
+        return true;
     }
-    return *result->second.second;
+    return false;
+}
+
+void TextureResource::setMemoryBudget(std::size_t bytes)
+{
+    m_tracker.setBudget(bytes);
+    evict();
+}
+
+ResourceStats TextureResource::getMemoryStats() const
+{
+    return m_tracker.getStats();
 }
 
 void TextureResource::setFallbackColour(Colour colour)
@@ -129,4 +304,150 @@ void TextureResource::setFallbackColour(Colour colour)
 Colour TextureResource::getFallbackColour() const
 {
     return m_fallbackColour;
-}
\ No newline at end of file
+}
+
+//private
+Texture& TextureResource::getFallbackTexture()
+{
+    if (m_fallbackTextures.count(m_fallbackColour) == 0)
+    {
+        Image img;
+        img.create(32, 32, m_fallbackColour);
+        std::unique_ptr<Texture> fbTex = std::make_unique<Texture>();
+        fbTex->create(32, 32);
+        fbTex->update(img.getPixelData());
+        m_fallbackTextures.insert(std::make_pair(m_fallbackColour, std::move(fbTex)));
+    }
+    return *m_fallbackTextures.at(m_fallbackColour);
+}
+
+void TextureResource::evict()
+{
+    const auto ids = m_tracker.collect();
+    for (auto id : ids)
+    {
+        const auto& path = m_textures.at(static_cast<std::uint32_t>(id)).first;
+        if (auto result = m_pathIDs.find(path); result != m_pathIDs.end()
+            && result->second == id)
+        {
+            m_pathIDs.erase(result);
+        }
+
+        //any images still being decoded for this ID are
+        //discarded by the uploader once they're ready
+        m_textures.erase(static_cast<std::uint32_t>(id));
+    }
+}
+
+std::size_t TextureResource::getByteSize(const Texture& texture)
+{
+    std::size_t pixelCount = texture.m_size.x * texture.m_size.y;
+    std::size_t byteSize = 0;
+
+    if (texture.m_compressed)
+    {
+        //BC1/ETC2 RGB use half a byte per pixel, other formats a full byte
+        byteSize = texture.m_format == ImageFormat::RGBA ? pixelCount : pixelCount / 2;
+    }
+    else
+    {
+        switch (texture.m_format)
+        {
+        default:
+        case ImageFormat::RGBA:
+            byteSize = pixelCount * 4;
+            break;
+        case ImageFormat::RGB:
+            byteSize = pixelCount * 3;
+            break;
+        case ImageFormat::A:
+            byteSize = pixelCount;
+            break;
+        }
+    }
+
+    //a full mip chain adds a third again
+    if (texture.m_hasMipMaps)
+    {
+        byteSize += byteSize / 3;
+    }
+    return byteSize;
+}
+
+std::size_t TextureResource::uploadImage(Texture& texture, const Image& image, bool createMipMaps, std::uint32_t& pixelBuffer)
+{
+    auto size = image.getSize();
+    auto maxSize = Texture::getMaxTextureSize();
+    if (size.x > maxSize || size.y > maxSize)
+    {
+        LogE << "Failed uploading texture: " << size.x << "x" << size.y << " is larger than the maximum texture size" << std::endl;
+        return 0;
+    }
+
+    GLint format = GL_RGBA;
+    std::size_t pixelSize = 4;
+    if (image.getFormat() == ImageFormat::RGB)
+    {
+        format = GL_RGB;
+        pixelSize = 3;
+    }
+    else if (image.getFormat() == ImageFormat::A)
+    {
+        format = GL_RED;
+        pixelSize = 1;
+    }
+    const std::size_t byteSize = size.x * size.y * pixelSize;
+
+    texture.m_size = size;
+    texture.m_format = image.getFormat();
+
+    glCheck(glBindTexture(GL_TEXTURE_2D, texture.m_handle));
+    if (texture.m_compressed)
+    {
+        glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000));
+        texture.m_compressed = false;
+    }
+
+#ifdef PLATFORM_DESKTOP
+    //copying into a pixel buffer lets the driver transfer
+    //the data to the GPU without stalling the main thread
+    if (pixelBuffer == 0)
+    {
+        glCheck(glGenBuffers(1, &pixelBuffer));
+    }
+    glCheck(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer));
+
+    //orphan the previous storage so we don't wait on the previous upload
+    glCheck(glBufferData(GL_PIXEL_UNPACK_BUFFER, byteSize, nullptr, GL_STREAM_DRAW));
+
+    void* dst = nullptr;
+    glCheck(dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, byteSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    if (dst)
+    {
+        std::memcpy(dst, image.getPixelData(), byteSize);
+        glCheck(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+        glCheck(glTexImage2D(GL_TEXTURE_2D, 0, format, size.x, size.y, 0, format, GL_UNSIGNED_BYTE, nullptr));
+        glCheck(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+    }
+    else
+    {
+        glCheck(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+        glCheck(glTexImage2D(GL_TEXTURE_2D, 0, format, size.x, size.y, 0, format, GL_UNSIGNED_BYTE, image.getPixelData()));
+    }
+#else
+    glCheck(glTexImage2D(GL_TEXTURE_2D, 0, format, size.x, size.y, 0, format, GL_UNSIGNED_BYTE, image.getPixelData()));
+#endif
+
+    if (createMipMaps)
+    {
+        texture.generateMipMaps();
+    }
+    else
+    {
+        glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texture.m_smooth ? GL_LINEAR : GL_NEAREST));
+        texture.m_hasMipMaps = false;
+    }
+    glCheck(glBindTexture(GL_TEXTURE_2D, 0));
+
+    return byteSize;
+}
@@ -32,6 +32,7 @@ source distribution.
 #include <crogine/graphics/MeshData.hpp>
 #include <crogine/graphics/Texture.hpp>
 #include <crogine/graphics/RenderTarget.hpp>
+#include <crogine/graphics/RenderTexture.hpp>
 
 #include "../../detail/GLCheck.hpp"
 
@@ -83,6 +84,11 @@ void PostProcess::resizeBuffer(std::int32_t w, std::int32_t h)
 
 //protected
 void PostProcess::drawQuad(std::size_t passIndex, FloatRect size)
+{
+    drawQuad(passIndex, size, RenderTarget::getActiveTarget()->getDefaultViewport());
+}
+
+void PostProcess::drawQuad(std::size_t passIndex, FloatRect size, IntRect vp)
 {
     CRO_ASSERT(m_vbo, "VBO not created!");
     
@@ -97,7 +103,6 @@ void PostProcess::drawQuad(std::size_t passIndex, FloatRect size)
     glCheck(glUniformMatrix4fv(uniforms.find("u_worldMatrix")->second, 1, GL_FALSE, glm::value_ptr(m_transform)));
     glCheck(glUniformMatrix4fv(uniforms.find("u_projectionMatrix")->second, 1, GL_FALSE, glm::value_ptr(m_projection)));
 
-    auto vp = RenderTarget::getActiveTarget()->getDefaultViewport();
     glViewport(vp.left, vp.bottom, vp.width, vp.height);
 
     //bind any textures / apply misc uniforms
@@ -251,6 +256,23 @@ std::size_t PostProcess::addPass(const Shader& shader)
     return m_passes.size() - 1;
 }
 
+std::size_t PostProcess::addTarget(glm::vec2 scale, bool depthBuffer)
+{
+    CRO_ASSERT(scale.x > 0 && scale.y > 0, "Target scale must be greater than zero");
+
+    auto& target = m_targets.emplace_back();
+    target.scale = scale;
+    target.depthBuffer = depthBuffer;
+    return m_targets.size() - 1;
+}
+
+RenderTexture& PostProcess::getTarget(std::size_t index) const
+{
+    CRO_ASSERT(index < m_targets.size(), "Target index out of range");
+    CRO_ASSERT(m_targets[index].texture, "Target not yet allocated - has this effect been added to a Scene?");
+    return *m_targets[index].texture;
+}
+
 //private
 void PostProcess::createVBO()
 {
@@ -32,6 +32,7 @@ source distribution.
 #include <crogine/graphics/postprocess/PostSSAO.hpp>
 #include <crogine/graphics/postprocess/PostVertex.hpp>
 #include <crogine/graphics/MultiRenderTexture.hpp>
+#include <crogine/graphics/RenderTexture.hpp>
 
 #include "../../detail/GLCheck.hpp"
 #include <crogine/detail/glm/gtx/compatibility.hpp>
@@ -44,19 +45,51 @@ namespace
 {
 #include "PostSSAO.inl"
 
-    constexpr std::int32_t KernelSize = 32;
     constexpr std::size_t NoiseSize = 16;
+
+    //g-buffer channels containing view space normals and positions
+    constexpr std::size_t GBufferNormal = 0;
+    constexpr std::size_t GBufferPosition = 1;
+
+    //number of frames over which the kernel is
+    //spread when temporal accumulation is enabled
+    constexpr std::int32_t TemporalFrames = 4;
+    constexpr float TemporalBlend = 1.f / TemporalFrames;
+
+    //offsets the noise texture each frame so that
+    //every pixel also uses a different rotation
+    constexpr std::array<glm::vec2, TemporalFrames> NoiseOffsets =
+    {
+        glm::vec2(0.f), glm::vec2(0.5f, 0.25f), glm::vec2(0.25f, 0.5f), glm::vec2(0.75f)
+    };
+
+    template <std::size_t N>
+    void findUniforms(const Shader& shader, const std::array<const char*, N>& names, std::array<std::int32_t, N>& dst)
+    {
+        const auto& uniforms = shader.getUniformMap();
+        for (auto i = 0u; i < N; ++i)
+        {
+            if (uniforms.count(names[i]))
+            {
+                dst[i] = uniforms.at(names[i]);
+            }
+        }
+    }
 }
 
 PostSSAO::PostSSAO(const MultiRenderTexture& mrt)
     : m_mrt         (mrt),
     m_noiseTexture  (0),
-    m_ssaoTexture   (0),
-    m_blurTexture   (0),
-    m_ssaoFBO       (0),
-    m_blurFBO       (0),
     m_intensity     (0.5f),
-    m_bias          (0.001f)
+    m_bias          (0.001f),
+    m_resolution    (Resolution::Full),
+    m_sampleCount   (32),
+    m_temporalEnabled(false),
+    m_frameIndex    (0),
+    m_historyIndex  (0),
+    m_historyValid  (false),
+    m_previousViewMatrix        (1.f),
+    m_previousProjectionMatrix  (1.f)
 {
 #ifdef PLATFORM_DESKTOP
     //create noise texture/samples
@@ -66,86 +99,43 @@ PostSSAO::PostSSAO(const MultiRenderTexture& mrt)
     std::fill(m_ssaoUniforms.begin(), m_ssaoUniforms.end(), -1);
     if (m_ssaoShader.loadFromString(PostVertex, SSAOFrag))
     {
-        //parse uniforms
-        const auto& uniforms = m_ssaoShader.getUniformMap();
-        if (uniforms.count("u_position"))
-        {
-            m_ssaoUniforms[SSAOUniformID::Position] = uniforms.at("u_position");
-        }
-
-        if (uniforms.count("u_normal"))
-        {
-            m_ssaoUniforms[SSAOUniformID::Normal] = uniforms.at("u_normal");
-        }
-
-        if (uniforms.count("u_noise"))
-        {
-            m_ssaoUniforms[SSAOUniformID::Noise] = uniforms.at("u_noise");
-        }
-
-        if (uniforms.count("u_samples[0]"))
-        {
-            m_ssaoUniforms[SSAOUniformID::Samples] = uniforms.at("u_samples[0]");
-        }
-
-        if (uniforms.count("u_camProjectionMatrix"))
-        {
-            m_ssaoUniforms[SSAOUniformID::ProjectionMatrix] = uniforms.at("u_camProjectionMatrix");
-        }
-
-        if (uniforms.count("u_bufferSize"))
-        {
-            m_ssaoUniforms[SSAOUniformID::BufferSize] = uniforms.at("u_bufferSize");
-        }
-
-        if (uniforms.count("u_bufferViewport"))
-        {
-            m_ssaoUniforms[SSAOUniformID::BufferViewport] = uniforms.at("u_bufferViewport");
-        }
-
-        if (uniforms.count("u_bias"))
-        {
-            m_ssaoUniforms[SSAOUniformID::Bias] = uniforms.at("u_bias");
-        }
+        findUniforms<SSAOUniformID::Count>(m_ssaoShader,
+            {
+                "u_position", "u_normal", "u_noise",
+                "u_samples[0]", "u_sampleCount", "u_sampleOffset",
+                "u_noiseOffset", "u_camProjectionMatrix",
+                "u_bufferSize", "u_bufferViewport",
+                "u_bias", "u_intensity"
+            }, m_ssaoUniforms);
+    }
 
-        if (uniforms.count("u_intensity"))
-        {
-            m_ssaoUniforms[SSAOUniformID::Intensity] = uniforms.at("u_intensity");
-        }
+    std::fill(m_temporalUniforms.begin(), m_temporalUniforms.end(), -1);
+    if (m_temporalShader.loadFromString(PostVertex, TemporalFrag))
+    {
+        findUniforms<TemporalUniformID::Count>(m_temporalShader,
+            {
+                "u_position", "u_current", "u_history",
+                "u_reprojectionMatrix", "u_camProjectionMatrix",
+                "u_bufferViewport", "u_blend", "u_historyValid"
+            }, m_temporalUniforms);
     }
 
     std::fill(m_blurUniforms.begin(), m_blurUniforms.end(), -1);
     if (m_blurShader.loadFromString(PostVertex, BlurFrag2))
     {
-        const auto& uniforms = m_blurShader.getUniformMap();
-        if (uniforms.count("u_texture"))
-        {
-            m_blurUniforms[BlurUniformID::Texture] = uniforms.at("u_texture");
-        }
-
-        if (uniforms.count("u_bufferSize"))
-        {
-            m_blurUniforms[BlurUniformID::BufferSize] = uniforms.at("u_bufferSize");
-        }
+        findUniforms<BlurUniformID::Count>(m_blurShader, { "u_texture", "u_bufferSize" }, m_blurUniforms);
     }
 
     std::fill(m_blendUniforms.begin(), m_blendUniforms.end(), -1);
     if (m_blendShader.loadFromString(PostVertex, BlendFrag))
     {
-        const auto& uniforms = m_blendShader.getUniformMap();
-        if (uniforms.count("u_baseTexture"))
-        {
-            m_blendUniforms[BlendUniformID::Base] = uniforms.at("u_baseTexture");
-        }
-
-        if (uniforms.count("u_ssaoTexture"))
-        {
-            m_blendUniforms[BlendUniformID::SSAO] = uniforms.at("u_ssaoTexture");
-        }
+        findUniforms<BlendUniformID::Count>(m_blendShader,
+            { "u_baseTexture", "u_ssaoTexture", "u_position", "u_ssaoSize" }, m_blendUniforms);
     }
 
     //add passes
     m_passIDs[PassID::SSAO] = addPass(m_ssaoShader);
+    m_passIDs[PassID::Temporal] = addPass(m_temporalShader);
     m_passIDs[PassID::Blur] = addPass(m_blurShader);
     m_passIDs[PassID::Final] = addPass(m_blendShader);
 #endif
@@ -160,32 +150,46 @@ PostSSAO::~PostSSAO()
         glCheck(glDeleteTextures(1, &m_noiseTexture));
     }
 
-    if (m_ssaoFBO)
+    for (auto& buffer : m_buffers)
     {
-        glCheck(glDeleteFramebuffers(1, &m_ssaoFBO));
-        glCheck(glDeleteTextures(1, &m_ssaoTexture));
-    }
-
-    if (m_blurTexture)
-    {
-        glCheck(glDeleteFramebuffers(1, &m_blurFBO));
-        glCheck(glDeleteTextures(1, &m_blurTexture));
+        if (buffer.fbo)
+        {
+            glCheck(glDeleteFramebuffers(1, &buffer.fbo));
+            glCheck(glDeleteTextures(1, &buffer.texture));
+        }
     }
 
 #endif
 }
 
 //public
-void PostSSAO::apply(const RenderTexture& source, const Camera& camera)
+void PostSSAO::apply(const RenderTexture& source)
 {
 #ifdef PLATFORM_DESKTOP
+    if (!m_camera.isValid()
+        || !m_camera.hasComponent<Camera>())
+    {
+        LogW << "PostSSAO: no camera set, effect was not applied" << std::endl;
+        return;
+    }
+
+    const auto& camera = m_camera.getComponent<Camera>();
+    const auto& viewMatrix = camera.getPass(Camera::Pass::Final).viewMatrix;
+    const auto& projectionMatrix = camera.getProjectionMatrix();
+
+    //when accumulating each frame uses the next subset of
+    //the kernel, and a different rotation of the noise
+    const auto temporalFrame = m_temporalEnabled ? static_cast<std::int32_t>(m_frameIndex % TemporalFrames) : 0;
+    const auto sampleOffset = (temporalFrame * m_sampleCount) % MaxSamples;
+    m_frameIndex++;
+
     //-----SSAO Pass-----//
     
     glCheck(glActiveTexture(GL_TEXTURE0));
-    glCheck(glBindTexture(GL_TEXTURE_2D, m_mrt.getTexture(0).textureID));
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_mrt.getTexture(GBufferNormal).textureID));
     
     glCheck(glActiveTexture(GL_TEXTURE1));
-    glCheck(glBindTexture(GL_TEXTURE_2D, m_mrt.getTexture(1).textureID));
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_mrt.getTexture(GBufferPosition).textureID));
 
     glCheck(glActiveTexture(GL_TEXTURE2));
     glCheck(glBindTexture(GL_TEXTURE_2D, m_noiseTexture));
@@ -196,41 +200,85 @@ void PostSSAO::apply(const RenderTexture& source, const Camera& camera)
     glCheck(glUniform1i(m_ssaoUniforms[SSAOUniformID::Normal], 0));
     glCheck(glUniform1i(m_ssaoUniforms[SSAOUniformID::Position], 1));
     glCheck(glUniform1i(m_ssaoUniforms[SSAOUniformID::Noise], 2));
-    glCheck(glUniform3fv(m_ssaoUniforms[SSAOUniformID::Samples], KernelSize, glm::value_ptr(m_kernel[0])));
+    glCheck(glUniform3fv(m_ssaoUniforms[SSAOUniformID::Samples], static_cast<GLsizei>(m_kernel.size()), glm::value_ptr(m_kernel[0])));
+    glCheck(glUniform1i(m_ssaoUniforms[SSAOUniformID::SampleCount], m_sampleCount));
+    glCheck(glUniform1i(m_ssaoUniforms[SSAOUniformID::SampleOffset], sampleOffset));
+    glCheck(glUniform2f(m_ssaoUniforms[SSAOUniformID::NoiseOffset], NoiseOffsets[temporalFrame].x, NoiseOffsets[temporalFrame].y));
     glCheck(glUniform2f(m_ssaoUniforms[SSAOUniformID::BufferSize], m_bufferSize.x, m_bufferSize.y));
     glCheck(glUniform4f(m_ssaoUniforms[SSAOUniformID::BufferViewport], camera.viewport.left, camera.viewport.bottom, camera.viewport.width,camera.viewport.height));
-    glCheck(glUniformMatrix4fv(m_ssaoUniforms[SSAOUniformID::ProjectionMatrix], 1, GL_FALSE, &camera.getProjectionMatrix()[0][0]));
+    glCheck(glUniformMatrix4fv(m_ssaoUniforms[SSAOUniformID::ProjectionMatrix], 1, GL_FALSE, &projectionMatrix[0][0]));
     glCheck(glUniform1f(m_ssaoUniforms[SSAOUniformID::Bias], m_bias));
     glCheck(glUniform1f(m_ssaoUniforms[SSAOUniformID::Intensity], m_intensity));
 
     //activate ssao fbo
     GLint currentBinding = 0;
     glCheck(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &currentBinding));
-    glCheck(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_ssaoFBO));
+    glCheck(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_buffers[BufferID::SSAO].fbo));
     glClear(GL_COLOR_BUFFER_BIT);
 
     std::array<std::int32_t, 4u> lastViewport;
     glCheck(glGetIntegerv(GL_VIEWPORT, lastViewport.data()));
 
-    glCheck(glViewport(0, 0, static_cast<std::int32_t>(m_bufferSize.x), static_cast<std::int32_t>(m_bufferSize.y)));
+    //the buffers may be smaller than the active target, so use their own viewport
+    const IntRect bufferViewport(0, 0, static_cast<std::int32_t>(m_bufferSize.x), static_cast<std::int32_t>(m_bufferSize.y));
 
     //render associated pass
-    drawQuad(m_passIDs[PassID::SSAO], { glm::vec2(0.f), m_bufferSize });
+    drawQuad(m_passIDs[PassID::SSAO], { glm::vec2(0.f), m_bufferSize }, bufferViewport);
+
+
+    //-----temporal pass-----//
+    auto blurInput = m_buffers[BufferID::SSAO].texture;
+    if (m_temporalEnabled)
+    {
+        const auto& previous = m_buffers[BufferID::HistoryA + m_historyIndex];
+        m_historyIndex = (m_historyIndex + 1) % 2;
+        const auto& current = m_buffers[BufferID::HistoryA + m_historyIndex];
+
+        const auto reprojection = m_previousViewMatrix * glm::inverse(viewMatrix);
+
+        glCheck(glActiveTexture(GL_TEXTURE0));
+        glCheck(glBindTexture(GL_TEXTURE_2D, m_mrt.getTexture(GBufferPosition).textureID));
+
+        glCheck(glActiveTexture(GL_TEXTURE1));
+        glCheck(glBindTexture(GL_TEXTURE_2D, m_buffers[BufferID::SSAO].texture));
+
+        glCheck(glActiveTexture(GL_TEXTURE2));
+        glCheck(glBindTexture(GL_TEXTURE_2D, previous.texture));
+
+        glCheck(glUseProgram(m_temporalShader.getGLHandle()));
+        glCheck(glUniform1i(m_temporalUniforms[TemporalUniformID::Position], 0));
+        glCheck(glUniform1i(m_temporalUniforms[TemporalUniformID::Current], 1));
+        glCheck(glUniform1i(m_temporalUniforms[TemporalUniformID::History], 2));
+        glCheck(glUniformMatrix4fv(m_temporalUniforms[TemporalUniformID::ReprojectionMatrix], 1, GL_FALSE, &reprojection[0][0]));
+        glCheck(glUniformMatrix4fv(m_temporalUniforms[TemporalUniformID::ProjectionMatrix], 1, GL_FALSE, &m_previousProjectionMatrix[0][0]));
+        glCheck(glUniform4f(m_temporalUniforms[TemporalUniformID::BufferViewport], camera.viewport.left, camera.viewport.bottom, camera.viewport.width, camera.viewport.height));
+        glCheck(glUniform1f(m_temporalUniforms[TemporalUniformID::Blend], TemporalBlend));
+        glCheck(glUniform1f(m_temporalUniforms[TemporalUniformID::HistoryValid], m_historyValid ? 1.f : 0.f));
+
+        glCheck(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, current.fbo));
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        drawQuad(m_passIDs[PassID::Temporal], { glm::vec2(0.f), m_bufferSize }, bufferViewport);
+
+        blurInput = current.texture;
+        m_historyValid = true;
+    }
+    m_previousViewMatrix = viewMatrix;
+    m_previousProjectionMatrix = projectionMatrix;
 
 
     //-----blur pass-----//
     glCheck(glActiveTexture(GL_TEXTURE0));
-    glCheck(glBindTexture(GL_TEXTURE_2D, m_ssaoTexture));
+    glCheck(glBindTexture(GL_TEXTURE_2D, blurInput));
 
     glCheck(glUseProgram(m_blurShader.getGLHandle()));
     glCheck(glUniform1i(m_blurUniforms[BlurUniformID::Texture], 0));
     glCheck(glUniform2f(m_blurUniforms[BlurUniformID::BufferSize], m_bufferSize.x, m_bufferSize.y));
     
-    //TODO if we resize this make sure to update the viewport
-    glCheck(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_blurFBO));
+    glCheck(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_buffers[BufferID::Blur].fbo));
     glClear(GL_COLOR_BUFFER_BIT);
 
-    drawQuad(m_passIDs[PassID::Blur], { glm::vec2(0.f), m_bufferSize });
+    drawQuad(m_passIDs[PassID::Blur], { glm::vec2(0.f), m_bufferSize }, bufferViewport);
 
 
     //-----final pass------//
@@ -238,11 +286,16 @@ void PostSSAO::apply(const RenderTexture& source, const Camera& camera)
     glCheck(glBindTexture(GL_TEXTURE_2D, source.getTexture().getGLHandle()));
 
     glCheck(glActiveTexture(GL_TEXTURE1));
-    glCheck(glBindTexture(GL_TEXTURE_2D, m_blurTexture));
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_buffers[BufferID::Blur].texture));
+
+    glCheck(glActiveTexture(GL_TEXTURE2));
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_mrt.getTexture(GBufferPosition).textureID));
 
     glCheck(glUseProgram(m_blendShader.getGLHandle()));
     glCheck(glUniform1i(m_blendUniforms[BlendUniformID::Base], 0));
     glCheck(glUniform1i(m_blendUniforms[BlendUniformID::SSAO], 1));
+    glCheck(glUniform1i(m_blendUniforms[BlendUniformID::Position], 2));
+    glCheck(glUniform2f(m_blendUniforms[BlendUniformID::SSAOSize], m_bufferSize.x, m_bufferSize.y));
 
 
     //activate original buffer
@@ -250,11 +303,22 @@ void PostSSAO::apply(const RenderTexture& source, const Camera& camera)
     glCheck(glViewport(lastViewport[0], lastViewport[1], lastViewport[2], lastViewport[3]));
 
     //render final pass
-    drawQuad(m_passIDs[PassID::Final], { glm::vec2(0.f), glm::vec2(App::getWindow().getSize()) });
+    drawQuad(m_passIDs[PassID::Final], { glm::vec2(0.f), glm::vec2(getCurrentBufferSize()) });
 
 #endif
 }
 
+void PostSSAO::setCamera(Entity camera)
+{
+    CRO_ASSERT(camera.hasComponent<Camera>(), "Entity has no Camera component");
+    if (camera != m_camera
+        || camera.getGeneration() != m_camera.getGeneration())
+    {
+        m_camera = camera;
+        m_historyValid = false;
+    }
+}
+
 void PostSSAO::setIntensity(float amount)
 {
     m_intensity = std::min(5.f, std::max(0.1f, amount));
@@ -265,12 +329,63 @@ void PostSSAO::setBias(float amount)
     m_bias = std::min(0.1f, std::max(0.001f, amount));
 }
 
+void PostSSAO::setQuality(Quality quality)
+{
+    switch (quality)
+    {
+    default:
+    case Quality::High:
+        setResolution(Resolution::Full);
+        setSampleCount(32);
+        setTemporalEnabled(false);
+        break;
+    case Quality::Medium:
+        setResolution(Resolution::Half);
+        setSampleCount(16);
+        setTemporalEnabled(true);
+        break;
+    case Quality::Low:
+        setResolution(Resolution::Quarter);
+        setSampleCount(8);
+        setTemporalEnabled(true);
+        break;
+    }
+}
+
+void PostSSAO::setResolution(Resolution resolution)
+{
+    if (resolution != m_resolution)
+    {
+        m_resolution = resolution;
+#ifdef PLATFORM_DESKTOP
+        createBuffers();
+#endif
+    }
+}
+
+void PostSSAO::setSampleCount(std::int32_t count)
+{
+    m_sampleCount = std::min(MaxSamples, std::max(4, count));
+}
+
+void PostSSAO::setTemporalEnabled(bool enabled)
+{
+    if (enabled != m_temporalEnabled)
+    {
+        m_temporalEnabled = enabled;
+        m_historyValid = false;
+#ifdef PLATFORM_DESKTOP
+        createBuffers();
+#endif
+    }
+}
+
 //private
 void PostSSAO::createNoiseSampler()
 {
     constexpr glm::vec3 normal(0.f, 0.f, 1.f);
-    constexpr std::int32_t MaxTries = KernelSize * 4;
-    for (auto i = 0, j = 0; i < KernelSize && j < MaxTries; ++j)
+    constexpr std::int32_t MaxTries = MaxSamples * 4;
+    for (auto i = 0, j = 0; i < MaxSamples && j < MaxTries; ++j)
     {
         auto sample = glm::vec3(
             cro::Util::Random::value(-1.f, 1.f),
@@ -284,7 +399,7 @@ void PostSSAO::createNoiseSampler()
         {
             sample *= cro::Util::Random::value(0.f, 1.f);
 
-            float scale = static_cast<float>(i) / KernelSize;
+            float scale = static_cast<float>(i) / MaxSamples;
             scale = glm::lerp(0.1f, 1.f, scale * scale);
             sample *= scale;
 
@@ -293,6 +408,19 @@ void PostSSAO::createNoiseSampler()
         }
     }
 
+    //samples are distributed from the centre outwards, so interleave
+    //them to make sure any contiguous subset covers the whole radius
+    //(for example the sample count taken each frame when accumulating)
+    std::vector<glm::vec3> interleaved;
+    for (auto stride = 0u; stride < TemporalFrames; ++stride)
+    {
+        for (auto i = stride; i < m_kernel.size(); i += TemporalFrames)
+        {
+            interleaved.push_back(m_kernel[i]);
+        }
+    }
+    m_kernel.swap(interleaved);
+
     std::vector<glm::vec3> noise;
     for (auto i = 0u; i < NoiseSize; ++i)
     {
@@ -311,47 +439,76 @@ void PostSSAO::createNoiseSampler()
     glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
 }
 
-void PostSSAO::bufferResized()
+void PostSSAO::createBuffers()
 {
     auto size = getCurrentBufferSize();
+    if (size.x == 0 || size.y == 0)
+    {
+        //not yet added to a scene
+        return;
+    }
 
-    //TODO reduce size? Looks pretty awful, could make this a
-    //performance preference
-
-    //create SSAO buffer
-    if (m_ssaoFBO == 0)
+    switch (m_resolution)
     {
-        glCheck(glGenFramebuffers(1, &m_ssaoFBO));
-        glCheck(glBindFramebuffer(GL_FRAMEBUFFER, m_ssaoFBO));
+    default: break;
+    case Resolution::Half:
+        size /= 2u;
+        break;
+    case Resolution::Quarter:
+        size /= 4u;
+        break;
+    }
+    size = glm::max(size, glm::uvec2(1u));
 
-        glCheck(glGenTextures(1, &m_ssaoTexture));
-        glCheck(glBindTexture(GL_TEXTURE_2D, m_ssaoTexture));
-        glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-        glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    //history is only needed when accumulating
+    const std::size_t bufferCount = m_temporalEnabled ? BufferID::Count : BufferID::HistoryA;
 
-        glCheck(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_ssaoTexture, 0));
-    }
+    for (auto i = 0u; i < BufferID::Count; ++i)
+    {
+        auto& buffer = m_buffers[i];
+        if (i >= bufferCount)
+        {
+            if (buffer.fbo)
+            {
+                glCheck(glDeleteFramebuffers(1, &buffer.fbo));
+                glCheck(glDeleteTextures(1, &buffer.texture));
+                buffer = {};
+            }
+            continue;
+        }
 
-    glCheck(glBindTexture(GL_TEXTURE_2D, m_ssaoTexture));
-    glCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, size.x, size.y, 0, GL_RED, GL_FLOAT, nullptr));
+        if (buffer.fbo == 0)
+        {
+            glCheck(glGenFramebuffers(1, &buffer.fbo));
+            glCheck(glBindFramebuffer(GL_FRAMEBUFFER, buffer.fbo));
 
+            //the upsample filter reads exact texels, the reprojection
+            //reads between them so history is filtered
+            const GLint filter = i < BufferID::HistoryA ? GL_NEAREST : GL_LINEAR;
 
-    //create blur buffer
-    if (m_blurFBO == 0)
-    {
-        glCheck(glGenFramebuffers(1, &m_blurFBO));
-        glCheck(glBindFramebuffer(GL_FRAMEBUFFER, m_blurFBO));
+            glCheck(glGenTextures(1, &buffer.texture));
+            glCheck(glBindTexture(GL_TEXTURE_2D, buffer.texture));
+            glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter));
+            glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter));
+            glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+            glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
 
-        glCheck(glGenTextures(1, &m_blurTexture));
-        glCheck(glBindTexture(GL_TEXTURE_2D, m_blurTexture));
-        glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-        glCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+            glCheck(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, buffer.texture, 0));
+        }
 
-        glCheck(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_blurTexture, 0));
+        //occlusion in R, view space depth in G
+        glCheck(glBindTexture(GL_TEXTURE_2D, buffer.texture));
+        glCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16F, size.x, size.y, 0, GL_RG, GL_FLOAT, nullptr));
     }
-
-    glCheck(glBindTexture(GL_TEXTURE_2D, m_blurTexture));
-    glCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, size.x, size.y, 0, GL_RED, GL_FLOAT, nullptr));
+    glCheck(glBindFramebuffer(GL_FRAMEBUFFER, 0));
 
     m_bufferSize = size;
+    m_historyValid = false;
+}
+
+void PostSSAO::bufferResized()
+{
+#ifdef PLATFORM_DESKTOP
+    createBuffers();
+#endif
 }
\ No newline at end of file
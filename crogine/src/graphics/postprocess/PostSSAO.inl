@@ -35,13 +35,16 @@ static const std::string SSAOFrag =
 R"(
     OUTPUT
     
-    #define KERNEL_SIZE 32
+    #define MAX_SAMPLES 64
 
     uniform sampler2D u_position;
     uniform sampler2D u_normal;
     uniform sampler2D u_noise;
 
-    uniform vec3 u_samples[KERNEL_SIZE];
+    uniform vec3 u_samples[MAX_SAMPLES];
+    uniform int u_sampleCount = 32;
+    uniform int u_sampleOffset = 0;
+    uniform vec2 u_noiseOffset = vec2(0.0);
     uniform mat4 u_camProjectionMatrix;
 
     uniform vec2 u_bufferSize;
@@ -60,7 +63,7 @@ R"(
 
         vec3 position = TEXTURE(u_position, v_texCoord).rgb;
         vec3 normal = normalize(TEXTURE(u_normal, v_texCoord).rgb);
-        vec3 randomOffset = normalize(TEXTURE(u_noise, v_texCoord * noiseScale).rgb);
+        vec3 randomOffset = normalize(TEXTURE(u_noise, v_texCoord * noiseScale + u_noiseOffset).rgb);
 
         vec3 tan = normalize(randomOffset - normal * dot(randomOffset, normal));
         vec3 bitan = cross(normal, tan);
@@ -68,9 +71,10 @@ R"(
 
         const float radius = 0.6;
         float occlusion = 0.0;
-        for(int i = 0; i < KERNEL_SIZE; ++i)
+        for(int i = 0; i < u_sampleCount; ++i)
         {
-            vec3 samplePos = tbn * u_samples[i];
+            //the offset selects a different subset of the kernel each frame when accumulating
+            vec3 samplePos = tbn * u_samples[(i + u_sampleOffset) % MAX_SAMPLES];
             samplePos = position + samplePos * radius;
 
             vec4 offset = vec4(samplePos, 1.0);
@@ -86,13 +90,55 @@ R"(
             occlusion += (depth >= samplePos.z + u_bias ? 1.0 : 0.0) * range;
         }
 
-        occlusion = 1.f - (occlusion / KERNEL_SIZE);
+        occlusion = 1.0 - (occlusion / float(u_sampleCount));
         occlusion = pow(occlusion, u_intensity);
 
-        FRAG_OUT.r = occlusion;
+        //depth is stored for reprojection and upsampling
+        FRAG_OUT = vec4(occlusion, position.z, 0.0, 1.0);
     }
 )";
 
+//blends the current occlusion with the previous frames' reprojected result
+static const std::string TemporalFrag =
+R"(
+    OUTPUT
+
+    uniform sampler2D u_position;
+    uniform sampler2D u_current;
+    uniform sampler2D u_history;
+
+    uniform mat4 u_reprojectionMatrix; //current view space to previous view space
+    uniform mat4 u_camProjectionMatrix; //previous projection
+    uniform vec4 u_bufferViewport;
+
+    uniform float u_blend = 0.25;
+    uniform float u_historyValid = 0.0;
+
+    VARYING_IN vec2 v_texCoord;
+
+    const float DepthTolerance = 0.05;
+
+    void main()
+    {
+        vec2 current = TEXTURE(u_current, v_texCoord).rg;
+
+        vec4 previousPosition = u_reprojectionMatrix * vec4(TEXTURE(u_position, v_texCoord).rgb, 1.0);
+        vec4 clipPosition = u_camProjectionMatrix * previousPosition;
+        vec2 uv = (clipPosition.xy / clipPosition.w) * 0.5 + 0.5;
+        uv = uv * u_bufferViewport.zw + u_bufferViewport.xy;
+
+        vec2 history = TEXTURE(u_history, uv).rg;
+
+        //reject history which was off screen or belongs to a different surface
+        float valid = u_historyValid
+            * step(0.0, uv.x) * step(uv.x, 1.0)
+            * step(0.0, uv.y) * step(uv.y, 1.0)
+            * step(abs(history.g - previousPosition.z), DepthTolerance * abs(previousPosition.z) + 0.01);
+
+        float occlusion = mix(current.r, mix(history.r, current.r, u_blend), valid);
+        FRAG_OUT = vec4(occlusion, current.g, 0.0, 1.0);
+    }
+)";
 
 static const std::string BlurFrag =
 R"(
@@ -132,7 +178,6 @@ R"(
 
     const int MAX_SIZE = 5;
     const int MAX_KERNEL_SIZE = ((MAX_SIZE * 2 + 1) * (MAX_SIZE * 2 + 1));
-    const vec3 ratio = vec3(0.3, 0.59, 0.11);
 
     vec4 mean = vec4(0.0);
     float variance = 0.0;
@@ -151,13 +196,13 @@ R"(
                 vec4 colour = TEXTURE(u_texture, (gl_FragCoord.xy + vec2(i, j)) / u_bufferSize);
                 temp += colour;
 
-                values[count] = dot(colour.rgb, ratio);
+                values[count] = colour.r;
                 count++;
             }
         }
 
-        temp.rgb /= count;
-        float meanValue = dot(temp.rgb, ratio);
+        temp.r /= count;
+        float meanValue = temp.r;
 
         float variance = 0.0;
         for(int i = 0; i < count; ++i)
@@ -183,7 +228,9 @@ R"(
         findMean(-size, 0, 0, size);
         findMean(0, size, -size, 0);
 
-        FRAG_OUT = vec4(mean.rgb, 1.0);
+        //only the occlusion is filtered, depth is kept for upsampling
+        float depth = TEXTURE(u_texture, gl_FragCoord.xy / u_bufferSize).g;
+        FRAG_OUT = vec4(mean.r, depth, 0.0, 1.0);
     }
 )";
 
@@ -194,16 +241,43 @@ R"(
 
     uniform sampler2D u_baseTexture;
     uniform sampler2D u_ssaoTexture;
+    uniform sampler2D u_position;
+    uniform vec2 u_ssaoSize;
 
     VARYING_IN vec2 v_texCoord;
 
+    const float DepthEpsilon = 0.001;
+
     void main()
     {
-        float ao = TEXTURE(u_ssaoTexture, v_texCoord).r;
-        vec3 baseColour = TEXTURE(u_baseTexture, v_texCoord).rgb;
+        //depth aware upsample - the four nearest occlusion samples are weighted
+        //by both their bilinear weight and how closely their depth matches this
+        //fragment, so occlusion doesn't bleed across edges. At full resolution
+        //this returns the sample under the fragment.
+        float depth = TEXTURE(u_position, v_texCoord).z;
+        vec2 ssaoCoord = v_texCoord * u_ssaoSize - 0.5;
+        vec2 base = floor(ssaoCoord);
+        vec2 fraction = ssaoCoord - base;
 
-        //FRAG_OUT = mix(vec4(baseColour, 1.0), vec4(baseColour * ao, 1.0), step(v_texCoord.x, 0.5));
-        FRAG_OUT = mix(vec4(baseColour, 1.0), vec4(vec3(ao), 1.0), step(v_texCoord.x, 0.5));
-        //FRAG_OUT = vec4(baseColour * ao, 1.0);
+        float occlusion = 0.0;
+        float totalWeight = 0.0;
+        for (int y = 0; y < 2; ++y)
+        {
+            for (int x = 0; x < 2; ++x)
+            {
+                vec2 offset = vec2(float(x), float(y));
+                vec2 ao = TEXTURE(u_ssaoTexture, (base + offset + 0.5) / u_ssaoSize).rg;
+
+                vec2 bilinear = mix(1.0 - fraction, fraction, offset);
+                float weight = (bilinear.x * bilinear.y) / (DepthEpsilon + abs(depth - ao.g));
+
+                occlusion += ao.r * weight;
+                totalWeight += weight;
+            }
+        }
+        occlusion /= max(totalWeight, 0.00001);
+
+        vec3 baseColour = TEXTURE(u_baseTexture, v_texCoord).rgb;
+        FRAG_OUT = vec4(baseColour * occlusion, 1.0);
     }
 )";
\ No newline at end of file
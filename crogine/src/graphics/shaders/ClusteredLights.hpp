@@ -0,0 +1,140 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <string>
+
+namespace cro::Shaders::ClusteredLights
+{
+    //included in PBR lighting shaders after calcLighting() is declared.
+    //the constants and buffer layout must match Detail::LightClusters
+    //and the LightSystem.
+    static const std::string Fragment = R"(
+        #if !defined(MOBILE)
+        #define CLUSTER_TILES_X 16
+        #define CLUSTER_TILES_Y 9
+        #define CLUSTER_SLICES 24
+        #define CLUSTER_LIGHT_OFFSET (CLUSTER_TILES_X * CLUSTER_TILES_Y * CLUSTER_SLICES)
+
+        uniform usamplerBuffer u_lightClusters;
+        uniform vec4 u_lightClusterParams; //slice scale, slice bias, index texel offset, enabled
+        uniform mat4 u_lightClusterMatrices[2]; //view, projection
+
+        vec4 fetchLightData(int texel)
+        {
+            return uintBitsToFloat(texelFetch(u_lightClusters, texel));
+        }
+
+        vec3 calcClusteredLighting(MaterialProperties matProp, SurfaceProperties surfProp, vec3 worldPosition, vec3 F0)
+        {
+            vec3 result = vec3(0.0);
+            if (u_lightClusterParams.w == 0.0)
+            {
+                return result;
+            }
+
+            vec4 viewPosition = u_lightClusterMatrices[0] * vec4(worldPosition, 1.0);
+            if (viewPosition.z > -0.0001)
+            {
+                return result;
+            }
+
+            vec4 clipPosition = u_lightClusterMatrices[1] * viewPosition;
+            vec2 ndc = clipPosition.xy / clipPosition.w;
+            if (any(greaterThan(abs(ndc), vec2(1.0))))
+            {
+                return result;
+            }
+
+            ivec2 tile = clamp(ivec2(floor((ndc * 0.5 + 0.5) * vec2(CLUSTER_TILES_X, CLUSTER_TILES_Y))), ivec2(0), ivec2(CLUSTER_TILES_X - 1, CLUSTER_TILES_Y - 1));
+            int slice = clamp(int(floor(log(-viewPosition.z) * u_lightClusterParams.x + u_lightClusterParams.y)), 0, CLUSTER_SLICES - 1);
+            uvec4 cluster = texelFetch(u_lightClusters, tile.x + (tile.y * CLUSTER_TILES_X) + (slice * CLUSTER_TILES_X * CLUSTER_TILES_Y));
+
+            int indexOffset = int(u_lightClusterParams.z);
+            for (uint i = 0u; i < cluster.y; ++i)
+            {
+                uint index = cluster.x + i;
+                int lightTexel = CLUSTER_LIGHT_OFFSET + int(texelFetch(u_lightClusters, indexOffset + int(index / 4u))[index % 4u]) * 3;
+
+                vec4 positionRadius = fetchLightData(lightTexel);
+                vec4 colourOuter = fetchLightData(lightTexel + 1);
+                vec4 directionInner = fetchLightData(lightTexel + 2);
+
+                vec3 lightVec = positionRadius.xyz - worldPosition;
+                float distSqr = dot(lightVec, lightVec);
+                float radiusSqr = positionRadius.w * positionRadius.w;
+                if (distSqr < radiusSqr)
+                {
+                    surfProp.lightDir = lightVec * inversesqrt(max(distSqr, 0.0001));
+
+                    //inverse square falloff, windowed to reach zero at the light radius
+                    float window = clamp(1.0 - (distSqr * distSqr) / (radiusSqr * radiusSqr), 0.0, 1.0);
+                    float attenuation = (window * window) / (distSqr + 1.0);
+
+                    //point lights have an outer cosine of -2 so this is always 1
+                    attenuation *= smoothstep(colourOuter.w, directionInner.w, dot(-surfProp.lightDir, directionInner.xyz));
+
+                    result += calcLighting(matProp, surfProp, colourOuter.rgb * attenuation, F0);
+                }
+            }
+            return result;
+        }
+
+        //undoes the tonemapping and gamma correction of the final colour so that local
+        //lights are combined in linear space, unaffected by the sun's colour or shadow.
+        vec3 addClusteredLighting(vec3 colour, vec3 lighting)
+        {
+            //the round trip isn't exact so skip it when there's nothing to add
+            if (u_lightClusterParams.w == 0.0
+                || lighting == vec3(0.0))
+            {
+                return colour;
+            }
+
+            vec3 linear = pow(colour, vec3(2.2));
+            linear = linear / max(vec3(1.0) - linear, vec3(0.0001));
+            linear += lighting;
+            linear = linear / (linear + vec3(1.0));
+            return pow(linear, vec3(1.0 / 2.2));
+        }
+        #else
+        vec3 calcClusteredLighting(MaterialProperties matProp, SurfaceProperties surfProp, vec3 worldPosition, vec3 F0)
+        {
+            return vec3(0.0);
+        }
+
+        vec3 addClusteredLighting(vec3 colour, vec3 lighting)
+        {
+            return colour;
+        }
+        #endif
+        )";
+}
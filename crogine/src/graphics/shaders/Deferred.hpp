@@ -29,6 +29,7 @@ source distribution.
 
 #pragma once
 
+#include "ClusteredLights.hpp"
 
 #include <string>
 
@@ -364,8 +365,7 @@ namespace cro::Shaders::Deferred
                 float NdotL = max(dot(surfProp.normalDir, surfProp.lightDir), 0.0);        
 
                 return (kD * matProp.albedo / PI + specular) * radiance * NdotL;  // note that we already multiplied the BRDF by the Fresnel (kS) so we won't multiply by kS again
-            }
-
+            })" + ClusteredLights::Fragment + R"(
             void main()
             {
                 MaterialProperties matProp;
@@ -393,18 +393,9 @@ namespace cro::Shaders::Deferred
 
                 vec3 Lo = vec3(0.0);
 
-                //point lights
-                /*
-                for( int i = 0; i < POINT_LIGHT_COUNT; ++i)
-                {
-                    vec3 lightDir = u_pointLights[i].worldPos - v_worldPosition;
-                    surfProp.lightDir = normalize(lightDir);
-
-                    float distance = length(lightDir);
-                    float attenuation = 1.0 / (distance * distance);
-                    Lo += calcLighting(matProp, surfProp, u_pointLights[i].colour.rgb * attenuation, F0);
-                }
-                */
+                //point and spot lights
+                vec3 worldPosition = (u_inverseViewMatrix * vec4(position.rgb, 1.0)).xyz;
+                vec3 localLo = calcClusteredLighting(matProp, surfProp, worldPosition, F0);
 
                 //directional light
                 surfProp.lightDir = normalize(-u_lightDirection);
@@ -437,6 +428,7 @@ namespace cro::Shaders::Deferred
                 colour *= shadowAmount(lightPos, surfProp);
 
                 colour *= u_lightColour.rgb;
+                colour = addClusteredLighting(colour, localLo);
 
                 o_colour = vec4(colour, albedo.a);
             }
@@ -6,6 +6,8 @@ https://learnopengl.com/PBR
 
 #pragma once
 
+#include "ClusteredLights.hpp"
+
 #include <string>
 
 namespace cro::Shaders::PBR
@@ -215,8 +217,7 @@ namespace cro::Shaders::PBR
             float NdotL = max(dot(surfProp.normalDir, surfProp.lightDir), 0.0);        
 
             return (kD * matProp.albedo / PI + specular) * radiance * NdotL;  // note that we already multiplied the BRDF by the Fresnel (kS) so we won't multiply by kS again
-        }
-
+        })" + ClusteredLights::Fragment + R"(
         void main()
         {
             MaterialProperties matProp;
@@ -264,18 +265,8 @@ namespace cro::Shaders::PBR
 
             vec3 Lo = vec3(0.0);
 
-            //point lights
-            /*
-            for( int i = 0; i < POINT_LIGHT_COUNT; ++i)
-            {
-                vec3 lightDir = u_pointLights[i].worldPos - v_worldPosition;
-                surfProp.lightDir = normalize(lightDir);
-
-                float distance = length(lightDir);
-                float attenuation = 1.0 / (distance * distance);
-                Lo += calcLighting(matProp, surfProp, u_pointLights[i].colour.rgb * attenuation, F0);
-            }
-            */
+            //point and spot lights
+            vec3 localLo = calcClusteredLighting(matProp, surfProp, v_worldPosition, F0);
 
             //directional light
             surfProp.lightDir = normalize(-u_lightDirection);
@@ -334,6 +325,7 @@ namespace cro::Shaders::PBR
         #endif
 
             colour *= u_lightColour.rgb;
+            colour = addClusteredLighting(colour, localLo);
 
             FRAG_OUT = vec4(colour, 1.0);
         })";
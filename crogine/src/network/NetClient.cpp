@@ -30,18 +30,20 @@ source distribution.
 #include "../detail/enet/enet/enet.h"
 
 #include "NetConf.hpp"
+#include "NetThread.hpp"
 
 #include <crogine/network/NetClient.hpp>
 #include <crogine/core/Log.hpp>
 #include <crogine/detail/Assert.hpp>
 
+#include <chrono>
 #include <cstring>
 
 using namespace cro;
 
 NetClient::NetClient()
     : m_client      (nullptr),
-    m_threadRunning (false)
+    m_useIOThread   (false)
 {
     if (!NetConf::instance)
     {
@@ -55,7 +57,9 @@ NetClient::~NetClient()
     {
         disconnect();
     }
-    
+
+    m_thread.reset();
+
     if (m_client)
     {
         enet_host_destroy(m_client);
@@ -127,18 +131,30 @@ bool NetClient::connect(const std::string& address, std::uint16_t port, std::uin
         return false;
     }
 
-    //wait for a success event from server - this part is blocking
+    //wait for a success event from server - this part is blocking.
+    //enet_host_service() sleeps for the entire timeout if nothing is received
+    //so service in short slices, else a lost request is never resent
     ENetEvent evt;
-    if (enet_host_service(m_client, &evt, timeout) > 0 && evt.type == ENET_EVENT_TYPE_CONNECT)
+    std::int32_t result = 0;
+    const auto start = enet_time_get();
+    while (result == 0
+        && enet_time_get() - start < timeout)
     {
-        //this is a hack to allow for long(er) loading times when the main
-        //thread is unable to poll a connection to keep it alive
-        enet_peer_timeout(m_peer.m_peer, ENET_PEER_TIMEOUT_LIMIT * 2, ENET_PEER_TIMEOUT_MINIMUM * 2, ENET_PEER_TIMEOUT_MAXIMUM * 2);
-
+        result = enet_host_service(m_client, &evt, 10);
+    }
 
-        //ehhhhh... it actually works, but ofc introduces latency.
-        //m_threadRunning = true;
-        //m_thread = std::make_unique<std::thread>(&NetClient::threadFunc, this);
+    if (result > 0 && evt.type == ENET_EVENT_TYPE_CONNECT)
+    {
+        if (m_useIOThread)
+        {
+            m_thread = std::make_unique<Detail::NetThread>(m_client);
+        }
+        else
+        {
+            //this is a hack to allow for long(er) loading times when the main
+            //thread is unable to poll a connection to keep it alive
+            enet_peer_timeout(m_peer.m_peer, ENET_PEER_TIMEOUT_LIMIT * 2, ENET_PEER_TIMEOUT_MINIMUM * 2, ENET_PEER_TIMEOUT_MAXIMUM * 2);
+        }
 
         LOG("Connected to " + address, Logger::Type::Info);
         return true;
@@ -152,9 +168,48 @@ bool NetClient::connect(const std::string& address, std::uint16_t port, std::uin
 
 void NetClient::disconnect()
 {
-    /*m_threadRunning = false;
-    m_thread->join();
-    m_thread.reset();*/
+    if (m_thread)
+    {
+        if (m_peer.m_peer)
+        {
+            //the thread owns the host, so have it perform the disconnection
+            //and wait for it to report back before taking the host back
+            m_thread->disconnect(m_peer.m_peer, false);
+
+            ENetEvent evt;
+            const auto start = enet_time_get();
+            while (m_peer.m_peer
+                && enet_time_get() - start < 3000)
+            {
+                while (m_thread->pollEvent(evt))
+                {
+                    if (evt.type == ENET_EVENT_TYPE_RECEIVE)
+                    {
+                        enet_packet_destroy(evt.packet);
+                    }
+                    else if (evt.type == ENET_EVENT_TYPE_DISCONNECT
+                        && evt.peer == m_peer.m_peer)
+                    {
+                        m_peer.m_peer = nullptr;
+                        LOG("Disconnected from server", Logger::Type::Info);
+                    }
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+        //the host must only be serviced by this thread from here
+        m_thread.reset();
+
+        if (m_peer.m_peer)
+        {
+            //timed out so force disconnect
+            LOG("Disconnect timed out", Logger::Type::Info);
+            enet_peer_reset(m_peer.m_peer);
+            m_peer.m_peer = nullptr;
+        }
+        return;
+    }
 
     if (m_peer.m_peer)
     {
@@ -190,12 +245,8 @@ bool NetClient::pollEvent(NetEvent& evt)
     if (!m_client) return false;
 
     ENetEvent hostEvt;
-    if (enet_host_service(m_client, &hostEvt, 0) > 0)
-    //if (!m_activeBuffer.empty())
+    if (m_thread ? m_thread->pollEvent(hostEvt) : enet_host_service(m_client, &hostEvt, 0) > 0)
     {
-        //auto hostEvt = std::any_cast<ENetEvent>(m_activeBuffer.front());
-        //m_activeBuffer.pop_front();
-
         switch (hostEvt.type)
         {
         default:
@@ -205,7 +256,13 @@ bool NetClient::pollEvent(NetEvent& evt)
             evt.type = NetEvent::ClientConnect;
             break;
         case ENET_EVENT_TYPE_DISCONNECT:
-            evt.type = NetEvent::ClientDisconnect;            
+            evt.type = NetEvent::ClientDisconnect;
+            if (hostEvt.peer == m_peer.m_peer)
+            {
+                //the peer has already been reset by the host so
+                //make sure disconnect() doesn't try to use it again
+                m_peer.m_peer = nullptr;
+            }
             break;
         case ENET_EVENT_TYPE_RECEIVE:
             evt.type = NetEvent::PacketReceived;
@@ -217,12 +274,21 @@ bool NetClient::pollEvent(NetEvent& evt)
         evt.peer.m_peer = hostEvt.peer;
         return true;
     }
+    return false;
+}
 
+void NetClient::setIOThreadEnabled(bool enabled)
+{
+    m_useIOThread = enabled;
+
+    if (!enabled)
     {
-        //std::lock_guard<std::mutex> lock(m_mutex);
-        //m_activeBuffer.swap(m_evtBuffer);
+        m_thread.reset();
+    }
+    else if (!m_thread && m_peer.m_peer)
+    {
+        m_thread = std::make_unique<Detail::NetThread>(m_client);
     }
-    return false;
 }
 
 void NetClient::sendPacket(std::uint8_t id, const void* data, std::size_t size, NetFlag flags, std::uint8_t channel)
@@ -247,24 +313,13 @@ void NetClient::sendPacket(std::uint8_t id, const void* data, std::size_t size,
         enet_packet_resize(packet, sizeof(std::uint8_t) + size);
         std::memcpy(&packet->data[sizeof(std::uint8_t)], data, size);
 
-        enet_peer_send(m_peer.m_peer, channel, packet);
-    }
-}
-
-//private
-void NetClient::threadFunc()
-{
-    while (m_threadRunning)
-    {
-        ENetEvent hostEvt;
+        if (m_thread)
         {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            while (enet_host_service(m_client, &hostEvt, 0) != 0)
-            {
-                m_evtBuffer.push_back(std::make_any<ENetEvent>(hostEvt));
-            }
+            m_thread->send(m_peer.m_peer, channel, packet);
+        }
+        else
+        {
+            enet_peer_send(m_peer.m_peer, channel, packet);
         }
-
-        std::this_thread::sleep_for(std::chrono::duration<int, std::milli>(50));
     }
 }
\ No newline at end of file
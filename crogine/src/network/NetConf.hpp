@@ -43,6 +43,7 @@ namespace cro
     private:
         friend class NetHost;
         friend class NetClient;
+        friend class NetSimulator;
 
         static std::unique_ptr<NetConf> instance;
 
@@ -92,6 +92,16 @@ std::size_t NetEvent::Packet::getSize() const
     return m_packet->dataLength - sizeof(std::uint8_t);
 }
 
+NetRecordRange NetEvent::Packet::getRecords() const
+{
+    if (m_packet && m_id == AggregateID)
+    {
+        const auto* end = m_packet->data + m_packet->dataLength;
+        return NetRecordRange(NetRecordIterator(m_packet->data + sizeof(std::uint8_t), end), NetRecordIterator(end, end));
+    }
+    return {};
+}
+
 //private
 void NetEvent::Packet::setPacketData(ENetPacket* packet)
 {
@@ -106,4 +116,54 @@ void NetEvent::Packet::setPacketData(ENetPacket* packet)
     {
         std::memcpy(&m_id, m_packet->data, sizeof(std::uint8_t));
     }
+}
+
+//record iterator
+NetRecordIterator::NetRecordIterator(const std::uint8_t* position, const std::uint8_t* end)
+    : m_position(position),
+    m_end       (end)
+{
+    read();
+}
+
+//public
+NetRecordIterator& NetRecordIterator::operator++()
+{
+    m_position = m_record.m_data + m_record.m_size;
+    read();
+    return *this;
+}
+
+NetRecordIterator NetRecordIterator::operator++(int)
+{
+    auto retVal = *this;
+    ++(*this);
+    return retVal;
+}
+
+//private
+void NetRecordIterator::read()
+{
+    //each record is a one byte ID followed by a two byte size
+    constexpr std::size_t HeaderSize = sizeof(std::uint8_t) + sizeof(std::uint16_t);
+
+    if (static_cast<std::size_t>(m_end - m_position) < HeaderSize)
+    {
+        m_position = m_end;
+        return;
+    }
+
+    std::uint16_t size = 0;
+    std::memcpy(&m_record.m_id, m_position, sizeof(std::uint8_t));
+    std::memcpy(&size, m_position + sizeof(std::uint8_t), sizeof(std::uint16_t));
+
+    if (static_cast<std::size_t>(m_end - m_position) - HeaderSize < size)
+    {
+        //truncated
+        m_position = m_end;
+        return;
+    }
+
+    m_record.m_data = m_position + HeaderSize;
+    m_record.m_size = size;
 }
\ No newline at end of file
@@ -32,17 +32,24 @@ source distribution.
 #include "../detail/enet/enet/enet.h"
 
 #include "NetConf.hpp"
+#include "NetThread.hpp"
+#include "PacketPool.hpp"
 #include <crogine/network/NetHost.hpp>
 #include <crogine/core/Log.hpp>
 #include <crogine/detail/Assert.hpp>
 
+#include <algorithm>
+
 using namespace cro;
 
 namespace
 {
-    ENetPacket* createPacket(std::uint8_t id, const void* data, std::size_t size, NetFlag flags)
+    //each record is a one byte ID followed by a two byte size
+    constexpr std::size_t RecordHeaderSize = sizeof(std::uint8_t) + sizeof(std::uint16_t);
+
+    std::uint32_t getPacketFlags(NetFlag flags)
     {
-        std::int32_t packetFlags = 0;
+        std::uint32_t packetFlags = 0;
         if (flags == NetFlag::Reliable)
         {
             packetFlags |= ENET_PACKET_FLAG_RELIABLE;
@@ -55,17 +62,25 @@ namespace
         {
             packetFlags |= ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT | ENET_PACKET_FLAG_UNSEQUENCED;
         }
+        return packetFlags;
+    }
 
-        ENetPacket* packet = enet_packet_create(&id, sizeof(std::uint8_t), packetFlags);
-        enet_packet_resize(packet, sizeof(std::uint8_t) + size);
-        std::memcpy(&packet->data[sizeof(std::uint8_t)], data, size);
-
+    ENetPacket* createPacket(Detail::PacketPool& pool, std::uint8_t id, const void* data, std::size_t size, NetFlag flags)
+    {
+        ENetPacket* packet = pool.create(sizeof(std::uint8_t) + size, getPacketFlags(flags));
+        if (packet)
+        {
+            packet->data[0] = id;
+            std::memcpy(&packet->data[sizeof(std::uint8_t)], data, size);
+        }
         return packet;
     }
 }
 
 NetHost::NetHost()
-    : m_host    (nullptr)
+    : m_host        (nullptr),
+    m_useIOThread   (false),
+    m_packetPool    (std::make_unique<Detail::PacketPool>())
 {
     if (!NetConf::instance)
     {
@@ -121,12 +136,29 @@ bool NetHost::start(const std::string& address, std::uint16_t port, std::size_t
 
     enet_host_compress_with_range_coder(m_host);
 
+    if (m_useIOThread)
+    {
+        m_thread = std::make_unique<Detail::NetThread>(m_host);
+    }
+
     LOG("Created server host on port " + std::to_string(port), Logger::Type::Info);
     return true;
 }
 
 void NetHost::stop()
 {
+    //the host must only be serviced by this thread from here
+    m_thread.reset();
+
+    for (auto& buffer : m_aggregateBuffers)
+    {
+        if (buffer.packet)
+        {
+            enet_packet_destroy(buffer.packet);
+        }
+    }
+    m_aggregateBuffers.clear();
+
     if (m_host)
     {
         if (m_host->connectedPeers > 0)
@@ -172,7 +204,7 @@ bool NetHost::pollEvent(NetEvent& evt)
     if (!m_host) return false;
 
     ENetEvent hostEvt;
-    if (enet_host_service(m_host, &hostEvt, 0) > 0)
+    if (m_thread ? m_thread->pollEvent(hostEvt) : enet_host_service(m_host, &hostEvt, 0) > 0)
     {
         switch (hostEvt.type)
         {
@@ -184,6 +216,7 @@ bool NetHost::pollEvent(NetEvent& evt)
             break;
         case ENET_EVENT_TYPE_DISCONNECT:
             evt.type = NetEvent::ClientDisconnect;
+            removeBuffers(hostEvt.peer, false);
             break;
         case ENET_EVENT_TYPE_RECEIVE:
             evt.type = NetEvent::PacketReceived;
@@ -198,11 +231,25 @@ bool NetHost::pollEvent(NetEvent& evt)
     return false;
 }
 
+void NetHost::setIOThreadEnabled(bool enabled)
+{
+    m_useIOThread = enabled;
+
+    if (!enabled)
+    {
+        m_thread.reset();
+    }
+    else if (!m_thread && m_host)
+    {
+        m_thread = std::make_unique<Detail::NetThread>(m_host);
+    }
+}
+
 void NetHost::broadcastPacket(std::uint8_t id, const void* data, std::size_t size, NetFlag flags, std::uint8_t channel)
 {
     if (m_host)
     {
-        enet_host_broadcast(m_host, channel, createPacket(id, data, size, flags));
+        send(nullptr, channel, createPacket(*m_packetPool, id, data, size, flags));
     }
 }
 
@@ -210,24 +257,192 @@ void NetHost::sendPacket(const NetPeer& peer, std::uint8_t id, const void* data,
 {
     if (peer.m_peer)
     {
-        enet_peer_send(peer.m_peer, channel, createPacket(id, data, size, flags));
+        send(peer.m_peer, channel, createPacket(*m_packetPool, id, data, size, flags));
+    }
+}
+
+void NetHost::queuePacket(const NetPeer& peer, std::uint8_t id, const void* data, std::size_t size, NetFlag flags, std::uint8_t channel)
+{
+    if (peer.m_peer)
+    {
+        queueRecord(peer.m_peer, id, data, size, flags, channel);
+    }
+}
+
+void NetHost::queueBroadcast(std::uint8_t id, const void* data, std::size_t size, NetFlag flags, std::uint8_t channel)
+{
+    if (m_host)
+    {
+        queueRecord(nullptr, id, data, size, flags, channel);
+    }
+}
+
+void NetHost::sendQueued()
+{
+    for (auto& buffer : m_aggregateBuffers)
+    {
+        sendBuffer(buffer);
     }
 }
 
 void NetHost::disconnect(NetPeer& peer)
 {
-    if (m_host && peer.m_peer)
+    auto* enetPeer = peer.m_peer;
+    peer.m_peer = nullptr;
+
+    if (enetPeer)
     {
-        enet_peer_disconnect(peer.m_peer, 0);
-        peer.m_peer = nullptr;
+        removeBuffers(enetPeer, false);
+
+        if (m_thread)
+        {
+            //the thread owns the host and its peers so
+            //only it may perform the disconnection
+            m_thread->disconnect(enetPeer, false);
+        }
+        else if (m_host)
+        {
+            enet_peer_disconnect(enetPeer, 0);
+        }
     }
 }
 
 void NetHost::disconnectLater(NetPeer& peer)
 {
-    if (m_host && peer.m_peer)
+    auto* enetPeer = peer.m_peer;
+    peer.m_peer = nullptr;
+
+    if (enetPeer)
+    {
+        removeBuffers(enetPeer, true);
+
+        if (m_thread)
+        {
+            //the thread owns the host and its peers so
+            //only it may perform the disconnection
+            m_thread->disconnect(enetPeer, true);
+        }
+        else if (m_host)
+        {
+            enet_peer_disconnect_later(enetPeer, 0);
+        }
+    }
+}
+
+//private
+void NetHost::queueRecord(ENetPeer* peer, std::uint8_t id, const void* data, std::size_t size, NetFlag flags, std::uint8_t channel)
+{
+    auto result = std::find_if(m_aggregateBuffers.begin(), m_aggregateBuffers.end(),
+        [peer, channel, flags](const AggregateBuffer& b)
+        {
+            return b.peer == peer && b.channel == channel && b.flags == flags;
+        });
+
+    if (result == m_aggregateBuffers.end())
+    {
+        auto& buffer = m_aggregateBuffers.emplace_back();
+        buffer.peer = peer;
+        buffer.channel = channel;
+        buffer.flags = flags;
+        result = m_aggregateBuffers.end() - 1;
+    }
+    auto& buffer = *result;
+
+    //an empty buffer still needs room for the aggregate ID once it's created
+    const auto bufferSize = buffer.packet ? buffer.size : sizeof(std::uint8_t);
+    if (bufferSize + RecordHeaderSize + size > Detail::PacketPool::BlockSize)
+    {
+        sendBuffer(buffer);
+
+        if (sizeof(std::uint8_t) + RecordHeaderSize + size > Detail::PacketPool::BlockSize)
+        {
+            //too big to share a datagram with anything else
+            send(peer, channel, createPacket(*m_packetPool, id, data, size, flags));
+            return;
+        }
+    }
+
+    if (!buffer.packet)
+    {
+        //records are written straight into the packet's pooled memory
+        buffer.packet = m_packetPool->create(Detail::PacketPool::BlockSize, getPacketFlags(flags));
+        if (!buffer.packet)
+        {
+            return;
+        }
+        buffer.packet->data[0] = NetEvent::Packet::AggregateID;
+        buffer.size = sizeof(std::uint8_t);
+    }
+
+    auto* dst = buffer.packet->data + buffer.size;
+    const auto recordSize = static_cast<std::uint16_t>(size);
+    std::memcpy(dst, &id, sizeof(std::uint8_t));
+    std::memcpy(dst + sizeof(std::uint8_t), &recordSize, sizeof(std::uint16_t));
+    std::memcpy(dst + RecordHeaderSize, data, size);
+    buffer.size += RecordHeaderSize + size;
+}
+
+void NetHost::sendBuffer(AggregateBuffer& buffer)
+{
+    if (buffer.packet)
+    {
+        buffer.packet->dataLength = buffer.size;
+        send(buffer.peer, buffer.channel, buffer.packet);
+
+        buffer.packet = nullptr;
+        buffer.size = 0;
+    }
+}
+
+void NetHost::removeBuffers(ENetPeer* peer, bool sendQueued)
+{
+    //peers are recycled by the host, so records queued for this
+    //one mustn't be left around to be sent to the next client
+    for (auto& buffer : m_aggregateBuffers)
+    {
+        if (buffer.peer == peer)
+        {
+            if (sendQueued)
+            {
+                sendBuffer(buffer);
+            }
+            else if (buffer.packet)
+            {
+                enet_packet_destroy(buffer.packet);
+                buffer.packet = nullptr;
+            }
+        }
+    }
+
+    m_aggregateBuffers.erase(std::remove_if(m_aggregateBuffers.begin(), m_aggregateBuffers.end(),
+        [peer](const AggregateBuffer& b)
+        {
+            return b.peer == peer;
+        }), m_aggregateBuffers.end());
+}
+
+void NetHost::send(ENetPeer* peer, std::uint8_t channel, ENetPacket* packet)
+{
+    if (!packet)
+    {
+        return;
+    }
+
+    if (m_thread)
+    {
+        m_thread->send(peer, channel, packet);
+    }
+    else if (peer)
+    {
+        if (enet_peer_send(peer, channel, packet) != 0
+            && packet->referenceCount == 0)
+        {
+            //peer has disconnected so the packet wasn't queued
+            enet_packet_destroy(packet);
+        }
+    }
+    else
     {
-        enet_peer_disconnect_later(peer.m_peer, 0);
-        peer.m_peer = nullptr;
+        enet_host_broadcast(m_host, channel, packet);
     }
 }
\ No newline at end of file
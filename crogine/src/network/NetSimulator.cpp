@@ -0,0 +1,460 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+//this should always be included first on windows, to ensure it is
+//included before windows.h (in this case by Log.hpp)
+#include "../detail/enet/enet/enet.h"
+
+#include "NetConf.hpp"
+#include <crogine/network/NetSimulator.hpp>
+#include <crogine/core/Log.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <queue>
+#include <random>
+
+using namespace cro;
+
+namespace
+{
+    //all times are in microseconds
+    std::int64_t getTime()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    //datagrams which would wait longer than this for bandwidth are dropped
+    constexpr std::int64_t MaxQueueTime = 500000;
+
+    //links with no traffic in either direction for this long are closed
+    constexpr std::int64_t LinkTimeout = 30000000;
+
+    //held back datagrams are delayed by at least this much
+    constexpr std::int64_t MinReorderDelay = 5000;
+
+    constexpr std::size_t MaxDatagramSize = ENET_PROTOCOL_MAXIMUM_MTU;
+    constexpr std::int32_t SocketBufferSize = 256 * 1024;
+
+    ENetSocket createSocket(const ENetAddress& bindAddress)
+    {
+        auto socket = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
+        if (socket != ENET_SOCKET_NULL)
+        {
+            enet_socket_set_option(socket, ENET_SOCKOPT_NONBLOCK, 1);
+            enet_socket_set_option(socket, ENET_SOCKOPT_RCVBUF, SocketBufferSize);
+            enet_socket_set_option(socket, ENET_SOCKOPT_SNDBUF, SocketBufferSize);
+
+            if (enet_socket_bind(socket, &bindAddress) != 0)
+            {
+                enet_socket_destroy(socket);
+                socket = ENET_SOCKET_NULL;
+            }
+        }
+        return socket;
+    }
+
+    struct Datagram final
+    {
+        std::int64_t deliveryTime = 0;
+        std::uint64_t order = 0; //keeps datagrams due at the same time in the order they arrived
+        std::vector<std::uint8_t> data;
+    };
+
+    struct DeliverLater final
+    {
+        bool operator()(const Datagram& a, const Datagram& b) const
+        {
+            return a.deliveryTime == b.deliveryTime ? a.order > b.order : a.deliveryTime > b.deliveryTime;
+        }
+    };
+
+    //one direction of a link
+    struct Channel final
+    {
+        std::mt19937 rng;
+        std::uint64_t order = 0;
+        std::int64_t lastDelivery = 0; //unless held back datagrams are delivered in order
+        std::int64_t busyUntil = 0; //when a bandwidth limited channel is next free
+        std::priority_queue<Datagram, std::vector<Datagram>, DeliverLater> queue;
+
+        void schedule(const std::uint8_t* data, std::size_t size, std::int64_t now, const NetSimulator::Settings& settings, NetSimulator::Stats& stats)
+        {
+            stats.received++;
+
+            //always draw the same numbers so that changing one setting
+            //doesn't alter the decisions made by the others
+            std::uniform_real_distribution<float> chance(0.f, 1.f);
+            const auto loss = chance(rng);
+            const auto duplicate = chance(rng);
+            const auto reorder = chance(rng);
+            const auto jitter = static_cast<std::int64_t>((chance(rng) * 2.f - 1.f) * settings.jitter * 1000.f);
+
+            if (loss < settings.packetLoss)
+            {
+                stats.dropped++;
+                return;
+            }
+
+            auto sendTime = now;
+            if (settings.bandwidth != 0)
+            {
+                sendTime = std::max(now, busyUntil);
+                if (sendTime - now > MaxQueueTime)
+                {
+                    stats.overflowed++;
+                    return;
+                }
+                busyUntil = sendTime + static_cast<std::int64_t>(size) * 1000000 / settings.bandwidth;
+                sendTime = busyUntil;
+            }
+
+            const std::int64_t latency = static_cast<std::int64_t>(settings.latency) * 1000;
+            auto deliveryTime = std::max(sendTime, sendTime + latency + jitter);
+
+            if (reorder < settings.reordering)
+            {
+                deliveryTime += std::max(latency, MinReorderDelay);
+                stats.reordered++;
+            }
+            else
+            {
+                deliveryTime = std::max(deliveryTime, lastDelivery);
+                lastDelivery = deliveryTime;
+            }
+
+            Datagram datagram;
+            datagram.deliveryTime = deliveryTime;
+            datagram.order = order++;
+            datagram.data.assign(data, data + size);
+
+            if (duplicate < settings.duplication)
+            {
+                auto copy = datagram;
+                copy.order = order++;
+                queue.push(std::move(copy));
+                stats.duplicated++;
+            }
+            queue.push(std::move(datagram));
+        }
+
+        template <typename F>
+        void deliver(std::int64_t now, NetSimulator::Stats& stats, F&& send)
+        {
+            while (!queue.empty()
+                && queue.top().deliveryTime <= now)
+            {
+                const auto& data = queue.top().data;
+                send(data);
+
+                stats.delivered++;
+                stats.bytesDelivered += data.size();
+                queue.pop();
+            }
+        }
+    };
+}
+
+struct NetSimulator::Listener final
+{
+    ENetSocket socket = ENET_SOCKET_NULL;
+    ENetAddress hostAddress = {};
+
+    ~Listener()
+    {
+        if (socket != ENET_SOCKET_NULL)
+        {
+            enet_socket_destroy(socket);
+        }
+    }
+};
+
+struct NetSimulator::Link final
+{
+    ENetAddress clientAddress = {};
+    ENetSocket socket = ENET_SOCKET_NULL; //relays to and from the host
+    std::int64_t lastActive = 0;
+
+    Channel upstream; //client to host
+    Channel downstream; //host to client
+
+    ~Link()
+    {
+        if (socket != ENET_SOCKET_NULL)
+        {
+            enet_socket_destroy(socket);
+        }
+    }
+};
+
+NetSimulator::NetSimulator()
+    : m_linkCount   (0),
+    m_useThread     (true),
+    m_running       (false)
+{
+    if (!NetConf::instance)
+    {
+        NetConf::instance = std::make_unique<NetConf>();
+    }
+}
+
+NetSimulator::~NetSimulator()
+{
+    stop();
+}
+
+//public
+bool NetSimulator::start(std::uint16_t listenPort, const std::string& hostAddress, std::uint16_t hostPort, const Settings& settings)
+{
+    if (m_listener)
+    {
+        LogE << "Network simulator already started" << std::endl;
+        return false;
+    }
+
+    if (!NetConf::instance->m_initOK)
+    {
+        LogE << "Network subsystem not initialised, starting simulator failed" << std::endl;
+        return false;
+    }
+
+    auto listener = std::make_unique<Listener>();
+    if (enet_address_set_host(&listener->hostAddress, hostAddress.c_str()) != 0)
+    {
+        LogE << "Failed setting network simulator host address " << hostAddress << std::endl;
+        return false;
+    }
+    listener->hostAddress.port = hostPort;
+
+    //only the loopback interface is used, there's no need to expose the simulator
+    ENetAddress listenAddress;
+    enet_address_set_host(&listenAddress, "127.0.0.1");
+    listenAddress.port = listenPort;
+
+    listener->socket = createSocket(listenAddress);
+    if (listener->socket == ENET_SOCKET_NULL)
+    {
+        LogE << "Failed creating network simulator on port " << listenPort << std::endl;
+        return false;
+    }
+
+    {
+        std::scoped_lock lock(m_mutex);
+        m_listener = std::move(listener);
+        m_settings = settings;
+        m_stats = {};
+        m_linkCount = 0;
+    }
+
+    if (m_useThread)
+    {
+        startThread();
+    }
+
+    LOG("Started network simulator on port " + std::to_string(listenPort), Logger::Type::Info);
+    return true;
+}
+
+void NetSimulator::stop()
+{
+    stopThread();
+
+    std::scoped_lock lock(m_mutex);
+    m_links.clear();
+    m_listener.reset();
+}
+
+void NetSimulator::setSettings(const Settings& settings)
+{
+    std::scoped_lock lock(m_mutex);
+    m_settings = settings;
+}
+
+NetSimulator::Settings NetSimulator::getSettings() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_settings;
+}
+
+void NetSimulator::setThreadEnabled(bool enabled)
+{
+    m_useThread = enabled;
+
+    if (!enabled)
+    {
+        stopThread();
+    }
+    else if (m_listener)
+    {
+        startThread();
+    }
+}
+
+void NetSimulator::update()
+{
+    std::scoped_lock lock(m_mutex);
+    if (m_listener)
+    {
+        const auto now = getTime();
+        receive(now);
+        deliver(now);
+    }
+}
+
+NetSimulator::Stats NetSimulator::getStats() const
+{
+    std::scoped_lock lock(m_mutex);
+    auto stats = m_stats;
+    stats.linkCount = m_links.size();
+    return stats;
+}
+
+//private
+void NetSimulator::startThread()
+{
+    if (!m_running)
+    {
+        m_running = true;
+        m_thread = std::thread(&NetSimulator::threadFunc, this);
+    }
+}
+
+void NetSimulator::stopThread()
+{
+    if (m_running)
+    {
+        m_running = false;
+        m_thread.join();
+    }
+}
+
+void NetSimulator::threadFunc()
+{
+    while (m_running)
+    {
+        update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+NetSimulator::Link* NetSimulator::getLink(std::uint32_t host, std::uint16_t port, std::int64_t now)
+{
+    auto result = std::find_if(m_links.begin(), m_links.end(),
+        [host, port](const std::unique_ptr<Link>& link)
+        {
+            return link->clientAddress.host == host && link->clientAddress.port == port;
+        });
+
+    if (result != m_links.end())
+    {
+        return result->get();
+    }
+
+    ENetAddress bindAddress;
+    bindAddress.host = ENET_HOST_ANY;
+    bindAddress.port = 0;
+
+    auto link = std::make_unique<Link>();
+    link->socket = createSocket(bindAddress);
+    if (link->socket == ENET_SOCKET_NULL)
+    {
+        LogE << "Network simulator failed to create link socket" << std::endl;
+        return nullptr;
+    }
+    link->clientAddress.host = host;
+    link->clientAddress.port = port;
+    link->lastActive = now;
+
+    //each direction of each link has its own sequence of random numbers
+    std::seed_seq upstreamSeed = { m_settings.seed, m_linkCount, 0u };
+    std::seed_seq downstreamSeed = { m_settings.seed, m_linkCount, 1u };
+    link->upstream.rng.seed(upstreamSeed);
+    link->downstream.rng.seed(downstreamSeed);
+    m_linkCount++;
+
+    return m_links.emplace_back(std::move(link)).get();
+}
+
+void NetSimulator::receive(std::int64_t now)
+{
+    std::array<std::uint8_t, MaxDatagramSize> buffer = {};
+    ENetBuffer enetBuffer;
+    enetBuffer.data = buffer.data();
+    enetBuffer.dataLength = buffer.size();
+
+    ENetAddress address;
+    std::int32_t size = 0;
+    while ((size = enet_socket_receive(m_listener->socket, &address, &enetBuffer, 1)) > 0)
+    {
+        if (auto* link = getLink(address.host, address.port, now); link)
+        {
+            link->upstream.schedule(buffer.data(), size, now, m_settings, m_stats);
+            link->lastActive = now;
+        }
+    }
+
+    for (auto& link : m_links)
+    {
+        while ((size = enet_socket_receive(link->socket, &address, &enetBuffer, 1)) > 0)
+        {
+            link->downstream.schedule(buffer.data(), size, now, m_settings, m_stats);
+            link->lastActive = now;
+        }
+    }
+}
+
+void NetSimulator::deliver(std::int64_t now)
+{
+    const auto send = [](ENetSocket socket, const ENetAddress& address, const std::vector<std::uint8_t>& data)
+    {
+        ENetBuffer buffer;
+        buffer.data = const_cast<std::uint8_t*>(data.data());
+        buffer.dataLength = data.size();
+        enet_socket_send(socket, &address, &buffer, 1);
+    };
+
+    for (auto& link : m_links)
+    {
+        link->upstream.deliver(now, m_stats, 
+            [&](const std::vector<std::uint8_t>& data) { send(link->socket, m_listener->hostAddress, data); });
+
+        link->downstream.deliver(now, m_stats,
+            [&](const std::vector<std::uint8_t>& data) { send(m_listener->socket, link->clientAddress, data); });
+    }
+
+    m_links.erase(std::remove_if(m_links.begin(), m_links.end(),
+        [now](const std::unique_ptr<Link>& link)
+        {
+            return now - link->lastActive > LinkTimeout
+                && link->upstream.queue.empty()
+                && link->downstream.queue.empty();
+        }), m_links.end());
+}
@@ -0,0 +1,180 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include "NetThread.hpp"
+
+using namespace cro;
+using namespace cro::Detail;
+
+namespace
+{
+    //maximum time the thread waits on the socket before checking
+    //for queued sends. This is the worst case send latency.
+    constexpr enet_uint32 ServiceTimeout = 1;
+}
+
+NetThread::NetThread(ENetHost* host)
+    : m_host    (host),
+    m_running   (true)
+{
+    m_thread = std::thread(&NetThread::threadFunc, this);
+}
+
+NetThread::~NetThread()
+{
+    stop();
+}
+
+//public
+void NetThread::send(ENetPeer* peer, std::uint8_t channel, ENetPacket* packet)
+{
+    Command cmd;
+    cmd.type = Command::Send;
+    cmd.peer = peer;
+    cmd.packet = packet;
+    cmd.channel = channel;
+
+    std::lock_guard<std::mutex> lock(m_commandMutex);
+    m_commands.push_back(cmd);
+}
+
+void NetThread::disconnect(ENetPeer* peer, bool later)
+{
+    Command cmd;
+    cmd.type = later ? Command::DisconnectLater : Command::Disconnect;
+    cmd.peer = peer;
+
+    std::lock_guard<std::mutex> lock(m_commandMutex);
+    m_commands.push_back(cmd);
+}
+
+bool NetThread::pollEvent(ENetEvent& evt)
+{
+    return m_events.pop(evt);
+}
+
+void NetThread::stop()
+{
+    if (m_thread.joinable())
+    {
+        m_running = false;
+        m_thread.join();
+
+        //the host belongs to this thread again, so
+        //make sure nothing that was queued is lost
+        processCommands();
+
+        ENetEvent evt;
+        while (m_events.pop(evt))
+        {
+            if (evt.type == ENET_EVENT_TYPE_RECEIVE)
+            {
+                enet_packet_destroy(evt.packet);
+            }
+        }
+
+        for (auto& e : m_backlog)
+        {
+            if (e.type == ENET_EVENT_TYPE_RECEIVE)
+            {
+                enet_packet_destroy(e.packet);
+            }
+        }
+        m_backlog.clear();
+    }
+}
+
+//private
+void NetThread::threadFunc()
+{
+    while (m_running)
+    {
+        processCommands();
+
+        //if the game thread isn't keeping up hold on to events
+        //until there's space, rather than dropping them
+        while (!m_backlog.empty() && m_events.push(m_backlog.front()))
+        {
+            m_backlog.pop_front();
+        }
+
+        //blocks until the socket has data, or the timeout expires
+        ENetEvent evt;
+        auto result = enet_host_service(m_host, &evt, ServiceTimeout);
+        while (result > 0)
+        {
+            if (!m_backlog.empty() || !m_events.push(evt))
+            {
+                m_backlog.push_back(evt);
+            }
+            result = enet_host_check_events(m_host, &evt);
+        }
+    }
+}
+
+void NetThread::processCommands()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_commandMutex);
+        m_activeCommands.swap(m_commands);
+    }
+
+    for (const auto& cmd : m_activeCommands)
+    {
+        switch (cmd.type)
+        {
+        default: break;
+        case Command::Send:
+            if (cmd.peer)
+            {
+                if (enet_peer_send(cmd.peer, cmd.channel, cmd.packet) != 0)
+                {
+                    //peer isn't connected, so we still own the packet
+                    if (cmd.packet->referenceCount == 0)
+                    {
+                        enet_packet_destroy(cmd.packet);
+                    }
+                }
+            }
+            else
+            {
+                enet_host_broadcast(m_host, cmd.channel, cmd.packet);
+            }
+            break;
+        case Command::Disconnect:
+            enet_peer_disconnect(cmd.peer, 0);
+            break;
+        case Command::DisconnectLater:
+            enet_peer_disconnect_later(cmd.peer, 0);
+            break;
+        }
+    }
+    m_activeCommands.clear();
+}
@@ -0,0 +1,121 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+//this should always be included first on windows, to ensure it is
+//included before windows.h
+#include "../detail/enet/enet/enet.h"
+#include "../detail/SPSCQueue.hpp"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cro::Detail
+{
+    /*!
+    \brief Services an ENet host on a dedicated thread.
+    Once started the thread takes ownership of all calls to the host,
+    so that connections are kept alive and packets are received even
+    when the game thread is stalled, for example while loading.
+    Received events are passed to the game thread via a lock free
+    queue, and packets may be queued for sending from any thread.
+    */
+    class NetThread final
+    {
+    public:
+        explicit NetThread(ENetHost*);
+        ~NetThread();
+
+        NetThread(const NetThread&) = delete;
+        NetThread(NetThread&&) = delete;
+        NetThread& operator = (const NetThread&) = delete;
+        NetThread& operator = (NetThread&&) = delete;
+
+        /*!
+        \brief Queues the given packet to be sent to the given peer.
+        If peer is nullptr the packet is broadcast to all connected peers.
+        The thread takes ownership of the packet. Thread safe.
+        */
+        void send(ENetPeer* peer, std::uint8_t channel, ENetPacket* packet);
+
+        /*!
+        \brief Queues a disconnection request for the given peer. Thread safe.
+        \param later If true the peer is disconnected once all queued packets
+        have been sent.
+        */
+        void disconnect(ENetPeer* peer, bool later);
+
+        /*!
+        \brief Pops the next received event, if there is one.
+        This must only be called from a single thread (usually the game thread).
+        Ownership of any packet in the event is passed to the caller.
+        */
+        bool pollEvent(ENetEvent&);
+
+        /*!
+        \brief Stops the thread and returns ownership of the host to the caller.
+        Any sends still queued are passed to the host before returning,
+        and any received events which have not been polled are discarded.
+        */
+        void stop();
+
+    private:
+        ENetHost* m_host;
+
+        struct Command final
+        {
+            enum
+            {
+                Send, Disconnect, DisconnectLater
+            }type = Send;
+            ENetPeer* peer = nullptr;
+            ENetPacket* packet = nullptr;
+            std::uint8_t channel = 0;
+        };
+
+        std::mutex m_commandMutex;
+        std::vector<Command> m_commands;
+        std::vector<Command> m_activeCommands;
+
+        static constexpr std::size_t EventQueueSize = 1024;
+        SPSCQueue<ENetEvent, EventQueueSize> m_events;
+        std::deque<ENetEvent> m_backlog; //only touched by the thread
+
+        std::atomic_bool m_running;
+        std::thread m_thread;
+
+        void threadFunc();
+        void processCommands();
+    };
+}
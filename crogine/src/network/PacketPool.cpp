@@ -0,0 +1,102 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include "PacketPool.hpp"
+
+using namespace cro;
+using namespace cro::Detail;
+
+namespace
+{
+    //blocks are allocated in chunks of this many at a time
+    constexpr std::size_t ChunkSize = 32;
+}
+
+PacketPool::PacketPool()
+{
+    m_freeBlocks.reserve(ChunkSize);
+}
+
+//public
+ENetPacket* PacketPool::create(std::size_t size, std::uint32_t flags)
+{
+    if (size > BlockSize)
+    {
+        return enet_packet_create(nullptr, size, flags);
+    }
+
+    std::uint8_t* block = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_freeBlocks.empty())
+        {
+            auto& chunk = m_chunks.emplace_back(std::make_unique<std::uint8_t[]>(BlockSize * ChunkSize));
+            for (auto i = 0u; i < ChunkSize; ++i)
+            {
+                m_freeBlocks.push_back(chunk.get() + (i * BlockSize));
+            }
+        }
+        block = m_freeBlocks.back();
+        m_freeBlocks.pop_back();
+    }
+
+    auto* packet = enet_packet_create(block, size, flags | ENET_PACKET_FLAG_NO_ALLOCATE);
+    if (!packet)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_freeBlocks.push_back(block);
+        return nullptr;
+    }
+
+    packet->freeCallback = &PacketPool::freeCallback;
+    packet->userData = this;
+    return packet;
+}
+
+std::size_t PacketPool::getBlockCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_chunks.size() * ChunkSize;
+}
+
+std::size_t PacketPool::getFreeCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_freeBlocks.size();
+}
+
+//private
+void PacketPool::freeCallback(ENetPacket* packet)
+{
+    auto* pool = static_cast<PacketPool*>(packet->userData);
+
+    std::lock_guard<std::mutex> lock(pool->m_mutex);
+    pool->m_freeBlocks.push_back(packet->data);
+}
@@ -0,0 +1,91 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include "../detail/enet/enet/enet.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace cro::Detail
+{
+    /*!
+    \brief Provides the memory for outgoing packets from a pool of
+    fixed size blocks, so that sending small packets doesn't allocate
+    and copy the packet data every time.
+    Blocks are returned to the pool by ENet when it destroys the packet,
+    which may happen on another thread, so the pool is thread safe. The
+    pool must outlive any packets created by it - in practice this means
+    destroying the host the packets were sent on first.
+    */
+    class PacketPool final
+    {
+    public:
+        //largest payload which fits in a single datagram
+        //with the default MTU, once ENet has added its headers
+        static constexpr std::size_t BlockSize = 1200;
+
+        PacketPool();
+
+        PacketPool(const PacketPool&) = delete;
+        PacketPool(PacketPool&&) = delete;
+        PacketPool& operator = (const PacketPool&) = delete;
+        PacketPool& operator = (PacketPool&&) = delete;
+
+        /*!
+        \brief Creates a packet with room for the given number of bytes.
+        The contents of the packet data are uninitialised. If size is
+        larger than BlockSize the packet data is allocated by ENet as usual.
+        \param size Size of the packet in bytes
+        \param flags ENetPacketFlag values
+        */
+        ENetPacket* create(std::size_t size, std::uint32_t flags);
+
+        /*!
+        \brief Returns the total number of blocks allocated by the pool
+        */
+        std::size_t getBlockCount() const;
+
+        /*!
+        \brief Returns the number of blocks not currently used by a packet
+        */
+        std::size_t getFreeCount() const;
+
+    private:
+        mutable std::mutex m_mutex;
+        std::vector<std::unique_ptr<std::uint8_t[]>> m_chunks;
+        std::vector<std::uint8_t*> m_freeBlocks;
+
+        static void freeCallback(ENetPacket*);
+    };
+}
@@ -0,0 +1,474 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include "Snapshot.hpp"
+
+#include <crogine/network/ReplicationSettings.hpp>
+#include <crogine/util/BitStream.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace cro;
+using namespace cro::Detail;
+using namespace cro::Util::Net;
+
+namespace
+{
+    constexpr std::uint32_t MinRotationBits = 4;
+    constexpr std::uint32_t MaxRotationBits = 10;
+
+    std::uint32_t clampRotationBits(std::uint32_t bits)
+    {
+        return std::clamp(bits, MinRotationBits, MaxRotationBits);
+    }
+
+    std::int32_t quantise(float value, float precision)
+    {
+        constexpr float MaxValue = static_cast<float>(std::numeric_limits<std::int32_t>::max() / 2);
+        return static_cast<std::int32_t>(std::round(std::clamp(value / precision, -MaxValue, MaxValue)));
+    }
+
+    std::uint32_t zigzag(std::int32_t value)
+    {
+        return (static_cast<std::uint32_t>(value) << 1) ^ static_cast<std::uint32_t>(value >> 31);
+    }
+
+    std::int32_t unzigzag(std::uint32_t value)
+    {
+        return static_cast<std::int32_t>(value >> 1) ^ -static_cast<std::int32_t>(value & 1);
+    }
+
+    //most deltas between ticks are small, so a 2 bit prefix
+    //selects the number of bits used to write them
+    constexpr std::array<std::uint32_t, 4u> DeltaBits = { 4, 8, 16, 32 };
+
+    std::uint32_t getDeltaBucket(std::uint32_t value)
+    {
+        std::uint32_t bucket = 0;
+        while (bucket < 3 && value >= (1u << DeltaBits[bucket]))
+        {
+            bucket++;
+        }
+        return bucket;
+    }
+
+    void writeDelta(BitWriter& writer, std::int32_t delta)
+    {
+        const auto value = zigzag(delta);
+        const auto bucket = getDeltaBucket(value);
+        writer.writeBits(bucket, 2);
+        writer.writeBits(value, DeltaBits[bucket]);
+    }
+
+    bool readDelta(BitReader& reader, std::int32_t& dst)
+    {
+        std::uint32_t bucket = 0;
+        std::uint32_t value = 0;
+        if (!reader.readBits(bucket, 2)
+            || !reader.readBits(value, DeltaBits[bucket]))
+        {
+            return false;
+        }
+        dst = unzigzag(value);
+        return true;
+    }
+
+    void writeVector(BitWriter& writer, const std::array<std::int32_t, 3u>& value, const std::array<std::int32_t, 3u>& baseline)
+    {
+        for (auto i = 0u; i < 3u; ++i)
+        {
+            writeDelta(writer, value[i] - baseline[i]);
+        }
+    }
+
+    bool readVector(BitReader& reader, std::array<std::int32_t, 3u>& dst, const std::array<std::int32_t, 3u>& baseline)
+    {
+        for (auto i = 0u; i < 3u; ++i)
+        {
+            std::int32_t delta = 0;
+            if (!readDelta(reader, delta))
+            {
+                return false;
+            }
+            dst[i] = baseline[i] + delta;
+        }
+        return true;
+    }
+
+    //used as the baseline of entities which are new to the client
+    EntityState defaultState(std::uint32_t netID, const ReplicationSettings& settings)
+    {
+        EntityState state;
+        state.netID = netID;
+        state.rotation = packRotation(glm::quat(1.f, 0.f, 0.f, 0.f), settings.rotationBits);
+
+        const auto scale = quantise(1.f, settings.scalePrecision);
+        state.scale = { scale, scale, scale };
+        return state;
+    }
+}
+
+Snapshot& SnapshotHistory::insert(std::uint16_t sequence)
+{
+    const auto index = sequence % Size;
+    m_valid[index] = true;
+
+    auto& snapshot = m_snapshots[index];
+    snapshot.sequence = sequence;
+    snapshot.timestamp = 0;
+    snapshot.entities.clear();
+    return snapshot;
+}
+
+const Snapshot* SnapshotHistory::find(std::uint16_t sequence) const
+{
+    const auto index = sequence % Size;
+    if (m_valid[index] && m_snapshots[index].sequence == sequence)
+    {
+        return &m_snapshots[index];
+    }
+    return nullptr;
+}
+
+void SnapshotHistory::clear()
+{
+    std::fill(m_valid.begin(), m_valid.end(), false);
+}
+
+const EntityState* Detail::findState(const std::vector<EntityState>& states, std::uint32_t netID)
+{
+    auto result = std::lower_bound(states.begin(), states.end(), netID,
+        [](const EntityState& state, std::uint32_t id) {return state.netID < id; });
+
+    if (result != states.end() && result->netID == netID)
+    {
+        return &(*result);
+    }
+    return nullptr;
+}
+
+std::uint32_t Detail::packRotation(glm::quat q, std::uint32_t bits)
+{
+    return Util::Net::packQuat(q, clampRotationBits(bits));
+}
+
+glm::quat Detail::unpackRotation(std::uint32_t packed, std::uint32_t bits)
+{
+    return Util::Net::unpackQuat(packed, clampRotationBits(bits));
+}
+
+EntityState Detail::quantiseState(std::uint32_t netID, glm::vec3 position, glm::quat rotation, glm::vec3 scale, const ReplicationSettings& settings)
+{
+    EntityState state;
+    state.netID = netID;
+    for (auto i = 0; i < 3; ++i)
+    {
+        state.position[i] = quantise(position[i], settings.positionPrecision);
+    }
+    state.rotation = packRotation(rotation, settings.rotationBits);
+
+    if (settings.replicateScale)
+    {
+        for (auto i = 0; i < 3; ++i)
+        {
+            state.scale[i] = quantise(scale[i], settings.scalePrecision);
+        }
+    }
+    else
+    {
+        state.scale = defaultState(netID, settings).scale;
+    }
+    return state;
+}
+
+void Detail::dequantiseState(const EntityState& state, const ReplicationSettings& settings, glm::vec3& position, glm::quat& rotation, glm::vec3& scale)
+{
+    for (auto i = 0; i < 3; ++i)
+    {
+        position[i] = static_cast<float>(state.position[i]) * settings.positionPrecision;
+        scale[i] = static_cast<float>(state.scale[i]) * settings.scalePrecision;
+    }
+    rotation = unpackRotation(state.rotation, settings.rotationBits);
+}
+
+std::size_t Detail::getStateBitCount(const EntityState& state, const EntityState* previous, const ReplicationSettings& settings)
+{
+    const auto base = previous ? *previous : defaultState(state.netID, settings);
+    if (base.position == state.position
+        && base.rotation == state.rotation
+        && base.scale == state.scale)
+    {
+        return 0;
+    }
+
+    const auto vectorBits = [](const std::array<std::int32_t, 3u>& a, const std::array<std::int32_t, 3u>& b)
+    {
+        std::size_t bits = 0;
+        for (auto i = 0u; i < 3u; ++i)
+        {
+            bits += 2 + DeltaBits[getDeltaBucket(zigzag(a[i] - b[i]))];
+        }
+        return bits;
+    };
+
+    std::size_t bits = 8; //ID delta, usually a single byte
+    bits += 1 + (state.position != base.position ? vectorBits(state.position, base.position) : 0);
+    bits += 1 + (state.rotation != base.rotation ? 2 + (clampRotationBits(settings.rotationBits) * 3) : 0);
+    if (settings.replicateScale)
+    {
+        bits += 1 + (state.scale != base.scale ? vectorBits(state.scale, base.scale) : 0);
+    }
+    return bits;
+}
+
+void Detail::encodeSnapshot(const Snapshot& snapshot, const Snapshot* baseline, const ReplicationSettings& settings, BitWriter& writer)
+{
+    static const std::vector<EntityState> EmptyBaseline;
+    const auto& baseStates = baseline ? baseline->entities : EmptyBaseline;
+
+    writer.writeBits(snapshot.sequence, 16);
+    writer.writeBits(snapshot.timestamp, 32);
+    writer.writeBool(baseline != nullptr);
+    if (baseline)
+    {
+        writer.writeBits(baseline->sequence, 16);
+    }
+
+    //find which entities changed since the baseline and which were removed
+    std::vector<std::pair<const EntityState*, EntityState>> changed;
+    std::vector<std::uint32_t> removed;
+
+    auto base = baseStates.begin();
+    for (const auto& state : snapshot.entities)
+    {
+        while (base != baseStates.end() && base->netID < state.netID)
+        {
+            removed.push_back(base->netID);
+            base++;
+        }
+
+        if (base != baseStates.end() && base->netID == state.netID)
+        {
+            if (base->position != state.position
+                || base->rotation != state.rotation
+                || base->scale != state.scale)
+            {
+                changed.emplace_back(&state, *base);
+            }
+            base++;
+        }
+        else
+        {
+            changed.emplace_back(&state, defaultState(state.netID, settings));
+        }
+    }
+    while (base != baseStates.end())
+    {
+        removed.push_back(base->netID);
+        base++;
+    }
+
+    const auto rotationBits = 2 + (clampRotationBits(settings.rotationBits) * 3);
+
+    writer.writeVarint(static_cast<std::uint32_t>(changed.size()));
+    std::uint32_t prevID = 0;
+    for (const auto& [state, previous] : changed)
+    {
+        writer.writeVarint(state->netID - prevID);
+        prevID = state->netID;
+
+        const bool positionChanged = state->position != previous.position;
+        writer.writeBool(positionChanged);
+        if (positionChanged)
+        {
+            writeVector(writer, state->position, previous.position);
+        }
+
+        const bool rotationChanged = state->rotation != previous.rotation;
+        writer.writeBool(rotationChanged);
+        if (rotationChanged)
+        {
+            writer.writeBits(state->rotation, rotationBits);
+        }
+
+        if (settings.replicateScale)
+        {
+            const bool scaleChanged = state->scale != previous.scale;
+            writer.writeBool(scaleChanged);
+            if (scaleChanged)
+            {
+                writeVector(writer, state->scale, previous.scale);
+            }
+        }
+    }
+
+    writer.writeVarint(static_cast<std::uint32_t>(removed.size()));
+    prevID = 0;
+    for (auto id : removed)
+    {
+        writer.writeVarint(id - prevID);
+        prevID = id;
+    }
+}
+
+bool Detail::decodeSnapshot(BitReader& reader, const SnapshotHistory& history, const ReplicationSettings& settings, Snapshot& dst)
+{
+    static const std::vector<EntityState> EmptyBaseline;
+
+    std::uint32_t sequence = 0;
+    std::uint32_t timestamp = 0;
+    bool hasBaseline = false;
+    if (!reader.readBits(sequence, 16)
+        || !reader.readBits(timestamp, 32)
+        || !reader.readBool(hasBaseline))
+    {
+        return false;
+    }
+
+    const Snapshot* baseline = nullptr;
+    if (hasBaseline)
+    {
+        std::uint32_t baseSequence = 0;
+        if (!reader.readBits(baseSequence, 16))
+        {
+            return false;
+        }
+
+        baseline = history.find(static_cast<std::uint16_t>(baseSequence));
+        if (!baseline)
+        {
+            return false;
+        }
+    }
+    const auto& baseStates = baseline ? baseline->entities : EmptyBaseline;
+    const auto rotationBits = 2 + (clampRotationBits(settings.rotationBits) * 3);
+
+    std::uint32_t changedCount = 0;
+    if (!reader.readVarint(changedCount))
+    {
+        return false;
+    }
+
+    std::vector<EntityState> changed;
+    std::uint32_t prevID = 0;
+    for (auto i = 0u; i < changedCount; ++i)
+    {
+        std::uint32_t idDelta = 0;
+        if (!reader.readVarint(idDelta)
+            || idDelta == 0 //IDs are strictly increasing, and never 0
+            || prevID + idDelta < prevID)
+        {
+            return false;
+        }
+        prevID += idDelta;
+
+        const auto* previous = findState(baseStates, prevID);
+        auto state = previous ? *previous : defaultState(prevID, settings);
+
+        bool fieldChanged = false;
+        if (!reader.readBool(fieldChanged)
+            || (fieldChanged && !readVector(reader, state.position, state.position)))
+        {
+            return false;
+        }
+
+        if (!reader.readBool(fieldChanged)
+            || (fieldChanged && !reader.readBits(state.rotation, rotationBits)))
+        {
+            return false;
+        }
+
+        if (settings.replicateScale)
+        {
+            if (!reader.readBool(fieldChanged)
+                || (fieldChanged && !readVector(reader, state.scale, state.scale)))
+            {
+                return false;
+            }
+        }
+        changed.push_back(state);
+    }
+
+    std::uint32_t removedCount = 0;
+    if (!reader.readVarint(removedCount))
+    {
+        return false;
+    }
+
+    std::vector<std::uint32_t> removed;
+    prevID = 0;
+    for (auto i = 0u; i < removedCount; ++i)
+    {
+        std::uint32_t idDelta = 0;
+        if (!reader.readVarint(idDelta)
+            || idDelta == 0
+            || prevID + idDelta < prevID)
+        {
+            return false;
+        }
+        prevID += idDelta;
+        removed.push_back(prevID);
+    }
+
+    //merge the changes with the unchanged baseline states
+    dst.sequence = static_cast<std::uint16_t>(sequence);
+    dst.timestamp = timestamp;
+    dst.entities.clear();
+    dst.entities.reserve(baseStates.size() + changed.size());
+
+    auto change = changed.begin();
+    auto remove = removed.begin();
+    for (const auto& state : baseStates)
+    {
+        while (change != changed.end() && change->netID < state.netID)
+        {
+            dst.entities.push_back(*change++);
+        }
+
+        while (remove != removed.end() && *remove < state.netID)
+        {
+            remove++;
+        }
+
+        if (change != changed.end() && change->netID == state.netID)
+        {
+            dst.entities.push_back(*change++);
+        }
+        else if (remove == removed.end() || *remove != state.netID)
+        {
+            dst.entities.push_back(state);
+        }
+    }
+    dst.entities.insert(dst.entities.end(), change, changed.end());
+
+    return true;
+}
@@ -0,0 +1,144 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include <crogine/detail/glm/vec3.hpp>
+#include <crogine/detail/glm/gtc/quaternion.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace cro
+{
+    struct ReplicationSettings;
+
+    namespace Util::Net
+    {
+        class BitWriter;
+        class BitReader;
+    }
+
+    namespace Detail
+    {
+        /*!
+        \brief Quantised transform of a single replicated entity
+        */
+        struct EntityState final
+        {
+            std::uint32_t netID = 0;
+            std::array<std::int32_t, 3u> position = {};
+            std::uint32_t rotation = 0; //packed with packRotation()
+            std::array<std::int32_t, 3u> scale = {};
+        };
+
+        /*!
+        \brief The state of all replicated entities at a single server tick.
+        Entities are sorted by netID.
+        */
+        struct Snapshot final
+        {
+            std::uint16_t sequence = 0;
+            std::uint32_t timestamp = 0; //server time in milliseconds
+            std::vector<EntityState> entities;
+        };
+
+        /*!
+        \brief Ring buffer of recent snapshots, indexed by sequence number.
+        Used as baselines for delta compression.
+        */
+        class SnapshotHistory final
+        {
+        public:
+            static constexpr std::size_t Size = 32;
+
+            /*!
+            \brief Returns a cleared snapshot with the given sequence number,
+            replacing any snapshot stored Size ticks ago.
+            */
+            Snapshot& insert(std::uint16_t sequence);
+
+            /*!
+            \brief Returns the snapshot with the given sequence number
+            or nullptr if it is no longer available.
+            */
+            const Snapshot* find(std::uint16_t sequence) const;
+
+            void clear();
+
+        private:
+            std::array<Snapshot, Size> m_snapshots = {};
+            std::array<bool, Size> m_valid = {};
+        };
+
+        /*!
+        \brief Returns true if sequence number a is more recent than b,
+        accounting for wrap around
+        */
+        inline bool sequenceGreater(std::uint16_t a, std::uint16_t b)
+        {
+            return static_cast<std::int16_t>(a - b) > 0;
+        }
+
+        /*!
+        \brief Returns the state with the given netID from a sorted
+        vector of states, or nullptr if it doesn't exist.
+        */
+        const EntityState* findState(const std::vector<EntityState>&, std::uint32_t netID);
+
+        std::uint32_t packRotation(glm::quat, std::uint32_t bits);
+        glm::quat unpackRotation(std::uint32_t, std::uint32_t bits);
+
+        EntityState quantiseState(std::uint32_t netID, glm::vec3 position, glm::quat rotation, glm::vec3 scale, const ReplicationSettings&);
+        void dequantiseState(const EntityState&, const ReplicationSettings&, glm::vec3& position, glm::quat& rotation, glm::vec3& scale);
+
+        /*!
+        \brief Returns the approximate number of bits encodeSnapshot() uses to
+        write the state as a delta of previous, or of a new entity if previous
+        is nullptr. Returns 0 if the state is unchanged.
+        */
+        std::size_t getStateBitCount(const EntityState& state, const EntityState* previous, const ReplicationSettings&);
+
+        /*!
+        \brief Writes the given snapshot as a delta of the baseline.
+        If baseline is nullptr all entity states are written in full.
+        */
+        void encodeSnapshot(const Snapshot& snapshot, const Snapshot* baseline, const ReplicationSettings&, Util::Net::BitWriter&);
+
+        /*!
+        \brief Reads a snapshot written with encodeSnapshot(). The baseline,
+        if used, is looked up in the given history.
+        \returns false if the data is malformed or the baseline
+        is no longer in the history.
+        */
+        bool decodeSnapshot(Util::Net::BitReader&, const SnapshotHistory&, const ReplicationSettings&, Snapshot& dst);
+    }
+}
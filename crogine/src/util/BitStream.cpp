@@ -0,0 +1,383 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include <crogine/util/BitStream.hpp>
+#include <crogine/detail/Assert.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+using namespace cro;
+using namespace cro::Util::Net;
+
+namespace
+{
+    constexpr std::uint32_t MinQuatBits = 2;
+    constexpr std::uint32_t MaxQuatBits = 10;
+    constexpr float MaxQuatComponent = 0.70710678f; //components other than the largest are within +/- 1/sqrt(2)
+
+    std::uint32_t quantisedSteps(float min, float max, float precision)
+    {
+        CRO_ASSERT(max > min && precision > 0, "");
+        const auto steps = std::ceil((max - min) / precision);
+        CRO_ASSERT(steps < static_cast<float>(std::numeric_limits<std::uint32_t>::max()), "Precision too high for range");
+        return static_cast<std::uint32_t>(steps);
+    }
+
+    std::uint32_t intRange(std::int32_t min, std::int32_t max)
+    {
+        CRO_ASSERT(max >= min, "");
+        return static_cast<std::uint32_t>(static_cast<std::int64_t>(max) - min);
+    }
+}
+
+std::uint32_t Util::Net::packQuat(glm::quat q, std::uint32_t bitsPerComponent)
+{
+    const auto bits = std::clamp(bitsPerComponent, MinQuatBits, MaxQuatBits);
+    q = glm::normalize(q);
+
+    const std::array<float, 4u> values = { q.x, q.y, q.z, q.w };
+    std::uint32_t largest = 0;
+    for (auto i = 1u; i < 4u; ++i)
+    {
+        if (std::abs(values[i]) > std::abs(values[largest]))
+        {
+            largest = i;
+        }
+    }
+
+    //q and -q are the same rotation, so flip the sign to make
+    //the largest component positive before omitting it
+    const float sign = values[largest] < 0.f ? -1.f : 1.f;
+    const float maxValue = static_cast<float>((1u << bits) - 1);
+
+    std::uint32_t result = largest;
+    std::uint32_t shift = 2;
+    for (auto i = 0u; i < 4u; ++i)
+    {
+        if (i != largest)
+        {
+            const float normalised = ((values[i] * sign) + MaxQuatComponent) / (MaxQuatComponent * 2.f);
+            const auto value = static_cast<std::uint32_t>(std::round(std::clamp(normalised, 0.f, 1.f) * maxValue));
+
+            result |= (value << shift);
+            shift += bits;
+        }
+    }
+    return result;
+}
+
+glm::quat Util::Net::unpackQuat(std::uint32_t packed, std::uint32_t bitsPerComponent)
+{
+    const auto bits = std::clamp(bitsPerComponent, MinQuatBits, MaxQuatBits);
+
+    const std::uint32_t largest = packed & 0x3;
+    const std::uint32_t mask = (1u << bits) - 1;
+    const float maxValue = static_cast<float>(mask);
+
+    std::array<float, 4u> values = {};
+    float sum = 0.f;
+    std::uint32_t shift = 2;
+    for (auto i = 0u; i < 4u; ++i)
+    {
+        if (i != largest)
+        {
+            const auto value = (packed >> shift) & mask;
+            values[i] = ((static_cast<float>(value) / maxValue) * (MaxQuatComponent * 2.f)) - MaxQuatComponent;
+            sum += values[i] * values[i];
+            shift += bits;
+        }
+    }
+    values[largest] = std::sqrt(std::max(0.f, 1.f - sum));
+
+    return glm::normalize(glm::quat(values[3], values[0], values[1], values[2]));
+}
+
+//----------------------------//
+
+void BitWriter::writeBits(std::uint32_t value, std::uint32_t bitCount)
+{
+    CRO_ASSERT(bitCount <= 32, "");
+
+    while (bitCount)
+    {
+        const auto byteIndex = m_bitCount / 8;
+        const auto bitOffset = static_cast<std::uint32_t>(m_bitCount % 8);
+        if (byteIndex == m_data.size())
+        {
+            m_data.push_back(0);
+        }
+
+        const auto count = std::min(8u - bitOffset, bitCount);
+        const auto mask = (1u << count) - 1;
+        m_data[byteIndex] |= static_cast<std::uint8_t>((value & mask) << bitOffset);
+
+        value >>= count;
+        bitCount -= count;
+        m_bitCount += count;
+    }
+}
+
+void BitWriter::writeBool(bool value)
+{
+    writeBits(value ? 1 : 0, 1);
+}
+
+void BitWriter::writeInt(std::int32_t value, std::int32_t min, std::int32_t max)
+{
+    const auto range = intRange(min, max);
+    value = std::clamp(value, min, max);
+    writeBits(static_cast<std::uint32_t>(static_cast<std::int64_t>(value) - min), bitsRequired(range));
+}
+
+void BitWriter::writeVarint(std::uint32_t value)
+{
+    do
+    {
+        const auto group = value & 0x7f;
+        value >>= 7;
+        writeBits(group | (value ? 0x80 : 0), 8);
+    } while (value);
+}
+
+void BitWriter::writeSignedVarint(std::int32_t value)
+{
+    //zigzag encoding maps 0, -1, 1, -2, 2... to 0, 1, 2, 3, 4...
+    writeVarint((static_cast<std::uint32_t>(value) << 1) ^ static_cast<std::uint32_t>(value >> 31));
+}
+
+void BitWriter::writeFloat(float value)
+{
+    std::uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeBits(bits, 32);
+}
+
+void BitWriter::writeFloat(float value, float min, float max, float precision)
+{
+    if (std::isnan(value))
+    {
+        value = min;
+    }
+
+    const auto steps = quantisedSteps(min, max, precision);
+    const auto normalised = (std::clamp(value, min, max) - min) / precision;
+    const auto quantised = std::min(static_cast<std::uint32_t>(std::round(normalised)), steps);
+
+    writeBits(quantised, bitsRequired(steps));
+}
+
+void BitWriter::writeVec3(glm::vec3 value, float min, float max, float precision)
+{
+    writeFloat(value.x, min, max, precision);
+    writeFloat(value.y, min, max, precision);
+    writeFloat(value.z, min, max, precision);
+}
+
+void BitWriter::writeQuat(glm::quat value, std::uint32_t bitsPerComponent)
+{
+    const auto bits = std::clamp(bitsPerComponent, MinQuatBits, MaxQuatBits);
+    writeBits(packQuat(value, bits), 2 + (bits * 3));
+}
+
+void BitWriter::clear()
+{
+    m_data.clear();
+    m_bitCount = 0;
+}
+
+//----------------------------//
+
+BitReader::BitReader(const void* data, std::size_t size)
+    : m_data        (static_cast<const std::uint8_t*>(data)),
+    m_bitSize       (data ? size * 8 : 0),
+    m_bitPosition   (0),
+    m_error         (false)
+{
+
+}
+
+bool BitReader::readBits(std::uint32_t& dst, std::uint32_t bitCount)
+{
+    if (m_error
+        || bitCount > 32
+        || getBitsRemaining() < bitCount)
+    {
+        m_error = true;
+        return false;
+    }
+
+    std::uint32_t result = 0;
+    std::uint32_t shift = 0;
+    while (bitCount)
+    {
+        const auto byteIndex = m_bitPosition / 8;
+        const auto bitOffset = static_cast<std::uint32_t>(m_bitPosition % 8);
+
+        const auto count = std::min(8u - bitOffset, bitCount);
+        const auto mask = (1u << count) - 1;
+        result |= ((static_cast<std::uint32_t>(m_data[byteIndex]) >> bitOffset) & mask) << shift;
+
+        shift += count;
+        bitCount -= count;
+        m_bitPosition += count;
+    }
+    dst = result;
+    return true;
+}
+
+bool BitReader::readBool(bool& dst)
+{
+    std::uint32_t value = 0;
+    if (readBits(value, 1))
+    {
+        dst = (value != 0);
+        return true;
+    }
+    return false;
+}
+
+bool BitReader::readInt(std::int32_t& dst, std::int32_t min, std::int32_t max)
+{
+    const auto range = intRange(min, max);
+
+    std::uint32_t value = 0;
+    if (!readBits(value, bitsRequired(range)))
+    {
+        return false;
+    }
+
+    if (value > range)
+    {
+        m_error = true;
+        return false;
+    }
+    dst = static_cast<std::int32_t>(static_cast<std::int64_t>(min) + value);
+    return true;
+}
+
+bool BitReader::readVarint(std::uint32_t& dst)
+{
+    std::uint32_t result = 0;
+    for (auto shift = 0u; shift < 35; shift += 7)
+    {
+        std::uint32_t group = 0;
+        if (!readBits(group, 8))
+        {
+            return false;
+        }
+
+        //the final group may only contain the top 4 bits of a 32 bit value
+        if (shift == 28 && (group & 0xf0))
+        {
+            break;
+        }
+
+        result |= (group & 0x7f) << shift;
+        if ((group & 0x80) == 0)
+        {
+            dst = result;
+            return true;
+        }
+    }
+
+    m_error = true;
+    return false;
+}
+
+bool BitReader::readSignedVarint(std::int32_t& dst)
+{
+    std::uint32_t value = 0;
+    if (readVarint(value))
+    {
+        dst = static_cast<std::int32_t>(value >> 1) ^ -static_cast<std::int32_t>(value & 1);
+        return true;
+    }
+    return false;
+}
+
+bool BitReader::readFloat(float& dst)
+{
+    std::uint32_t bits = 0;
+    if (readBits(bits, 32))
+    {
+        std::memcpy(&dst, &bits, sizeof(bits));
+        return true;
+    }
+    return false;
+}
+
+bool BitReader::readFloat(float& dst, float min, float max, float precision)
+{
+    const auto steps = quantisedSteps(min, max, precision);
+
+    std::uint32_t value = 0;
+    if (!readBits(value, bitsRequired(steps)))
+    {
+        return false;
+    }
+
+    if (value > steps)
+    {
+        m_error = true;
+        return false;
+    }
+    dst = std::min(min + (static_cast<float>(value) * precision), max);
+    return true;
+}
+
+bool BitReader::readVec3(glm::vec3& dst, float min, float max, float precision)
+{
+    glm::vec3 result(0.f);
+    if (readFloat(result.x, min, max, precision)
+        && readFloat(result.y, min, max, precision)
+        && readFloat(result.z, min, max, precision))
+    {
+        dst = result;
+        return true;
+    }
+    return false;
+}
+
+bool BitReader::readQuat(glm::quat& dst, std::uint32_t bitsPerComponent)
+{
+    const auto bits = std::clamp(bitsPerComponent, MinQuatBits, MaxQuatBits);
+
+    std::uint32_t value = 0;
+    if (readBits(value, 2 + (bits * 3)))
+    {
+        dst = unpackQuat(value, bits);
+        return true;
+    }
+    return false;
+}
@@ -65,7 +65,7 @@ using namespace sv;
 GameState::GameState(SharedData& sd)
     : m_returnValue (StateID::Game),
     m_sharedData    (sd),
-    m_scene         (sd.messageBus),
+    m_scene         (sd.messageBus, 128, cro::SCENE_FLAG_HEADLESS),
     m_activePlayers (0),
     m_playerSpawns  (PlayerSpawns)
 {
@@ -1320,7 +1320,14 @@ void BilliardsState::handleNetEvent(const net::NetEvent& evt)
         }
             break;
         case PacketID::ActorSpawn:
-            spawnBall(evt.packet.as<ActorInfo>());
+        {
+            ActorInfo info;
+            cro::Util::Net::BitReader reader(evt.packet.getData(), evt.packet.getSize());
+            if (cro::Util::Net::read(reader, info))
+            {
+                spawnBall(info);
+            }
+        }
             break;
         case PacketID::SetPlayer:
             m_wantsGameState = false;
@@ -1378,10 +1385,10 @@ void BilliardsState::spawnBall(const ActorInfo& info)
 {
     auto entity = m_gameScene.createEntity();
     entity.addComponent<cro::Transform>().setPosition(info.position);
-    entity.getComponent<cro::Transform>().setRotation(cro::Util::Net::decompressQuat(info.rotation));
+    entity.getComponent<cro::Transform>().setRotation(info.rotation);
     entity.addComponent<cro::CommandTarget>().ID = CommandID::Ball;
     entity.addComponent<InterpolationComponent<InterpolationType::Hermite>>(
-        InterpolationPoint(info.position, glm::vec3(0.f), cro::Util::Net::decompressQuat(info.rotation), info.timestamp)).id = info.serverID;
+        InterpolationPoint(info.position, glm::vec3(0.f), info.rotation, info.timestamp)).id = info.serverID;
     entity.addComponent<BilliardBall>().id = info.state;
 
     m_ballDefinition.createModel(entity);
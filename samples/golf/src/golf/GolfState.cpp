@@ -3811,7 +3811,7 @@ void GolfState::spawnBall(const ActorInfo& info)
     entity.getComponent<cro::Transform>().setScale(glm::vec3(0.f));
     entity.addComponent<cro::CommandTarget>().ID = CommandID::Ball;
     entity.addComponent<InterpolationComponent<InterpolationType::Linear>>(
-        InterpolationPoint(info.position, glm::vec3(0.f), cro::Util::Net::decompressQuat(info.rotation), info.timestamp)).id = info.serverID;
+        InterpolationPoint(info.position, glm::vec3(0.f), info.rotation, info.timestamp)).id = info.serverID;
     entity.addComponent<ClientCollider>();
     entity.addComponent<cro::Model>(m_resources.meshes.getMesh(m_ballResources.ballMeshID), material);
     entity.getComponent<cro::Model>().setRenderFlags(~RenderFlags::MiniMap);
@@ -4184,10 +4184,24 @@ void GolfState::handleNetEvent(const net::NetEvent& evt)
             }
             break;
         case PacketID::ActorSpawn:
-            spawnBall(evt.packet.as<ActorInfo>());
+        {
+            ActorInfo info;
+            cro::Util::Net::BitReader reader(evt.packet.getData(), evt.packet.getSize());
+            if (cro::Util::Net::read(reader, info))
+            {
+                spawnBall(info);
+            }
+        }
             break;
         case PacketID::ActorUpdate:
-            updateActor( evt.packet.as<ActorInfo>());            
+        {
+            ActorInfo info;
+            cro::Util::Net::BitReader reader(evt.packet.getData(), evt.packet.getSize());
+            if (cro::Util::Net::read(reader, info))
+            {
+                updateActor(info);
+            }
+        }
             break;
         case PacketID::ActorAnimation:
         {
@@ -5278,7 +5292,7 @@ void GolfState::updateActor(const ActorInfo& update)
             bool active = (interp.id == update.serverID);
             if (active)
             {
-                interp.addPoint({ update.position, glm::vec3(0.f), cro::Util::Net::decompressQuat(update.rotation), update.timestamp });
+                interp.addPoint({ update.position, glm::vec3(0.f), update.rotation, update.timestamp });
 
                 //update spectator camera
                 cro::Command cmd2;
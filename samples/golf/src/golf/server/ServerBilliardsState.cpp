@@ -52,7 +52,7 @@ namespace
 BilliardsState::BilliardsState(SharedData& sd)
     : m_returnValue     (StateID::Billiards),
     m_sharedData        (sd),
-    m_scene             (sd.messageBus, 512),
+    m_scene             (sd.messageBus, 512, cro::SCENE_FLAG_HEADLESS),
     m_tableDataValid    (false),
     m_gameStarted       (false),
     m_allMapsLoaded     (false),
@@ -356,12 +356,14 @@ void BilliardsState::sendInitialGameState(std::uint8_t clientID)
 
             ActorInfo info;
             info.position = entity.getComponent<cro::Transform>().getPosition();
-            info.rotation = cro::Util::Net::compressQuat(entity.getComponent<cro::Transform>().getRotation());
+            info.rotation = entity.getComponent<cro::Transform>().getRotation();
             info.serverID = entity.getIndex();
             info.timestamp = timestamp;
             info.state = ball.id;
 
-            m_sharedData.host.sendPacket(m_sharedData.clients[clientID].peer, PacketID::ActorSpawn, info, net::NetFlag::Reliable);
+            cro::Util::Net::BitWriter writer;
+            cro::Util::Net::write(writer, info);
+            m_sharedData.host.sendPacket(m_sharedData.clients[clientID].peer, PacketID::ActorSpawn, writer.getData(), writer.getSize(), net::NetFlag::Reliable);
         }
 
         //and the table info such as the cueball spawn
@@ -479,11 +481,13 @@ void BilliardsState::spawnBall(cro::Entity entity)
     ActorInfo info;
     info.serverID = entity.getIndex();
     info.position = entity.getComponent<cro::Transform>().getPosition();
-    info.rotation = cro::Util::Net::compressQuat(entity.getComponent<cro::Transform>().getRotation());
+    info.rotation = entity.getComponent<cro::Transform>().getRotation();
     info.state = entity.getComponent<BilliardBall>().id;
     info.timestamp = m_serverTime.elapsed().asMilliseconds();
 
-    m_sharedData.host.broadcastPacket(PacketID::ActorSpawn, info, net::NetFlag::Reliable, ConstVal::NetChannelReliable);
+    cro::Util::Net::BitWriter writer;
+    cro::Util::Net::write(writer, info);
+    m_sharedData.host.broadcastPacket(PacketID::ActorSpawn, writer.getData(), writer.getSize(), net::NetFlag::Reliable, ConstVal::NetChannelReliable);
 }
 
 void BilliardsState::endGame(const BilliardsPlayer& winner)
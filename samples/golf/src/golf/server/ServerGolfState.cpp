@@ -59,7 +59,7 @@ GolfState::GolfState(SharedData& sd)
     : m_returnValue (StateID::Golf),
     m_sharedData    (sd),
     m_mapDataValid  (false),
-    m_scene         (sd.messageBus, 512),
+    m_scene         (sd.messageBus, 512, cro::SCENE_FLAG_HEADLESS),
     m_gameStarted   (false),
     m_allMapsLoaded (false),
     m_currentHole   (0),
@@ -242,13 +242,15 @@ void GolfState::netBroadcast()
             ActorInfo info;
             info.serverID = static_cast<std::uint32_t>(ball.getIndex());
             info.position = ball.getComponent<cro::Transform>().getPosition();
-            info.rotation = cro::Util::Net::compressQuat(ball.getComponent<cro::Transform>().getRotation());
+            info.rotation = ball.getComponent<cro::Transform>().getRotation();
             //info.velocity = cro::Util::Net::compressVec3(ball.getComponent<Ball>().velocity);
             info.timestamp = timestamp;
             info.clientID = player.client;
             info.playerID = player.player;
             info.state = static_cast<std::uint8_t>(ball.getComponent<Ball>().state);
-            m_sharedData.host.broadcastPacket(PacketID::ActorUpdate, info, net::NetFlag::Unreliable);
+            cro::Util::Net::BitWriter writer;
+            cro::Util::Net::write(writer, info);
+            m_sharedData.host.broadcastPacket(PacketID::ActorUpdate, writer.getData(), writer.getSize(), net::NetFlag::Unreliable);
         }
     }
 
@@ -318,7 +320,9 @@ void GolfState::sendInitialGameState(std::uint8_t clientID)
             info.clientID = player.client;
             info.playerID = player.player;
             info.timestamp = timestamp;
-            m_sharedData.host.sendPacket(m_sharedData.clients[clientID].peer, PacketID::ActorSpawn, info, net::NetFlag::Reliable);
+            cro::Util::Net::BitWriter writer;
+            cro::Util::Net::write(writer, info);
+            m_sharedData.host.sendPacket(m_sharedData.clients[clientID].peer, PacketID::ActorSpawn, writer.getData(), writer.getSize(), net::NetFlag::Reliable);
         }
     }
 
@@ -613,7 +617,9 @@ void GolfState::setNextHole()
             info.clientID = player.client;
             info.playerID = player.player;
             info.state = static_cast<std::uint8_t>(ball.getComponent<Ball>().state);
-            m_sharedData.host.broadcastPacket(PacketID::ActorUpdate, info, net::NetFlag::Reliable, ConstVal::NetChannelReliable);
+            cro::Util::Net::BitWriter writer;
+            cro::Util::Net::write(writer, info);
+            m_sharedData.host.broadcastPacket(PacketID::ActorUpdate, writer.getData(), writer.getSize(), net::NetFlag::Reliable, ConstVal::NetChannelReliable);
         }
 
         //tell clients to set up next hole
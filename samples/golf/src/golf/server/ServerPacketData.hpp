@@ -34,6 +34,10 @@ source distribution.
 
 #include <crogine/ecs/Entity.hpp>
 #include <crogine/detail/glm/vec3.hpp>
+#include <crogine/detail/glm/gtc/quaternion.hpp>
+#include <crogine/util/BitStream.hpp>
+
+#include <limits>
 
 struct ActivePlayer
 {
@@ -64,16 +68,35 @@ struct PlayerStatus final : public ActivePlayer
     bool readyQuit = false; //used at round end to see if all players want to skip scores
 };
 
+//sent with cro::Util::Net::BitWriter rather than as raw bytes
 struct ActorInfo final
 {
-    std::array<std::int16_t, 4u> rotation = {};
-    //std::array<std::int16_t, 3u> velocity = {};
+    glm::quat rotation = glm::quat(1.f, 0.f, 0.f, 0.f);
     std::uint32_t serverID = 0;
     glm::vec3 position = glm::vec3(0.f);
     std::int32_t timestamp = 0;
     std::uint8_t clientID = 0;
     std::uint8_t playerID = 0;
     std::uint8_t state = 0;
+
+    //positions are quantised to 2mm within the bounds of
+    //the largest course (320x200) plus a margin for OOB
+    static constexpr float PositionPrecision = 1.f / 512.f;
+    static constexpr std::uint32_t RotationBits = 9;
+
+    template <typename Stream>
+    bool serialise(Stream& stream)
+    {
+        return stream.serialiseVarint(serverID)
+            && stream.serialiseFloat(position.x, -64.f, 384.f, PositionPrecision)
+            && stream.serialiseFloat(position.y, -16.f, 240.f, PositionPrecision)
+            && stream.serialiseFloat(position.z, -264.f, 64.f, PositionPrecision)
+            && stream.serialiseQuat(rotation, RotationBits)
+            && stream.serialiseInt(timestamp, 0, std::numeric_limits<std::int32_t>::max())
+            && stream.serialiseInt(clientID, 0, static_cast<std::int32_t>(ConstVal::MaxClients) - 1)
+            && stream.serialiseInt(playerID, 0, 3) //ConnectionData::MaxPlayers
+            && stream.serialiseInt(state, 0, 255);
+    }
 };
 
 static inline bool operator == (const ActorInfo& actor, const ActivePlayer& player)
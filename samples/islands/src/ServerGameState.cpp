@@ -59,7 +59,7 @@ namespace
 GameState::GameState(SharedData& sd)
     : m_returnValue (StateID::Game),
     m_sharedData    (sd),
-    m_scene         (sd.messageBus)
+    m_scene         (sd.messageBus, 128, cro::SCENE_FLAG_HEADLESS)
 {
     initScene();
     buildWorld();
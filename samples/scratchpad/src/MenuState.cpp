@@ -385,6 +385,32 @@ void MenuState::createScene()
                 }
             });
 
+    //net bench button
+    textPos.y -= MenuSpacing;
+    entity = createButton("Network Benchmark", textPos);
+    entity.getComponent<cro::UIInput>().callbacks[cro::UIInput::ButtonUp] =
+        uiSystem->addCallback([&](cro::Entity e, const cro::ButtonEvent& evt)
+            {
+                if (activated(evt))
+                {
+                    requestStackClear();
+                    requestStackPush(States::ScratchPad::NetBench);
+                }
+            });
+
+    //engine benchmarks button
+    textPos.y -= MenuSpacing;
+    entity = createButton("Benchmarks", textPos);
+    entity.getComponent<cro::UIInput>().callbacks[cro::UIInput::ButtonUp] =
+        uiSystem->addCallback([&](cro::Entity e, const cro::ButtonEvent& evt)
+            {
+                if (activated(evt))
+                {
+                    requestStackClear();
+                    requestStackPush(States::ScratchPad::Benchmarks);
+                }
+            });
+
 
     //load plugin
     textPos.y -= MenuSpacing;
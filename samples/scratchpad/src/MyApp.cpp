@@ -35,6 +35,8 @@ source distribution.
 #include "bsp/BspState.hpp"
 #include "collision/CollisionState.hpp"
 #include "frustum/FrustumState.hpp"
+#include "netbench/NetBenchState.hpp"
+#include "benchmarks/BenchmarkState.hpp"
 #include "voxels/VoxelState.hpp"
 #include "vats/VatsState.hpp"
 #include "retro/RetroState.hpp"
@@ -116,6 +118,8 @@ bool MyApp::initialise()
     m_stateStack.registerState<RetroState>(States::ScratchPad::Retro);
     m_stateStack.registerState<FrustumState>(States::ScratchPad::Frustum);
     m_stateStack.registerState<RollingState>(States::ScratchPad::Rolling);
+    m_stateStack.registerState<NetBenchState>(States::ScratchPad::NetBench);
+    m_stateStack.registerState<BenchmarkState>(States::ScratchPad::Benchmarks);
 
 #ifdef CRO_DEBUG_
     m_stateStack.pushState(States::ScratchPad::Rolling);
@@ -46,6 +46,8 @@ namespace States
             Rolling,
             Voxels,
             VATs,
+            NetBench,
+            Benchmarks,
 
             Count
         };
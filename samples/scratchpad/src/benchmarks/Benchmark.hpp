@@ -0,0 +1,53 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+/*
+A benchmark or test shown as a tab of the BenchmarkState. The state
+calls run() on its worker thread, and none of the other functions
+until run() has returned, so settings and results need no locking
+*/
+class Benchmark
+{
+public:
+    virtual ~Benchmark() = default;
+
+    virtual const char* getName() const = 0;
+
+    //draws the ImGui controls for this benchmark's settings
+    virtual void drawSettings() = 0;
+
+    //called on the worker thread
+    virtual void run() = 0;
+
+    //draws the results of the last run, if there was one
+    virtual void drawResult() = 0;
+};
@@ -0,0 +1,174 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include "BenchmarkState.hpp"
+#include "BitStreamFuzz.hpp"
+#include "ConfigBench.hpp"
+#include "QuadBench.hpp"
+#include "TreeBench.hpp"
+
+#include <crogine/core/App.hpp>
+#include <crogine/ecs/components/Transform.hpp>
+#include <crogine/gui/Gui.hpp>
+
+namespace
+{
+    //scenes hold at most Detail::MinFreeIDs entities, a few
+    //of which are used by the scene itself
+    constexpr std::int32_t EntityCount = 1000;
+}
+
+BenchmarkState::BenchmarkState(cro::StateStack& stack, cro::State::Context context)
+    : cro::State        (stack, context),
+    m_scene             (context.appInstance.getMessageBus()),
+    m_activeBenchmark   (0),
+    m_running           (false)
+{
+    m_entities.reserve(EntityCount);
+    for (auto i = 0; i < EntityCount; ++i)
+    {
+        auto entity = m_scene.createEntity();
+        entity.addComponent<cro::Transform>();
+        m_entities.push_back(entity);
+    }
+
+    m_benchmarks.emplace_back(std::make_unique<ConfigBench>());
+    m_benchmarks.emplace_back(std::make_unique<TreeBench>(m_entities));
+    m_benchmarks.emplace_back(std::make_unique<QuadBench>(m_entities));
+    m_benchmarks.emplace_back(std::make_unique<BitStreamFuzz>());
+
+    context.mainWindow.loadResources([this]() {
+        createUI();
+    });
+}
+
+BenchmarkState::~BenchmarkState()
+{
+    //the running benchmark must finish before it's destroyed
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+//public
+bool BenchmarkState::handleEvent(const cro::Event& evt)
+{
+    if (cro::ui::wantsMouse() || cro::ui::wantsKeyboard())
+    {
+        return true;
+    }
+
+    if (evt.type == SDL_KEYDOWN)
+    {
+        switch (evt.key.keysym.sym)
+        {
+        default: break;
+        case SDLK_BACKSPACE:
+            if (!m_running)
+            {
+                requestStackClear();
+                requestStackPush(States::ScratchPad::MainMenu);
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+void BenchmarkState::handleMessage(const cro::Message&)
+{
+
+}
+
+bool BenchmarkState::simulate(float)
+{
+    if (!m_running && m_thread.joinable())
+    {
+        m_thread.join();
+    }
+    return true;
+}
+
+void BenchmarkState::render()
+{
+
+}
+
+//private
+void BenchmarkState::createUI()
+{
+    registerWindow([&]()
+        {
+            if (ImGui::Begin("Benchmarks"))
+            {
+                //the benchmarks are left alone while one is running
+                if (m_running)
+                {
+                    ImGui::Text("Running %s...", m_benchmarks[m_activeBenchmark]->getName());
+                }
+                else if (ImGui::BeginTabBar("##benchmarks"))
+                {
+                    for (auto i = 0u; i < m_benchmarks.size(); ++i)
+                    {
+                        auto& benchmark = *m_benchmarks[i];
+                        if (ImGui::BeginTabItem(benchmark.getName()))
+                        {
+                            benchmark.drawSettings();
+
+                            if (ImGui::Button("Run"))
+                            {
+                                //the last run may have finished since simulate()
+                                if (m_thread.joinable())
+                                {
+                                    m_thread.join();
+                                }
+
+                                m_activeBenchmark = i;
+                                m_running = true;
+                                m_thread = std::thread([&, i]()
+                                    {
+                                        m_benchmarks[i]->run();
+                                        m_running = false;
+                                    });
+                            }
+
+                            ImGui::Separator();
+                            benchmark.drawResult();
+
+                            ImGui::EndTabItem();
+                        }
+                    }
+                    ImGui::EndTabBar();
+                }
+            }
+            ImGui::End();
+        });
+}
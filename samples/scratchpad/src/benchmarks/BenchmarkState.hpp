@@ -0,0 +1,76 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include "../StateIDs.hpp"
+#include "Benchmark.hpp"
+
+#include <crogine/core/State.hpp>
+#include <crogine/ecs/Scene.hpp>
+#include <crogine/gui/GuiClient.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/*
+Runs the engine benchmarks and tests, each in its own tab, on a
+worker thread so that the UI remains responsive while they're run
+*/
+class BenchmarkState final : public cro::State, public cro::GuiClient
+{
+public:
+    BenchmarkState(cro::StateStack&, cro::State::Context);
+    ~BenchmarkState();
+
+    cro::StateID getStateID() const override { return States::ScratchPad::Benchmarks; }
+
+    bool handleEvent(const cro::Event&) override;
+    void handleMessage(const cro::Message&) override;
+    bool simulate(float) override;
+    void render() override;
+
+private:
+
+    //the trees are given bounds directly so these are only
+    //used as handles, and the scene is never simulated
+    cro::Scene m_scene;
+    std::vector<cro::Entity> m_entities;
+
+    std::vector<std::unique_ptr<Benchmark>> m_benchmarks;
+    std::size_t m_activeBenchmark;
+
+    std::thread m_thread;
+    std::atomic_bool m_running;
+
+    void createUI();
+};
@@ -0,0 +1,665 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include "BitStreamFuzz.hpp"
+
+#include <crogine/core/Clock.hpp>
+#include <crogine/gui/Gui.hpp>
+#include <crogine/util/BitStream.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace cro::Util::Net;
+
+namespace
+{
+    //mirrors ActorInfo in the golf sample's server/ServerPacketData.hpp,
+    //which can't be included here, so keep the two in sync
+    constexpr std::int32_t MaxClients = 4;
+    const glm::vec3 MinPosition(-64.f, -16.f, -264.f);
+    const glm::vec3 MaxPosition(384.f, 240.f, 64.f);
+
+    struct ActorInfo final
+    {
+        glm::quat rotation = glm::quat(1.f, 0.f, 0.f, 0.f);
+        std::uint32_t serverID = 0;
+        glm::vec3 position = glm::vec3(0.f);
+        std::int32_t timestamp = 0;
+        std::uint8_t clientID = 0;
+        std::uint8_t playerID = 0;
+        std::uint8_t state = 0;
+
+        static constexpr float PositionPrecision = 1.f / 512.f;
+        static constexpr std::uint32_t RotationBits = 9;
+
+        template <typename Stream>
+        bool serialise(Stream& stream)
+        {
+            return stream.serialiseVarint(serverID)
+                && stream.serialiseFloat(position.x, MinPosition.x, MaxPosition.x, PositionPrecision)
+                && stream.serialiseFloat(position.y, MinPosition.y, MaxPosition.y, PositionPrecision)
+                && stream.serialiseFloat(position.z, MinPosition.z, MaxPosition.z, PositionPrecision)
+                && stream.serialiseQuat(rotation, RotationBits)
+                && stream.serialiseInt(timestamp, 0, std::numeric_limits<std::int32_t>::max())
+                && stream.serialiseInt(clientID, 0, MaxClients - 1)
+                && stream.serialiseInt(playerID, 0, 3)
+                && stream.serialiseInt(state, 0, 255);
+        }
+    };
+
+    using Rng = std::mt19937;
+
+    //shifts a random value by a random amount so that
+    //small values, which use fewer bytes, are tested too
+    std::uint32_t randomMagnitude(Rng& rng)
+    {
+        return static_cast<std::uint32_t>(rng()) >> (rng() % 32);
+    }
+
+    glm::quat randomQuat(Rng& rng)
+    {
+        std::normal_distribution<float> dist;
+        glm::quat q(dist(rng), dist(rng), dist(rng), dist(rng));
+        return glm::length(q) > 0.0001f ? glm::normalize(q) : glm::quat(1.f, 0.f, 0.f, 0.f);
+    }
+
+    bool isUnit(glm::quat q)
+    {
+        return std::isfinite(q.x) && std::isfinite(q.y) && std::isfinite(q.z) && std::isfinite(q.w)
+            && std::abs(glm::length(q) - 1.f) < 0.001f;
+    }
+
+    //each of the three sent components is within half a
+    //step, and the reconstructed one is within a similar error
+    bool quatMatches(glm::quat a, glm::quat b, std::uint32_t bitsPerComponent)
+    {
+        const auto bits = std::clamp(bitsPerComponent, 2u, 10u);
+        const float maxError = (0.70710678f / static_cast<float>((1u << bits) - 1)) * 4.f;
+        return std::abs(glm::dot(a, b)) >= 1.f - ((maxError * maxError) / 2.f);
+    }
+
+    bool floatMatches(float value, float expected, float min, float max, float precision)
+    {
+        const float tolerance = (precision / 2.f) + ((std::abs(min) + std::abs(max)) * 0.00001f);
+        return std::abs(value - std::clamp(expected, min, max)) <= tolerance;
+    }
+
+    ActorInfo randomActor(Rng& rng)
+    {
+        std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+        ActorInfo actor;
+        actor.serverID = randomMagnitude(rng);
+        actor.position = MinPosition + (glm::vec3(unit(rng), unit(rng), unit(rng)) * (MaxPosition - MinPosition));
+        actor.rotation = randomQuat(rng);
+        actor.timestamp = static_cast<std::int32_t>(randomMagnitude(rng) >> 1);
+        actor.clientID = static_cast<std::uint8_t>(rng() % MaxClients);
+        actor.playerID = static_cast<std::uint8_t>(rng() % 4);
+        actor.state = static_cast<std::uint8_t>(rng() % 256);
+        return actor;
+    }
+
+    bool actorMatches(const ActorInfo& a, const ActorInfo& b)
+    {
+        for (auto i = 0; i < 3; ++i)
+        {
+            if (!floatMatches(b.position[i], a.position[i], MinPosition[i], MaxPosition[i], ActorInfo::PositionPrecision))
+            {
+                return false;
+            }
+        }
+
+        return a.serverID == b.serverID
+            && quatMatches(a.rotation, b.rotation, ActorInfo::RotationBits)
+            && a.timestamp == b.timestamp
+            && a.clientID == b.clientID
+            && a.playerID == b.playerID
+            && a.state == b.state;
+    }
+
+    //written values have to be read back with the same parameters,
+    //which for a valid packet serialise() ensures
+    bool actorInRange(const ActorInfo& actor)
+    {
+        for (auto i = 0; i < 3; ++i)
+        {
+            //also false for NaN
+            if (!(actor.position[i] >= MinPosition[i] && actor.position[i] <= MaxPosition[i]))
+            {
+                return false;
+            }
+        }
+
+        return isUnit(actor.rotation)
+            && actor.timestamp >= 0
+            && actor.clientID < MaxClients
+            && actor.playerID < 4;
+    }
+
+    //a single call to one of the BitWriter/BitReader functions
+    struct Op final
+    {
+        enum
+        {
+            Bits, Bool, Int, Varint, SignedVarint,
+            Float, RangedFloat, Quat,
+
+            Count
+        };
+        std::int32_t type = Bits;
+
+        std::uint32_t bitCount = 0; //or bits per quat component
+        std::int32_t min = 0;
+        std::int32_t max = 0;
+        float floatMin = 0.f;
+        float floatMax = 0.f;
+        float precision = 1.f;
+
+        std::uint32_t uintValue = 0;
+        std::int32_t intValue = 0;
+        float floatValue = 0.f;
+        glm::quat quatValue = glm::quat(1.f, 0.f, 0.f, 0.f);
+    };
+
+    //when only reading, bit counts which are invalid
+    //for the writer are included, and should fail
+    Op randomOp(Rng& rng, bool readOnly)
+    {
+        Op op;
+        op.type = static_cast<std::int32_t>(rng() % Op::Count);
+
+        switch (op.type)
+        {
+        default: break;
+        case Op::Bits:
+            op.bitCount = static_cast<std::uint32_t>(rng() % (readOnly ? 41 : 33));
+            op.uintValue = static_cast<std::uint32_t>(rng());
+            break;
+        case Op::Bool:
+            op.uintValue = static_cast<std::uint32_t>(rng() % 2);
+            break;
+        case Op::Int:
+        {
+            op.min = static_cast<std::int32_t>(rng()) >> (rng() % 32);
+            const auto max = static_cast<std::int64_t>(op.min) + randomMagnitude(rng);
+            op.max = static_cast<std::int32_t>(std::min<std::int64_t>(max, std::numeric_limits<std::int32_t>::max()));
+
+            //values outside the range should be clamped
+            if (rng() % 4)
+            {
+                const auto range = static_cast<std::uint64_t>(static_cast<std::int64_t>(op.max) - op.min) + 1;
+                op.intValue = static_cast<std::int32_t>(op.min + static_cast<std::int64_t>(rng() % range));
+            }
+            else
+            {
+                op.intValue = static_cast<std::int32_t>(rng());
+            }
+        }
+            break;
+        case Op::Varint:
+            op.uintValue = randomMagnitude(rng);
+            break;
+        case Op::SignedVarint:
+            op.intValue = static_cast<std::int32_t>(rng()) >> (rng() % 32);
+            break;
+        case Op::Float:
+            //any bit pattern, including NaN
+            op.uintValue = static_cast<std::uint32_t>(rng());
+            std::memcpy(&op.floatValue, &op.uintValue, sizeof(float));
+            break;
+        case Op::RangedFloat:
+        {
+            static const std::array<float, 5u> Precisions = { 1.f / 512.f, 1.f / 64.f, 0.1f, 1.f, 10.f };
+            op.floatMin = std::uniform_real_distribution<float>(-1000.f, 1000.f)(rng);
+            op.floatMax = op.floatMin + std::uniform_real_distribution<float>(0.01f, 2000.f)(rng);
+            op.precision = Precisions[rng() % Precisions.size()];
+            op.floatValue = std::uniform_real_distribution<float>(op.floatMin - 10.f, op.floatMax + 10.f)(rng);
+        }
+            break;
+        case Op::Quat:
+            op.bitCount = static_cast<std::uint32_t>(rng() % 13); //clamped to 2 - 10
+            op.quatValue = randomQuat(rng);
+            break;
+        }
+        return op;
+    }
+
+    void writeOp(BitWriter& writer, const Op& op)
+    {
+        switch (op.type)
+        {
+        default: break;
+        case Op::Bits:
+            writer.writeBits(op.uintValue, op.bitCount);
+            break;
+        case Op::Bool:
+            writer.writeBool(op.uintValue != 0);
+            break;
+        case Op::Int:
+            writer.writeInt(op.intValue, op.min, op.max);
+            break;
+        case Op::Varint:
+            writer.writeVarint(op.uintValue);
+            break;
+        case Op::SignedVarint:
+            writer.writeSignedVarint(op.intValue);
+            break;
+        case Op::Float:
+            writer.writeFloat(op.floatValue);
+            break;
+        case Op::RangedFloat:
+            writer.writeFloat(op.floatValue, op.floatMin, op.floatMax, op.precision);
+            break;
+        case Op::Quat:
+            writer.writeQuat(op.quatValue, op.bitCount);
+            break;
+        }
+    }
+
+    //reads the raw bits of a ranged value from a copy of the reader,
+    //to check that the reader rejects exactly those outside the range
+    bool rawInRange(const BitReader& reader, std::uint32_t range)
+    {
+        auto copy = reader;
+        std::uint32_t raw = 0;
+        return copy.readBits(raw, bitsRequired(range)) && raw <= range;
+    }
+
+    //decodes a varint from a copy of the reader, rejecting
+    //those which don't end within the 32 bits of a value
+    bool rawVarint(const BitReader& reader, std::uint32_t& value)
+    {
+        auto copy = reader;
+        value = 0;
+        for (auto shift = 0u; shift < 35; shift += 7)
+        {
+            std::uint32_t group = 0;
+            if (!copy.readBits(group, 8)
+                || (shift == 28 && group > 0x0f))
+            {
+                return false;
+            }
+
+            value |= (group & 0x7f) << shift;
+            if ((group & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+    Reads a value with the parameters of op. Successful reads must be
+    within the parameter's range, and also match the value of op when
+    compare is true. Failed reads must leave the destination unmodified.
+    Returns false if any of these checks fail.
+    */
+    bool readOp(BitReader& reader, const Op& op, bool compare, bool& success)
+    {
+        constexpr std::uint32_t Sentinel = 0xdeadbeef;
+
+        switch (op.type)
+        {
+        default: return false;
+        case Op::Bits:
+        {
+            const auto valid = op.bitCount <= 32
+                && !reader.hasError()
+                && reader.getBitsRemaining() >= op.bitCount;
+
+            std::uint32_t value = Sentinel;
+            success = reader.readBits(value, op.bitCount);
+            if (success != valid)
+            {
+                return false;
+            }
+
+            if (!success)
+            {
+                return value == Sentinel;
+            }
+
+            const auto mask = op.bitCount < 32 ? (1u << op.bitCount) - 1 : 0xffffffffu;
+            return (value & ~mask) == 0
+                && (!compare || value == (op.uintValue & mask));
+        }
+        case Op::Bool:
+        {
+            bool value = false;
+            success = reader.readBool(value);
+            return !success || !compare || value == (op.uintValue != 0);
+        }
+        case Op::Int:
+        {
+            const auto valid = rawInRange(reader, static_cast<std::uint32_t>(static_cast<std::int64_t>(op.max) - op.min));
+
+            std::int32_t value = static_cast<std::int32_t>(Sentinel);
+            success = reader.readInt(value, op.min, op.max);
+            if (success != valid)
+            {
+                return false;
+            }
+
+            if (!success)
+            {
+                return value == static_cast<std::int32_t>(Sentinel);
+            }
+            return value >= op.min && value <= op.max
+                && (!compare || value == std::clamp(op.intValue, op.min, op.max));
+        }
+        case Op::Varint:
+        {
+            std::uint32_t expected = 0;
+            const auto valid = rawVarint(reader, expected);
+
+            std::uint32_t value = Sentinel;
+            success = reader.readVarint(value);
+            if (success != valid)
+            {
+                return false;
+            }
+
+            if (!success)
+            {
+                return value == Sentinel;
+            }
+            return value == expected
+                && (!compare || value == op.uintValue);
+        }
+        case Op::SignedVarint:
+        {
+            std::uint32_t encoded = 0;
+            const auto valid = rawVarint(reader, encoded);
+
+            std::int32_t value = static_cast<std::int32_t>(Sentinel);
+            success = reader.readSignedVarint(value);
+            if (success != valid)
+            {
+                return false;
+            }
+
+            if (!success)
+            {
+                return value == static_cast<std::int32_t>(Sentinel);
+            }
+            return (static_cast<std::uint32_t>(value) << 1 ^ static_cast<std::uint32_t>(value >> 31)) == encoded
+                && (!compare || value == op.intValue);
+        }
+        case Op::Float:
+        {
+            float value = 0.f;
+            std::memcpy(&value, &Sentinel, sizeof(float));
+            success = reader.readFloat(value);
+
+            std::uint32_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(float));
+            if (!success)
+            {
+                return bits == Sentinel;
+            }
+            return !compare || bits == op.uintValue;
+        }
+        case Op::RangedFloat:
+        {
+            const auto steps = static_cast<std::uint32_t>(std::ceil((op.floatMax - op.floatMin) / op.precision));
+            const auto valid = rawInRange(reader, steps);
+
+            constexpr float FloatSentinel = -12345.f;
+            float value = FloatSentinel;
+            success = reader.readFloat(value, op.floatMin, op.floatMax, op.precision);
+            if (success != valid)
+            {
+                return false;
+            }
+
+            if (!success)
+            {
+                return value == FloatSentinel;
+            }
+            return value >= op.floatMin && value <= op.floatMax
+                && (!compare || floatMatches(value, op.floatValue, op.floatMin, op.floatMax, op.precision));
+        }
+        case Op::Quat:
+        {
+            const glm::quat QuatSentinel(0.f, 0.f, 0.f, 0.f);
+            glm::quat value = QuatSentinel;
+            success = reader.readQuat(value, op.bitCount);
+            if (!success)
+            {
+                return value == QuatSentinel;
+            }
+            return isUnit(value)
+                && (!compare || quatMatches(value, op.quatValue, op.bitCount));
+        }
+        }
+    }
+}
+
+void BitStreamFuzz::drawSettings()
+{
+    ImGui::SliderInt("Iterations", &m_settings.iterations, 1000, 200000);
+    ImGui::InputInt("Seed", &m_settings.seed);
+}
+
+void BitStreamFuzz::run()
+{
+    m_result = fuzz(m_settings);
+}
+
+void BitStreamFuzz::drawResult()
+{
+    if (m_result.valid)
+    {
+        ImGui::Text("Round trips: %u, %u failed", m_result.roundTrips, m_result.roundTripFailures);
+        ImGui::Text("Truncated: %u, %u accepted", m_result.truncations, m_result.truncationFailures);
+        ImGui::Text("Random: %u, %u accepted, %u out of range", m_result.randomBuffers, m_result.randomAccepted, m_result.rangeFailures);
+        ImGui::Text("Sequences: %u, %u failed", m_result.sequences, m_result.sequenceFailures);
+        ImGui::Text("Time: %3.2fms", m_result.time);
+
+        if (m_result.getFailureCount() != 0)
+        {
+            ImGui::Text("First failure: %s", m_result.firstFailure.c_str());
+        }
+    }
+}
+
+//private
+BitStreamFuzz::Result BitStreamFuzz::fuzz(const Settings& settings)
+{
+    Result result;
+
+    Rng rng(static_cast<std::uint32_t>(settings.seed));
+    std::int32_t iteration = 0;
+
+    const auto fail = [&](std::uint32_t& counter, const std::string& msg)
+    {
+        counter++;
+        if (result.firstFailure.empty())
+        {
+            result.firstFailure = msg + " on iteration " + std::to_string(iteration);
+        }
+    };
+
+    //random or corrupt data must either be rejected or be within range
+    const auto readRandom = [&](const std::vector<std::uint8_t>& buffer)
+    {
+        result.randomBuffers++;
+
+        BitReader reader(buffer.data(), buffer.size());
+        ActorInfo actor;
+        if (read(reader, actor))
+        {
+            result.randomAccepted++;
+            if (!actorInRange(actor))
+            {
+                fail(result.rangeFailures, "Accepted actor out of range");
+            }
+        }
+        if (reader.getBitsRemaining() > buffer.size() * 8)
+        {
+            fail(result.rangeFailures, "Read past the end of an actor");
+        }
+
+        //and the same for arbitrary reads, which must
+        //all fail once one of them has failed
+        result.sequences++;
+        BitReader opReader(buffer.data(), buffer.size());
+        auto remaining = opReader.getBitsRemaining();
+        bool failed = false;
+        for (auto i = 0u; i < 8u; ++i)
+        {
+            const auto op = randomOp(rng, true);
+            bool success = false;
+            if (!readOp(opReader, op, false, success)
+                || (failed && success)
+                || opReader.getBitsRemaining() > remaining)
+            {
+                fail(result.sequenceFailures, "Random read of type " + std::to_string(op.type) + " invalid");
+                break;
+            }
+            failed = failed || !success;
+            remaining = opReader.getBitsRemaining();
+        }
+    };
+
+    BitWriter writer;
+    std::vector<std::uint8_t> buffer;
+    std::vector<Op> ops;
+
+    cro::Clock clock;
+    for (; iteration < settings.iterations; ++iteration)
+    {
+        //valid actors must round trip, leaving only padding unread
+        const auto actor = randomActor(rng);
+        writer.clear();
+        write(writer, actor);
+
+        result.roundTrips++;
+        BitReader reader(writer.getData(), writer.getSize());
+        ActorInfo received;
+        if (!read(reader, received)
+            || !actorMatches(actor, received)
+            || reader.getBitsRemaining() >= 8)
+        {
+            fail(result.roundTripFailures, "Actor round trip failed");
+        }
+
+        //and every truncation of them must be rejected
+        for (auto i = 0u; i < writer.getSize(); ++i)
+        {
+            result.truncations++;
+            BitReader truncatedReader(writer.getData(), i);
+            ActorInfo truncated;
+            if (read(truncatedReader, truncated))
+            {
+                fail(result.truncationFailures, "Actor truncated to " + std::to_string(i) + " bytes was accepted");
+            }
+        }
+
+        //a valid packet with a few bits flipped
+        buffer.assign(writer.getData(), writer.getData() + writer.getSize());
+        const auto flipCount = 1 + (rng() % 4);
+        for (auto i = 0u; i < flipCount; ++i)
+        {
+            buffer[rng() % buffer.size()] ^= static_cast<std::uint8_t>(1u << (rng() % 8));
+        }
+        readRandom(buffer);
+
+        //and one which is just noise
+        buffer.resize(rng() % 32);
+        for (auto& b : buffer)
+        {
+            b = static_cast<std::uint8_t>(rng());
+        }
+        readRandom(buffer);
+
+        //random sequences of values must round trip too
+        ops.resize(1 + (rng() % 16));
+        writer.clear();
+        for (auto& op : ops)
+        {
+            op = randomOp(rng, false);
+            writeOp(writer, op);
+        }
+
+        result.sequences++;
+        BitReader opReader(writer.getData(), writer.getSize());
+        for (const auto& op : ops)
+        {
+            bool success = false;
+            if (!readOp(opReader, op, true, success)
+                || !success)
+            {
+                fail(result.sequenceFailures, "Round trip of type " + std::to_string(op.type) + " failed");
+                break;
+            }
+        }
+        if (opReader.hasError()
+            || opReader.getBitsRemaining() >= 8)
+        {
+            fail(result.sequenceFailures, "Sequence round trip didn't read all the data");
+        }
+
+        //and fail from the first value which is cut off
+        if (writer.getSize() != 0)
+        {
+            result.sequences++;
+            BitReader truncatedReader(writer.getData(), writer.getSize() - 1);
+            bool failed = false;
+            for (const auto& op : ops)
+            {
+                bool success = false;
+                if (!readOp(truncatedReader, op, true, success)
+                    || (failed && success))
+                {
+                    fail(result.sequenceFailures, "Truncated read of type " + std::to_string(op.type) + " invalid");
+                    break;
+                }
+                failed = failed || !success;
+            }
+
+            if (!failed)
+            {
+                fail(result.sequenceFailures, "Truncated sequence was accepted");
+            }
+        }
+    }
+
+    result.time = clock.elapsed().asSeconds() * 1000.f;
+    result.valid = true;
+    return result;
+}
@@ -0,0 +1,85 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include "Benchmark.hpp"
+
+#include <cstdint>
+#include <string>
+
+/*
+Fuzzes BitReader with packets shaped like the golf sample's ActorInfo:
+valid packets must round trip within their quantisation, truncated
+ones must be rejected, and random or corrupted buffers must either
+be rejected or produce values inside the serialised ranges. Random
+sequences of the individual read/write functions are checked the
+same way, along with the reader's sticky error flag.
+*/
+class BitStreamFuzz final : public Benchmark
+{
+public:
+    const char* getName() const override { return "Bit Stream Fuzz"; }
+
+    void drawSettings() override;
+    void run() override;
+    void drawResult() override;
+
+private:
+
+    struct Settings final
+    {
+        std::int32_t iterations = 20000;
+        std::int32_t seed = 1;
+    }m_settings;
+
+    struct Result final
+    {
+        bool valid = false;
+        float time = 0.f; //ms
+        std::uint32_t roundTrips = 0;
+        std::uint32_t roundTripFailures = 0;
+        std::uint32_t truncations = 0;
+        std::uint32_t truncationFailures = 0; //truncated packets which were accepted
+        std::uint32_t randomBuffers = 0;
+        std::uint32_t randomAccepted = 0;
+        std::uint32_t rangeFailures = 0; //accepted with values outside the serialised ranges
+        std::uint32_t sequences = 0;
+        std::uint32_t sequenceFailures = 0;
+        std::string firstFailure;
+
+        std::uint32_t getFailureCount() const
+        {
+            return roundTripFailures + truncationFailures + rangeFailures + sequenceFailures;
+        }
+    }m_result;
+
+    static Result fuzz(const Settings&);
+};
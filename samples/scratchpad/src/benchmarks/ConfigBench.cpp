@@ -0,0 +1,133 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include "ConfigBench.hpp"
+
+#include <crogine/core/App.hpp>
+#include <crogine/core/Clock.hpp>
+#include <crogine/core/ConfigFile.hpp>
+#include <crogine/core/Log.hpp>
+#include <crogine/gui/Gui.hpp>
+
+#include <fstream>
+#include <random>
+
+namespace
+{
+    const std::string CorpusName("config_bench.cmt");
+}
+
+void ConfigBench::drawSettings()
+{
+    ImGui::SliderInt("Objects", &m_settings.objectCount, 1000, 100000);
+    ImGui::SliderInt("Iterations", &m_settings.iterations, 1, 20);
+}
+
+void ConfigBench::run()
+{
+    const auto path = cro::App::getPreferencePath() + CorpusName;
+
+    m_result = {};
+    if (generateCorpus(path, m_settings.objectCount))
+    {
+        m_result = benchmark(path, m_settings.iterations);
+    }
+}
+
+void ConfigBench::drawResult()
+{
+    if (m_result.valid)
+    {
+        ImGui::Text("Corpus: %3.2fMB, %u objects", m_result.corpusSize, static_cast<std::uint32_t>(m_result.objectCount));
+        ImGui::Text("Parse time: %3.2fms", m_result.parseTime);
+        ImGui::Text("Throughput: %3.1fMB/s", m_result.throughput);
+    }
+}
+
+//private
+bool ConfigBench::generateCorpus(const std::string& path, std::int32_t objectCount)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        LogE << "Failed opening " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    //fixed seed so every run parses the same file. The content mixes
+    //the things parsers have to deal with in real model definitions -
+    //comments, tabs, CRLF line endings, quoted strings and vectors
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<std::int32_t> dist(0, 999);
+
+    file << "model config_bench\n{\n";
+    for (auto i = 0; i < objectCount; ++i)
+    {
+        file << "    material VertexLit //comment here\n    {\n";
+        file << "\tdiffuse = \"assets/images/texture_" << i << ".png\"\n";
+        file << "        colour = " << dist(rng) / 1000.f << "," << dist(rng) / 1000.f << ",0.5,1\r\n";
+        file << "        position = " << dist(rng) - 500 << ", 2.5 ," << dist(rng) % 7 << "\n";
+        file << "        smooth = true\n";
+        file << "        mask_colour = 1,1,1,1 //end\n    }\n";
+    }
+    file << "}\n";
+
+    return file.good();
+}
+
+ConfigBench::Result ConfigBench::benchmark(const std::string& path, std::int32_t iterations)
+{
+    Result result;
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+    {
+        return result;
+    }
+    result.corpusSize = static_cast<float>(file.tellg()) / (1024.f * 1024.f);
+
+    cro::ConfigFile cfg;
+    cro::Clock clock;
+    for (auto i = 0; i < iterations; ++i)
+    {
+        if (!cfg.loadFromFile(path, false))
+        {
+            return result;
+        }
+    }
+    const auto elapsed = clock.elapsed().asSeconds() / iterations;
+
+    result.valid = true;
+    result.parseTime = elapsed * 1000.f;
+    result.throughput = result.corpusSize / elapsed;
+    result.objectCount = cfg.getObjects().size();
+
+    return result;
+}
@@ -0,0 +1,71 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include "Benchmark.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+Measures ConfigFile parse throughput by generating a corpus of
+model definition style objects and timing repeated loads of it
+*/
+class ConfigBench final : public Benchmark
+{
+public:
+    const char* getName() const override { return "Config"; }
+
+    void drawSettings() override;
+    void run() override;
+    void drawResult() override;
+
+private:
+
+    struct Settings final
+    {
+        std::int32_t objectCount = 20000;
+        std::int32_t iterations = 5;
+    }m_settings;
+
+    struct Result final
+    {
+        bool valid = false;
+        float corpusSize = 0.f; //MB
+        float parseTime = 0.f; //ms per load
+        float throughput = 0.f; //MB/s
+        std::size_t objectCount = 0; //objects found in the parsed file
+    }m_result;
+
+    static bool generateCorpus(const std::string& path, std::int32_t objectCount);
+    static Result benchmark(const std::string& path, std::int32_t iterations);
+};
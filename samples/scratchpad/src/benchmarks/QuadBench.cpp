@@ -0,0 +1,185 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "QuadBench.hpp"
+
+#include <crogine/core/Clock.hpp>
+#include <crogine/detail/QuadTree.hpp>
+#include <crogine/gui/Gui.hpp>
+
+#include <random>
+
+namespace
+{
+    const cro::FloatRect WorldArea(0.f, 0.f, 1000.f, 1000.f);
+    const glm::vec2 ViewSize(320.f, 180.f);
+
+    float toMicroseconds(const cro::Clock& clock, std::size_t count)
+    {
+        return count == 0 ? 0.f : clock.elapsed().asSeconds() * 1000000.f / count;
+    }
+}
+
+QuadBench::QuadBench(const std::vector<cro::Entity>& entities)
+    : m_entities(entities)
+{
+
+}
+
+void QuadBench::drawSettings()
+{
+    ImGui::SliderInt("Sprites", &m_settings.spriteCount, 100, static_cast<std::int32_t>(m_entities.size()));
+    ImGui::SliderInt("Frames", &m_settings.frameCount, 10, 1000);
+    ImGui::SliderInt("Queries Per Frame", &m_settings.queriesPerFrame, 1, 50);
+    ImGui::SliderInt("Iterations", &m_settings.iterations, 1, 50);
+    ImGui::SliderFloat("Moving", &m_settings.moveFraction, 0.f, 1.f);
+}
+
+void QuadBench::run()
+{
+    m_result = benchmark(m_entities, m_settings);
+}
+
+void QuadBench::drawResult()
+{
+    if (m_result.valid)
+    {
+        ImGui::Text("Insert: %3.3fus per sprite", m_result.insertTime);
+        ImGui::Text("Move: %3.3fus per sprite, %u of %u reinserted", m_result.moveTime,
+            static_cast<std::uint32_t>(m_result.reinsertCount), static_cast<std::uint32_t>(m_result.moveCount));
+        ImGui::Text("Query: %3.3fus, %u results", m_result.queryTime, static_cast<std::uint32_t>(m_result.queryResults));
+        ImGui::Text("Intersecting: %3.3fms", m_result.intersectTime);
+    }
+}
+
+//private
+QuadBench::Result QuadBench::benchmark(const std::vector<cro::Entity>& entities, const Settings& settings)
+{
+    Result result;
+
+    const auto spriteCount = std::min(static_cast<std::size_t>(settings.spriteCount), entities.size());
+    const auto frameCount = std::max(1, settings.frameCount);
+    const auto iterations = std::max(1, settings.iterations);
+
+    //fixed seed so every run measures the same movement
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(0.f, 1.f);
+    std::uniform_real_distribution<float> size(8.f, 32.f);
+    std::uniform_real_distribution<float> step(-2.f, 2.f);
+
+    std::vector<cro::FloatRect> bounds;
+    for (auto i = 0u; i < spriteCount; ++i)
+    {
+        bounds.emplace_back(position(rng) * WorldArea.width, position(rng) * WorldArea.height, size(rng), size(rng));
+    }
+
+    //each frame a portion of the sprites moves a short distance
+    std::vector<std::vector<std::pair<std::size_t, glm::vec2>>> moves(frameCount);
+    for (auto& frame : moves)
+    {
+        for (auto i = 0u; i < spriteCount; ++i)
+        {
+            if (position(rng) < settings.moveFraction)
+            {
+                frame.emplace_back(i, glm::vec2(step(rng), step(rng)));
+            }
+        }
+        result.moveCount += frame.size();
+    }
+
+    std::vector<cro::FloatRect> views;
+    for (auto i = 0; i < settings.queriesPerFrame * frameCount; ++i)
+    {
+        views.emplace_back(position(rng) * (WorldArea.width - ViewSize.x), position(rng) * (WorldArea.height - ViewSize.y), ViewSize.x, ViewSize.y);
+    }
+
+    cro::Detail::QuadTree tree(WorldArea);
+
+    //the tree is rebuilt once per frame so that
+    //there are enough insertions to measure
+    cro::Clock clock;
+    for (auto i = 0; i < frameCount; ++i)
+    {
+        tree.clear();
+        for (auto j = 0u; j < spriteCount; ++j)
+        {
+            tree.add(entities[j], bounds[j]);
+        }
+    }
+    result.insertTime = toMicroseconds(clock, spriteCount * frameCount);
+
+    //the sprites keep wandering with each iteration
+    //rather than returning to their start positions
+    clock.restart();
+    for (auto i = 0; i < iterations; ++i)
+    {
+        for (const auto& frame : moves)
+        {
+            for (const auto& [index, offset] : frame)
+            {
+                bounds[index].left += offset.x;
+                bounds[index].bottom += offset.y;
+                if (tree.update(entities[index], bounds[index]))
+                {
+                    result.reinsertCount++;
+                }
+            }
+        }
+    }
+    result.moveCount *= iterations;
+    result.moveTime = toMicroseconds(clock, result.moveCount);
+
+    //the output buffer is reused, as RenderSystem2D does
+    std::vector<cro::Entity> visible;
+    std::size_t queryResults = 0;
+    clock.restart();
+    for (auto i = 0; i < iterations; ++i)
+    {
+        for (const auto& view : views)
+        {
+            visible.clear();
+            tree.query(view, visible);
+            queryResults += visible.size();
+        }
+    }
+    result.queryTime = toMicroseconds(clock, views.size() * iterations);
+    result.queryResults = queryResults / (views.size() * iterations);
+
+    std::vector<std::pair<cro::Entity, cro::Entity>> pairs;
+    clock.restart();
+    for (auto i = 0; i < frameCount; ++i)
+    {
+        pairs.clear();
+        tree.getIntersecting(pairs);
+    }
+    result.intersectTime = toMicroseconds(clock, frameCount) / 1000.f;
+
+    result.valid = true;
+    return result;
+}
@@ -0,0 +1,91 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include "Benchmark.hpp"
+
+#include <crogine/ecs/Entity.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+Measures the cost of inserting, moving and querying sprite sized
+members of a QuadTree, as RenderSystem2D does when culling.
+
+This only measures the current QuadTree - it has no copy of the
+previous implementation to compare against. The sprite count is
+limited by the number of entities a Scene can hold (1024) so it
+doesn't run 100k sprites either. The old/new 100k sprite figures
+given in commit 146e470 came from a separate harness which was
+never committed.
+*/
+class QuadBench final : public Benchmark
+{
+public:
+    //the quad tree is given the sprite bounds directly
+    //so these entities need no components
+    explicit QuadBench(const std::vector<cro::Entity>& entities);
+
+    const char* getName() const override { return "Quad Tree"; }
+
+    void drawSettings() override;
+    void run() override;
+    void drawResult() override;
+
+private:
+
+    const std::vector<cro::Entity>& m_entities;
+
+    struct Settings final
+    {
+        std::int32_t spriteCount = 1000;
+        std::int32_t frameCount = 100;
+        std::int32_t queriesPerFrame = 10;
+        std::int32_t iterations = 10; //of the moves and queries
+        float moveFraction = 0.25f; //of sprites which move each frame
+    }m_settings;
+
+    struct Result final
+    {
+        bool valid = false;
+        float insertTime = 0.f; //us per sprite
+        float moveTime = 0.f; //us per moved sprite
+        float queryTime = 0.f; //us per query
+        float intersectTime = 0.f; //ms per frame
+        std::size_t moveCount = 0;
+        std::size_t reinsertCount = 0;
+        std::size_t queryResults = 0; //average per query
+    }m_result;
+
+    static Result benchmark(const std::vector<cro::Entity>& entities, const Settings&);
+};
@@ -0,0 +1,189 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "TreeBench.hpp"
+
+#include <crogine/core/Clock.hpp>
+#include <crogine/detail/BalancedTree.hpp>
+#include <crogine/gui/Gui.hpp>
+
+#include <random>
+
+namespace
+{
+    constexpr std::int32_t MaxNodes = 100000;
+
+    //the tree is filled with a flattish world, which
+    //is roughly what a game level looks like
+    const glm::vec3 WorldSize(1000.f, 100.f, 1000.f);
+    constexpr std::uint64_t QueryFilter = 0b0101;
+
+    float toMilliseconds(const cro::Clock& clock, std::int32_t iterations)
+    {
+        return clock.elapsed().asSeconds() * 1000.f / iterations;
+    }
+}
+
+TreeBench::TreeBench(const std::vector<cro::Entity>& entities)
+    : m_entities(entities)
+{
+
+}
+
+void TreeBench::drawSettings()
+{
+    ImGui::SliderInt("Nodes", &m_settings.nodeCount, 1000, MaxNodes);
+    ImGui::SliderInt("Queries", &m_settings.queryCount, 1000, 50000);
+    ImGui::SliderInt("Iterations", &m_settings.iterations, 1, 10);
+    ImGui::SliderFloat("Query Extent", &m_settings.queryExtent, 1.f, 50.f);
+}
+
+void TreeBench::run()
+{
+    m_result = benchmark(m_entities, m_settings);
+}
+
+void TreeBench::drawResult()
+{
+    if (m_result.valid)
+    {
+        ImGui::Text("Build: %3.2fms, height %d", m_result.buildTime, m_result.treeHeight);
+        ImGui::Text("Single: %3.2fms, %u results", m_result.singleTime, static_cast<std::uint32_t>(m_result.singleResults));
+        ImGui::Text("Batched: %3.2fms, %u results", m_result.batchTime, static_cast<std::uint32_t>(m_result.batchResults));
+        ImGui::Text("Sphere: %3.2fms", m_result.sphereTime);
+        ImGui::Text("Ray: %3.2fms", m_result.rayTime);
+        ImGui::Text("Pairs: %3.2fms, %u pairs", m_result.pairTime, static_cast<std::uint32_t>(m_result.pairCount));
+    }
+}
+
+//private
+TreeBench::Result TreeBench::benchmark(const std::vector<cro::Entity>& entities, const Settings& settings)
+{
+    Result result;
+
+    const auto iterations = std::max(1, settings.iterations);
+
+    //fixed seed so every run measures the same tree and queries
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(0.f, 1.f);
+    std::uniform_real_distribution<float> size(0.5f, 4.f);
+    const auto randomPosition = [&]()
+    {
+        return glm::vec3(position(rng), position(rng), position(rng)) * WorldSize;
+    };
+
+    cro::Detail::BalancedTree tree(1.f);
+    cro::Clock clock;
+    for (auto i = 0; i < settings.nodeCount; ++i)
+    {
+        const auto centre = randomPosition();
+        const auto halfSize = glm::vec3(size(rng));
+        tree.addToTree(entities[i % entities.size()], cro::Box(centre - halfSize, centre + halfSize), 1ull << (i % 4));
+    }
+    result.buildTime = toMilliseconds(clock, 1);
+    result.treeHeight = tree.getNodes()[tree.getRoot()].height;
+
+    std::vector<cro::Box> areas;
+    std::vector<cro::Sphere> spheres;
+    std::vector<std::pair<glm::vec3, glm::vec3>> rays;
+    for (auto i = 0; i < settings.queryCount; ++i)
+    {
+        const auto centre = randomPosition();
+        areas.emplace_back(centre - glm::vec3(settings.queryExtent), centre + glm::vec3(settings.queryExtent));
+
+        auto& sphere = spheres.emplace_back();
+        sphere.centre = centre;
+        sphere.radius = settings.queryExtent;
+
+        rays.emplace_back(centre, glm::normalize(randomPosition() - centre));
+    }
+
+    //the output buffer is reused, as a game would
+    std::vector<cro::Entity> results;
+    clock.restart();
+    for (auto i = 0; i < iterations; ++i)
+    {
+        result.singleResults = 0;
+        for (const auto& area : areas)
+        {
+            results.clear();
+            tree.query(area, QueryFilter, results);
+            result.singleResults += results.size();
+        }
+    }
+    result.singleTime = toMilliseconds(clock, iterations);
+
+    std::vector<std::vector<cro::Entity>> batchResults;
+    clock.restart();
+    for (auto i = 0; i < iterations; ++i)
+    {
+        tree.query(areas, QueryFilter, batchResults);
+    }
+    result.batchTime = toMilliseconds(clock, iterations);
+
+    for (const auto& r : batchResults)
+    {
+        result.batchResults += r.size();
+    }
+
+    clock.restart();
+    for (auto i = 0; i < iterations; ++i)
+    {
+        for (const auto& sphere : spheres)
+        {
+            results.clear();
+            tree.query(sphere, QueryFilter, results);
+        }
+    }
+    result.sphereTime = toMilliseconds(clock, iterations);
+
+    clock.restart();
+    for (auto i = 0; i < iterations; ++i)
+    {
+        for (const auto& [origin, direction] : rays)
+        {
+            results.clear();
+            tree.queryRay(origin, direction, settings.queryExtent * 10.f, QueryFilter, results);
+        }
+    }
+    result.rayTime = toMilliseconds(clock, iterations);
+
+    std::vector<std::pair<cro::Entity, cro::Entity>> pairs;
+    clock.restart();
+    for (auto i = 0; i < iterations; ++i)
+    {
+        pairs.clear();
+        tree.queryPairs(QueryFilter, pairs);
+    }
+    result.pairTime = toMilliseconds(clock, iterations);
+    result.pairCount = pairs.size();
+
+    result.valid = true;
+    return result;
+}
@@ -0,0 +1,87 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include "Benchmark.hpp"
+
+#include <crogine/ecs/Entity.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+Measures the dynamic tree's query performance by filling a
+BalancedTree with randomly placed boxes and timing single,
+batched, sphere, ray and pair queries against it
+*/
+class TreeBench final : public Benchmark
+{
+public:
+    //the leaves share these entities, which need
+    //a Transform component but are never moved
+    explicit TreeBench(const std::vector<cro::Entity>& entities);
+
+    const char* getName() const override { return "Tree"; }
+
+    void drawSettings() override;
+    void run() override;
+    void drawResult() override;
+
+private:
+
+    const std::vector<cro::Entity>& m_entities;
+
+    struct Settings final
+    {
+        std::int32_t nodeCount = 50000;
+        std::int32_t queryCount = 10000;
+        std::int32_t iterations = 3;
+        float queryExtent = 10.f;
+    }m_settings;
+
+    struct Result final
+    {
+        bool valid = false;
+        float buildTime = 0.f; //all times in ms
+        float singleTime = 0.f; //per pass over all queries
+        float batchTime = 0.f;
+        float sphereTime = 0.f;
+        float rayTime = 0.f;
+        float pairTime = 0.f;
+        std::int32_t treeHeight = 0;
+        std::size_t singleResults = 0; //totals from the last pass
+        std::size_t batchResults = 0;
+        std::size_t pairCount = 0;
+    }m_result;
+
+    static Result benchmark(const std::vector<cro::Entity>& entities, const Settings&);
+};
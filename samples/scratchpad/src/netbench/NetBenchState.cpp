@@ -0,0 +1,323 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#include "NetBenchState.hpp"
+
+#include <crogine/core/Clock.hpp>
+#include <crogine/gui/Gui.hpp>
+#include <crogine/network/NetClient.hpp>
+#include <crogine/network/NetHost.hpp>
+
+#include <vector>
+
+namespace
+{
+    constexpr std::uint16_t Port = 20557;
+    constexpr std::uint8_t PacketID = 1;
+
+    //roughly the size of the actor updates sent by the golf server
+    struct ActorUpdate final
+    {
+        std::uint32_t serverID = 0;
+        float position[3] = {};
+        std::int16_t rotation[4] = {};
+        std::int32_t timestamp = 0;
+        std::uint8_t clientID = 0;
+        std::uint8_t playerID = 0;
+        std::uint8_t state = 0;
+    };
+
+    struct ClientStats final
+    {
+        std::atomic<std::size_t> packetCount = 0;
+        std::atomic<std::size_t> byteCount = 0;
+        std::atomic<std::size_t> recordCount = 0;
+    };
+}
+
+NetBenchState::NetBenchState(cro::StateStack& stack, cro::State::Context context)
+    : cro::State    (stack, context),
+    m_running       (false)
+{
+    context.mainWindow.loadResources([this]() {
+        createUI();
+    });
+}
+
+NetBenchState::~NetBenchState()
+{
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+//public
+bool NetBenchState::handleEvent(const cro::Event& evt)
+{
+    if (cro::ui::wantsMouse() || cro::ui::wantsKeyboard())
+    {
+        return true;
+    }
+
+    if (evt.type == SDL_KEYDOWN)
+    {
+        switch (evt.key.keysym.sym)
+        {
+        default: break;
+        case SDLK_BACKSPACE:
+            if (!m_running)
+            {
+                requestStackClear();
+                requestStackPush(States::ScratchPad::MainMenu);
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+void NetBenchState::handleMessage(const cro::Message&)
+{
+
+}
+
+bool NetBenchState::simulate(float)
+{
+    if (!m_running && m_thread.joinable())
+    {
+        m_thread.join();
+    }
+    return true;
+}
+
+void NetBenchState::render()
+{
+
+}
+
+//private
+void NetBenchState::createUI()
+{
+    registerWindow([&]()
+        {
+            if (ImGui::Begin("Net Bench"))
+            {
+                ImGui::SliderInt("Clients", &m_settings.clientCount, 1, 16);
+                ImGui::SliderInt("Records Per Tick", &m_settings.recordsPerTick, 1, 200);
+                ImGui::SliderInt("Tick Rate", &m_settings.tickRate, 1, 60);
+                ImGui::SliderInt("Duration", &m_settings.duration, 1, 30);
+                ImGui::Checkbox("Reliable", &m_settings.reliable);
+
+                if (m_running)
+                {
+                    ImGui::Text("Running...");
+                }
+                else
+                {
+                    if (ImGui::Button("Run Individual"))
+                    {
+                        m_running = true;
+                        m_thread = std::thread(&NetBenchState::run, this, Mode::Individual, m_settings);
+                    }
+                    ImGui::SameLine();
+                    if (ImGui::Button("Run Aggregated"))
+                    {
+                        m_running = true;
+                        m_thread = std::thread(&NetBenchState::run, this, Mode::Aggregated, m_settings);
+                    }
+                }
+
+                ImGui::Separator();
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                const std::array<std::string, Mode::Count> Labels = { "Individual", "Aggregated" };
+                for (auto i = 0; i < Mode::Count; ++i)
+                {
+                    const auto& result = m_results[i];
+                    if (result.valid)
+                    {
+                        ImGui::Text("%s", Labels[i].c_str());
+                        ImGui::Text("  Packets/s: %3.1f", result.packetsPerSecond);
+                        ImGui::Text("  Bytes/s: %3.1f", result.bytesPerSecond);
+                        ImGui::Text("  Records/s: %3.1f (%3.2f%% lost)", result.recordsPerSecond, result.recordsLost);
+                        ImGui::Text("  Host send time: %3.1fus per tick", result.sendTime);
+                    }
+                }
+            }
+            ImGui::End();
+        });
+}
+
+void NetBenchState::run(std::int32_t mode, Settings settings)
+{
+    cro::NetHost host;
+    if (!host.start("", Port, settings.clientCount, 1))
+    {
+        m_running = false;
+        return;
+    }
+
+    std::atomic_bool clientsRunning = true;
+    std::atomic<std::int32_t> connectedCount = 0;
+    std::atomic<std::int32_t> finishedCount = 0;
+    ClientStats stats;
+
+    std::vector<std::thread> clients;
+    for (auto i = 0; i < settings.clientCount; ++i)
+    {
+        clients.emplace_back([&]()
+            {
+                cro::NetClient client;
+                if (!client.create(1)
+                    || !client.connect("127.0.0.1", Port))
+                {
+                    finishedCount++;
+                    return;
+                }
+                connectedCount++;
+
+                while (clientsRunning)
+                {
+                    cro::NetEvent evt;
+                    while (client.pollEvent(evt))
+                    {
+                        if (evt.type == cro::NetEvent::PacketReceived)
+                        {
+                            stats.packetCount++;
+                            stats.byteCount += evt.packet.getSize() + 1;
+
+                            if (evt.packet.getID() == cro::NetEvent::Packet::AggregateID)
+                            {
+                                for (const auto& record : evt.packet.getRecords())
+                                {
+                                    if (record.getID() == PacketID)
+                                    {
+                                        stats.recordCount++;
+                                    }
+                                }
+                            }
+                            else if (evt.packet.getID() == PacketID)
+                            {
+                                stats.recordCount++;
+                            }
+                        }
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                client.disconnect();
+                finishedCount++;
+            });
+    }
+
+    //wait for everyone to connect
+    cro::Clock timeout;
+    while (connectedCount < settings.clientCount
+        && timeout.elapsed().asSeconds() < 5.f)
+    {
+        cro::NetEvent evt;
+        while (host.pollEvent(evt)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const auto flags = settings.reliable ? cro::NetFlag::Reliable : cro::NetFlag::Unreliable;
+    const auto tickTime = 1.f / settings.tickRate;
+    const auto tickCount = settings.tickRate * settings.duration;
+    float sendTime = 0.f;
+
+    ActorUpdate update;
+    cro::Clock runClock;
+    for (auto i = 0; i < tickCount; ++i)
+    {
+        cro::Clock tickClock;
+        for (auto j = 0; j < settings.recordsPerTick; ++j)
+        {
+            update.serverID = j;
+            update.timestamp = i;
+            if (mode == Mode::Individual)
+            {
+                host.broadcastPacket(PacketID, update, flags);
+            }
+            else
+            {
+                host.queueBroadcast(PacketID, update, flags);
+            }
+        }
+        host.sendQueued();
+
+        cro::NetEvent evt;
+        while (host.pollEvent(evt)) {}
+        sendTime += tickClock.elapsed().asSeconds();
+
+        while (tickClock.elapsed().asSeconds() < tickTime)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    //give the clients a moment to catch up
+    cro::Clock drainClock;
+    while (drainClock.elapsed().asSeconds() < 0.5f)
+    {
+        cro::NetEvent evt;
+        while (host.pollEvent(evt)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const float elapsed = runClock.elapsed().asSeconds();
+
+    //client disconnect() blocks until the host replies
+    //so keep polling until they're all done
+    clientsRunning = false;
+    while (finishedCount < settings.clientCount)
+    {
+        cro::NetEvent evt;
+        while (host.pollEvent(evt)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    for (auto& client : clients)
+    {
+        client.join();
+    }
+    host.stop();
+
+    const float expected = static_cast<float>(tickCount * settings.recordsPerTick * settings.clientCount);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& result = m_results[mode];
+    result.valid = true;
+    result.packetsPerSecond = stats.packetCount / elapsed;
+    result.bytesPerSecond = stats.byteCount / elapsed;
+    result.recordsPerSecond = stats.recordCount / elapsed;
+    result.recordsLost = (1.f - (stats.recordCount / expected)) * 100.f;
+    result.sendTime = (sendTime / tickCount) * 1000000.f;
+
+    m_running = false;
+}
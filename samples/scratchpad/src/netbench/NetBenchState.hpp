@@ -0,0 +1,98 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2022
+http://trederia.blogspot.com
+
+crogine application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+
+#pragma once
+
+#include "../StateIDs.hpp"
+
+#include <crogine/core/State.hpp>
+#include <crogine/gui/GuiClient.hpp>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+/*
+Loopback benchmark comparing sending many small packets individually
+with NetHost::broadcastPacket() to packing them into one packet per
+tick with NetHost::queueBroadcast()
+*/
+class NetBenchState final : public cro::State, public cro::GuiClient
+{
+public:
+    NetBenchState(cro::StateStack&, cro::State::Context);
+    ~NetBenchState();
+
+    cro::StateID getStateID() const override { return States::ScratchPad::NetBench; }
+
+    bool handleEvent(const cro::Event&) override;
+    void handleMessage(const cro::Message&) override;
+    bool simulate(float) override;
+    void render() override;
+
+private:
+
+    struct Settings final
+    {
+        std::int32_t clientCount = 4;
+        std::int32_t recordsPerTick = 40;
+        std::int32_t tickRate = 20;
+        std::int32_t duration = 5;
+        bool reliable = false;
+    }m_settings;
+
+    struct Result final
+    {
+        bool valid = false;
+        float packetsPerSecond = 0.f; //ENet packets received by all clients
+        float bytesPerSecond = 0.f; //payload bytes received by all clients
+        float recordsPerSecond = 0.f;
+        float recordsLost = 0.f; //percent
+        float sendTime = 0.f; //host time per tick in microseconds
+    };
+
+    struct Mode final
+    {
+        enum
+        {
+            Individual, Aggregated,
+            Count
+        };
+    };
+    std::array<Result, Mode::Count> m_results = {};
+    std::mutex m_mutex;
+
+    std::thread m_thread;
+    std::atomic_bool m_running;
+
+    void createUI();
+    void run(std::int32_t mode, Settings);
+};
@@ -49,12 +49,15 @@ namespace
 }
 
 PostRadial::PostRadial()
+    : m_blurTarget(0)
 {
     m_inputShader.loadFromString(cro::PostVertex, extractionFrag);
     m_outputShader.loadFromString(cro::PostVertex, blueDream);
 
     addPass(m_inputShader);
     addPass(m_outputShader);
+
+    m_blurTarget = addTarget(glm::vec2(0.5f));
 }
 
 //public
@@ -62,19 +65,12 @@ void PostRadial::apply(const cro::RenderTexture& source)
 {
     glm::vec2 size(getCurrentBufferSize());
     setUniform("u_texture", source.getTexture(), m_inputShader);
-    m_blurBuffer.clear();
+    auto& blurBuffer = getTarget(m_blurTarget);
+    blurBuffer.clear();
     drawQuad(0, { 0.f, 0.f, size.x / 2.f, size.y / 2.f });
-    m_blurBuffer.display();
+    blurBuffer.display();
     
+    setUniform("u_texture", blurBuffer.getTexture(), m_outputShader);
     setUniform("u_baseTexture", source.getTexture(), m_outputShader);
     drawQuad(1, { 0.f, 0.f, size.x, size.y });
-}
-
-//private
-void PostRadial::bufferResized()
-{
-    auto size = getCurrentBufferSize() / 2u;
-    
-    m_blurBuffer.create(size.x, size.y, false);
-    setUniform("u_texture", m_blurBuffer.getTexture(), m_outputShader);
 }
\ No newline at end of file
@@ -44,9 +44,7 @@ public:
 private:
     cro::Shader m_inputShader;
     cro::Shader m_outputShader;
-    cro::RenderTexture m_blurBuffer;
-
-    void bufferResized() override;
+    std::size_t m_blurTarget;
 };
 
 #endif //TL_POST_RADIAL_HPP_
\ No newline at end of file